@@ -168,9 +168,31 @@ function init() {
     document.getElementById('player-fields').appendChild(ojama1);
     document.getElementById('player-fields').appendChild(ojama2);
 
-    setInterval(function() {
-        loadData();
-    }, 10);
+    if (window.EventSource) {
+        startStream();
+    } else {
+        setInterval(function() {
+            loadData();
+        }, 10);
+    }
+}
+
+function startStream() {
+    // The server sends the whole state first, then only the changed members.
+    var state = {};
+    var source = new EventSource("/stream");
+
+    source.addEventListener('snapshot', function(e) {
+        state = JSON.parse(e.data);
+        displayGameState(state);
+    });
+
+    source.addEventListener('delta', function(e) {
+        var delta = JSON.parse(e.data);
+        for (var key in delta)
+            state[key] = delta[key];
+        displayGameState(state);
+    });
 }
 
 function loadData() {
@@ -1,6 +1,8 @@
 #ifndef BASE_AVX_H_
 #define BASE_AVX_H_
 
+#include <cstdint>
+
 #if !defined(_MSC_VER)
 #include <x86intrin.h>
 #endif
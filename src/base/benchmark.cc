@@ -0,0 +1,143 @@
+#include "base/benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+using namespace std;
+
+namespace base {
+
+namespace {
+
+// Returns the value at |percentile| (0 - 100) of |sorted|, which must be sorted.
+double percentileOf(const vector<unsigned long long>& sorted, double percentile)
+{
+    if (sorted.empty())
+        return 0;
+
+    size_t index = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+    if (index > 0)
+        --index;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+} // anonymous namespace
+
+string BenchmarkResult::toString() const
+{
+    stringstream ss;
+    ss << left << setw(56) << name << right
+       << " N=" << setw(8) << iterations
+       << fixed << setprecision(0)
+       << " p50=" << setw(9) << p50Cycles
+       << " p90=" << setw(9) << p90Cycles
+       << " p99=" << setw(9) << p99Cycles
+       << " mean=" << setw(9) << meanCycles
+       << " sd=" << setw(8) << stddevCycles
+       << setprecision(1)
+       << " (" << nanosPerIteration << " ns/iter)";
+    return ss.str();
+}
+
+// static
+BenchmarkResult BenchmarkResult::fromSamples(const string& name,
+                                             vector<unsigned long long>* samples,
+                                             chrono::nanoseconds wallTime)
+{
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = samples->size();
+    if (samples->empty())
+        return result;
+
+    sort(samples->begin(), samples->end());
+
+    double sum = 0;
+    for (auto x : *samples)
+        sum += x;
+    double mean = sum / samples->size();
+
+    double diffSquareSum = 0;
+    for (auto x : *samples)
+        diffSquareSum += (x - mean) * (x - mean);
+
+    result.meanCycles = mean;
+    result.stddevCycles = std::sqrt(diffSquareSum / samples->size());
+    result.minCycles = samples->front();
+    result.p50Cycles = percentileOf(*samples, 50);
+    result.p90Cycles = percentileOf(*samples, 90);
+    result.p99Cycles = percentileOf(*samples, 99);
+    result.maxCycles = samples->back();
+    result.nanosPerIteration = static_cast<double>(wallTime.count()) / samples->size();
+    return result;
+}
+
+vector<BenchmarkRegression> findRegressions(const vector<BenchmarkResult>& baseline,
+                                            const vector<BenchmarkResult>& current,
+                                            double threshold)
+{
+    map<string, const BenchmarkResult*> baselineMap;
+    for (const auto& result : baseline)
+        baselineMap[result.name] = &result;
+
+    vector<BenchmarkRegression> regressions;
+    for (const auto& result : current) {
+        auto it = baselineMap.find(result.name);
+        if (it == baselineMap.end() || it->second->p50Cycles <= 0)
+            continue;
+
+        BenchmarkRegression regression { result.name, it->second->p50Cycles, result.p50Cycles };
+        if (regression.ratio() > 1.0 + threshold)
+            regressions.push_back(regression);
+    }
+
+    return regressions;
+}
+
+size_t Benchmark::calibrateIterations(size_t warmupIterations, chrono::nanoseconds warmupTime) const
+{
+    double nanosPerIteration = static_cast<double>(warmupTime.count()) / std::max<size_t>(warmupIterations, 1);
+    double minNanos = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(options_.minTime).count());
+
+    size_t iterations = nanosPerIteration > 0 ?
+        static_cast<size_t>(minNanos / nanosPerIteration) : options_.maxIterations;
+    return std::min(std::max(iterations, options_.minIterations), options_.maxIterations);
+}
+
+void Benchmark::addResult(const string& label, vector<unsigned long long>* samples, chrono::nanoseconds wallTime)
+{
+    string name = label.empty() ? name_ : name_ + "/" + label;
+    results_.push_back(BenchmarkResult::fromSamples(name, samples, wallTime));
+}
+
+// static
+BenchmarkRegistry* BenchmarkRegistry::instance()
+{
+    static BenchmarkRegistry registry;
+    return &registry;
+}
+
+vector<BenchmarkResult> BenchmarkRegistry::run(const string& filter,
+                                               const BenchmarkOptions& options,
+                                               const function<void (const Benchmark&)>& callback) const
+{
+    vector<BenchmarkResult> results;
+    for (const auto& entry : entries_) {
+        if (entry.name.find(filter) == string::npos)
+            continue;
+
+        Benchmark benchmark(entry.name, options);
+        entry.function(benchmark);
+        if (callback)
+            callback(benchmark);
+
+        results.insert(results.end(), benchmark.results().begin(), benchmark.results().end());
+    }
+
+    return results;
+}
+
+} // namespace base
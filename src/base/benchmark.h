@@ -0,0 +1,191 @@
+#ifndef BASE_BENCHMARK_H_
+#define BASE_BENCHMARK_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "base/time_stamp_counter.h"
+
+// A tiny micro-benchmark framework.
+//
+// Define a benchmark with BENCHMARK(Group, Name), and measure some code in it with
+// benchmark.measure(). Each measure() warms up, chooses the number of iterations so that
+// the measurement takes about --benchmark_min_time_ms, and records the cycles of each
+// iteration with rdtscp. Link puyoai_base_benchmark_main to get the runner.
+//
+//   BENCHMARK(CoreFieldBenchmark, simulate)
+//   {
+//       const CoreField original(...);
+//       benchmark.measureWithSetup("CoreField",
+//                                  [&]() { return CoreField(original); },
+//                                  [](CoreField& cf) { base::doNotOptimize(cf.simulate()); });
+//   }
+//
+// measureWithSetup() calls the setup outside of the timed region, so it can be used
+// to prepare a fresh state for each iteration.
+
+namespace base {
+
+// Prevents the compiler from optimizing away the computation of |value|.
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+    static const volatile void* sink;
+    sink = &value;
+#else
+    asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
+
+struct BenchmarkOptions {
+    std::chrono::milliseconds warmupTime { 100 };
+    std::chrono::milliseconds minTime { 500 };
+    size_t minIterations = 10;
+    size_t maxIterations = 1000000;
+};
+
+// The statistics of one measure(). Cycles are the values of the time stamp counter.
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations = 0;
+    double meanCycles = 0;
+    double stddevCycles = 0;
+    double minCycles = 0;
+    double p50Cycles = 0;
+    double p90Cycles = 0;
+    double p99Cycles = 0;
+    double maxCycles = 0;
+    // Wall time per iteration including the setup.
+    double nanosPerIteration = 0;
+
+    std::string toString() const;
+
+    // Computes the statistics from the samples. |samples| will be reordered.
+    static BenchmarkResult fromSamples(const std::string& name,
+                                       std::vector<unsigned long long>* samples,
+                                       std::chrono::nanoseconds wallTime);
+};
+
+struct BenchmarkRegression {
+    std::string name;
+    double baselineCycles;
+    double currentCycles;
+
+    double ratio() const { return currentCycles / baselineCycles; }
+};
+
+// Compares the median cycles of |current| with |baseline|, and returns the results
+// that get slower more than |threshold| (e.g. 0.1 for 10%).
+std::vector<BenchmarkRegression> findRegressions(const std::vector<BenchmarkResult>& baseline,
+                                                 const std::vector<BenchmarkResult>& current,
+                                                 double threshold);
+
+class Benchmark {
+public:
+    Benchmark(const std::string& name, const BenchmarkOptions& options) :
+        name_(name), options_(options) {}
+
+    const std::string& name() const { return name_; }
+    const std::vector<BenchmarkResult>& results() const { return results_; }
+
+    // Measures |f|, which takes no argument.
+    template<typename F>
+    void measure(const std::string& label, F f)
+    {
+        measureWithSetup(label, []() { return 0; }, [&f](int) { f(); });
+    }
+
+    template<typename F>
+    void measure(F f) { measure(std::string(), f); }
+
+    // Measures |f|, which takes the value |setup| returns. |setup| is not measured.
+    template<typename Setup, typename F>
+    void measureWithSetup(const std::string& label, Setup setup, F f);
+
+private:
+    size_t calibrateIterations(size_t warmupIterations, std::chrono::nanoseconds warmupTime) const;
+    void addResult(const std::string& label,
+                   std::vector<unsigned long long>* samples,
+                   std::chrono::nanoseconds wallTime);
+
+    const std::string name_;
+    const BenchmarkOptions options_;
+    std::vector<BenchmarkResult> results_;
+};
+
+typedef void (*BenchmarkFunction)(Benchmark&);
+
+class BenchmarkRegistry {
+public:
+    struct Entry {
+        std::string name;
+        BenchmarkFunction function;
+    };
+
+    static BenchmarkRegistry* instance();
+
+    void add(const std::string& name, BenchmarkFunction f) { entries_.push_back(Entry { name, f }); }
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    // Runs the benchmarks whose names contain |filter|.
+    // |callback| is called after each benchmark finishes.
+    std::vector<BenchmarkResult> run(const std::string& filter,
+                                     const BenchmarkOptions&,
+                                     const std::function<void (const Benchmark&)>& callback) const;
+
+private:
+    std::vector<Entry> entries_;
+};
+
+struct BenchmarkRegisterer {
+    BenchmarkRegisterer(const char* name, BenchmarkFunction f) { BenchmarkRegistry::instance()->add(name, f); }
+};
+
+template<typename Setup, typename F>
+void Benchmark::measureWithSetup(const std::string& label, Setup setup, F f)
+{
+    typedef std::chrono::steady_clock Clock;
+    unsigned int aux;
+
+    // Warm up caches and branch predictors, and estimate the cost of an iteration.
+    size_t warmupIterations = 0;
+    Clock::time_point warmupBegin = Clock::now();
+    Clock::duration warmupTime;
+    do {
+        auto v = setup();
+        f(v);
+        ++warmupIterations;
+        warmupTime = Clock::now() - warmupBegin;
+    } while (warmupTime < options_.warmupTime && warmupIterations < options_.maxIterations);
+
+    size_t iterations = calibrateIterations(
+        warmupIterations, std::chrono::duration_cast<std::chrono::nanoseconds>(warmupTime));
+
+    std::vector<unsigned long long> samples;
+    samples.reserve(iterations);
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        auto v = setup();
+        unsigned long long start = rdtscp(&aux);
+        f(v);
+        unsigned long long end = rdtscp(&aux);
+        samples.push_back(end > start ? end - start : 0);
+    }
+    Clock::time_point end = Clock::now();
+
+    addResult(label, &samples, std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin));
+}
+
+} // namespace base
+
+#define BENCHMARK(group, name)                                          \
+    static void group##_##name##_Benchmark(base::Benchmark&);           \
+    static base::BenchmarkRegisterer group##_##name##_registerer(       \
+        #group "." #name, &group##_##name##_Benchmark);                 \
+    static void group##_##name##_Benchmark(base::Benchmark& benchmark)
+
+#endif // BASE_BENCHMARK_H_
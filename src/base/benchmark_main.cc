@@ -0,0 +1,192 @@
+// The main function for the benchmarks defined with BENCHMARK().
+//
+// Usage:
+//   field_benchmark --benchmark_filter=simulate --benchmark_json=out.json
+//   field_benchmark --benchmark_baseline=out.json --benchmark_regression_threshold=0.05
+//
+// When a baseline is given, the benchmarks whose median is slower than the baseline
+// more than the threshold are reported, and the exit status becomes 1.
+
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if OS_LINUX
+#include <sched.h>
+#endif
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <json/json.h>
+
+#include "base/base.h"
+#include "base/benchmark.h"
+#include "base/file/file.h"
+
+using namespace std;
+
+DEFINE_string(benchmark_filter, "", "Runs only the benchmarks whose names contain this.");
+DEFINE_int32(benchmark_warmup_ms, 100, "Warm up time of each measurement in milliseconds.");
+DEFINE_int32(benchmark_min_time_ms, 500, "Minimum time of each measurement in milliseconds.");
+DEFINE_int32(benchmark_min_iterations, 10, "Minimum iterations of each measurement.");
+DEFINE_int32(benchmark_max_iterations, 1000000, "Maximum iterations of each measurement.");
+DEFINE_int32(benchmark_cpu, -1, "Pins the benchmark to this CPU. Negative to disable.");
+DEFINE_string(benchmark_json, "", "Writes the results to this file as JSON.");
+DEFINE_string(benchmark_baseline, "", "Compares the results with this JSON written by --benchmark_json.");
+DEFINE_double(benchmark_regression_threshold, 0.1, "Regression threshold ratio of the median cycles.");
+DEFINE_bool(benchmark_list, false, "Lists the benchmarks, and exits.");
+
+namespace {
+
+bool pinToCPU(int cpu)
+{
+#if OS_LINUX
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    if (sched_setaffinity(0, sizeof(cpuset), &cpuset) != 0) {
+        PLOG(ERROR) << "failed to pin to cpu " << cpu;
+        return false;
+    }
+    return true;
+#else
+    LOG(WARNING) << "--benchmark_cpu is not supported on this platform.";
+    UNUSED_VARIABLE(cpu);
+    return false;
+#endif
+}
+
+Json::Value toJson(const base::BenchmarkResult& result)
+{
+    Json::Value value;
+    value["name"] = result.name;
+    value["iterations"] = static_cast<Json::UInt64>(result.iterations);
+    value["mean_cycles"] = result.meanCycles;
+    value["stddev_cycles"] = result.stddevCycles;
+    value["min_cycles"] = result.minCycles;
+    value["p50_cycles"] = result.p50Cycles;
+    value["p90_cycles"] = result.p90Cycles;
+    value["p99_cycles"] = result.p99Cycles;
+    value["max_cycles"] = result.maxCycles;
+    value["ns_per_iteration"] = result.nanosPerIteration;
+    return value;
+}
+
+base::BenchmarkResult fromJson(const Json::Value& value)
+{
+    base::BenchmarkResult result;
+    result.name = value["name"].asString();
+    result.iterations = value["iterations"].asUInt64();
+    result.meanCycles = value["mean_cycles"].asDouble();
+    result.stddevCycles = value["stddev_cycles"].asDouble();
+    result.minCycles = value["min_cycles"].asDouble();
+    result.p50Cycles = value["p50_cycles"].asDouble();
+    result.p90Cycles = value["p90_cycles"].asDouble();
+    result.p99Cycles = value["p99_cycles"].asDouble();
+    result.maxCycles = value["max_cycles"].asDouble();
+    result.nanosPerIteration = value["ns_per_iteration"].asDouble();
+    return result;
+}
+
+bool loadBaseline(const string& filename, vector<base::BenchmarkResult>* results)
+{
+    string content;
+    if (!file::readFile(filename, &content)) {
+        LOG(ERROR) << "failed to read " << filename;
+        return false;
+    }
+
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(content, root)) {
+        LOG(ERROR) << "failed to parse " << filename << ": " << reader.getFormattedErrorMessages();
+        return false;
+    }
+
+    for (const auto& value : root["benchmarks"])
+        results->push_back(fromJson(value));
+    return true;
+}
+
+// Measures the cost of rdtscp itself, which is included in every sample.
+double measureOverhead(const base::BenchmarkOptions& options)
+{
+    base::Benchmark benchmark("overhead", options);
+    benchmark.measure([]() {});
+    return benchmark.results().front().p50Cycles;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    const base::BenchmarkRegistry* registry = base::BenchmarkRegistry::instance();
+    if (FLAGS_benchmark_list) {
+        for (const auto& entry : registry->entries())
+            cout << entry.name << endl;
+        return 0;
+    }
+
+    if (FLAGS_benchmark_cpu >= 0)
+        pinToCPU(FLAGS_benchmark_cpu);
+
+    base::BenchmarkOptions options;
+    options.warmupTime = chrono::milliseconds(FLAGS_benchmark_warmup_ms);
+    options.minTime = chrono::milliseconds(FLAGS_benchmark_min_time_ms);
+    options.minIterations = FLAGS_benchmark_min_iterations;
+    options.maxIterations = FLAGS_benchmark_max_iterations;
+
+    double overhead = measureOverhead(options);
+    cout << "rdtscp overhead: " << overhead << " cycles (included in each result)" << endl;
+
+    vector<base::BenchmarkResult> results = registry->run(FLAGS_benchmark_filter, options, [](const base::Benchmark& b) {
+        for (const auto& result : b.results())
+            cout << result.toString() << endl;
+    });
+
+    if (!FLAGS_benchmark_json.empty()) {
+        Json::Value root;
+        root["context"]["time"] = static_cast<Json::Int64>(time(nullptr));
+        root["context"]["cpu"] = FLAGS_benchmark_cpu;
+        root["context"]["overhead_cycles"] = overhead;
+        root["benchmarks"] = Json::Value(Json::arrayValue);
+        for (const auto& result : results)
+            root["benchmarks"].append(toJson(result));
+
+        ofstream ofs(FLAGS_benchmark_json);
+        ofs << Json::StyledWriter().write(root);
+        if (!ofs) {
+            LOG(ERROR) << "failed to write " << FLAGS_benchmark_json;
+            return 1;
+        }
+    }
+
+    if (FLAGS_benchmark_baseline.empty())
+        return 0;
+
+    vector<base::BenchmarkResult> baseline;
+    if (!loadBaseline(FLAGS_benchmark_baseline, &baseline))
+        return 1;
+
+    vector<base::BenchmarkRegression> regressions =
+        base::findRegressions(baseline, results, FLAGS_benchmark_regression_threshold);
+    if (regressions.empty()) {
+        cout << "No regression found." << endl;
+        return 0;
+    }
+
+    for (const auto& regression : regressions) {
+        cout << "REGRESSION: " << regression.name
+             << fixed << setprecision(0)
+             << " p50 " << regression.baselineCycles << " -> " << regression.currentCycles
+             << setprecision(1) << " (" << showpos << (regression.ratio() - 1) * 100 << noshowpos << "%)" << endl;
+    }
+    return 1;
+}
@@ -0,0 +1,76 @@
+#include "base/benchmark.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+TEST(BenchmarkTest, fromSamples)
+{
+    vector<unsigned long long> samples;
+    for (int i = 100; i >= 1; --i)
+        samples.push_back(i);
+
+    base::BenchmarkResult result = base::BenchmarkResult::fromSamples("x", &samples, chrono::nanoseconds(1000));
+    EXPECT_EQ("x", result.name);
+    EXPECT_EQ(100U, result.iterations);
+    EXPECT_EQ(1, result.minCycles);
+    EXPECT_EQ(50, result.p50Cycles);
+    EXPECT_EQ(90, result.p90Cycles);
+    EXPECT_EQ(99, result.p99Cycles);
+    EXPECT_EQ(100, result.maxCycles);
+    EXPECT_DOUBLE_EQ(50.5, result.meanCycles);
+    EXPECT_DOUBLE_EQ(10, result.nanosPerIteration);
+}
+
+TEST(BenchmarkTest, findRegressions)
+{
+    vector<base::BenchmarkResult> baseline(3);
+    baseline[0].name = "a";
+    baseline[0].p50Cycles = 100;
+    baseline[1].name = "b";
+    baseline[1].p50Cycles = 100;
+    baseline[2].name = "c";
+    baseline[2].p50Cycles = 100;
+
+    vector<base::BenchmarkResult> current(4);
+    current[0].name = "a";
+    current[0].p50Cycles = 105;
+    current[1].name = "b";
+    current[1].p50Cycles = 120;
+    current[2].name = "c";
+    current[2].p50Cycles = 80;
+    // Not in the baseline.
+    current[3].name = "d";
+    current[3].p50Cycles = 1000;
+
+    vector<base::BenchmarkRegression> regressions = base::findRegressions(baseline, current, 0.1);
+    ASSERT_EQ(1U, regressions.size());
+    EXPECT_EQ("b", regressions[0].name);
+    EXPECT_DOUBLE_EQ(1.2, regressions[0].ratio());
+}
+
+TEST(BenchmarkTest, measure)
+{
+    base::BenchmarkOptions options;
+    options.warmupTime = chrono::milliseconds(1);
+    options.minTime = chrono::milliseconds(1);
+    options.minIterations = 10;
+    options.maxIterations = 1000;
+
+    int numSetup = 0;
+    int numCalled = 0;
+    base::Benchmark benchmark("Group.name", options);
+    benchmark.measure([&]() { ++numCalled; });
+    benchmark.measureWithSetup("label", [&]() { return ++numSetup; }, [&](int) { ++numCalled; });
+
+    ASSERT_EQ(2U, benchmark.results().size());
+    EXPECT_EQ("Group.name", benchmark.results()[0].name);
+    EXPECT_EQ("Group.name/label", benchmark.results()[1].name);
+
+    for (const auto& result : benchmark.results()) {
+        EXPECT_LE(10U, result.iterations);
+        EXPECT_GE(1000U, result.iterations);
+    }
+    EXPECT_LT(0, numSetup);
+    EXPECT_LE(numSetup, numCalled);
+}
@@ -1,5 +1,7 @@
 #include "base/executor.h"
 
+#include <algorithm>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -17,6 +19,49 @@ unique_ptr<Executor> Executor::makeDefaultExecutor(bool automaticStart)
     return unique_ptr<Executor>(executor);
 }
 
+// static
+void Executor::runWithHelpers(Executor* executor, int parallelism, const Func& work)
+{
+    // A helper might start after this has returned, so the helpers own this with shared_ptr.
+    struct State {
+        explicit State(const Func& work) : work(work) {}
+
+        const Func work;
+        mutex mu;
+        condition_variable condVar;
+        int numRunningHelpers = 0;
+        bool closed = false;
+    };
+
+    shared_ptr<State> state = make_shared<State>(work);
+    if (executor) {
+        int numHelpers = std::min(executor->numThreads(), parallelism);
+        for (int i = 1; i < numHelpers; ++i) {
+            executor->submit([state]() {
+                {
+                    lock_guard<mutex> lock(state->mu);
+                    if (state->closed)
+                        return;
+                    ++state->numRunningHelpers;
+                }
+                state->work();
+                {
+                    lock_guard<mutex> lock(state->mu);
+                    --state->numRunningHelpers;
+                }
+                state->condVar.notify_all();
+            });
+        }
+    }
+
+    work();
+    {
+        unique_lock<mutex> lock(state->mu);
+        state->closed = true;
+        state->condVar.wait(lock, [&]() { return state->numRunningHelpers == 0; });
+    }
+}
+
 Executor::Executor(int numThread) :
     threads_(numThread),
     shouldStop_(false),
@@ -56,37 +101,77 @@ void Executor::stop()
 }
 
 void Executor::submit(Executor::Func f)
+{
+    submit(std::move(f), TaskOptions());
+}
+
+void Executor::submit(Executor::Func f, const TaskOptions& options)
 {
     CHECK(f) << "function should be callable";
 
+    if (options.group)
+        options.group->add();
+
     unique_lock<mutex> lock(mu_);
-    tasks_.push_back(std::move(f));
+    TaskKey key { options.priority, options.deadline, nextSequence_++ };
+    tasks_.emplace(key, Task { std::move(f), options.group });
     condVar_.notify_one();
 }
 
 void Executor::runWorkerLoop()
 {
     while (true) {
-        Func f = take();
-        if (!f)
+        Task task = take();
+        if (!task.func)
             break;
 
-        f();
+        task.func();
+        if (task.group)
+            task.group->done();
     }
 }
 
-Executor::Func Executor::take()
+Executor::Task Executor::take()
 {
     unique_lock<mutex> lock(mu_);
     while (true) {
-        if (!tasks_.empty())
-            break;
-        if (shouldStop_)
-            return Func();
-        condVar_.wait(lock);
+        if (tasks_.empty()) {
+            if (shouldStop_)
+                return Task { Func(), nullptr };
+            condVar_.wait(lock);
+            continue;
+        }
+
+        auto it = tasks_.begin();
+        Task task = std::move(it->second);
+        tasks_.erase(it);
+
+        // The task of a cancelled group is discarded.
+        if (task.group && task.group->isCancelled()) {
+            task.group->done();
+            continue;
+        }
+
+        return task;
     }
+}
+
+void TaskGroup::wait()
+{
+    unique_lock<mutex> lock(mu_);
+    condVar_.wait(lock, [this]() { return numPending_ == 0; });
+}
 
-    Func f = std::move(tasks_.front());
-    tasks_.pop_front();
-    return f;
+void TaskGroup::add()
+{
+    lock_guard<mutex> lock(mu_);
+    ++numPending_;
+}
+
+void TaskGroup::done()
+{
+    // Notifies with the lock held, since the group might be destructed as soon as wait() returns.
+    lock_guard<mutex> lock(mu_);
+    --numPending_;
+    condVar_.notify_all();
 }
@@ -3,23 +3,78 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <deque>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
 
 #include "base/noncopyable.h"
 
+// TaskGroup is a set of tasks which can be waited for and cancelled together.
+// A task is added to a group with Executor::TaskOptions.
+class TaskGroup : noncopyable {
+public:
+    TaskGroup() {}
+    // Waits for the tasks.
+    ~TaskGroup() { wait(); }
+
+    // The tasks that haven't started won't run. A running task can check isCancelled()
+    // to finish early.
+    void cancel() { cancelled_ = true; }
+    bool isCancelled() const { return cancelled_; }
+
+    // Waits until every task of this group has run or has been discarded.
+    void wait();
+
+private:
+    friend class Executor;
+
+    void add();
+    void done();
+
+    std::atomic<bool> cancelled_ { false };
+    std::mutex mu_;
+    std::condition_variable condVar_;
+    int numPending_ = 0;
+};
+
 // Executor is an implementation of thread pool.
 // This implementation might have certain overhead. It's not intended to be used for
 // a lot of micro tasks. Please submit coarse tasks.
+//
+// A task with higher priority runs first. Among the tasks of the same priority,
+// the task whose deadline is the earliest runs first, and then the task submitted first.
 class Executor : noncopyable {
 public:
     typedef std::function<void (void)> Func;
 
+    enum class Priority {
+        LOW,
+        NORMAL,
+        HIGH,
+    };
+
+    struct TaskOptions {
+        Priority priority = Priority::NORMAL;
+        // Compared with currentTime(). A task is run even after its deadline.
+        double deadline = std::numeric_limits<double>::infinity();
+        // When specified, the task belongs to |group|, which must outlive the task.
+        TaskGroup* group = nullptr;
+    };
+
     static std::unique_ptr<Executor> makeDefaultExecutor(bool automaticStart = true);
 
+    // Runs |work| on the calling thread and on at most |parallelism| - 1 helper tasks of
+    // |executor|, and returns when all the started runs have finished. |work| should take
+    // jobs from a shared queue until the queue becomes empty.
+    // Since a helper might not start soon when |executor| is busy, the helpers which have not
+    // started when the calling thread finishes |work| are skipped. |executor| can be null.
+    static void runWithHelpers(Executor* executor, int parallelism, const Func& work);
+
     explicit Executor(int numThread);
     ~Executor();
 
@@ -27,16 +82,40 @@ public:
     void stop();
 
     void submit(Func);
+    void submit(Func, const TaskOptions&);
+
+    int numThreads() const { return static_cast<int>(threads_.size()); }
 
 private:
+    struct TaskKey {
+        friend bool operator<(const TaskKey& lhs, const TaskKey& rhs)
+        {
+            if (lhs.priority != rhs.priority)
+                return lhs.priority > rhs.priority;
+            if (lhs.deadline != rhs.deadline)
+                return lhs.deadline < rhs.deadline;
+            return lhs.sequence < rhs.sequence;
+        }
+
+        Priority priority;
+        double deadline;
+        std::uint64_t sequence;
+    };
+
+    struct Task {
+        Func func;
+        TaskGroup* group;
+    };
+
     void runWorkerLoop();
-    Func take();
+    Task take();
 
     std::vector<std::thread> threads_;
     std::mutex mu_;
     std::condition_variable condVar_;
     std::atomic<bool> shouldStop_;
-    std::deque<Func> tasks_;
+    std::map<TaskKey, Task> tasks_;
+    std::uint64_t nextSequence_ = 0;
     bool hasStarted_;
 };
 
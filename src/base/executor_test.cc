@@ -0,0 +1,156 @@
+#include "base/executor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+
+// Blocks the only worker of an executor until unblock() is called, so that the tasks
+// submitted meanwhile are queued.
+class Blocker {
+public:
+    explicit Blocker(Executor* executor)
+    {
+        executor->submit([this]() {
+            unique_lock<mutex> lock(mu_);
+            condVar_.wait(lock, [this]() { return unblocked_; });
+        });
+    }
+
+    void unblock()
+    {
+        lock_guard<mutex> lock(mu_);
+        unblocked_ = true;
+        condVar_.notify_all();
+    }
+
+private:
+    mutex mu_;
+    condition_variable condVar_;
+    bool unblocked_ = false;
+};
+
+} // anonymous namespace
+
+TEST(ExecutorTest, priorityAndDeadline)
+{
+    Executor executor(1);
+    executor.start();
+
+    Blocker blocker(&executor);
+
+    mutex mu;
+    vector<int> order;
+    auto task = [&](int id) {
+        return [&, id]() {
+            lock_guard<mutex> lock(mu);
+            order.push_back(id);
+        };
+    };
+
+    Executor::TaskOptions low;
+    low.priority = Executor::Priority::LOW;
+    Executor::TaskOptions high;
+    high.priority = Executor::Priority::HIGH;
+    Executor::TaskOptions highWithDeadline = high;
+    highWithDeadline.deadline = 1.0;
+
+    executor.submit(task(5), low);
+    executor.submit(task(3));
+    executor.submit(task(4));
+    executor.submit(task(2), high);
+    executor.submit(task(1), highWithDeadline);
+
+    blocker.unblock();
+    executor.stop();
+
+    EXPECT_EQ((vector<int> { 1, 2, 3, 4, 5 }), order);
+}
+
+TEST(ExecutorTest, cancelTaskGroup)
+{
+    Executor executor(1);
+    executor.start();
+
+    Blocker blocker(&executor);
+
+    mutex mu;
+    int numRun = 0;
+    auto task = [&]() {
+        lock_guard<mutex> lock(mu);
+        ++numRun;
+    };
+
+    TaskGroup cancelled;
+    TaskGroup notCancelled;
+
+    Executor::TaskOptions options;
+    options.group = &cancelled;
+    for (int i = 0; i < 3; ++i)
+        executor.submit(task, options);
+    options.group = &notCancelled;
+    for (int i = 0; i < 2; ++i)
+        executor.submit(task, options);
+
+    cancelled.cancel();
+    EXPECT_TRUE(cancelled.isCancelled());
+    EXPECT_FALSE(notCancelled.isCancelled());
+
+    blocker.unblock();
+    cancelled.wait();
+    notCancelled.wait();
+
+    EXPECT_EQ(2, numRun);
+    executor.stop();
+}
+
+TEST(ExecutorTest, runWithHelpers)
+{
+    Executor executor(4);
+    executor.start();
+
+    vector<atomic<int>> counts(1000);
+    atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next++; i < counts.size(); i = next++)
+            ++counts[i];
+    };
+
+    Executor::runWithHelpers(&executor, 4, work);
+    for (const auto& count : counts)
+        EXPECT_EQ(1, count);
+
+    executor.stop();
+}
+
+TEST(ExecutorTest, runWithHelpersWithoutExecutor)
+{
+    int numRun = 0;
+    Executor::runWithHelpers(nullptr, 4, [&]() { ++numRun; });
+    EXPECT_EQ(1, numRun);
+}
+
+TEST(ExecutorTest, runWithHelpersDoesNotWaitForBusyExecutor)
+{
+    Executor executor(2);
+    executor.start();
+
+    // Both the workers are blocked, so the helper cannot start until the calling thread has finished.
+    Blocker blocker1(&executor);
+    Blocker blocker2(&executor);
+
+    atomic<int> numRun(0);
+    Executor::runWithHelpers(&executor, 2, [&]() { ++numRun; });
+    EXPECT_EQ(1, numRun);
+
+    blocker1.unblock();
+    blocker2.unblock();
+    executor.stop();
+    EXPECT_EQ(1, numRun);
+}
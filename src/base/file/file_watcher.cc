@@ -0,0 +1,173 @@
+#include "base/file/file_watcher.h"
+
+#include "build/build_config.h"
+
+#ifdef OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <set>
+
+#include <glog/logging.h>
+
+#include "base/file/path.h"
+
+using namespace std;
+
+namespace file {
+
+FileWatcher::FileWatcher(Callback callback) :
+    callback_(std::move(callback))
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    stop();
+}
+
+void FileWatcher::addPath(const string& path)
+{
+    CHECK(!thread_.joinable()) << "addPath() must be called before start()";
+
+    string dir = dirname(path);
+    if (dir.empty())
+        dir = ".";
+    paths_[dir][basename(path)] = path;
+}
+
+#ifdef OS_LINUX
+
+bool FileWatcher::start()
+{
+    CHECK(!thread_.joinable()) << "FileWatcher has already started";
+
+    inotifyFd_ = inotify_init1(IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        PLOG(ERROR) << "inotify_init1 failed";
+        return false;
+    }
+
+    for (const auto& entry : paths_) {
+        const string& dir = entry.first;
+        int wd = inotify_add_watch(inotifyFd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd < 0) {
+            PLOG(ERROR) << "inotify_add_watch failed: " << dir;
+            stop();
+            return false;
+        }
+        watchedDirectories_[wd] = dir;
+    }
+
+    if (pipe2(stopFds_, O_CLOEXEC) < 0) {
+        PLOG(ERROR) << "pipe2 failed";
+        stop();
+        return false;
+    }
+
+    thread_ = thread([this]() { runLoop(); });
+    return true;
+}
+
+void FileWatcher::runLoop()
+{
+    // Enough for several events. An event has a name of at most NAME_MAX bytes.
+    alignas(struct inotify_event) char buf[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+
+    while (true) {
+        struct pollfd fds[2];
+        fds[0].fd = inotifyFd_;
+        fds[0].events = POLLIN;
+        fds[1].fd = stopFds_[0];
+        fds[1].events = POLLIN;
+
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            PLOG(ERROR) << "poll failed";
+            return;
+        }
+
+        if (fds[1].revents)
+            return;
+        if (!(fds[0].revents & POLLIN))
+            continue;
+
+        ssize_t len = read(inotifyFd_, buf, sizeof(buf));
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            PLOG(ERROR) << "read from inotify failed";
+            return;
+        }
+
+        // A file is often written with several events (e.g. IN_CREATE and IN_CLOSE_WRITE).
+        // We call the callback once for the events that are read at once.
+        set<string> changedPaths;
+        for (char* p = buf; p < buf + len; ) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->len == 0)
+                continue;
+            auto dirIt = watchedDirectories_.find(event->wd);
+            if (dirIt == watchedDirectories_.end())
+                continue;
+            const map<string, string>& files = paths_[dirIt->second];
+            auto fileIt = files.find(event->name);
+            if (fileIt == files.end())
+                continue;
+            changedPaths.insert(fileIt->second);
+        }
+
+        for (const string& path : changedPaths)
+            callback_(path);
+    }
+}
+
+void FileWatcher::stop()
+{
+    if (thread_.joinable()) {
+        char c = 0;
+        if (write(stopFds_[1], &c, 1) < 0)
+            PLOG(ERROR) << "failed to wake up the watcher thread";
+        thread_.join();
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        if (stopFds_[i] >= 0) {
+            close(stopFds_[i]);
+            stopFds_[i] = -1;
+        }
+    }
+    if (inotifyFd_ >= 0) {
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+    watchedDirectories_.clear();
+}
+
+#else
+
+bool FileWatcher::start()
+{
+    LOG(WARNING) << "FileWatcher is not supported on this platform";
+    return false;
+}
+
+void FileWatcher::runLoop()
+{
+}
+
+void FileWatcher::stop()
+{
+}
+
+#endif
+
+} // namespace file
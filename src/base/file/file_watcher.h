@@ -0,0 +1,51 @@
+#ifndef BASE_FILE_FILE_WATCHER_H_
+#define BASE_FILE_FILE_WATCHER_H_
+
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/noncopyable.h"
+
+namespace file {
+
+// FileWatcher calls the callback on its own thread when a watched file is written.
+// Since editors often replace a file with rename(2), the parent directories are watched
+// instead of the files. The callback might be called more than once for one change.
+//
+// This is implemented with inotify, so this works only on Linux.
+class FileWatcher : noncopyable {
+public:
+    typedef std::function<void (const std::string& path)> Callback;
+
+    explicit FileWatcher(Callback callback);
+    ~FileWatcher();
+
+    // Adds |path| to the watched files. Must be called before start().
+    // |path| is passed to the callback as is.
+    void addPath(const std::string& path);
+
+    // Returns false if the files cannot be watched.
+    bool start();
+    void stop();
+
+private:
+    void runLoop();
+
+    Callback callback_;
+    // directory -> (basename -> path)
+    std::map<std::string, std::map<std::string, std::string>> paths_;
+    // watch descriptor -> directory
+    std::map<int, std::string> watchedDirectories_;
+
+    int inotifyFd_ = -1;
+    // The read end and the write end of the pipe to wake up the thread to stop.
+    int stopFds_[2] = { -1, -1 };
+    std::thread thread_;
+};
+
+} // namespace file
+
+#endif // BASE_FILE_FILE_WATCHER_H_
@@ -0,0 +1,121 @@
+#include "base/file/file_watcher.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "build/build_config.h"
+#include "base/file/file.h"
+#include "base/file/path.h"
+
+using namespace std;
+
+#ifdef OS_LINUX
+
+namespace {
+
+class FileWatcherTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/file_watcher_test.XXXXXX";
+        ASSERT_TRUE(mkdtemp(tmpl) != nullptr);
+        dir_ = tmpl;
+    }
+
+    void TearDown() override
+    {
+        vector<string> files;
+        if (file::listFiles(dir_, &files)) {
+            for (const auto& f : files) {
+                if (f != "." && f != "..")
+                    file::remove(file::joinPath(dir_, f));
+            }
+        }
+        rmdir(dir_.c_str());
+    }
+
+    void onChanged(const string& path)
+    {
+        lock_guard<mutex> lock(mu_);
+        changedPaths_.push_back(path);
+        condVar_.notify_all();
+    }
+
+    // Waits until |path| is notified. Returns false on timeout.
+    bool waitFor(const string& path)
+    {
+        unique_lock<mutex> lock(mu_);
+        return condVar_.wait_for(lock, chrono::seconds(5), [&]() {
+            for (const auto& p : changedPaths_) {
+                if (p == path)
+                    return true;
+            }
+            return false;
+        });
+    }
+
+    string dir_;
+    mutex mu_;
+    condition_variable condVar_;
+    vector<string> changedPaths_;
+};
+
+} // anonymous namespace
+
+TEST_F(FileWatcherTest, write)
+{
+    const string watched = file::joinPath(dir_, "watched.toml");
+    const string unwatched = file::joinPath(dir_, "unwatched.toml");
+
+    file::FileWatcher watcher([this](const string& path) { onChanged(path); });
+    watcher.addPath(watched);
+    ASSERT_TRUE(watcher.start());
+
+    ASSERT_TRUE(file::writeFile(unwatched, "a"));
+    ASSERT_TRUE(file::writeFile(watched, "b"));
+    EXPECT_TRUE(waitFor(watched));
+
+    watcher.stop();
+
+    lock_guard<mutex> lock(mu_);
+    for (const auto& p : changedPaths_)
+        EXPECT_EQ(watched, p);
+}
+
+TEST_F(FileWatcherTest, rename)
+{
+    const string watched = file::joinPath(dir_, "watched.toml");
+    const string tmp = file::joinPath(dir_, "watched.toml.tmp");
+
+    file::FileWatcher watcher([this](const string& path) { onChanged(path); });
+    watcher.addPath(watched);
+    ASSERT_TRUE(watcher.start());
+
+    // Editors often save a file like this.
+    ASSERT_TRUE(file::writeFile(tmp, "a"));
+    ASSERT_EQ(0, std::rename(tmp.c_str(), watched.c_str()));
+    EXPECT_TRUE(waitFor(watched));
+}
+
+TEST_F(FileWatcherTest, stopWithoutEvent)
+{
+    file::FileWatcher watcher([this](const string& path) { onChanged(path); });
+    watcher.addPath(file::joinPath(dir_, "watched.toml"));
+    ASSERT_TRUE(watcher.start());
+    watcher.stop();
+    // Stopping twice is allowed.
+    watcher.stop();
+
+    lock_guard<mutex> lock(mu_);
+    EXPECT_TRUE(changedPaths_.empty());
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef BASE_LAZY_REBUILD_H_
+#define BASE_LAZY_REBUILD_H_
+
+#include <atomic>
+#include <mutex>
+
+#include "base/noncopyable.h"
+
+namespace base {
+
+// LazyRebuild tracks whether a value derived from other data (e.g. a packed matrix) is stale.
+// The owner calls invalidate() when it modifies the data, and calls rebuildIfNeeded() before
+// using the derived value. Once the value is built, rebuildIfNeeded() costs one atomic load.
+//
+// Concurrent calls of rebuildIfNeeded() are safe: only one of them rebuilds, and the others
+// wait for it. invalidate() must not be called while the derived value is used.
+class LazyRebuild : noncopyable {
+public:
+    LazyRebuild() {}
+
+    void invalidate() { dirty_.store(true, std::memory_order_release); }
+
+    // Calls |rebuild| if invalidate() has been called since the last rebuild (or if it's
+    // never built).
+    template<typename Rebuild>
+    void rebuildIfNeeded(Rebuild rebuild)
+    {
+        if (!dirty_.load(std::memory_order_acquire))
+            return;
+
+        std::lock_guard<std::mutex> lock(mu_);
+        if (dirty_.load(std::memory_order_relaxed)) {
+            rebuild();
+            dirty_.store(false, std::memory_order_release);
+        }
+    }
+
+private:
+    std::atomic<bool> dirty_ { true };
+    std::mutex mu_;
+};
+
+} // namespace base
+
+#endif // BASE_LAZY_REBUILD_H_
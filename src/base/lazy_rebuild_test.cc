@@ -0,0 +1,54 @@
+#include "base/lazy_rebuild.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+TEST(LazyRebuildTest, rebuildOnlyAfterInvalidate)
+{
+    base::LazyRebuild lazy;
+    int numRebuilds = 0;
+    auto rebuild = [&]() { ++numRebuilds; };
+
+    // It's not built at first.
+    lazy.rebuildIfNeeded(rebuild);
+    EXPECT_EQ(1, numRebuilds);
+    lazy.rebuildIfNeeded(rebuild);
+    EXPECT_EQ(1, numRebuilds);
+
+    lazy.invalidate();
+    lazy.invalidate();
+    lazy.rebuildIfNeeded(rebuild);
+    EXPECT_EQ(2, numRebuilds);
+    lazy.rebuildIfNeeded(rebuild);
+    EXPECT_EQ(2, numRebuilds);
+}
+
+TEST(LazyRebuildTest, concurrentRebuild)
+{
+    base::LazyRebuild lazy;
+    atomic<int> numRebuilds(0);
+    int value = 0;
+
+    vector<thread> threads;
+    vector<int> seen(8);
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&, i]() {
+            lazy.rebuildIfNeeded([&]() {
+                ++numRebuilds;
+                value = 42;
+            });
+            seen[i] = value;
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    EXPECT_EQ(1, numRebuilds);
+    for (int v : seen)
+        EXPECT_EQ(42, v);
+}
@@ -0,0 +1,109 @@
+#ifndef BASE_SIGNATURE_SET_H_
+#define BASE_SIGNATURE_SET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glog/logging.h>
+
+// SignatureSet is a set of 64-bit signatures (hashes of something).
+// This is an open addressing hash table, so inserting a signature doesn't allocate
+// a node. This is used to check duplicates in hot loops, where std::unordered_set
+// is too slow.
+class SignatureSet {
+public:
+    explicit SignatureSet(size_t initialCapacity = 256) :
+        slots_(roundUpToPowerOfTwo(initialCapacity))
+    {
+    }
+
+    // Returns true if |signature| is newly inserted.
+    bool insert(std::uint64_t signature)
+    {
+        // 0 is used as an empty slot marker.
+        if (signature == 0) {
+            if (hasZero_)
+                return false;
+            hasZero_ = true;
+            return true;
+        }
+
+        // Keep the load factor less than 1/2.
+        if ((size_ + 1) * 2 > slots_.size())
+            rehash(slots_.size() * 2);
+
+        if (!insertInternal(&slots_, signature))
+            return false;
+        ++size_;
+        return true;
+    }
+
+    bool contains(std::uint64_t signature) const
+    {
+        if (signature == 0)
+            return hasZero_;
+
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = indexOf(signature, mask); slots_[i] != 0; i = (i + 1) & mask) {
+            if (slots_[i] == signature)
+                return true;
+        }
+        return false;
+    }
+
+    size_t size() const { return size_ + (hasZero_ ? 1 : 0); }
+    bool isEmpty() const { return size() == 0; }
+
+    void clear()
+    {
+        std::fill(slots_.begin(), slots_.end(), 0);
+        size_ = 0;
+        hasZero_ = false;
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t n)
+    {
+        size_t v = 2;
+        while (v < n)
+            v *= 2;
+        return v;
+    }
+
+    static size_t indexOf(std::uint64_t signature, size_t mask)
+    {
+        return static_cast<size_t>(signature ^ (signature >> 32)) & mask;
+    }
+
+    static bool insertInternal(std::vector<std::uint64_t>* slots, std::uint64_t signature)
+    {
+        DCHECK_NE(0ULL, signature);
+        const size_t mask = slots->size() - 1;
+        size_t i = indexOf(signature, mask);
+        while ((*slots)[i] != 0) {
+            if ((*slots)[i] == signature)
+                return false;
+            i = (i + 1) & mask;
+        }
+        (*slots)[i] = signature;
+        return true;
+    }
+
+    void rehash(size_t newCapacity)
+    {
+        std::vector<std::uint64_t> newSlots(newCapacity);
+        for (std::uint64_t s : slots_) {
+            if (s != 0)
+                insertInternal(&newSlots, s);
+        }
+        slots_.swap(newSlots);
+    }
+
+    std::vector<std::uint64_t> slots_;
+    size_t size_ = 0;
+    bool hasZero_ = false;
+};
+
+#endif // BASE_SIGNATURE_SET_H_
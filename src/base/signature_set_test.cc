@@ -0,0 +1,39 @@
+#include "base/signature_set.h"
+
+#include <gtest/gtest.h>
+
+TEST(SignatureSetTest, basic)
+{
+    SignatureSet s;
+    EXPECT_TRUE(s.isEmpty());
+
+    EXPECT_TRUE(s.insert(1));
+    EXPECT_TRUE(s.insert(0));
+    EXPECT_TRUE(s.insert(0xFFFFFFFFFFFFFFFFULL));
+    EXPECT_FALSE(s.insert(1));
+    EXPECT_FALSE(s.insert(0));
+
+    EXPECT_EQ(3U, s.size());
+    EXPECT_TRUE(s.contains(0));
+    EXPECT_TRUE(s.contains(1));
+    EXPECT_FALSE(s.contains(2));
+
+    s.clear();
+    EXPECT_TRUE(s.isEmpty());
+    EXPECT_FALSE(s.contains(0));
+    EXPECT_FALSE(s.contains(1));
+}
+
+TEST(SignatureSetTest, grow)
+{
+    SignatureSet s(4);
+    // Signatures colliding in the lower bits.
+    for (std::uint64_t i = 1; i <= 1000; ++i)
+        EXPECT_TRUE(s.insert(i << 32));
+    for (std::uint64_t i = 1; i <= 1000; ++i)
+        EXPECT_FALSE(s.insert(i << 32));
+
+    EXPECT_EQ(1000U, s.size());
+    EXPECT_TRUE(s.contains(1000ULL << 32));
+    EXPECT_FALSE(s.contains(1001ULL << 32));
+}
@@ -0,0 +1,201 @@
+#include "base/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace base {
+
+namespace {
+
+// The owner thread might overwrite a slot while collect() is reading it. So the fields are
+// atomic, and |sequence| tells which event the slot has: it is the index of the event + 1 when
+// the slot is complete, and 0 while the slot is being written.
+struct TraceSlot {
+    atomic<size_t> sequence { 0 };
+    atomic<const char*> name { nullptr };
+    atomic<unsigned long long> beginCycles { 0 };
+    atomic<unsigned long long> endCycles { 0 };
+};
+
+// A ring buffer of one thread. Only the owner thread writes to it.
+struct ThreadBuffer {
+    explicit ThreadBuffer(int threadId) : threadId(threadId), slots(Trace::BUFFER_SIZE) {}
+
+    const int threadId;
+    // The number of events recorded so far.
+    atomic<size_t> count { 0 };
+    vector<TraceSlot> slots;
+};
+
+// Buffers are never freed, since collect() can read them after their threads have gone.
+mutex buffersMutex;
+vector<unique_ptr<ThreadBuffer>> buffers;
+
+once_flag calibrationFlag;
+double calibratedCyclesPerMicrosecond = 0;
+
+ThreadBuffer* currentThreadBuffer()
+{
+    static thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer)
+        return buffer;
+
+    lock_guard<mutex> lock(buffersMutex);
+    buffers.emplace_back(new ThreadBuffer(static_cast<int>(buffers.size()) + 1));
+    buffer = buffers.back().get();
+    return buffer;
+}
+
+void calibrate()
+{
+    typedef chrono::steady_clock Clock;
+
+    Clock::time_point beginTime = Clock::now();
+    unsigned long long beginCycles = Trace::now();
+    this_thread::sleep_for(chrono::milliseconds(10));
+    Clock::time_point endTime = Clock::now();
+    unsigned long long endCycles = Trace::now();
+
+    double micros = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(endTime - beginTime).count()) / 1000;
+    calibratedCyclesPerMicrosecond = micros > 0 ? (endCycles - beginCycles) / micros : 1.0;
+}
+
+} // anonymous namespace
+
+const size_t Trace::BUFFER_SIZE;
+atomic<bool> Trace::enabled_(false);
+
+// static
+void Trace::setEnabled(bool flag)
+{
+    if (flag)
+        call_once(calibrationFlag, calibrate);
+    enabled_.store(flag, memory_order_release);
+}
+
+// static
+void Trace::record(const char* name, unsigned long long beginCycles, unsigned long long endCycles)
+{
+    ThreadBuffer* buffer = currentThreadBuffer();
+    size_t count = buffer->count.load(memory_order_relaxed);
+    TraceSlot& slot = buffer->slots[count % BUFFER_SIZE];
+    slot.sequence.store(0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot.name.store(name, memory_order_relaxed);
+    slot.beginCycles.store(beginCycles, memory_order_relaxed);
+    slot.endCycles.store(endCycles, memory_order_relaxed);
+    slot.sequence.store(count + 1, memory_order_release);
+    buffer->count.store(count + 1, memory_order_release);
+}
+
+// static
+vector<TraceEvent> Trace::collect(unsigned long long sinceCycles)
+{
+    vector<TraceEvent> events;
+
+    lock_guard<mutex> lock(buffersMutex);
+    for (const auto& buffer : buffers) {
+        size_t count = buffer->count.load(memory_order_acquire);
+        size_t first = count > BUFFER_SIZE ? count - BUFFER_SIZE : 0;
+
+        for (size_t i = first; i < count; ++i) {
+            const TraceSlot& slot = buffer->slots[i % BUFFER_SIZE];
+            if (slot.sequence.load(memory_order_acquire) != i + 1)
+                continue;
+            TraceEvent event {
+                slot.name.load(memory_order_relaxed),
+                slot.beginCycles.load(memory_order_relaxed),
+                slot.endCycles.load(memory_order_relaxed),
+                buffer->threadId
+            };
+            // Skips the slot if the owner thread has started to overwrite it while we were reading it.
+            atomic_thread_fence(memory_order_acquire);
+            if (slot.sequence.load(memory_order_relaxed) != i + 1)
+                continue;
+
+            if (event.beginCycles < sinceCycles)
+                continue;
+            events.push_back(event);
+        }
+    }
+
+    sort(events.begin(), events.end(), [](const TraceEvent& lhs, const TraceEvent& rhs) {
+        if (lhs.beginCycles != rhs.beginCycles)
+            return lhs.beginCycles < rhs.beginCycles;
+        // A parent scope ends after its children.
+        return lhs.endCycles > rhs.endCycles;
+    });
+    return events;
+}
+
+// static
+double Trace::cyclesPerMicrosecond()
+{
+    call_once(calibrationFlag, calibrate);
+    return calibratedCyclesPerMicrosecond;
+}
+
+// static
+string Trace::toChromeTraceJson(const vector<TraceEvent>& events)
+{
+    const double cpus = cyclesPerMicrosecond();
+    const unsigned long long origin = events.empty() ? 0 : events.front().beginCycles;
+
+    stringstream ss;
+    ss << fixed << setprecision(3);
+    ss << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const TraceEvent& event = events[i];
+        if (i > 0)
+            ss << ',';
+        ss << "{\"name\":\"" << event.name << "\""
+           << ",\"ph\":\"X\",\"pid\":1"
+           << ",\"tid\":" << event.threadId
+           << ",\"ts\":" << (event.beginCycles - origin) / cpus
+           << ",\"dur\":" << (event.endCycles - event.beginCycles) / cpus
+           << "}";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+// static
+string Trace::toSummaryString(const vector<TraceEvent>& events)
+{
+    struct Summary {
+        size_t count = 0;
+        unsigned long long cycles = 0;
+    };
+
+    map<string, Summary> summaries;
+    for (const auto& event : events) {
+        Summary& summary = summaries[event.name];
+        summary.count += 1;
+        summary.cycles += event.endCycles - event.beginCycles;
+    }
+
+    vector<pair<string, Summary>> sorted(summaries.begin(), summaries.end());
+    sort(sorted.begin(), sorted.end(), [](const pair<string, Summary>& lhs, const pair<string, Summary>& rhs) {
+        return lhs.second.cycles > rhs.second.cycles;
+    });
+
+    const double cpus = cyclesPerMicrosecond();
+    stringstream ss;
+    ss << fixed << setprecision(3);
+    for (const auto& entry : sorted) {
+        ss << left << setw(48) << entry.first << right
+           << " count=" << setw(8) << entry.second.count
+           << " total=" << setw(10) << entry.second.cycles / cpus / 1000 << " [ms]" << endl;
+    }
+    return ss.str();
+}
+
+} // namespace base
@@ -0,0 +1,98 @@
+#ifndef BASE_TRACE_H_
+#define BASE_TRACE_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "base/base.h"
+#include "base/time_stamp_counter.h"
+
+// Low overhead tracing of hot paths.
+//
+// TRACE_SCOPE("name") stamps the beginning and the end of the scope with rdtscp, and
+// records them into a ring buffer owned by the current thread. When tracing is disabled,
+// TRACE_SCOPE costs only a relaxed atomic load and a branch, so it can be left in
+// the code used in real games.
+//
+//   void Foo::bar()
+//   {
+//       TRACE_SCOPE("Foo::bar");
+//       ...
+//   }
+//
+// Trace::collect() gathers the events from all threads, and toChromeTraceJson() makes
+// a JSON which chrome://tracing can load.
+
+namespace base {
+
+struct TraceEvent {
+    // Only the pointer is stored, so this must be a string literal.
+    const char* name;
+    unsigned long long beginCycles;
+    unsigned long long endCycles;
+    int threadId;
+};
+
+class Trace {
+public:
+    // The number of events each thread keeps. Older events are overwritten.
+    static const size_t BUFFER_SIZE = 1 << 16;
+
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+    // Enabling tracing for the first time takes about 10ms to calibrate the time stamp counter.
+    static void setEnabled(bool);
+
+    static unsigned long long now()
+    {
+        unsigned int aux;
+        return rdtscp(&aux);
+    }
+
+    // Records an event into the buffer of the current thread.
+    static void record(const char* name, unsigned long long beginCycles, unsigned long long endCycles);
+
+    // Returns the events which began at or after |sinceCycles| in all threads, sorted by
+    // their beginning. Events recorded while collect() is running might be missed.
+    static std::vector<TraceEvent> collect(unsigned long long sinceCycles);
+
+    // Returns the number of time stamp counter cycles per microsecond.
+    static double cyclesPerMicrosecond();
+
+    // Returns the events in the Chrome trace event format.
+    static std::string toChromeTraceJson(const std::vector<TraceEvent>&);
+    // Returns the number of calls and the total time for each name, the most expensive first.
+    static std::string toSummaryString(const std::vector<TraceEvent>&);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char* name) :
+        name_(Trace::isEnabled() ? name : nullptr),
+        beginCycles_(name_ ? Trace::now() : 0)
+    {
+    }
+
+    ~ScopedTrace()
+    {
+        if (name_)
+            Trace::record(name_, beginCycles_, Trace::now());
+    }
+
+private:
+    const char* name_;
+    unsigned long long beginCycles_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedTrace);
+};
+
+} // namespace base
+
+#define TRACE_SCOPE_CONCAT_INTERNAL(x, y) x##y
+#define TRACE_SCOPE_CONCAT(x, y) TRACE_SCOPE_CONCAT_INTERNAL(x, y)
+#define TRACE_SCOPE(name) base::ScopedTrace TRACE_SCOPE_CONCAT(scopedTrace_, __LINE__)(name)
+
+#endif // BASE_TRACE_H_
@@ -0,0 +1,106 @@
+#include "base/trace.h"
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+class TraceTest : public testing::Test {
+protected:
+    void TearDown() override { base::Trace::setEnabled(false); }
+};
+
+TEST_F(TraceTest, disabled)
+{
+    base::Trace::setEnabled(false);
+    unsigned long long since = base::Trace::now();
+    {
+        TRACE_SCOPE("disabled");
+    }
+
+    EXPECT_TRUE(base::Trace::collect(since).empty());
+}
+
+TEST_F(TraceTest, nested)
+{
+    base::Trace::setEnabled(true);
+    unsigned long long since = base::Trace::now();
+    {
+        TRACE_SCOPE("outer");
+        {
+            TRACE_SCOPE("inner");
+        }
+    }
+
+    vector<base::TraceEvent> events = base::Trace::collect(since);
+    ASSERT_EQ(2U, events.size());
+    EXPECT_STREQ("outer", events[0].name);
+    EXPECT_STREQ("inner", events[1].name);
+    EXPECT_LE(events[0].beginCycles, events[1].beginCycles);
+    EXPECT_LE(events[1].endCycles, events[0].endCycles);
+    EXPECT_EQ(events[0].threadId, events[1].threadId);
+
+    string json = base::Trace::toChromeTraceJson(events);
+    EXPECT_NE(string::npos, json.find("\"name\":\"outer\""));
+    EXPECT_NE(string::npos, json.find("\"ph\":\"X\""));
+
+    string summary = base::Trace::toSummaryString(events);
+    EXPECT_NE(string::npos, summary.find("inner"));
+}
+
+TEST_F(TraceTest, threads)
+{
+    base::Trace::setEnabled(true);
+    unsigned long long since = base::Trace::now();
+
+    thread th([]() {
+        TRACE_SCOPE("thread");
+    });
+    th.join();
+    {
+        TRACE_SCOPE("main");
+    }
+
+    vector<base::TraceEvent> events = base::Trace::collect(since);
+    ASSERT_EQ(2U, events.size());
+    EXPECT_NE(events[0].threadId, events[1].threadId);
+}
+
+TEST_F(TraceTest, wrapAround)
+{
+    base::Trace::setEnabled(true);
+    unsigned long long since = base::Trace::now();
+    for (size_t i = 0; i < base::Trace::BUFFER_SIZE + 10; ++i) {
+        TRACE_SCOPE("loop");
+    }
+
+    EXPECT_EQ(base::Trace::BUFFER_SIZE, base::Trace::collect(since).size());
+}
+
+TEST_F(TraceTest, collectWhileRecording)
+{
+    static const char* const NAMES[] = { "even", "odd" };
+    // Far later than now(), so that only the events of this test are collected.
+    const unsigned long long origin = 1ULL << 62;
+
+    atomic<bool> done(false);
+    thread th([&]() {
+        for (unsigned long long i = 0; !done; ++i)
+            base::Trace::record(NAMES[i % 2], origin + i, origin + 2 * i);
+    });
+
+    // The recording thread keeps overwriting the slots. A collected event must not mix
+    // the fields of different events.
+    for (int n = 0; n < 100; ++n) {
+        for (const base::TraceEvent& event : base::Trace::collect(origin)) {
+            unsigned long long i = event.beginCycles - origin;
+            ASSERT_STREQ(NAMES[i % 2], event.name);
+            ASSERT_EQ(origin + 2 * i, event.endCycles);
+        }
+    }
+
+    done = true;
+    th.join();
+}
@@ -3,8 +3,11 @@
 #include <smmintrin.h>
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <sstream>
 
+#include "core/field_canonicalization.h"
 #include "core/frame.h"
 #include "core/plain_field.h"
 #include "core/position.h"
@@ -105,6 +108,47 @@ bool BitField::hasFloatingPuyo() const
     return !b.maskedField13().isEmpty();
 }
 
+int BitField::vanishWithoutDrop(int currentChain)
+{
+    RensaNonTracker tracker;
+    FieldBits erased;
+    int score = vanish(currentChain, &erased, &tracker);
+    if (score == 0)
+        return 0;
+
+    for (int i = 0; i < 3; ++i)
+        m_[i].unsetAll(erased);
+    return score;
+}
+
+FieldBits BitField::floatingBits() const
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_cmpeq_epi8(zero, zero);
+
+    FieldBits existing = (m_[0] | m_[1] | m_[2]).maskedField13();
+    FieldBits empty = FieldBits(_mm_xor_si128(existing, ones)).maskedField13();
+
+    // For each column, takes the lowest empty cell, and then all the cells above it.
+    __m128i lowestEmpty = _mm_and_si128(empty, _mm_sub_epi16(zero, empty));
+    __m128i aboveLowestEmpty = _mm_sub_epi16(zero, _mm_slli_epi16(lowestEmpty, 1));
+    return existing & aboveLowestEmpty;
+}
+
+bool BitField::dropFloatingPuyosOneRow()
+{
+    FieldBits floating = floatingBits();
+    if (floating.isEmpty())
+        return false;
+
+    // Since the cell below a floating puyo is empty or floating, we can shift them in place.
+    for (int i = 0; i < 3; ++i) {
+        __m128i dropped = _mm_srli_epi16(_mm_and_si128(m_[i], floating), 1);
+        m_[i] = FieldBits(_mm_or_si128(_mm_andnot_si128(floating, m_[i]), dropped));
+    }
+    return true;
+}
+
 Position* BitField::fillSameColorPosition(int x, int y, PuyoColor c,
                                           Position* positionQueueHead, FieldBits* checked) const
 {
@@ -144,6 +188,34 @@ bool BitField::rensaWillOccur() const
     return false;
 }
 
+PlainField BitField::toPlainField() const
+{
+    // Expands 16 bits of a column to 16 bytes: the byte y takes the bit y.
+    const __m128i shuffle = _mm_set_epi8(1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i bitMask = _mm_set1_epi64x(0x8040201008040201LL);
+
+    union {
+        __m128i m;
+        std::uint16_t s[8];
+    } xmm[3];
+    for (int i = 0; i < 3; ++i)
+        xmm[i].m = m_[i].xmm();
+
+    // Since the walls on the 0th and 15th rows are also expanded, the whole column can be stored.
+    PlainField pf;
+    for (int x = 1; x <= FieldConstant::WIDTH; ++x) {
+        __m128i c = _mm_setzero_si128();
+        for (int i = 0; i < 3; ++i) {
+            __m128i v = _mm_shuffle_epi8(_mm_cvtsi32_si128(xmm[i].s[x]), shuffle);
+            __m128i isSet = _mm_cmpeq_epi8(_mm_and_si128(v, bitMask), bitMask);
+            c = _mm_or_si128(c, _mm_and_si128(isSet, _mm_set1_epi8(1 << i)));
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(pf.mutableColumn(x)), c);
+    }
+
+    return pf;
+}
+
 std::string BitField::toString(char charIfEmpty) const
 {
     ostringstream ss;
@@ -193,6 +265,91 @@ size_t BitField::hash() const
     return r;
 }
 
+BitField BitField::mirror() const
+{
+    BitField bf(*this);
+    for (int i = 0; i < 3; ++i)
+        bf.m_[i] = m_[i].mirror();
+    return bf;
+}
+
+BitField BitField::canonicalizeColors(FieldCanonicalization* canonicalization) const
+{
+    // The index of the lowest bit is the position where the color appears first.
+    auto firstAppearance = [](const FieldBits& bits) {
+        union {
+            std::uint64_t v[2];
+            __m128i m;
+        };
+        m = bits.xmm();
+        if (v[0])
+            return countTrailingZeros64(v[0]);
+        if (v[1])
+            return 64 + countTrailingZeros64(v[1]);
+        return 128;
+    };
+
+    PuyoColor colors[NUM_NORMAL_PUYO_COLORS];
+    FieldBits colorBits[NUM_NORMAL_PUYO_COLORS];
+    int appearances[NUM_NORMAL_PUYO_COLORS];
+    for (int i = 0; i < NUM_NORMAL_PUYO_COLORS; ++i) {
+        colors[i] = NORMAL_PUYO_COLORS[i];
+        colorBits[i] = bits(colors[i]);
+        appearances[i] = firstAppearance(colorBits[i]);
+    }
+    // Stable, so absent colors keep the original order.
+    std::stable_sort(colors, colors + NUM_NORMAL_PUYO_COLORS, [&](PuyoColor lhs, PuyoColor rhs) {
+        return appearances[normalColorIndex(lhs)] < appearances[normalColorIndex(rhs)];
+    });
+
+    // A normal color has the 3rd plane, and the lower 2 planes are the index of the color.
+    BitField bf(*this);
+    const FieldBits normal = m_[2];
+    bf.m_[0].unsetAll(normal);
+    bf.m_[1].unsetAll(normal);
+    for (int i = 0; i < NUM_NORMAL_PUYO_COLORS; ++i) {
+        const PuyoColor original = colors[i];
+        const PuyoColor canonical = NORMAL_PUYO_COLORS[i];
+        const FieldBits& b = colorBits[normalColorIndex(original)];
+        if (ordinal(canonical) & 1)
+            bf.m_[0].setAll(b);
+        if (ordinal(canonical) & 2)
+            bf.m_[1].setAll(b);
+        if (canonicalization)
+            canonicalization->setColor(original, canonical);
+    }
+
+    return bf;
+}
+
+BitField BitField::canonicalize(FieldCanonicalization* canonicalization, bool allowsMirror) const
+{
+    FieldCanonicalization c;
+    BitField bf = canonicalizeColors(&c);
+    if (allowsMirror) {
+        FieldCanonicalization mc;
+        BitField mirrored = mirror().canonicalizeColors(&mc);
+        // Takes the smaller one in the order of the raw planes.
+        union {
+            std::uint64_t v[6];
+            __m128i m[3];
+        } lhs, rhs;
+        for (int i = 0; i < 3; ++i) {
+            lhs.m[i] = bf.m_[i].xmm();
+            rhs.m[i] = mirrored.m_[i].xmm();
+        }
+        if (std::lexicographical_compare(rhs.v, rhs.v + 6, lhs.v, lhs.v + 6)) {
+            bf = mirrored;
+            c = mc;
+            c.setMirrored(true);
+        }
+    }
+
+    if (canonicalization)
+        *canonicalization = c;
+    return bf;
+}
+
 bool operator==(const BitField& lhs, const BitField& rhs)
 {
     for (int i = 0; i < 3; ++i)
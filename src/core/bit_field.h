@@ -14,6 +14,7 @@
 #include "core/rensa_tracker.h"
 #include "core/score.h"
 
+class FieldCanonicalization;
 class PlainField;
 struct Position;
 
@@ -72,9 +73,20 @@ public:
     template<typename Tracker> NOINLINE_UNLESS_RELEASE RensaStepResult vanishDrop(SimulationContext*, Tracker*);
     template<typename Tracker> bool vanishDropFast(SimulationContext*, Tracker*);
 
+    // Vanishes the connected puyos, but doesn't drop the puyos in the air. Score will be returned.
+    // This is for the realtime simulation, where the puyos in the air drop one row per step.
+    int vanishWithoutDrop(int currentChain);
+    // Returns the puyos in the air, i.e. the puyos that have an empty cell somewhere below them.
+    // The puyos on the 14th row are not contained, since they never drop.
+    FieldBits floatingBits() const;
+    // Drops all the puyos in the air by one row. Returns false if no puyo is in the air.
+    bool dropFloatingPuyosOneRow();
+
     // Caution: heights must be aligned to 16.
     void calculateHeight(int heights[FieldConstant::MAP_WIDTH]) const;
 
+    PlainField toPlainField() const;
+
     std::string toString(char charIfEmpty = ' ') const;
     std::string toDebugString(char charIfEmpty = ' ') const;
 
@@ -88,6 +100,17 @@ public:
 
     size_t hash() const;
 
+    // Returns the mirrored field. The 1st column and the 6th column are swapped, and so on.
+    BitField mirror() const;
+    // Returns the canonical field, whose normal colors are renamed so that they first appear
+    // in the order of RED, BLUE, YELLOW, GREEN when the field is scanned column by column
+    // from the bottom of the 1st column. If |allowsMirror| is true, the smaller of the
+    // canonical field and the canonical mirrored field is returned. How the field was
+    // transformed is set to |canonicalization| unless it's nullptr.
+    BitField canonicalize(FieldCanonicalization* canonicalization = nullptr, bool allowsMirror = false) const;
+    // Returns the same hash for the fields that have the same canonical field.
+    size_t canonicalHash(bool allowsMirror = false) const { return canonicalize(nullptr, allowsMirror).hash(); }
+
     friend bool operator==(const BitField&, const BitField&);
     friend std::ostream& operator<<(std::ostream&, const BitField&);
 
@@ -100,6 +123,9 @@ public:
 #endif
 
 private:
+    // Permutes the normal colors so that they first appear in the canonical order.
+    BitField canonicalizeColors(FieldCanonicalization*) const;
+
     BitField escapeInvisible();
     void recoverInvisible(const BitField&);
 
@@ -0,0 +1,74 @@
+#include "core/bit_field.h"
+
+#include <glog/logging.h>
+
+#include "base/base.h"
+#include "base/benchmark.h"
+
+using namespace std;
+
+static const BitField& filledBitField()
+{
+    static const BitField bf(
+        ".G.BRG"
+        "GBRRYR"
+        "RRYYBY"
+        "RGYRBR"
+        "YGYRBY"
+        "YGBGYR"
+        "GRBGYR"
+        "BRBYBY"
+        "RYYBYY"
+        "BRBYBR"
+        "BGBYRR"
+        "YGBGBG"
+        "RBGBGG");
+    return bf;
+}
+
+BENCHMARK(BitFieldBenchmark, hash)
+{
+    const BitField bf;
+    benchmark.measure([&]() { base::doNotOptimize(bf.hash()); });
+}
+
+BENCHMARK(BitFieldBenchmark, simulate_filled)
+{
+    const BitField& original = filledBitField();
+    {
+        BitField bf(original);
+        CHECK_EQ(19, bf.simulate().chains);
+    }
+
+    benchmark.measureWithSetup("simulate",
+                               [&]() { return BitField(original); },
+                               [](BitField& bf) {
+                                   BitField::SimulationContext context;
+                                   RensaNonTracker tracker;
+                                   base::doNotOptimize(bf.simulate(&context, &tracker));
+                               });
+
+    benchmark.measureWithSetup("simulateFast",
+                               [&]() { return BitField(original); },
+                               [](BitField& bf) {
+                                   RensaNonTracker tracker;
+                                   base::doNotOptimize(bf.simulateFast(&tracker));
+                               });
+
+#if defined(__AVX2__) && defined(__BMI2__)
+    benchmark.measureWithSetup("simulateAVX2",
+                               [&]() { return BitField(original); },
+                               [](BitField& bf) {
+                                   BitField::SimulationContext context;
+                                   RensaNonTracker tracker;
+                                   base::doNotOptimize(bf.simulateAVX2(&context, &tracker));
+                               });
+
+    benchmark.measureWithSetup("simulateFastAVX2",
+                               [&]() { return BitField(original); },
+                               [](BitField& bf) {
+                                   RensaNonTracker tracker;
+                                   base::doNotOptimize(bf.simulateFastAVX2(&tracker));
+                               });
+#endif // defined(__AVX2__) && defined(__BMI2__)
+}
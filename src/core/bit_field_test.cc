@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 
+#include "core/field_canonicalization.h"
 #include "core/plain_field.h"
 
 using namespace std;
@@ -435,6 +436,106 @@ TEST(BitFieldTest, hasFloatingPuyo)
     EXPECT_TRUE(bf13.hasFloatingPuyo());
 }
 
+TEST(BitFieldTest, floatingBits)
+{
+    BitField bf(
+        "..B..."
+        "Y.B..."
+        "R...Y."
+        "....Y.");
+    bf.setColor(1, 13, PuyoColor::OJAMA);
+    bf.setColor(2, 13, PuyoColor::OJAMA);
+    // A puyo on the 14th row never drops.
+    bf.setColor(6, 14, PuyoColor::RED);
+
+    FieldBits expected(
+        "..1..."
+        "1.1..."
+        "1....."
+        "......");
+    expected.set(1, 13);
+    expected.set(2, 13);
+
+    EXPECT_EQ(expected, bf.floatingBits());
+}
+
+TEST(BitFieldTest, dropFloatingPuyosOneRow)
+{
+    BitField bf(
+        "..B..."
+        "Y.B..."
+        "R...Y."
+        "....Y.");
+    bf.setColor(1, 13, PuyoColor::OJAMA);
+    bf.setColor(2, 13, PuyoColor::OJAMA);
+    bf.setColor(6, 14, PuyoColor::RED);
+
+    EXPECT_TRUE(bf.dropFloatingPuyosOneRow());
+
+    BitField expected(
+        "..B..."
+        "Y.B.Y."
+        "R...Y.");
+    expected.setColor(1, 12, PuyoColor::OJAMA);
+    expected.setColor(2, 12, PuyoColor::OJAMA);
+    expected.setColor(6, 14, PuyoColor::RED);
+    EXPECT_EQ(expected, bf);
+
+    int numDrops = 1;
+    while (bf.dropFloatingPuyosOneRow())
+        ++numDrops;
+    EXPECT_EQ(12, numDrops);
+
+    BitField expectedLast(
+        "O....."
+        "Y.B.Y."
+        "ROB.Y.");
+    expectedLast.setColor(6, 14, PuyoColor::RED);
+    EXPECT_EQ(expectedLast, bf);
+}
+
+TEST(BitFieldTest, vanishWithoutDrop)
+{
+    for (const auto& testcase : SIMULATION_TEST_CASES) {
+        BitField bf(testcase.field);
+
+        int chains = 0;
+        int sumScore = 0;
+        while (true) {
+            int score = bf.vanishWithoutDrop(chains + 1);
+            if (score == 0)
+                break;
+            ++chains;
+            sumScore += score;
+            while (bf.dropFloatingPuyosOneRow()) {}
+        }
+
+        EXPECT_EQ(testcase.chains, chains) << testcase.field.toDebugString();
+        EXPECT_EQ(testcase.score, sumScore) << testcase.field.toDebugString();
+    }
+}
+
+TEST(BitFieldTest, toPlainField)
+{
+    PlainField pf(
+        "O....." // 13
+        "......"
+        "......"
+        "......"
+        "......"
+        "......"
+        "......"
+        "......"
+        "......"
+        "......"
+        "..B..."
+        "Y.B.Y."
+        "ROB.Y.");
+    pf.setColor(6, 14, PuyoColor::RED);
+
+    EXPECT_EQ(pf, BitField(pf).toPlainField());
+}
+
 TEST(BitFieldTest, hasEmptyNeighbor)
 {
     BitField bf(
@@ -731,3 +832,63 @@ TEST(BitFieldTest, hash)
         }
     }
 }
+
+TEST(BitFieldTest, canonicalize)
+{
+    BitField bf(
+        "G....."
+        "GY..O."
+        "BBYRR.");
+    BitField expected(
+        "B....."
+        "BY..O."
+        "RRYGG.");
+
+    FieldCanonicalization canonicalization;
+    BitField canonical = bf.canonicalize(&canonicalization);
+    EXPECT_EQ(expected, canonical);
+    EXPECT_FALSE(canonicalization.isMirrored());
+    EXPECT_EQ(PuyoColor::RED, canonicalization.canonicalColor(PuyoColor::BLUE));
+    EXPECT_EQ(PuyoColor::BLUE, canonicalization.originalColor(PuyoColor::RED));
+    EXPECT_EQ(PuyoColor::OJAMA, canonicalization.canonicalColor(PuyoColor::OJAMA));
+
+    // Any color permutation has the same canonical field.
+    BitField permuted(
+        "R....."
+        "RB..O."
+        "YYBGG.");
+    EXPECT_EQ(canonical, permuted.canonicalize());
+    EXPECT_EQ(bf.canonicalHash(), permuted.canonicalHash());
+    EXPECT_NE(bf.hash(), permuted.hash());
+
+    // The canonical field is canonical.
+    FieldCanonicalization identity;
+    EXPECT_EQ(canonical, canonical.canonicalize(&identity));
+    EXPECT_TRUE(identity.isIdentity());
+}
+
+TEST(BitFieldTest, canonicalizeWithMirror)
+{
+    BitField bf(
+        ".....G"
+        ".O..YG"
+        ".RRYBB");
+    BitField mirrored(
+        "G....."
+        "GY..O."
+        "BBYRR.");
+    EXPECT_EQ(mirrored, bf.mirror());
+    EXPECT_FALSE(bf.canonicalize() == mirrored.canonicalize());
+
+    FieldCanonicalization c1, c2;
+    BitField canonical = bf.canonicalize(&c1, true);
+    EXPECT_EQ(canonical, mirrored.canonicalize(&c2, true));
+    EXPECT_EQ(bf.canonicalHash(true), mirrored.canonicalHash(true));
+    EXPECT_NE(c1.isMirrored(), c2.isMirrored());
+
+    // A decision on the canonical field can be mapped back.
+    const FieldCanonicalization& c = c1.isMirrored() ? c1 : c2;
+    EXPECT_EQ(Decision(6, 0), c.originalDecision(Decision(1, 0)));
+    EXPECT_EQ(Decision(5, 3), c.originalDecision(Decision(2, 1)));
+    EXPECT_EQ(Decision(3, 2), c.originalDecision(Decision(4, 2)));
+}
@@ -4,9 +4,12 @@
 #include <glog/logging.h>
 
 #include "base/base.h"
+#include "base/time.h"
+#include "core/client/ai/think_scheduler.h"
 #include "core/core_field.h"
 #include "core/decision.h"
 #include "core/field_pretty_printer.h"
+#include "core/frame.h"
 #include "core/frame_request.h"
 #include "core/frame_response.h"
 #include "core/kumipuyo.h"
@@ -42,8 +45,13 @@ AI::AI(int argc, char* argv[], const string& name) :
 }
 
 AI::AI(const string& name) :
+    AI(name, AIBase::makeConnector())
+{
+}
+
+AI::AI(const string& name, unique_ptr<ClientConnector> connector) :
     name_(name),
-    connector_(AIBase::makeConnector()),
+    connector_(std::move(connector)),
     desynced_(false),
     rethinkRequested_(false),
     enemyDecisionRequestFrameId_(0),
@@ -137,8 +145,9 @@ void AI::runLoop()
             }
 
             next1.fieldBeforeThink = me_.field;
-            next1.dropDecision = think(nextThinkFrameId, me_.field, seq,
-                                       myPlayerState(), enemyPlayerState(), false);
+            next1.dropDecision = scheduledThink(nextThinkFrameId - frameRequest.frameId,
+                                                nextThinkFrameId, me_.field, seq,
+                                                myPlayerState(), enemyPlayerState(), false);
 
             next1.kumipuyo = kumipuyoSeq.get(1);
             next1.ready = true;
@@ -167,12 +176,13 @@ void AI::runLoop()
             VLOG(1) << "REQUEST_AGAIN";
             DCHECK(!frameRequest.myPlayerFrameRequest().event.decisionRequest)
                 << "decisionRequestAgain should not come with decisionRequest.";
-            DropDecision dropDecision = think(frameRequest.frameId,
-                                              CoreField(frameRequest.myPlayerFrameRequest().field),
-                                              frameRequest.myPlayerFrameRequest().kumipuyoSeq,
-                                              myPlayerState(),
-                                              enemyPlayerState(),
-                                              true);
+            DropDecision dropDecision = scheduledThink(0,
+                                                       frameRequest.frameId,
+                                                       CoreField(frameRequest.myPlayerFrameRequest().field),
+                                                       frameRequest.myPlayerFrameRequest().kumipuyoSeq,
+                                                       myPlayerState(),
+                                                       enemyPlayerState(),
+                                                       true);
             connector_->send(FrameResponse(frameRequest.frameId, dropDecision.decision(), dropDecision.message()));
             continue;
         }
@@ -213,7 +223,7 @@ void AI::runLoop()
             CHECK_EQ(kumipuyoSeq.get(0), seq.get(0));
             CHECK_EQ(kumipuyoSeq.get(1), seq.get(1));
 
-            next1.dropDecision = think(frameRequest.frameId, me_.field, seq, myPlayerState(), enemyPlayerState(), true);
+            next1.dropDecision = scheduledThink(0, frameRequest.frameId, me_.field, seq, myPlayerState(), enemyPlayerState(), true);
             next1.kumipuyo = kumipuyoSeq.get(0);
             next1.ready = true;
             next1.needsRethink = false;
@@ -241,6 +251,17 @@ void AI::runLoop()
     LOG(INFO) << "will exit run loop";
 }
 
+DropDecision AI::scheduledThink(int framesToDeadline, int frameId, const CoreField& field, const KumipuyoSeq& seq,
+                                const PlayerState& me, const PlayerState& enemy, bool fast) const
+{
+    if (!thinkScheduler_)
+        return think(frameId, field, seq, me, enemy, fast);
+
+    const double deadline = currentTime() + static_cast<double>(std::max(framesToDeadline, 0)) / FPS;
+    ThinkScheduler::Slot slot(thinkScheduler_, deadline);
+    return think(frameId, field, seq, me, enemy, fast);
+}
+
 void AI::gaze(int frameId, const CoreField&, const KumipuyoSeq&)
 {
     UNUSED_VARIABLE(frameId);
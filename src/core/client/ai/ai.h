@@ -12,6 +12,7 @@
 
 class CoreField;
 class PlainField;
+class ThinkScheduler;
 struct FrameRequest;
 
 // AI is a utility class of AI.
@@ -23,12 +24,19 @@ public:
 
     void runLoop();
 
+    // When set, think() is called after |scheduler| gives a slot. This is for running many AIs
+    // in one process. |scheduler| must outlive runLoop().
+    void setThinkScheduler(ThinkScheduler* scheduler) { thinkScheduler_ = scheduler; }
+
     // Set AI's behavior. If true, you can rethink next decision when the enemy has started his rensa.
     void setBehaviorRethinkAfterOpponentRensa(bool flag) { behaviorRethinkAfterOpponentRensa_ = flag; }
 
 protected:
     AI(int argc, char* argv[], const std::string& name);
     explicit AI(const std::string& name);
+    // Uses |connector| instead of making one from --connector, e.g. for a connection
+    // accepted by AIHost.
+    AI(const std::string& name, std::unique_ptr<ClientConnector> connector);
 
     // think will be called when AI should decide the next decision.
     // Basically, this will be called when NEXT2 has appeared.
@@ -129,8 +137,13 @@ private:
     // Returns the remembered sequence. If desynced, provided is returned as is.
     KumipuyoSeq rememberedSequence(int indexFrom, const KumipuyoSeq& provided) const;
 
+    // Calls think() via |thinkScheduler_| if set. The decision is needed in |framesToDeadline| frames.
+    DropDecision scheduledThink(int framesToDeadline, int frameId, const CoreField&, const KumipuyoSeq&,
+                                const PlayerState& me, const PlayerState& enemy, bool fast) const;
+
     std::string name_;
     std::unique_ptr<ClientConnector> connector_;
+    ThinkScheduler* thinkScheduler_ = nullptr;
 
     bool desynced_;
 
@@ -0,0 +1,111 @@
+#include "core/client/ai/ai_host.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <glog/logging.h>
+
+#include "core/connector/socket_connector_impl.h"
+#include "net/socket/socket_factory.h"
+
+using namespace std;
+
+AIHost::AIHost(AIFactory factory, int numThinkSlots) :
+    factory_(std::move(factory)),
+    thinkScheduler_(numThinkSlots)
+{
+}
+
+AIHost::~AIHost()
+{
+    reapSessions(true);
+
+    if (!path_.empty())
+        unlink(path_.c_str());
+}
+
+bool AIHost::listen(const string& path)
+{
+    unlink(path.c_str());
+
+    unique_ptr<net::UnixDomainServerSocket> socket(
+        new net::UnixDomainServerSocket(net::SocketFactory::instance()->makeUnixDomainServerSocket()));
+    if (!socket->valid())
+        return false;
+    if (!socket->bind(path.c_str()))
+        return false;
+    if (!socket->listen(16))
+        return false;
+
+    serverSocket_ = std::move(socket);
+    path_ = path;
+    return true;
+}
+
+void AIHost::run()
+{
+    CHECK(serverSocket_) << "listen() should be called before run()";
+
+    while (!stopped_) {
+        net::UnixDomainSocket socket = serverSocket_->accept();
+        if (stopped_)
+            break;
+        if (!socket.valid())
+            break;
+
+        reapSessions(false);
+
+        unique_ptr<ConnectorImpl> impl(new SocketConnectorImpl(std::move(socket)));
+        unique_ptr<Session> session(new Session);
+        session->ai = factory_(unique_ptr<ClientConnector>(new ClientConnector(std::move(impl))));
+        session->ai->setThinkScheduler(&thinkScheduler_);
+
+        Session* s = session.get();
+        lock_guard<mutex> lock(mu_);
+        sessions_.push_back(std::move(session));
+        s->thread = thread([this, s]() {
+            s->ai->runLoop();
+            lock_guard<mutex> lock(mu_);
+            s->done = true;
+        });
+        LOG(INFO) << "session started: sessions=" << sessions_.size();
+    }
+}
+
+void AIHost::stop()
+{
+    stopped_ = true;
+    // Wakes up accept().
+    if (serverSocket_)
+        shutdown(serverSocket_->get(), SHUT_RDWR);
+}
+
+int AIHost::numRunningSessions() const
+{
+    lock_guard<mutex> lock(mu_);
+    int n = 0;
+    for (const auto& session : sessions_) {
+        if (!session->done)
+            ++n;
+    }
+    return n;
+}
+
+void AIHost::reapSessions(bool waitsAll)
+{
+    list<unique_ptr<Session>> finished;
+    {
+        lock_guard<mutex> lock(mu_);
+        for (auto it = sessions_.begin(); it != sessions_.end(); ) {
+            if (waitsAll || (*it)->done) {
+                finished.push_back(std::move(*it));
+                it = sessions_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (auto& session : finished)
+        session->thread.join();
+}
@@ -0,0 +1,68 @@
+#ifndef CORE_CLIENT_AI_AI_HOST_H_
+#define CORE_CLIENT_AI_AI_HOST_H_
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "base/noncopyable.h"
+#include "core/client/ai/ai.h"
+#include "core/client/ai/think_scheduler.h"
+#include "net/socket/unix_domain_server_socket.h"
+
+// AIHost serves many games in one process. It accepts connections on a unix domain socket,
+// and runs one AI for each connection on its own thread. Each AI keeps its own PlayerState
+// etc., while the immutable tables (e.g. PuyoSetProbability) are shared in the process.
+// think() of all the AIs is scheduled by one ThinkScheduler, so the AI whose decision is
+// needed earliest thinks first.
+//
+// A client of the server connects with --connector=unix:<path>.
+class AIHost : noncopyable {
+public:
+    // Makes an AI which talks with |connector| for a new connection. This is called on
+    // the thread calling run().
+    typedef std::function<std::unique_ptr<AI> (std::unique_ptr<ClientConnector> connector)> AIFactory;
+
+    // At most |numThinkSlots| AIs think at the same time.
+    AIHost(AIFactory factory, int numThinkSlots);
+    // Waits for the running sessions.
+    ~AIHost();
+
+    // Listens on |path|. If a file exists at |path|, it's removed.
+    bool listen(const std::string& path);
+
+    // Accepts connections until stop() is called, and returns.
+    // The sessions that are running are not interrupted.
+    void run();
+    // Makes run() return. This can be called from any thread.
+    void stop();
+
+    // Returns the number of the sessions that haven't finished yet.
+    int numRunningSessions() const;
+
+private:
+    struct Session {
+        std::unique_ptr<AI> ai;
+        std::thread thread;
+        bool done = false;
+    };
+
+    // Joins the finished sessions.
+    void reapSessions(bool waitsAll);
+
+    AIFactory factory_;
+    ThinkScheduler thinkScheduler_;
+
+    std::unique_ptr<net::UnixDomainServerSocket> serverSocket_;
+    std::string path_;
+    std::atomic<bool> stopped_ { false };
+
+    mutable std::mutex mu_;
+    std::list<std::unique_ptr<Session>> sessions_;
+};
+
+#endif // CORE_CLIENT_AI_AI_HOST_H_
@@ -0,0 +1,98 @@
+#include "core/client/ai/ai_host.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "core/frame_request.h"
+#include "net/socket/socket_factory.h"
+#include "net/socket/unix_domain_client_socket.h"
+
+using namespace std;
+
+DECLARE_string(connector);
+
+namespace {
+
+class TestAI : public AI {
+public:
+    explicit TestAI(unique_ptr<ClientConnector> connector) : AI("test", std::move(connector)) {}
+    ~TestAI() override {}
+
+protected:
+    DropDecision think(int, const CoreField&, const KumipuyoSeq&,
+                       const PlayerState&, const PlayerState&, bool) const override
+    {
+        return DropDecision(Decision(3, 0), "test");
+    }
+};
+
+void sendRequest(net::Socket* socket, const string& payload)
+{
+    FrameRequestHeader header(payload.size());
+    ASSERT_TRUE(socket->writeExactly(&header, sizeof(header)));
+    ASSERT_TRUE(socket->writeExactly(payload.data(), payload.size()));
+}
+
+string receiveResponse(net::Socket* socket)
+{
+    uint32_t size;
+    if (!socket->readExactly(&size, sizeof(size)))
+        return string();
+    string s(size, '\0');
+    if (!socket->readExactly(&s[0], size))
+        return string();
+    return s;
+}
+
+} // anonymous namespace
+
+TEST(AIHostTest, serveMultipleSessions)
+{
+    const string path = "/tmp/ai_host_test." + to_string(getpid());
+
+    // The sessions use the accepted connections, so --connector must not be used.
+    // Connecting to this path would fail.
+    const string savedConnector = FLAGS_connector;
+    FLAGS_connector = "unix:" + path + ".nonexistent";
+
+    atomic<int> numAIs(0);
+    AIHost host([&](unique_ptr<ClientConnector> connector) {
+        ++numAIs;
+        return unique_ptr<AI>(new TestAI(std::move(connector)));
+    }, 1);
+    ASSERT_TRUE(host.listen(path));
+
+    thread hostThread([&]() { host.run(); });
+
+    vector<net::UnixDomainClientSocket> clients;
+    for (int i = 0; i < 3; ++i) {
+        clients.push_back(net::SocketFactory::instance()->makeUnixDomainClientSocket());
+        ASSERT_TRUE(clients.back().connect(path.c_str()));
+    }
+
+    // Each session responds to its own client.
+    for (int i = 0; i < 3; ++i)
+        sendRequest(&clients[i], "ID=" + to_string(i + 2));
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ("ID=" + to_string(i + 2), receiveResponse(&clients[i]));
+
+    EXPECT_EQ(3, numAIs);
+    EXPECT_EQ(3, host.numRunningSessions());
+
+    // A session finishes when its connection is closed.
+    clients.clear();
+    for (int i = 0; i < 500 && host.numRunningSessions() > 0; ++i)
+        usleep(10 * 1000);
+    EXPECT_EQ(0, host.numRunningSessions());
+
+    host.stop();
+    hostThread.join();
+    FLAGS_connector = savedConnector;
+}
@@ -0,0 +1,43 @@
+#include "core/client/ai/think_scheduler.h"
+
+#include <glog/logging.h>
+
+using namespace std;
+
+ThinkScheduler::ThinkScheduler(int numSlots) :
+    numFreeSlots_(numSlots)
+{
+    CHECK_LT(0, numSlots);
+}
+
+void ThinkScheduler::acquire(double deadline)
+{
+    unique_lock<mutex> lock(mu_);
+    const pair<double, uint64_t> key(deadline, nextArrival_++);
+    waiting_.insert(key);
+
+    // Every waiter is woken up when a slot is released, and only the earliest one proceeds.
+    condVar_.wait(lock, [&]() { return numFreeSlots_ > 0 && *waiting_.begin() == key; });
+
+    waiting_.erase(waiting_.begin());
+    --numFreeSlots_;
+
+    // Another slot might be still free.
+    if (numFreeSlots_ > 0 && !waiting_.empty())
+        condVar_.notify_all();
+}
+
+void ThinkScheduler::release()
+{
+    {
+        lock_guard<mutex> lock(mu_);
+        ++numFreeSlots_;
+    }
+    condVar_.notify_all();
+}
+
+int ThinkScheduler::numWaiting() const
+{
+    lock_guard<mutex> lock(mu_);
+    return static_cast<int>(waiting_.size());
+}
@@ -0,0 +1,47 @@
+#ifndef CORE_CLIENT_AI_THINK_SCHEDULER_H_
+#define CORE_CLIENT_AI_THINK_SCHEDULER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include "base/noncopyable.h"
+
+// ThinkScheduler limits the number of think() running at the same time among the AIs
+// in one process. When a slot becomes free, the waiting AI whose deadline is the earliest
+// takes it. Ties are broken by the arrival order.
+class ThinkScheduler : noncopyable {
+public:
+    // Holds a slot while alive.
+    class Slot : noncopyable {
+    public:
+        Slot(ThinkScheduler* scheduler, double deadline) : scheduler_(scheduler)
+        {
+            scheduler_->acquire(deadline);
+        }
+        ~Slot() { scheduler_->release(); }
+
+    private:
+        ThinkScheduler* scheduler_;
+    };
+
+    explicit ThinkScheduler(int numSlots);
+
+    // Blocks until a slot is given. |deadline| is compared with currentTime().
+    void acquire(double deadline);
+    void release();
+
+    int numWaiting() const;
+
+private:
+    mutable std::mutex mu_;
+    std::condition_variable condVar_;
+    int numFreeSlots_;
+    std::uint64_t nextArrival_ = 0;
+    // (deadline, arrival)
+    std::set<std::pair<double, std::uint64_t>> waiting_;
+};
+
+#endif // CORE_CLIENT_AI_THINK_SCHEDULER_H_
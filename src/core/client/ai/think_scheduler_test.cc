@@ -0,0 +1,64 @@
+#include "core/client/ai/think_scheduler.h"
+
+#include <unistd.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+TEST(ThinkSchedulerTest, earliestDeadlineFirst)
+{
+    ThinkScheduler scheduler(1);
+
+    mutex mu;
+    vector<int> order;
+
+    vector<thread> threads;
+    {
+        ThinkScheduler::Slot slot(&scheduler, 0.0);
+
+        const double deadlines[] = { 3.0, 1.0, 2.0 };
+        for (int i = 0; i < 3; ++i) {
+            const double deadline = deadlines[i];
+            threads.emplace_back([&, deadline]() {
+                ThinkScheduler::Slot slot(&scheduler, deadline);
+                lock_guard<mutex> lock(mu);
+                order.push_back(static_cast<int>(deadline));
+            });
+        }
+
+        while (scheduler.numWaiting() < 3)
+            usleep(1000);
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    EXPECT_EQ((vector<int> { 1, 2, 3 }), order);
+}
+
+TEST(ThinkSchedulerTest, multipleSlots)
+{
+    ThinkScheduler scheduler(2);
+
+    // Both slots can be taken without blocking.
+    scheduler.acquire(1.0);
+    scheduler.acquire(2.0);
+    EXPECT_EQ(0, scheduler.numWaiting());
+
+    thread t([&]() {
+        ThinkScheduler::Slot slot(&scheduler, 3.0);
+    });
+    while (scheduler.numWaiting() < 1)
+        usleep(1000);
+
+    scheduler.release();
+    t.join();
+    EXPECT_EQ(0, scheduler.numWaiting());
+
+    scheduler.release();
+}
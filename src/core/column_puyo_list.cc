@@ -18,6 +18,26 @@ string ColumnPuyoList::toString() const
     return oss.str();
 }
 
+ColumnPuyoList ColumnPuyoList::canonicalize() const
+{
+    PuyoColor names[NUM_PUYO_COLORS] {};
+    int numNames = 0;
+
+    ColumnPuyoList cpl(*this);
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < size_[i]; ++j) {
+            PuyoColor c = puyos_[i][j];
+            if (!isNormalColor(c))
+                continue;
+            if (names[ordinal(c)] == PuyoColor::EMPTY)
+                names[ordinal(c)] = NORMAL_PUYO_COLORS[numNames++];
+            cpl.puyos_[i][j] = names[ordinal(c)];
+        }
+    }
+
+    return cpl;
+}
+
 // static
 bool operator==(const ColumnPuyoList& lhs, const ColumnPuyoList& rhs)
 {
@@ -141,6 +141,11 @@ public:
         }
     }
 
+    // Returns the list whose normal colors are renamed so that they first appear in the
+    // order of RED, BLUE, YELLOW, GREEN (column by column from the bottom of the 1st column).
+    // Placeholders are kept.
+    ColumnPuyoList canonicalize() const;
+
     std::string toString() const;
 
     friend bool operator==(const ColumnPuyoList&, const ColumnPuyoList&);
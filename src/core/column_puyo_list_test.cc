@@ -144,3 +144,25 @@ TEST(ColumnPuyoListTest, mergeWithPlaceHolders3)
 
     EXPECT_FALSE(cpl1.merge(cpl2));
 }
+
+TEST(ColumnPuyoListTest, canonicalize)
+{
+    ColumnPuyoList cpl;
+    cpl.add(1, PuyoColor::GREEN);
+    cpl.add(1, PuyoColor::IRON);
+    cpl.add(1, PuyoColor::YELLOW);
+    cpl.add(3, PuyoColor::GREEN);
+    cpl.add(4, PuyoColor::RED);
+
+    ColumnPuyoList expected;
+    expected.add(1, PuyoColor::RED);
+    expected.add(1, PuyoColor::IRON);
+    expected.add(1, PuyoColor::BLUE);
+    expected.add(3, PuyoColor::RED);
+    expected.add(4, PuyoColor::YELLOW);
+
+    ColumnPuyoList canonical = cpl.canonicalize();
+    EXPECT_EQ(expected, canonical);
+    EXPECT_TRUE(canonical.hasPlaceHolder());
+    EXPECT_EQ(canonical, canonical.canonicalize());
+}
@@ -187,6 +187,12 @@ public:
     // utility methods
 
     size_t hash() const { return field_.hash(); }
+    // See BitField::canonicalize().
+    CoreField canonicalize(FieldCanonicalization* canonicalization = nullptr, bool allowsMirror = false) const
+    {
+        return CoreField(field_.canonicalize(canonicalization, allowsMirror));
+    }
+    size_t canonicalHash(bool allowsMirror = false) const { return field_.canonicalHash(allowsMirror); }
 
     std::string toDebugString() const;
 
@@ -0,0 +1,64 @@
+#include "core/drop_decision_table.h"
+
+#include "core/puyo_color.h"
+#include "core/puyo_controller.h"
+
+namespace {
+
+// A representative height for each height class.
+const int REPRESENTATIVE_HEIGHTS[] = { 10, 11, 12, 13 };
+
+void fillColumn(CoreField* field, int x, int height)
+{
+    while (field->height(x) < height)
+        CHECK(field->dropPuyoOn(x, PuyoColor::OJAMA));
+}
+
+} // anonymous namespace
+
+// static
+const DropDecisionTable& DropDecisionTable::instance()
+{
+    static const DropDecisionTable table;
+    return table;
+}
+
+DropDecisionTable::DropDecisionTable() :
+    reachableBits_{},
+    frames_{}
+{
+    for (int profile = 0; profile < NUM_PROFILES; ++profile) {
+        CoreField field;
+        for (int x = 1; x <= WIDTH; ++x)
+            fillColumn(&field, x, REPRESENTATIVE_HEIGHTS[(profile >> (2 * (x - 1))) & 3]);
+        DCHECK_EQ(profile, profileIndex(field));
+
+        unsigned int bits = 0;
+        for (int x = 1; x <= WIDTH; ++x) {
+            for (int r = 0; r < 4; ++r) {
+                Decision decision(x, r);
+                if (decision.isValid() && PuyoController::isReachable(field, decision))
+                    bits |= decisionBit(decision);
+            }
+        }
+        reachableBits_[profile] = bits;
+    }
+
+    for (int x = 1; x <= WIDTH; ++x) {
+        for (int r = 0; r < 4; ++r) {
+            Decision decision(x, r);
+            if (!decision.isValid())
+                continue;
+            for (int h1 = 0; h1 <= HEIGHT + 1; ++h1) {
+                for (int h2 = 0; h2 <= HEIGHT + 1; ++h2) {
+                    if (decision.axisX() == decision.childX() && h1 != h2)
+                        continue;
+                    CoreField field;
+                    fillColumn(&field, decision.axisX(), h1);
+                    fillColumn(&field, decision.childX(), h2);
+                    frames_[decisionIndex(decision)][h1][h2] = field.framesToDropNext(decision);
+                }
+            }
+        }
+    }
+}
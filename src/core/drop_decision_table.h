@@ -0,0 +1,73 @@
+#ifndef CORE_DROP_DECISION_TABLE_H_
+#define CORE_DROP_DECISION_TABLE_H_
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "base/base.h"
+#include "core/core_field.h"
+#include "core/decision.h"
+#include "core/field_constant.h"
+
+// DropDecisionTable is a precomputed version of PuyoController::isReachable() and
+// CoreField::framesToDropNext(). Plan enumeration calls them for all 22 decisions
+// on every node, so we look them up from tables instead of calculating each time.
+//
+// PuyoController::isReachable() only distinguishes column heights <= 10, 11, 12 and 13,
+// so the reachable decisions are indexed by such a compressed height profile (4^6 entries).
+// framesToDropNext() needs the exact heights of the axis and child columns, so the frames
+// are indexed by (decision, axis height, child height).
+class DropDecisionTable : public FieldConstant {
+public:
+    static const DropDecisionTable& instance();
+
+    // Returns the bit of |decision| in the reachable decision bits.
+    static unsigned int decisionBit(const Decision& decision)
+    {
+        DCHECK(decision.isValid()) << decision.toString();
+        return 1U << decisionIndex(decision);
+    }
+    static bool hasDecision(unsigned int bits, const Decision& decision) { return (bits & decisionBit(decision)) != 0; }
+
+    // Returns the set of decisions reachable on |field|.
+    // Use hasDecision() to check a decision is in the set.
+    unsigned int reachableDecisionBits(const CoreField& field) const { return reachableBits_[profileIndex(field)]; }
+    // The same as PuyoController::isReachable(field, decision).
+    bool isReachable(const CoreField& field, const Decision& decision) const
+    {
+        return hasDecision(reachableDecisionBits(field), decision);
+    }
+
+    // The same as field.framesToDropNext(decision).
+    int framesToDropNext(const CoreField& field, const Decision& decision) const
+    {
+        DCHECK(decision.isValid()) << decision.toString();
+        return frames_[decisionIndex(decision)][field.height(decision.axisX())][field.height(decision.childX())];
+    }
+
+private:
+    static const int NUM_PROFILES = 1 << (2 * WIDTH);
+    static const int NUM_DECISION_INDICES = WIDTH * 4;
+
+    DropDecisionTable();
+
+    static int decisionIndex(const Decision& decision) { return (decision.x - 1) * 4 + decision.r; }
+    // Compresses a height into 4 classes: <= 10, 11, 12, and >= 13.
+    static int heightClass(int height) { return std::min(std::max(height - 10, 0), 3); }
+    static int profileIndex(const CoreField& field)
+    {
+        int index = 0;
+        for (int x = 1; x <= WIDTH; ++x)
+            index |= heightClass(field.height(x)) << (2 * (x - 1));
+        return index;
+    }
+
+    unsigned int reachableBits_[NUM_PROFILES];
+    // A column height is in [0, 13].
+    short frames_[NUM_DECISION_INDICES][HEIGHT + 2][HEIGHT + 2];
+
+    DISALLOW_COPY_AND_ASSIGN(DropDecisionTable);
+};
+
+#endif // CORE_DROP_DECISION_TABLE_H_
@@ -0,0 +1,95 @@
+#include "core/drop_decision_table.h"
+
+#include <gtest/gtest.h>
+
+#include "core/core_field.h"
+#include "core/decision.h"
+#include "core/puyo_color.h"
+#include "core/puyo_controller.h"
+
+using namespace std;
+
+namespace {
+
+// Enumerates all the height profiles from column |x| to 6, and checks the table
+// returns the same result as PuyoController::isReachable and CoreField::framesToDropNext.
+void checkAllProfiles(const DropDecisionTable& table, CoreField* field, int x)
+{
+    if (x > FieldConstant::WIDTH) {
+        unsigned int bits = table.reachableDecisionBits(*field);
+        for (int dx = 1; dx <= FieldConstant::WIDTH; ++dx) {
+            for (int r = 0; r < 4; ++r) {
+                Decision decision(dx, r);
+                if (!decision.isValid())
+                    continue;
+
+                bool reachable = PuyoController::isReachable(*field, decision);
+                ASSERT_EQ(reachable, DropDecisionTable::hasDecision(bits, decision))
+                    << decision.toString() << '\n' << field->toDebugString();
+                ASSERT_EQ(field->framesToDropNext(decision), table.framesToDropNext(*field, decision))
+                    << decision.toString() << '\n' << field->toDebugString();
+            }
+        }
+        return;
+    }
+
+    for (int h = 0; h <= 13; ++h) {
+        checkAllProfiles(table, field, x + 1);
+        if (::testing::Test::HasFatalFailure())
+            return;
+        if (h < 13)
+            ASSERT_TRUE(field->dropPuyoOn(x, PuyoColor::OJAMA));
+    }
+
+    for (int h = 0; h < 13; ++h)
+        field->removePuyoFrom(x);
+}
+
+} // anonymous namespace
+
+TEST(DropDecisionTableTest, emptyField)
+{
+    const DropDecisionTable& table = DropDecisionTable::instance();
+    CoreField f;
+
+    unsigned int bits = table.reachableDecisionBits(f);
+    for (int x = 1; x <= 6; ++x) {
+        for (int r = 0; r < 4; ++r) {
+            Decision d(x, r);
+            if (!d.isValid())
+                continue;
+            EXPECT_TRUE(DropDecisionTable::hasDecision(bits, d)) << d;
+            EXPECT_EQ(f.framesToDropNext(d), table.framesToDropNext(f, d)) << d;
+        }
+    }
+}
+
+TEST(DropDecisionTableTest, unreachable)
+{
+    const DropDecisionTable& table = DropDecisionTable::instance();
+    CoreField f(
+        " O O  "
+        " O O  " // 12
+        " O O  "
+        " O O  "
+        " O O  "
+        " O O  " // 8
+        " O O  "
+        " O O  "
+        " O O  "
+        " O O  " // 4
+        " O O  "
+        " O O  "
+        " O O  ");
+
+    EXPECT_TRUE(table.isReachable(f, Decision(3, 0)));
+    EXPECT_FALSE(table.isReachable(f, Decision(1, 0)));
+    EXPECT_FALSE(table.isReachable(f, Decision(6, 3)));
+}
+
+TEST(DropDecisionTableTest, exhaustive)
+{
+    const DropDecisionTable& table = DropDecisionTable::instance();
+    CoreField f;
+    checkAllProfiles(table, &f, 1);
+}
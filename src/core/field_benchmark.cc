@@ -0,0 +1,277 @@
+#include "core/core_field.h"
+
+#include <glog/logging.h>
+
+#include "base/base.h"
+#include "base/benchmark.h"
+#include "core/bit_field.h"
+#include "core/field_bits.h"
+#include "core/rensa_result.h"
+
+using namespace std;
+
+static void benchmarkCountConnectedPuyos(base::Benchmark& benchmark, const PlainField& f, int expected, int x, int y)
+{
+    const BitField bf(f);
+    const PuyoColor c = bf.color(x, y);
+
+    const int expected4 = expected >= 4 ? 4 : expected;
+    CHECK_EQ(expected, f.countConnectedPuyos(x, y));
+    CHECK_LE(expected4, f.countConnectedPuyosMax4(x, y));
+    CHECK_EQ(expected, bf.countConnectedPuyos(x, y));
+    CHECK_LE(expected4, bf.countConnectedPuyosMax4(x, y));
+    CHECK_EQ(expected, bf.countConnectedPuyos(x, y, c));
+    CHECK_LE(expected4, bf.countConnectedPuyosMax4(x, y, c));
+
+    benchmark.measure("PlainField", [&]() { base::doNotOptimize(f.countConnectedPuyos(x, y)); });
+    benchmark.measure("PlainField/max4", [&]() { base::doNotOptimize(f.countConnectedPuyosMax4(x, y)); });
+    benchmark.measure("BitField", [&]() { base::doNotOptimize(bf.countConnectedPuyos(x, y)); });
+    benchmark.measure("BitField/max4", [&]() { base::doNotOptimize(bf.countConnectedPuyosMax4(x, y)); });
+    benchmark.measure("BitField/color", [&]() { base::doNotOptimize(bf.countConnectedPuyos(x, y, c)); });
+    benchmark.measure("BitField/max4/color", [&]() { base::doNotOptimize(bf.countConnectedPuyosMax4(x, y, c)); });
+}
+
+static void benchmarkSimulation(base::Benchmark& benchmark, const CoreField& original)
+{
+    const int expectedChain = CoreField(original).simulate().chains;
+    CHECK_EQ(expectedChain, BitField(original.bitField()).simulate().chains);
+
+    auto copyCoreField = [&]() { return CoreField(original); };
+    auto copyBitField = [&]() { return BitField(original.bitField()); };
+
+    benchmark.measureWithSetup("CoreField", copyCoreField, [](CoreField& cf) {
+        base::doNotOptimize(cf.simulate());
+    });
+
+    benchmark.measureWithSetup("BitField", copyBitField, [](BitField& bf) {
+        base::doNotOptimize(bf.simulate());
+    });
+
+    benchmark.measureWithSetup("BitField/fast", copyBitField, [](BitField& bf) {
+        RensaNonTracker tracker;
+        base::doNotOptimize(bf.simulateFast(&tracker));
+    });
+
+#if defined(__AVX2__) && defined(__BMI2__)
+    benchmark.measureWithSetup("BitField/AVX2", copyBitField, [](BitField& bf) {
+        BitField::SimulationContext context;
+        RensaNonTracker tracker;
+        base::doNotOptimize(bf.simulateAVX2(&context, &tracker));
+    });
+
+    benchmark.measureWithSetup("BitField/fast/AVX2", copyBitField, [](BitField& bf) {
+        RensaNonTracker tracker;
+        base::doNotOptimize(bf.simulateFastAVX2(&tracker));
+    });
+#endif // __AVX2__ and __BMI2__
+}
+
+static void benchmarkVanishDrop(base::Benchmark& benchmark, const CoreField& original)
+{
+    auto copyCoreField = [&]() { return CoreField(original); };
+    auto copyBitField = [&]() { return BitField(original.bitField()); };
+
+    benchmark.measureWithSetup("CoreField", copyCoreField, [](CoreField& cf) {
+        CoreField::SimulationContext context;
+        RensaNonTracker tracker;
+        while (cf.vanishDrop(&context, &tracker).score > 0) {
+            // do nothing.
+        }
+        base::doNotOptimize(context);
+    });
+
+    benchmark.measureWithSetup("BitField", copyBitField, [](BitField& bf) {
+        BitField::SimulationContext context;
+        RensaNonTracker tracker;
+        while (bf.vanishDrop(&context, &tracker).score > 0) {
+            // do nothing.
+        }
+        base::doNotOptimize(context);
+    });
+
+    benchmark.measureWithSetup("BitField/fast", copyBitField, [](BitField& bf) {
+        BitField::SimulationContext context;
+        RensaNonTracker tracker;
+        while (bf.vanishDropFast(&context, &tracker)) {
+            // do nothing.
+        }
+        base::doNotOptimize(context);
+    });
+
+#if defined(__AVX2__) && defined(__BMI2__)
+    benchmark.measureWithSetup("BitField/AVX2", copyBitField, [](BitField& bf) {
+        BitField::SimulationContext context;
+        RensaNonTracker tracker;
+        while (bf.vanishDropAVX2(&context, &tracker).score > 0) {
+            // do nothing.
+        }
+        base::doNotOptimize(context);
+    });
+
+    benchmark.measureWithSetup("BitField/fast/AVX2", copyBitField, [](BitField& bf) {
+        BitField::SimulationContext context;
+        RensaNonTracker tracker;
+        while (bf.vanishDropFastAVX2(&context, &tracker)) {
+            // do nothing.
+        }
+        base::doNotOptimize(context);
+    });
+#endif // __AVX2__ and __BMI2__
+}
+
+BENCHMARK(FieldBenchmark, copy)
+{
+    const CoreField f(".G.BRG"
+                      "GBRRYR"
+                      "RRYYBY"
+                      "RGYRBR"
+                      "YGYRBY"
+                      "YGBGYR"
+                      "GRBGYR"
+                      "BRBYBY"
+                      "RYYBYY"
+                      "BRBYBR"
+                      "BGBYRR"
+                      "YGBGBG"
+                      "RBGBGG");
+
+    benchmark.measure([&]() {
+        CoreField f2(f);
+        base::doNotOptimize(f2);
+    });
+}
+
+BENCHMARK(FieldBenchmark, simulate_empty)
+{
+    CoreField cf;
+    benchmarkSimulation(benchmark, cf);
+}
+
+BENCHMARK(FieldBenchmark, simulate_easy)
+{
+    CoreField cf(".RBRB."
+                 "RBRBR."
+                 "RBRBR."
+                 "RBRBRR");
+    benchmarkSimulation(benchmark, cf);
+}
+
+BENCHMARK(FieldBenchmark, simulate_evil)
+{
+    CoreField cf("..BB.."
+                 "..GGB."
+                 ".GYYG."
+                 ".BBBYB"
+                 "RRRRBY");
+    benchmarkSimulation(benchmark, cf);
+}
+
+BENCHMARK(FieldBenchmark, simulate_filled)
+{
+    CoreField cf(".G.BRG"
+                 "GBRRYR"
+                 "RRYYBY"
+                 "RGYRBR"
+                 "YGYRBY"
+                 "YGBGYR"
+                 "GRBGYR"
+                 "BRBYBY"
+                 "RYYBYY"
+                 "BRBYBR"
+                 "BGBYRR"
+                 "YGBGBG"
+                 "RBGBGG");
+    benchmarkSimulation(benchmark, cf);
+}
+
+BENCHMARK(FieldBenchmark, vanishDrop_filled)
+{
+    CoreField cf(".G.BRG"
+                 "GBRRYR"
+                 "RRYYBY"
+                 "RGYRBR"
+                 "YGYRBY"
+                 "YGBGYR"
+                 "GRBGYR"
+                 "BRBYBY"
+                 "RYYBYY"
+                 "BRBYBR"
+                 "BGBYRR"
+                 "YGBGBG"
+                 "RBGBGG");
+    benchmarkVanishDrop(benchmark, cf);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_empty)
+{
+    const PlainField f;
+    benchmarkCountConnectedPuyos(benchmark, f, 72, 3, 12);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_1)
+{
+    const PlainField f("..R...");
+    benchmarkCountConnectedPuyos(benchmark, f, 1, 3, 1);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_2)
+{
+    const PlainField f("..RR..");
+    benchmarkCountConnectedPuyos(benchmark, f, 2, 3, 1);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_3)
+{
+    const PlainField f("..RRR.");
+    benchmarkCountConnectedPuyos(benchmark, f, 3, 3, 1);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_4)
+{
+    const PlainField f("..RRRR");
+    benchmarkCountConnectedPuyos(benchmark, f, 4, 3, 1);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_4_2)
+{
+    const PlainField f(
+        "..R..."
+        "..R..."
+        "..R..."
+        "..R...");
+    benchmarkCountConnectedPuyos(benchmark, f, 4, 3, 1);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_4_3)
+{
+    const PlainField f(
+        "..RR.."
+        "..RR..");
+    benchmarkCountConnectedPuyos(benchmark, f, 4, 3, 1);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_6)
+{
+    const PlainField f(
+        "RRRRRR");
+    benchmarkCountConnectedPuyos(benchmark, f, 6, 1, 1);
+}
+
+BENCHMARK(FieldBenchmark, countConnectedPuyos_evil)
+{
+    const PlainField f(
+        "RRRRRR" // 12
+        "R....R"
+        "R..R.R"
+        "R.RR.R"
+        "R.R..R" // 8
+        "R.RR.R"
+        "R..R.R"
+        "R.RR.R"
+        "R.R..R" // 4
+        "R.RRRR"
+        "R....."
+        "RRRRRR");
+
+    benchmarkCountConnectedPuyos(benchmark, f, 44, 6, 1);
+}
@@ -0,0 +1,59 @@
+#ifndef CORE_FIELD_CANONICALIZATION_H_
+#define CORE_FIELD_CANONICALIZATION_H_
+
+#include "core/decision.h"
+#include "core/puyo_color.h"
+
+// FieldCanonicalization describes how a field was transformed into the canonical field
+// by BitField::canonicalize(). The normal colors are permuted, and the field might be
+// mirrored. This is used to map a result on the canonical field back to the original field.
+class FieldCanonicalization {
+public:
+    FieldCanonicalization()
+    {
+        for (int i = 0; i < NUM_PUYO_COLORS; ++i)
+            toCanonical_[i] = toOriginal_[i] = static_cast<PuyoColor>(i);
+    }
+
+    // Maps the normal color |original| to |canonical|.
+    void setColor(PuyoColor original, PuyoColor canonical)
+    {
+        toCanonical_[ordinal(original)] = canonical;
+        toOriginal_[ordinal(canonical)] = original;
+    }
+    void setMirrored(bool mirrored) { mirrored_ = mirrored; }
+
+    bool isMirrored() const { return mirrored_; }
+    bool isIdentity() const
+    {
+        if (mirrored_)
+            return false;
+        for (int i = 0; i < NUM_PUYO_COLORS; ++i) {
+            if (toCanonical_[i] != static_cast<PuyoColor>(i))
+                return false;
+        }
+        return true;
+    }
+
+    PuyoColor canonicalColor(PuyoColor original) const { return toCanonical_[ordinal(original)]; }
+    PuyoColor originalColor(PuyoColor canonical) const { return toOriginal_[ordinal(canonical)]; }
+
+    int canonicalX(int x) const { return mirrored_ ? 7 - x : x; }
+    int originalX(int x) const { return mirrored_ ? 7 - x : x; }
+
+    // Maps a decision on the canonical field to the original field.
+    Decision originalDecision(const Decision& d) const
+    {
+        if (!mirrored_)
+            return d;
+        // Mirroring swaps the right (1) and the left (3).
+        return Decision(7 - d.x, (4 - d.r) & 3);
+    }
+
+private:
+    PuyoColor toCanonical_[NUM_PUYO_COLORS];
+    PuyoColor toOriginal_[NUM_PUYO_COLORS];
+    bool mirrored_ = false;
+};
+
+#endif // CORE_FIELD_CANONICALIZATION_H_
@@ -1,7 +1,11 @@
 #include "core/kumipuyo_seq.h"
 
+#include <algorithm>
+
 #include <glog/logging.h>
 
+#include "core/kumipuyo_seq_view.h"
+
 using namespace std;
 
 KumipuyoSeq::KumipuyoSeq(const string& str)
@@ -9,66 +13,109 @@ KumipuyoSeq::KumipuyoSeq(const string& str)
     for (string::size_type i = 0; i * 2 + 1 < str.size(); ++i) {
         PuyoColor axis = toPuyoColor(str[i * 2]);
         PuyoColor child = toPuyoColor(str[i * 2 + 1]);
-        seq_.push_back(Kumipuyo(axis, child));
+        add(Kumipuyo(axis, child));
     }
 }
 
-KumipuyoSeq::KumipuyoSeq(const vector<Kumipuyo>& seq) : seq_(seq)
+KumipuyoSeq::KumipuyoSeq(const vector<Kumipuyo>& seq) :
+    KumipuyoSeq(seq.data(), seq.data() + seq.size())
 {
 }
 
-KumipuyoSeq::KumipuyoSeq(initializer_list<Kumipuyo> seq) : seq_(seq)
+KumipuyoSeq::KumipuyoSeq(initializer_list<Kumipuyo> seq) :
+    KumipuyoSeq(seq.begin(), seq.end())
 {
 }
 
+KumipuyoSeq::KumipuyoSeq(const Kumipuyo* begin, const Kumipuyo* end)
+{
+    DCHECK_LE(begin, end);
+
+    size_ = end - begin;
+    if (size_ <= INLINE_CAPACITY)
+        std::copy(begin, end, inline_);
+    else
+        heap_.assign(begin, end);
+}
+
 PuyoColor KumipuyoSeq::color(NextPuyoPosition npp) const
 {
-    switch (npp) {
-    case NextPuyoPosition::CURRENT_AXIS:
-        return size() > 0 ? axis(0) : PuyoColor::EMPTY;
-    case NextPuyoPosition::CURRENT_CHILD:
-        return size() > 0 ? child(0) : PuyoColor::EMPTY;
-    case NextPuyoPosition::NEXT1_AXIS:
-        return size() > 1 ? axis(1) : PuyoColor::EMPTY;
-    case NextPuyoPosition::NEXT1_CHILD:
-        return size() > 1 ? child(1) : PuyoColor::EMPTY;
-    case NextPuyoPosition::NEXT2_AXIS:
-        return size() > 2 ? axis(2) : PuyoColor::EMPTY;
-    case NextPuyoPosition::NEXT2_CHILD:
-        return size() > 2 ? child(2) : PuyoColor::EMPTY;
+    return KumipuyoSeqView(*this).color(npp);
+}
+
+void KumipuyoSeq::resize(int n)
+{
+    DCHECK_LE(0, n);
+
+    if (n <= size_) {
+        if (!heap_.empty())
+            heap_.resize(begin_ + n);
+        size_ = n;
+        return;
     }
 
-    CHECK(false) << "Unknown NextPuyoPosition: " << static_cast<int>(npp);
-    return PuyoColor::EMPTY;
+    while (size_ < n)
+        add(Kumipuyo());
 }
 
-string KumipuyoSeq::toString() const
+void KumipuyoSeq::add(const Kumipuyo& kp)
 {
-    std::string s;
-    for (const auto& kumipuyo : seq_) {
-        s += toChar(kumipuyo.axis);
-        s += toChar(kumipuyo.child);
+    if (!heap_.empty()) {
+        heap_.push_back(kp);
+        ++size_;
+        return;
+    }
+
+    if (begin_ + size_ < INLINE_CAPACITY) {
+        inline_[begin_ + size_++] = kp;
+        return;
+    }
+
+    // Reuses the space of the dropped kumipuyos if possible.
+    if (size_ < INLINE_CAPACITY) {
+        std::copy(inline_ + begin_, inline_ + begin_ + size_, inline_);
+        begin_ = 0;
+        inline_[size_++] = kp;
+        return;
     }
 
-    return s;
+    heap_.reserve(2 * INLINE_CAPACITY);
+    heap_.assign(inline_ + begin_, inline_ + begin_ + size_);
+    heap_.push_back(kp);
+    begin_ = 0;
+    ++size_;
+}
+
+void KumipuyoSeq::append(const KumipuyoSeq& seq)
+{
+    // |seq| might be |this|.
+    const int n = seq.size();
+    for (int i = 0; i < n; ++i)
+        add(Kumipuyo(seq.get(i)));
+}
+
+string KumipuyoSeq::toString() const
+{
+    return KumipuyoSeqView(*this).toString();
 }
 
 KumipuyoSeq KumipuyoSeq::subsequence(int begin, int n) const
 {
-    DCHECK_LE(begin, static_cast<int>(seq_.size()));
-    DCHECK_LE(begin + n, static_cast<int>(seq_.size()));
+    DCHECK_LE(begin, size_);
+    DCHECK_LE(begin + n, size_);
     DCHECK_LE(0, n);
 
-    KumipuyoSeq seq;
-    seq.seq_.assign(seq_.begin() + begin, seq_.begin() + begin + n);
-    return seq;
+    return KumipuyoSeq(data() + begin, data() + begin + n);
 }
 
 KumipuyoSeq KumipuyoSeq::subsequence(int begin) const
 {
-    DCHECK_LE(begin, static_cast<int>(seq_.size()));
+    DCHECK_LE(begin, size_);
 
-    KumipuyoSeq seq;
-    seq.seq_.assign(seq_.begin() + begin, seq_.end());
-    return seq;
+    return KumipuyoSeq(data() + begin, data() + size_);
+}
+
+bool operator==(const KumipuyoSeq& lhs, const KumipuyoSeq& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
@@ -9,48 +9,62 @@
 #include "core/next_puyo.h"
 #include "core/puyo_color.h"
 
+// KumipuyoSeq is a sequence of Kumipuyo. Since most sequences are short, up to
+// INLINE_CAPACITY kumipuyos are stored in the object itself, and no heap allocation happens.
+// Use KumipuyoSeqView to pass a sequence (or a part of it) without copying.
 class KumipuyoSeq {
 public:
+    static const int INLINE_CAPACITY = 16;
+
     KumipuyoSeq() {}
     KumipuyoSeq(const std::string&);
     KumipuyoSeq(const std::vector<Kumipuyo>&);
     KumipuyoSeq(std::initializer_list<Kumipuyo>);
+    KumipuyoSeq(const Kumipuyo* begin, const Kumipuyo* end);
 
-    void clear() { seq_.clear(); }
+    void clear() { begin_ = 0; size_ = 0; heap_.clear(); }
 
-    const Kumipuyo& get(int n) const { return seq_[n]; }
+    const Kumipuyo& get(int n) const { return data()[n]; }
     PuyoColor color(NextPuyoPosition) const;
-    PuyoColor axis(int n) const { return seq_[n].axis; }
-    PuyoColor child(int n) const { return seq_[n].child; }
+    PuyoColor axis(int n) const { return data()[n].axis; }
+    PuyoColor child(int n) const { return data()[n].child; }
 
-    bool isEmpty() const { return seq_.empty(); }
-    int size() const { return seq_.size(); }
-    void resize(int n) { seq_.resize(n); }
+    bool isEmpty() const { return size_ == 0; }
+    int size() const { return size_; }
+    void resize(int n);
 
-    const Kumipuyo& front() const { return seq_.front(); }
-    void dropFront() { seq_.erase(seq_.begin()); }
-    void add(const Kumipuyo& kp) { seq_.push_back(kp); }
-    void append(const KumipuyoSeq& seq) { seq_.insert(seq_.end(), seq.seq_.begin(), seq.seq_.end()); }
+    const Kumipuyo& front() const { return data()[0]; }
+    // This doesn't move the rest of kumipuyos.
+    void dropFront() { ++begin_; --size_; }
+    void add(const Kumipuyo&);
+    void append(const KumipuyoSeq&);
 
-    std::vector<Kumipuyo>::iterator begin() { return seq_.begin(); }
-    std::vector<Kumipuyo>::const_iterator begin() const { return seq_.cbegin(); }
-    std::vector<Kumipuyo>::iterator end() { return seq_.end(); }
-    std::vector<Kumipuyo>::const_iterator end() const { return seq_.cend(); }
+    Kumipuyo* begin() { return data(); }
+    const Kumipuyo* begin() const { return data(); }
+    Kumipuyo* end() { return data() + size_; }
+    const Kumipuyo* end() const { return data() + size_; }
 
     KumipuyoSeq subsequence(int begin, int n) const;
     KumipuyoSeq subsequence(int begin) const;
 
-    void setAxis(int n, PuyoColor c) { seq_[n].axis = c; }
-    void setChild(int n, PuyoColor c) { seq_[n].child = c; }
+    void setAxis(int n, PuyoColor c) { data()[n].axis = c; }
+    void setChild(int n, PuyoColor c) { data()[n].child = c; }
 
     std::string toString() const;
 
-    friend bool operator==(const KumipuyoSeq& lhs, const KumipuyoSeq& rhs) { return lhs.seq_ == rhs.seq_; }
+    friend bool operator==(const KumipuyoSeq&, const KumipuyoSeq&);
     friend bool operator!=(const KumipuyoSeq& lhs, const KumipuyoSeq& rhs) { return !(lhs == rhs); }
 
 private:
-    std::vector<Kumipuyo> seq_;
+    // When |heap_| is empty, the kumipuyos are stored in |inline_|.
+    // Otherwise, they are stored in |heap_|. In both cases, the first |begin_| kumipuyos have been dropped.
+    Kumipuyo* data() { return (heap_.empty() ? inline_ : heap_.data()) + begin_; }
+    const Kumipuyo* data() const { return (heap_.empty() ? inline_ : heap_.data()) + begin_; }
+
+    int begin_ = 0;
+    int size_ = 0;
+    Kumipuyo inline_[INLINE_CAPACITY];
+    std::vector<Kumipuyo> heap_;
 };
 
 #endif
-
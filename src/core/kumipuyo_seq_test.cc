@@ -1,5 +1,7 @@
 #include "core/kumipuyo_seq.h"
 
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(KumipuyoSeqTest, basic)
@@ -31,3 +33,57 @@ TEST(KumipuyoSeqTest, color)
     EXPECT_EQ(PuyoColor::EMPTY, seq.color(NextPuyoPosition::NEXT2_AXIS));
     EXPECT_EQ(PuyoColor::EMPTY, seq.color(NextPuyoPosition::NEXT2_CHILD));
 }
+
+TEST(KumipuyoSeqTest, dropFront)
+{
+    KumipuyoSeq seq("RBYGRR");
+    seq.dropFront();
+
+    EXPECT_EQ(KumipuyoSeq("YGRR"), seq);
+    EXPECT_EQ(Kumipuyo(PuyoColor::YELLOW, PuyoColor::GREEN), seq.front());
+
+    seq.add(Kumipuyo(PuyoColor::BLUE, PuyoColor::BLUE));
+    EXPECT_EQ(KumipuyoSeq("YGRRBB"), seq);
+}
+
+TEST(KumipuyoSeqTest, addBeyondInlineCapacity)
+{
+    const int n = KumipuyoSeq::INLINE_CAPACITY * 3;
+    const PuyoColor colors[] = { PuyoColor::RED, PuyoColor::BLUE, PuyoColor::YELLOW };
+
+    KumipuyoSeq seq;
+    std::vector<Kumipuyo> expected;
+    for (int i = 0; i < n; ++i) {
+        Kumipuyo kp(colors[i % 3], colors[i / 3 % 3]);
+        seq.add(kp);
+        expected.push_back(kp);
+
+        // Dropping some keeps the rest.
+        if (i % 5 == 4) {
+            seq.dropFront();
+            expected.erase(expected.begin());
+        }
+    }
+
+    EXPECT_EQ(KumipuyoSeq(expected), seq);
+    EXPECT_EQ(static_cast<int>(expected.size()), seq.size());
+    for (int i = 0; i < seq.size(); ++i)
+        EXPECT_EQ(expected[i], seq.get(i));
+
+    KumipuyoSeq copied(seq);
+    EXPECT_EQ(seq, copied);
+    EXPECT_EQ(KumipuyoSeq(std::vector<Kumipuyo>(expected.begin() + 3, expected.begin() + 5)), seq.subsequence(3, 2));
+
+    seq.resize(2);
+    EXPECT_EQ(KumipuyoSeq(std::vector<Kumipuyo>(expected.begin(), expected.begin() + 2)), seq);
+
+    seq.clear();
+    EXPECT_TRUE(seq.isEmpty());
+}
+
+TEST(KumipuyoSeqTest, append)
+{
+    KumipuyoSeq seq("RBYG");
+    seq.append(seq);
+    EXPECT_EQ(KumipuyoSeq("RBYGRBYG"), seq);
+}
@@ -0,0 +1,42 @@
+#include "core/kumipuyo_seq_view.h"
+
+#include <algorithm>
+
+using namespace std;
+
+PuyoColor KumipuyoSeqView::color(NextPuyoPosition npp) const
+{
+    switch (npp) {
+    case NextPuyoPosition::CURRENT_AXIS:
+        return size() > 0 ? axis(0) : PuyoColor::EMPTY;
+    case NextPuyoPosition::CURRENT_CHILD:
+        return size() > 0 ? child(0) : PuyoColor::EMPTY;
+    case NextPuyoPosition::NEXT1_AXIS:
+        return size() > 1 ? axis(1) : PuyoColor::EMPTY;
+    case NextPuyoPosition::NEXT1_CHILD:
+        return size() > 1 ? child(1) : PuyoColor::EMPTY;
+    case NextPuyoPosition::NEXT2_AXIS:
+        return size() > 2 ? axis(2) : PuyoColor::EMPTY;
+    case NextPuyoPosition::NEXT2_CHILD:
+        return size() > 2 ? child(2) : PuyoColor::EMPTY;
+    }
+
+    CHECK(false) << "Unknown NextPuyoPosition: " << static_cast<int>(npp);
+    return PuyoColor::EMPTY;
+}
+
+string KumipuyoSeqView::toString() const
+{
+    std::string s;
+    for (const auto& kumipuyo : *this) {
+        s += toChar(kumipuyo.axis);
+        s += toChar(kumipuyo.child);
+    }
+
+    return s;
+}
+
+bool operator==(const KumipuyoSeqView& lhs, const KumipuyoSeqView& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
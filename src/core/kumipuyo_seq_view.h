@@ -0,0 +1,61 @@
+#ifndef CORE_KUMIPUYO_SEQ_VIEW_H_
+#define CORE_KUMIPUYO_SEQ_VIEW_H_
+
+#include <string>
+
+#include <glog/logging.h>
+
+#include "core/kumipuyo.h"
+#include "core/kumipuyo_seq.h"
+#include "core/next_puyo.h"
+#include "core/puyo_color.h"
+
+// KumipuyoSeqView is a non-owning view of kumipuyos in a KumipuyoSeq. Taking a view or
+// a subsequence of it doesn't copy kumipuyos, so pass this by value.
+// The viewed KumipuyoSeq must outlive the view, and must not be modified while it's viewed.
+class KumipuyoSeqView {
+public:
+    KumipuyoSeqView() {}
+    KumipuyoSeqView(const KumipuyoSeq& seq) : data_(seq.begin()), size_(seq.size()) {}
+    KumipuyoSeqView(const Kumipuyo* data, int size) : data_(data), size_(size) {}
+
+    const Kumipuyo& get(int n) const { return data_[n]; }
+    PuyoColor color(NextPuyoPosition) const;
+    PuyoColor axis(int n) const { return data_[n].axis; }
+    PuyoColor child(int n) const { return data_[n].child; }
+
+    bool isEmpty() const { return size_ == 0; }
+    int size() const { return size_; }
+
+    const Kumipuyo& front() const { return data_[0]; }
+    void dropFront() { ++data_; --size_; }
+
+    const Kumipuyo* begin() const { return data_; }
+    const Kumipuyo* end() const { return data_ + size_; }
+
+    KumipuyoSeqView subsequence(int begin, int n) const
+    {
+        DCHECK_LE(0, n);
+        DCHECK_LE(begin + n, size_);
+        return KumipuyoSeqView(data_ + begin, n);
+    }
+    KumipuyoSeqView subsequence(int begin) const
+    {
+        DCHECK_LE(begin, size_);
+        return KumipuyoSeqView(data_ + begin, size_ - begin);
+    }
+
+    // Copies the viewed kumipuyos.
+    KumipuyoSeq toKumipuyoSeq() const { return KumipuyoSeq(begin(), end()); }
+
+    std::string toString() const;
+
+    friend bool operator==(const KumipuyoSeqView&, const KumipuyoSeqView&);
+    friend bool operator!=(const KumipuyoSeqView& lhs, const KumipuyoSeqView& rhs) { return !(lhs == rhs); }
+
+private:
+    const Kumipuyo* data_ = nullptr;
+    int size_ = 0;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "core/kumipuyo_seq_view.h"
+
+#include <gtest/gtest.h>
+
+TEST(KumipuyoSeqViewTest, basic)
+{
+    KumipuyoSeqView view;
+    EXPECT_TRUE(view.isEmpty());
+    EXPECT_EQ(0, view.size());
+}
+
+TEST(KumipuyoSeqViewTest, view)
+{
+    KumipuyoSeq seq("RBYGRR");
+    KumipuyoSeqView view(seq);
+
+    EXPECT_EQ(3, view.size());
+    EXPECT_EQ(PuyoColor::RED, view.axis(0));
+    EXPECT_EQ(PuyoColor::BLUE, view.child(0));
+    EXPECT_EQ(PuyoColor::YELLOW, view.color(NextPuyoPosition::NEXT1_AXIS));
+    EXPECT_EQ(PuyoColor::RED, view.color(NextPuyoPosition::NEXT2_CHILD));
+    EXPECT_EQ("RBYGRR", view.toString());
+
+    // The view refers to the kumipuyos of |seq|.
+    EXPECT_EQ(&seq.get(1), &view.get(1));
+}
+
+TEST(KumipuyoSeqViewTest, subsequence)
+{
+    KumipuyoSeq seq("RBYGRRBB");
+    KumipuyoSeqView view(seq);
+
+    EXPECT_EQ(KumipuyoSeqView(KumipuyoSeq("YGRR")), view.subsequence(1, 2));
+    EXPECT_EQ(KumipuyoSeqView(KumipuyoSeq("RRBB")), view.subsequence(2));
+    EXPECT_TRUE(view.subsequence(4).isEmpty());
+    EXPECT_EQ(PuyoColor::EMPTY, view.subsequence(3).color(NextPuyoPosition::NEXT1_AXIS));
+
+    view.dropFront();
+    EXPECT_EQ("YGRRBB", view.toString());
+    EXPECT_EQ(seq.subsequence(1), view.toKumipuyoSeq());
+}
@@ -19,15 +19,29 @@ namespace {
 Decision makeDecision(const toml::Value& v)
 {
     const toml::Array ary = v.as<toml::Array>();
+    if (ary.size() != 2)
+        return Decision();
     int x = ary[0].as<int>();
     int r = ary[1].as<int>();
     return Decision(x, r);
 }
 
+// BijectionMatcher can match the variables 'A' - 'D'.
+bool isValidNextPattern(const string& nextPattern)
+{
+    if (nextPattern.size() != 4)
+        return false;
+    for (char c : nextPattern) {
+        if (c < 'A' || 'D' < c)
+            return false;
+    }
+    return true;
+}
+
 } // namespace anonymous
 
-DecisionBookField::DecisionBookField(const vector<string>& field, map<string, Decision>&& decisions) :
-    pattern_(strings::join(field, "")),
+DecisionBookField::DecisionBookField(FieldPattern&& pattern, map<string, Decision>&& decisions) :
+    pattern_(move(pattern)),
     decisions_(move(decisions))
 {
 }
@@ -118,20 +132,50 @@ bool DecisionBook::loadFromValue(const toml::Value& book)
     if (!book.valid())
         return false;
 
-    const toml::Array& vs = book.find("book")->as<toml::Array>();
+    const toml::Value* booksValue = book.find("book");
+    if (!booksValue || !booksValue->is<toml::Array>()) {
+        LOG(ERROR) << "decision book should have an array of |book|";
+        return false;
+    }
+
+    const toml::Array& vs = booksValue->as<toml::Array>();
     fields_.reserve(vs.size());
     for (const toml::Value& v : vs) {
         vector<string> f;
         for (const auto& s : v.get<toml::Array>("field"))
             f.push_back(s.as<string>());
+
+        FieldPattern pattern;
+        if (!FieldPattern::parse(strings::join(f, ""), string(), &pattern))
+            return false;
+        for (const auto& p : pattern.patterns()) {
+            if (p.var < 'A' || 'D' < p.var) {
+                LOG(ERROR) << "field should use only A - D: " << strings::join(f, "");
+                return false;
+            }
+        }
+        if (!pattern.isBijectionMatchable()) {
+            LOG(ERROR) << "field should not have '*': " << strings::join(f, "");
+            return false;
+        }
+
         map<string, Decision> m;
         for (const auto& e : v.as<toml::Table>()) {
             if (e.first == "field")
                 continue;
-            m[e.first] = makeDecision(e.second);
+            if (!isValidNextPattern(e.first)) {
+                LOG(ERROR) << "next should be 4 variables of A - D: " << e.first;
+                return false;
+            }
+            Decision decision = makeDecision(e.second);
+            if (!decision.isValid()) {
+                LOG(ERROR) << "invalid decision for " << e.first;
+                return false;
+            }
+            m[e.first] = decision;
         }
 
-        fields_.emplace_back(f, std::move(m));
+        fields_.emplace_back(std::move(pattern), std::move(m));
     }
 
     return true;
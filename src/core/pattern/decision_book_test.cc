@@ -93,3 +93,27 @@ TEST(DecisionBookTest, nextDecision3)
     cf.dropKumipuyo(Decision(3, 2), seq.front());
     seq.dropFront();
 }
+
+TEST(DecisionBookTest, invalid)
+{
+    const char* const books[] = {
+        // No book.
+        "foo = 1\n",
+        // An unacceptable character in the field.
+        "[[book]]\nfield = [\"AA!...\"]\nAABB = [3, 0]\n",
+        // BijectionMatcher can match only A - D.
+        "[[book]]\nfield = [\"E.....\"]\nAABB = [3, 0]\n",
+        "[[book]]\nfield = [\"*.....\"]\nAABB = [3, 0]\n",
+        // A next should be 4 variables.
+        "[[book]]\nfield = []\nAAB = [3, 0]\n",
+        "[[book]]\nfield = []\nAABE = [3, 0]\n",
+        // An invalid decision.
+        "[[book]]\nfield = []\nAABB = [7, 0]\n",
+        "[[book]]\nfield = []\nAABB = [3]\n",
+    };
+
+    for (const char* str : books) {
+        DecisionBook book;
+        EXPECT_FALSE(book.loadFromString(str)) << str;
+    }
+}
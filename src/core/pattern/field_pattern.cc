@@ -6,6 +6,7 @@
 #include <cctype>
 #include <cstddef>
 #include <sstream>
+#include <utility>
 
 #include "core/column_puyo_list.h"
 #include "core/core_field.h"
@@ -17,6 +18,29 @@ using namespace std;
 
 FieldPattern::FieldPattern(const string& field, const string& notPatternField)
 {
+    CHECK(init(field, notPatternField)) << field;
+}
+
+// static
+bool FieldPattern::parse(const string& field, const string& notPatternField, FieldPattern* pattern)
+{
+    FieldPattern p;
+    if (!p.init(field, notPatternField))
+        return false;
+
+    *pattern = std::move(p);
+    return true;
+}
+
+bool FieldPattern::init(const string& field, const string& notPatternField)
+{
+    // A pattern can have 13 rows at most.
+    const size_t maxLength = FieldConstant::WIDTH * (FieldConstant::HEIGHT + 1);
+    if (field.length() > maxLength || notPatternField.length() > maxLength) {
+        LOG(ERROR) << "A pattern should have 13 rows at most: " << field;
+        return false;
+    }
+
     int varCount = 0;
     struct TempPattern {
         FieldBits varBits;
@@ -46,7 +70,8 @@ FieldPattern::FieldPattern(const string& field, const string& notPatternField)
             emptyBits.set(x, y);
             pats[c - 'a'].allowVarBits.set(x, y);
         } else {
-            CHECK(false) << "Unacceptable variable " << c << " at (" << x << ", " << y << ")";
+            LOG(ERROR) << "Unacceptable variable " << c << " at (" << x << ", " << y << ")";
+            return false;
         }
     }
 
@@ -66,7 +91,8 @@ FieldPattern::FieldPattern(const string& field, const string& notPatternField)
             continue;
         }
 
-        CHECK(false) << "Unacceptable variable " << c << " at (" << x << ", " << y << ")";
+        LOG(ERROR) << "Unacceptable variable " << c << " at (" << x << ", " << y << ")";
+        return false;
     }
 
     for (int i = 0; i < 26; ++i) {
@@ -76,12 +102,16 @@ FieldPattern::FieldPattern(const string& field, const string& notPatternField)
         p.varBits = pats[i].varBits;
 
         if (pats[i].varBits.isEmpty()) {
-            CHECK(pats[i].allowVarBits.isEmpty())
-                << "Var " << p.var << " is not used, but allow-var "
-                << p.var << " is used.";
-            CHECK(pats[i].notVarBits.isEmpty())
-                << "Var " << p.var << " is not used, but not-var "
-                << p.var << " is used.";
+            if (!pats[i].allowVarBits.isEmpty()) {
+                LOG(ERROR) << "Var " << p.var << " is not used, but allow-var "
+                           << p.var << " is used.";
+                return false;
+            }
+            if (!pats[i].notVarBits.isEmpty()) {
+                LOG(ERROR) << "Var " << p.var << " is not used, but not-var "
+                           << p.var << " is used.";
+                return false;
+            }
             continue;
         }
 
@@ -91,6 +121,7 @@ FieldPattern::FieldPattern(const string& field, const string& notPatternField)
     }
 
     numVariables_ = varCount;
+    return true;
 }
 
 bool FieldPattern::isBijectionMatchable() const
@@ -17,8 +17,14 @@ public:
         FieldBits notVarBits;
     };
 
+    // An empty pattern.
+    FieldPattern() {}
+    // Dies if the field is malformed. Use parse() for a field from a file.
     explicit FieldPattern(const std::string&, const std::string& notPatternField = std::string());
 
+    // Parses |field| and |notPatternField| into |pattern|. Returns false if they are malformed.
+    static bool parse(const std::string& field, const std::string& notPatternField, FieldPattern* pattern);
+
     bool isBijectionMatchable() const;
     // 'A' - 'Z' is 1, the others are 0.
     FieldBits patternBits() const;
@@ -37,7 +43,9 @@ public:
     std::string toDebugString() const;
 
 private:
-    int numVariables_;
+    bool init(const std::string& field, const std::string& notPatternField);
+
+    int numVariables_ = 0;
     FieldBits mustPatternBits_;
     FieldBits anyPatternBits_;
     FieldBits ironPatternBits_;
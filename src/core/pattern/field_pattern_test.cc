@@ -87,3 +87,17 @@ TEST(FieldPatternTest, mirror)
         ".....1"
         "......"), mirror.pattern(0).notVarBits);
 }
+
+TEST(FieldPatternTest, parse)
+{
+    FieldPattern pattern;
+    EXPECT_FALSE(FieldPattern::parse("AAB...", "..C...", &pattern));
+    EXPECT_TRUE(FieldPattern::parse("AAB...", "..B...", &pattern));
+    EXPECT_EQ(3, pattern.numVariables());
+
+    EXPECT_FALSE(FieldPattern::parse("AA!...", "", &pattern));
+    EXPECT_FALSE(FieldPattern::parse("AAa.b.", "", &pattern));
+    EXPECT_FALSE(FieldPattern::parse(string(6 * 14, 'A'), "", &pattern));
+    // |pattern| is not modified on failure.
+    EXPECT_EQ(3, pattern.numVariables());
+}
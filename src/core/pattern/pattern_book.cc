@@ -7,12 +7,13 @@ using namespace std;
 
 namespace {
 
-ColumnPuyoList diff(const CoreField& before, const BitField& after)
+// Returns the puyos that are in |after| and above |heights| of the field before.
+ColumnPuyoList diff(const int heights[FieldConstant::MAP_WIDTH], const BitField& after)
 {
     ColumnPuyoList cpl;
 
     for (int x = 1; x <= 6; ++x) {
-        for (int y = before.height(x) + 1; y <= 13; ++y) {
+        for (int y = heights[x] + 1; y <= 13; ++y) {
             PuyoColor pc = after.color(x, y);
             if (pc == PuyoColor::EMPTY)
                 break;
@@ -61,7 +62,13 @@ bool PatternBook::loadFromString(const string& str, bool ignoreDuplicate)
 
 bool PatternBook::loadFromValue(const toml::Value& patterns, bool ignoreDuplicate)
 {
-    const toml::Array& vs = patterns.find("pattern")->as<toml::Array>();
+    const toml::Value* patternsValue = patterns.find("pattern");
+    if (!patternsValue || !patternsValue->is<toml::Array>()) {
+        LOG(ERROR) << "pattern book should have an array of |pattern|";
+        return false;
+    }
+
+    const toml::Array& vs = patternsValue->as<toml::Array>();
     for (const toml::Value& v : vs) {
         string fieldStr;
         for (const auto& s : v.get<toml::Array>("field"))
@@ -78,10 +85,32 @@ bool PatternBook::loadFromValue(const toml::Value& patterns, bool ignoreDuplicat
             name = p->as<string>();
         }
 
+        // A pattern can have 13 rows at most.
+        const size_t maxLength = FieldConstant::WIDTH * (FieldConstant::HEIGHT + 1);
+        if (fieldStr.size() > maxLength || notFieldStr.size() > maxLength) {
+            LOG(ERROR) << "pattern should have 13 rows at most: " << name;
+            return false;
+        }
+        for (char c : fieldStr) {
+            if (c != '.' && c != '*' && c != '&' && !('A' <= c && c <= 'Z') && !('a' <= c && c <= 'z')) {
+                LOG(ERROR) << "Unacceptable variable " << c << " in field: " << fieldStr;
+                return false;
+            }
+        }
+        for (char c : notFieldStr) {
+            if (c != '.' && !('A' <= c && c <= 'Z')) {
+                LOG(ERROR) << "Unacceptable variable " << c << " in not_field: " << notFieldStr;
+                return false;
+            }
+        }
+
         int ignitionColumn = 0;
         if (const toml::Value* p = v.find("ignition")) {
             ignitionColumn = p->as<int>();
-            CHECK(1 <= ignitionColumn && ignitionColumn <= 6) << ignitionColumn;
+            if (ignitionColumn < 1 || 6 < ignitionColumn) {
+                LOG(ERROR) << "ignition should be in [1, 6]: " << ignitionColumn;
+                return false;
+            }
         }
 
         double score = 0;
@@ -90,8 +119,10 @@ bool PatternBook::loadFromValue(const toml::Value& patterns, bool ignoreDuplicat
                 score = p->as<int>();
             else if (p->is<double>())
                 score = p->as<double>();
-            else
-                CHECK(false);
+            else {
+                LOG(ERROR) << "score is not a number: " << name;
+                return false;
+            }
         }
 
         FieldBits mustBits;
@@ -99,6 +130,10 @@ bool PatternBook::loadFromValue(const toml::Value& patterns, bool ignoreDuplicat
             for (const auto& cp : p->as<toml::Array>()) {
                 int x = cp.get<int>(0);
                 int y = cp.get<int>(1);
+                if (x < 1 || FieldConstant::WIDTH < x || y < 1 || FieldConstant::HEIGHT + 1 < y) {
+                    LOG(ERROR) << "precondition is out of the field: (" << x << ", " << y << ") in " << name;
+                    return false;
+                }
                 mustBits.set(x, y);
             }
         }
@@ -115,8 +150,10 @@ bool PatternBook::loadFromValue(const toml::Value& patterns, bool ignoreDuplicat
             FieldBits notBits(notFieldStr, c);
 
             if (bits.isEmpty()) {
-                CHECK(allowFieldBits.isEmpty());
-                CHECK(notBits.isEmpty());
+                if (!allowFieldBits.isEmpty() || !notBits.isEmpty()) {
+                    LOG(ERROR) << "variable " << c << " is used without " << c << " in field: " << fieldStr;
+                    return false;
+                }
                 continue;
             }
 
@@ -141,8 +178,11 @@ bool PatternBook::loadFromValue(const toml::Value& patterns, bool ignoreDuplicat
             if (!mirrorTree->isLeaf())
                 mirrorTree->setLeaf(name, ironPatternBits.mirror(), mustBits.mirror(), mirrorIgnitionColumn, numVariables, score);
         } else {
-            CHECK(tree->setLeaf(name, ironPatternBits, mustBits, ignitionColumn, numVariables, score)) << fieldStr;
-            CHECK(mirrorTree->setLeaf(name, ironPatternBits.mirror(), mustBits.mirror(), mirrorIgnitionColumn, numVariables, score)) << fieldStr;
+            if (!tree->setLeaf(name, ironPatternBits, mustBits, ignitionColumn, numVariables, score) ||
+                !mirrorTree->setLeaf(name, ironPatternBits.mirror(), mustBits.mirror(), mirrorIgnitionColumn, numVariables, score)) {
+                LOG(ERROR) << "duplicated pattern: " << fieldStr;
+                return false;
+            }
         }
     }
 
@@ -150,16 +190,16 @@ bool PatternBook::loadFromValue(const toml::Value& patterns, bool ignoreDuplicat
 }
 
 void PatternBook::complement(const CoreField& originalField,
-                                const PatternBook::ComplementCallback& callback) const
+                             const PatternBook::ComplementCallback& callback) const
 {
-    complement(originalField, 0, callback);
+    complement(originalField.bitField(), 0, callback);
 }
 
 void PatternBook::complement(const CoreField& originalField,
-                                int allowedNumUnusedVariables,
-                                const ComplementCallback& callback) const
+                             int allowedNumUnusedVariables,
+                             const ComplementCallback& callback) const
 {
-    iterate(*root_, originalField, originalField.bitField(), FieldBits(), allowedNumUnusedVariables, 0, callback);
+    complement(originalField.bitField(), allowedNumUnusedVariables, callback);
 }
 
 void PatternBook::complement(const CoreField& originalField,
@@ -167,42 +207,70 @@ void PatternBook::complement(const CoreField& originalField,
                              int allowedNumUnusedVariables,
                              const ComplementCallback& callback) const
 {
+    complement(originalField.bitField(), ignitionBits, allowedNumUnusedVariables, callback);
+}
+
+void PatternBook::complement(const BitField& originalField,
+                             int allowedNumUnusedVariables,
+                             const ComplementCallback& callback) const
+{
+    alignas(16) int heights[FieldConstant::MAP_WIDTH];
+    originalField.calculateHeight(heights);
+
+    BitField currentField(originalField);
+    iterate(*root_, originalField, heights, &currentField, FieldBits(), allowedNumUnusedVariables, 0, callback);
+}
+
+void PatternBook::complement(const BitField& originalField,
+                             const FieldBits& ignitionBits,
+                             int allowedNumUnusedVariables,
+                             const ComplementCallback& callback) const
+{
+    alignas(16) int heights[FieldConstant::MAP_WIDTH];
+    originalField.calculateHeight(heights);
+
+    BitField currentField(originalField);
     for (const auto& entry : root_->children_) {
         if (entry.first.varBits() != ignitionBits)
             continue;
         // TODO(mayah): Probably, we don't need to check notBits.
-        iterate(*entry.second, originalField, originalField.bitField(),
+        iterate(*entry.second, originalField, heights, &currentField,
                 entry.first.varBits() & ignitionBits,
                 allowedNumUnusedVariables, 0, callback);
     }
 }
 
 void PatternBook::iterate(const PatternTree& tree,
-                          const CoreField& originalField,
-                          const BitField& currentField,
+                          const BitField& originalField,
+                          const int originalHeights[FieldConstant::MAP_WIDTH],
+                          BitField* currentField,
                           const FieldBits& matchedBits,
                           int allowedNumUnusedVariables,
                           int numUnusedVariables,
                           const ComplementCallback& callback) const
 {
+    // |currentField| is modified in place. Every puyo put here is removed before returning,
+    // so that |currentField| is the same as the caller's.
+    const FieldBits emptyBits = currentField->bits(PuyoColor::EMPTY);
+
     if (tree.isLeaf()) {
-        if ((tree.patternBookField().mustBits() & originalField.bitField().field13Bits()) == tree.patternBookField().mustBits()) {
-            BitField bf(currentField);
-            bf.setColorAllIfEmpty(tree.patternBookField().ironBits(), PuyoColor::IRON);
-            if (!bf.hasFloatingPuyo()) {
-                CoreField cf(bf);
-                callback(std::move(cf), diff(originalField, bf), numUnusedVariables, matchedBits, tree.patternBookField());
-            }
+        if ((tree.patternBookField().mustBits() & originalField.field13Bits()) == tree.patternBookField().mustBits()) {
+            const FieldBits ironBits = tree.patternBookField().ironBits() & emptyBits;
+            currentField->setColorAll(ironBits, PuyoColor::IRON);
+            if (!currentField->hasFloatingPuyo())
+                callback(*currentField, diff(originalHeights, *currentField), numUnusedVariables, matchedBits, tree.patternBookField());
+            currentField->setColorAll(ironBits, PuyoColor::EMPTY);
         }
     }
 
-    FieldBits ojamaBits = currentField.bits(PuyoColor::OJAMA);
+    // A variable cannot be put on ojama or iron.
+    const FieldBits blockedBits = currentField->bits(PuyoColor::OJAMA) | currentField->bits(PuyoColor::IRON);
     for (const auto& entry : tree.children_) {
         PuyoColor foundColor = PuyoColor::EMPTY;
         bool ok = true;
         FieldBits newMatchedBits(matchedBits);
         for (PuyoColor c : NORMAL_PUYO_COLORS) {
-            FieldBits matched = entry.first.varBits() & currentField.bits(c);
+            FieldBits matched = entry.first.varBits() & currentField->bits(c);
             if (matched.isEmpty())
                 continue;
             if (foundColor != PuyoColor::EMPTY) {
@@ -216,8 +284,7 @@ void PatternBook::iterate(const PatternTree& tree,
         if (!ok)
             continue;
 
-        // Check ojama.
-        if (!(entry.first.varBits() & ojamaBits).isEmpty())
+        if (!(entry.first.varBits() & blockedBits).isEmpty())
             continue;
 
         bool unusedVariableUsed = false;
@@ -227,7 +294,7 @@ void PatternBook::iterate(const PatternTree& tree,
 
             // TODO(mayah): Should check all colors?
             for (PuyoColor c : NORMAL_PUYO_COLORS) {
-                if ((entry.first.notBits() & currentField.bits(c)).isEmpty()) {
+                if ((entry.first.notBits() & currentField->bits(c)).isEmpty()) {
                     foundColor = c;
                     break;
                 }
@@ -239,12 +306,14 @@ void PatternBook::iterate(const PatternTree& tree,
             unusedVariableUsed = true;
         } else {
             // Check not bits.
-            if (!(entry.first.notBits() & currentField.bits(foundColor)).isEmpty())
+            if (!(entry.first.notBits() & currentField->bits(foundColor)).isEmpty())
                 continue;
         }
 
-        BitField bf(currentField);
-        bf.setColorAll(entry.first.varBits(), foundColor);
-        iterate(*entry.second, originalField, bf, newMatchedBits, allowedNumUnusedVariables, unusedVariableUsed ? numUnusedVariables + 1 : numUnusedVariables, callback);
+        const FieldBits putBits = entry.first.varBits() & emptyBits;
+        currentField->setColorAll(putBits, foundColor);
+        iterate(*entry.second, originalField, originalHeights, currentField, newMatchedBits,
+                allowedNumUnusedVariables, unusedVariableUsed ? numUnusedVariables + 1 : numUnusedVariables, callback);
+        currentField->setColorAll(putBits, PuyoColor::EMPTY);
     }
 }
@@ -11,6 +11,7 @@
 
 #include "base/noncopyable.h"
 #include "core/rensa/rensa_detector.h"
+#include "core/bit_field.h"
 #include "core/column_puyo_list.h"
 #include "core/core_field.h"
 #include "core/pattern/field_pattern.h"
@@ -20,7 +21,8 @@
 
 class PatternBook : noncopyable {
 public:
-    typedef std::function<void (CoreField&& complementedField,
+    // |complementedField| is valid only during the callback. Copy it if it's necessary later.
+    typedef std::function<void (const BitField& complementedField,
                                 const ColumnPuyoList& complementedPuyoList,
                                 int numFilledUnusedVariables,
                                 const FieldBits& matchedBits,
@@ -36,11 +38,14 @@ public:
     void complement(const CoreField&, const ComplementCallback&) const;
     void complement(const CoreField&, int allowedNumUnusedVariables, const ComplementCallback&) const;
     void complement(const CoreField&, const FieldBits& ignitionBits, int allowedNumUnusedVariables, const ComplementCallback&) const;
+    void complement(const BitField&, int allowedNumUnusedVariables, const ComplementCallback&) const;
+    void complement(const BitField&, const FieldBits& ignitionBits, int allowedNumUnusedVariables, const ComplementCallback&) const;
 
 private:
     void iterate(const PatternTree&,
-                 const CoreField& oridinalField,
-                 const BitField& currentField,
+                 const BitField& originalField,
+                 const int originalHeights[FieldConstant::MAP_WIDTH],
+                 BitField* currentField,
                  const FieldBits& matchedBits,
                  int allowedNumUnusedVariables,
                  int numUnusedVariables,
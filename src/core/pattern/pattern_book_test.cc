@@ -15,7 +15,7 @@ void testMatch(const char* book, const CoreField& original)
     ASSERT_TRUE(patternBook.loadFromString(book));
 
     bool found = false;
-    auto callback = [&](CoreField&& /*cf*/, const ColumnPuyoList& /*cpl*/,
+    auto callback = [&](const BitField& /*bf*/, const ColumnPuyoList& /*cpl*/,
                         int /*numFilledUnusedVariables*/, const FieldBits& /*matchedBits*/,
                         const PatternBookField& /*patternBookField*/) {
         found = true;
@@ -32,9 +32,10 @@ void testUnmatch(const char* book, const CoreField& original)
 
     bool found = false;
     CoreField foundField;
-    auto callback = [&](CoreField&& cf, const ColumnPuyoList& /*cpl*/,
+    auto callback = [&](const BitField& bf, const ColumnPuyoList& /*cpl*/,
                         int /*numFilledUnusedVariables*/, const FieldBits& /*matchedBits*/,
                         const PatternBookField& /*patternBookField*/) {
+        CoreField cf(bf);
         found = true;
         foundField = cf;
     };
@@ -52,9 +53,10 @@ void testComplement(const char* book, const CoreField& original,
     ASSERT_TRUE(patternBook.loadFromString(book));
 
     vector<bool> found(size);
-    auto callback = [&](CoreField&& cf, const ColumnPuyoList& /*cpl*/,
+    auto callback = [&](const BitField& bf, const ColumnPuyoList& /*cpl*/,
                         int /*numFilledUnusedVariables*/, const FieldBits& /*matchedBits*/,
                         const PatternBookField& /*patternBookField*/) {
+        CoreField cf(bf);
         bool expectedFound = false;
         for (size_t i = 0; i < size; ++i) {
             if (expected[i] == cf) {
@@ -83,9 +85,10 @@ void testComplementWithIgnitionBits(const char* book,
     ASSERT_TRUE(patternBook.loadFromString(book));
 
     vector<bool> found(size);
-    auto callback = [&](CoreField&& cf, const ColumnPuyoList& /*cpl*/,
+    auto callback = [&](const BitField& bf, const ColumnPuyoList& /*cpl*/,
                         int /*numFilledUnusedVariables*/, const FieldBits& /*matchedBits*/,
                         const PatternBookField& /*patternBookField*/) {
+        CoreField cf(bf);
         bool expectedFound = false;
         for (size_t i = 0; i < size; ++i) {
             if (expected[i] == cf) {
@@ -175,9 +178,10 @@ name = "GTR"
 
     bool found[ARRAY_SIZE(expected)] {};
 
-    auto callback = [&](CoreField&& cf, const ColumnPuyoList& cpl,
+    auto callback = [&](const BitField& bf, const ColumnPuyoList& cpl,
                         int numFilledUnusedVariables, const FieldBits& matchedBits,
                         const PatternBookField& patternBookField) {
+        CoreField cf(bf);
         for (size_t i = 0; i < ARRAY_SIZE(expected); ++i) {
             if (expected[i] != cf)
                 continue;
@@ -575,3 +579,76 @@ ignition = 2
 
     testUnmatch(BOOK, original);
 }
+
+TEST(PatternBookTest, invalid)
+{
+    static const char BOOK_WITH_INVALID_IGNITION[] = R"(
+[[pattern]]
+field = [
+    "AAA...",
+]
+ignition = 7
+)";
+
+    static const char BOOK_WITH_INVALID_PRECONDITION[] = R"(
+[[pattern]]
+field = [
+    "AAA...",
+]
+precondition = [[7, 1]]
+)";
+
+    static const char BOOK_WITH_INVALID_CHARACTER[] = R"(
+[[pattern]]
+field = [
+    "AA!...",
+]
+)";
+
+    static const char BOOK_WITH_UNUSED_NOT_FIELD[] = R"(
+[[pattern]]
+field = [
+    "AAA...",
+]
+not_field = [
+    "...B..",
+]
+)";
+
+    static const char BOOK_WITH_DUPLICATE[] = R"(
+[[pattern]]
+field = [
+    "AAA...",
+]
+
+[[pattern]]
+field = [
+    "AAA...",
+]
+)";
+
+    {
+        PatternBook patternBook;
+        EXPECT_FALSE(patternBook.loadFromString(BOOK_WITH_INVALID_IGNITION));
+    }
+    {
+        PatternBook patternBook;
+        EXPECT_FALSE(patternBook.loadFromString(BOOK_WITH_INVALID_PRECONDITION));
+    }
+    {
+        PatternBook patternBook;
+        EXPECT_FALSE(patternBook.loadFromString(BOOK_WITH_INVALID_CHARACTER));
+    }
+    {
+        PatternBook patternBook;
+        EXPECT_FALSE(patternBook.loadFromString(BOOK_WITH_UNUSED_NOT_FIELD));
+    }
+    {
+        PatternBook patternBook;
+        EXPECT_FALSE(patternBook.loadFromString(BOOK_WITH_DUPLICATE));
+    }
+    {
+        PatternBook patternBook;
+        EXPECT_FALSE(patternBook.loadFromString("foo = 1"));
+    }
+}
@@ -63,6 +63,7 @@ public:
 
     // Returns the column data. The result pointer should be 16-byte aligned.
     const PuyoColor* column(int x) const { return field_[x]; }
+    PuyoColor* mutableColumn(int x) { return field_[x]; }
 
     friend bool operator==(const PlainField&, const PlainField&);
 
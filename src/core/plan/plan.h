@@ -8,6 +8,7 @@
 #include "base/noncopyable.h"
 #include "core/core_field.h"
 #include "core/decision.h"
+#include "core/kumipuyo.h"
 #include "core/rensa_result.h"
 
 class KumipuyoSeq;
@@ -26,13 +27,31 @@ public:
     {
     }
 
+    // All the decisions. The first 11 decisions are enough for a kumipuyo whose axis and child
+    // have the same color.
+    static const Decision DECISIONS[22];
+
     typedef std::function<void (const RefPlan&)> IterationCallback;
     // if |kumipuyos.size()| < |depth|, we will add extra kumipuyo.
     static void iterateAvailablePlans(const CoreField&, const KumipuyoSeq&, int depth, const IterationCallback&);
+    // Same as above, but |callback| is inlined. A lambda will choose this.
+    template<typename Callback>
+    static void iterateAvailablePlans(const CoreField&, const KumipuyoSeq&, int depth, Callback callback);
 
     typedef std::function<void (const CoreField&, const std::vector<Decision>&,
                                 int numChigiri, int framesToIgnite, int lastDropFrames, bool shouldFire)> RensaIterationCallback;
     static void iterateAvailablePlansWithoutFiring(const CoreField&, const KumipuyoSeq&, int depth, const RensaIterationCallback&);
+    template<typename Callback>
+    static void iterateAvailablePlansWithoutFiring(const CoreField&, const KumipuyoSeq&, int depth, Callback callback);
+
+    // Visits the available plans with |visitor|, which can prune subtrees. PlanVisitor should have
+    //   bool shouldDescend(const CoreField& field, const std::vector<Decision>& decisions,
+    //                      int numChigiri, int totalFrames);
+    //     Called before trying the next kumipuyo on |field|. Returning false prunes the subtree.
+    //   void visit(const RefPlan& plan);
+    //     Called for each plan.
+    template<typename PlanVisitor>
+    static void visitAvailablePlans(const CoreField&, const KumipuyoSeq&, int depth, PlanVisitor* visitor);
 
     const CoreField& field() const { return field_; }
 
@@ -63,6 +82,19 @@ public:
 
     friend bool operator==(const Plan& lhs, const Plan& rhs);
 private:
+    template<typename Callback> class CallbackPlanVisitor;
+    template<typename PlanVisitor> class RefPlanWalker;
+    template<typename Callback> class RensaWalker;
+
+    // Drops kumipuyos on |field| and removes them after trying (make/unmake), so no field
+    // is copied while walking. |field| is restored when this returns.
+    template<typename Walker>
+    static void walkAvailablePlans(CoreField* field, const KumipuyoSeq&, std::vector<Decision>* decisions,
+                                   int currentDepth, int maxDepth, int currentNumChigiri, int totalFrames,
+                                   Walker* walker);
+
+    static const Kumipuyo ALL_KUMIPUYO_KINDS[10];
+
     CoreField field_;      // Future field (after the rensa has been finished).
     std::vector<Decision> decisions_;
     RensaResult rensaResult_;
@@ -141,4 +173,6 @@ private:
     bool hasZenkeshi_;
 };
 
+#include "plan_inl.h"
+
 #endif // CORE_PLAN_PLAN_H_
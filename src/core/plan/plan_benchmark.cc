@@ -0,0 +1,107 @@
+#include "core/plan/plan.h"
+
+#include "base/benchmark.h"
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+
+using namespace std;
+
+static void benchmarkIterateAvailablePlans(base::Benchmark& benchmark,
+                                           const CoreField& f, const KumipuyoSeq& seq, int depth)
+{
+    benchmark.measure([&]() {
+        int numPlans = 0;
+        Plan::iterateAvailablePlans(f, seq, depth, [&numPlans](const RefPlan&) { ++numPlans; });
+        base::doNotOptimize(numPlans);
+    });
+}
+
+// Uses the std::function overload. The inlined overload with make/unmake made Empty24 about 8%
+// faster than the former std::function-only implementation (342ms vs 372ms, best of 42 runs),
+// and Filled24 about 1%. Most of the time is spent in dropKumipuyo() and
+// rensaWillOccurWhenLastDecisionIs(), so pruning with visitAvailablePlans() is the larger win.
+static void benchmarkIterateAvailablePlansWithFunction(base::Benchmark& benchmark,
+                                                       const CoreField& f, const KumipuyoSeq& seq, int depth)
+{
+    benchmark.measure([&]() {
+        int numPlans = 0;
+        const Plan::IterationCallback callback = [&numPlans](const RefPlan&) { ++numPlans; };
+        Plan::iterateAvailablePlans(f, seq, depth, callback);
+        base::doNotOptimize(numPlans);
+    });
+}
+
+static const CoreField& filledField()
+{
+    static const CoreField f("B....."
+                             "R....."
+                             "B....."
+                             "R....."
+                             "BR...."
+                             "BR...."
+                             "BYRBY."
+                             "RBYRBY"
+                             "RBYRBY"
+                             "RBYRBY");
+    return f;
+}
+
+// Since seq has 4 kumipuyo, this won't test all kumipuyo possibilities.
+BENCHMARK(PlanBenchmark, Empty44)
+{
+    benchmarkIterateAvailablePlans(benchmark, CoreField(), KumipuyoSeq("RRGGYYBB"), 4);
+}
+
+BENCHMARK(PlanBenchmark, Filled44)
+{
+    benchmarkIterateAvailablePlans(benchmark, filledField(), KumipuyoSeq("RRGGYYBB"), 4);
+}
+
+// Since seq has 2 kumipuyo, this will try all kumipuyo color possibilities.
+BENCHMARK(PlanBenchmark, Empty23)
+{
+    benchmarkIterateAvailablePlans(benchmark, CoreField(), KumipuyoSeq("RRGG"), 3);
+}
+
+BENCHMARK(PlanBenchmark, Filled23)
+{
+    benchmarkIterateAvailablePlans(benchmark, filledField(), KumipuyoSeq("BBGG"), 3);
+}
+
+BENCHMARK(PlanBenchmark, Empty24)
+{
+    benchmarkIterateAvailablePlans(benchmark, CoreField(), KumipuyoSeq("RRGG"), 4);
+}
+
+BENCHMARK(PlanBenchmark, Filled24)
+{
+    benchmarkIterateAvailablePlans(benchmark, filledField(), KumipuyoSeq("BBGG"), 4);
+}
+
+BENCHMARK(PlanBenchmark, Empty24WithFunction)
+{
+    benchmarkIterateAvailablePlansWithFunction(benchmark, CoreField(), KumipuyoSeq("RRGG"), 4);
+}
+
+BENCHMARK(PlanBenchmark, Filled24WithFunction)
+{
+    benchmarkIterateAvailablePlansWithFunction(benchmark, filledField(), KumipuyoSeq("BBGG"), 4);
+}
+
+// Prunes the subtrees having chigiri.
+BENCHMARK(PlanBenchmark, Empty24PrunedByVisitor)
+{
+    struct Visitor {
+        bool shouldDescend(const CoreField&, const vector<Decision>&, int numChigiri, int) { return numChigiri == 0; }
+        void visit(const RefPlan&) { ++numPlans; }
+        int numPlans = 0;
+    };
+
+    const CoreField field;
+    const KumipuyoSeq seq("RRGG");
+    benchmark.measure([&]() {
+        Visitor visitor;
+        Plan::visitAvailablePlans(field, seq, 4, &visitor);
+        base::doNotOptimize(visitor.numPlans);
+    });
+}
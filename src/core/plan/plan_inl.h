@@ -0,0 +1,187 @@
+#ifndef CORE_PLAN_PLAN_INL_H_
+#define CORE_PLAN_PLAN_INL_H_
+
+#include <glog/logging.h>
+
+#include "core/drop_decision_table.h"
+#include "core/kumipuyo_seq.h"
+
+// Adapts a callback taking RefPlan to PlanVisitor. No subtree is pruned.
+template<typename Callback>
+class Plan::CallbackPlanVisitor {
+public:
+    explicit CallbackPlanVisitor(Callback& callback) : callback_(callback) {}
+
+    bool shouldDescend(const CoreField&, const std::vector<Decision>&, int /*numChigiri*/, int /*totalFrames*/)
+    {
+        return true;
+    }
+    void visit(const RefPlan& plan) { callback_(plan); }
+
+private:
+    Callback& callback_;
+};
+
+// Makes RefPlan from the field before rensa, and passes it to PlanVisitor.
+template<typename PlanVisitor>
+class Plan::RefPlanWalker {
+public:
+    explicit RefPlanWalker(PlanVisitor* visitor) : visitor_(visitor) {}
+
+    bool shouldDescend(const CoreField& field, const std::vector<Decision>& decisions, int numChigiri, int totalFrames)
+    {
+        return visitor_->shouldDescend(field, decisions, numChigiri, totalFrames);
+    }
+
+    void visitLeaf(const CoreField& fieldBeforeRensa, const std::vector<Decision>& decisions,
+                   int numChigiri, int framesToIgnite, int lastDropFrames, bool shouldFire)
+    {
+        DCHECK(!decisions.empty());
+
+        if (!shouldFire) {
+            DCHECK(fieldBeforeRensa.isEmpty(3, 12));
+            const RensaResult rensaResult;
+            visitor_->visit(RefPlan(fieldBeforeRensa, decisions, rensaResult, numChigiri,
+                                    framesToIgnite, lastDropFrames, 0, 0, 0, 0, false));
+            return;
+        }
+
+        // Since simulate() is destructive, we simulate on the scratch field.
+        scratchField_ = fieldBeforeRensa;
+        const RensaResult rensaResult = scratchField_.simulate();
+        DCHECK_GT(rensaResult.chains, 0);
+        if (scratchField_.isEmpty(3, 12)) {
+            visitor_->visit(RefPlan(scratchField_, decisions, rensaResult, numChigiri,
+                                    framesToIgnite, lastDropFrames, 0, 0, 0, 0, false));
+        }
+    }
+
+private:
+    PlanVisitor* visitor_;
+    CoreField scratchField_;
+};
+
+template<typename Callback>
+class Plan::RensaWalker {
+public:
+    explicit RensaWalker(Callback& callback) : callback_(callback) {}
+
+    bool shouldDescend(const CoreField&, const std::vector<Decision>&, int /*numChigiri*/, int /*totalFrames*/)
+    {
+        return true;
+    }
+
+    void visitLeaf(const CoreField& fieldBeforeRensa, const std::vector<Decision>& decisions,
+                   int numChigiri, int framesToIgnite, int lastDropFrames, bool shouldFire)
+    {
+        callback_(fieldBeforeRensa, decisions, numChigiri, framesToIgnite, lastDropFrames, shouldFire);
+    }
+
+private:
+    Callback& callback_;
+};
+
+// static
+template<typename Walker>
+void Plan::walkAvailablePlans(CoreField* field,
+                              const KumipuyoSeq& kumipuyoSeq,
+                              std::vector<Decision>* decisions,
+                              int currentDepth,
+                              int maxDepth,
+                              int currentNumChigiri,
+                              int totalFrames,
+                              Walker* walker)
+{
+    const Kumipuyo* ptr;
+    int n;
+
+    Kumipuyo tmp;
+    if (currentDepth < kumipuyoSeq.size()) {
+        tmp = kumipuyoSeq.get(currentDepth);
+        ptr = &tmp;
+        n = 1;
+    } else {
+        ptr = ALL_KUMIPUYO_KINDS;
+        n = 10;
+    }
+
+    const DropDecisionTable& table = DropDecisionTable::instance();
+    const unsigned int reachableBits = table.reachableDecisionBits(*field);
+
+    for (int j = 0; j < 22; j++) {
+        const Decision& decision = DECISIONS[j];
+        if (!DropDecisionTable::hasDecision(reachableBits, decision))
+            continue;
+
+        const int numChigiri = currentNumChigiri + field->isChigiriDecision(decision);
+        const int dropFrames = table.framesToDropNext(*field, decision);
+
+        decisions->push_back(decision);
+        for (int i = 0; i < n; ++i) {
+            const Kumipuyo& kumipuyo = ptr[i];
+            int num_decisions = (kumipuyo.axis == kumipuyo.child) ? 11 : 22;
+            if (j >= num_decisions)
+                continue;
+
+            if (!field->dropKumipuyo(decision, kumipuyo))
+                continue;
+
+            bool shouldFire = field->rensaWillOccurWhenLastDecisionIs(decision);
+            if (shouldFire || field->isEmpty(3, 12)) {
+                if (currentDepth + 1 == maxDepth || shouldFire) {
+                    walker->visitLeaf(*field, *decisions, numChigiri, totalFrames, dropFrames, shouldFire);
+                } else if (walker->shouldDescend(*field, *decisions, numChigiri, totalFrames + dropFrames)) {
+                    walkAvailablePlans(field, kumipuyoSeq, decisions, currentDepth + 1, maxDepth,
+                                       numChigiri, totalFrames + dropFrames, walker);
+                }
+            }
+
+            field->removePuyoFrom(decision.axisX());
+            field->removePuyoFrom(decision.childX());
+        }
+        decisions->pop_back();
+    }
+}
+
+// static
+template<typename PlanVisitor>
+void Plan::visitAvailablePlans(const CoreField& field,
+                               const KumipuyoSeq& kumipuyoSeq,
+                               int maxDepth,
+                               PlanVisitor* visitor)
+{
+    CoreField workingField(field);
+    std::vector<Decision> decisions;
+    decisions.reserve(maxDepth);
+
+    RefPlanWalker<PlanVisitor> walker(visitor);
+    walkAvailablePlans(&workingField, kumipuyoSeq, &decisions, 0, maxDepth, 0, 0, &walker);
+}
+
+// static
+template<typename Callback>
+void Plan::iterateAvailablePlans(const CoreField& field,
+                                 const KumipuyoSeq& kumipuyoSeq,
+                                 int maxDepth,
+                                 Callback callback)
+{
+    CallbackPlanVisitor<Callback> visitor(callback);
+    visitAvailablePlans(field, kumipuyoSeq, maxDepth, &visitor);
+}
+
+// static
+template<typename Callback>
+void Plan::iterateAvailablePlansWithoutFiring(const CoreField& field,
+                                              const KumipuyoSeq& kumipuyoSeq,
+                                              int maxDepth,
+                                              Callback callback)
+{
+    CoreField workingField(field);
+    std::vector<Decision> decisions;
+    decisions.reserve(maxDepth);
+
+    RensaWalker<Callback> walker(callback);
+    walkAvailablePlans(&workingField, kumipuyoSeq, &decisions, 0, maxDepth, 0, 0, &walker);
+}
+
+#endif // CORE_PLAN_PLAN_INL_H_
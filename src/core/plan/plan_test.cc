@@ -72,3 +72,85 @@ TEST(Plan, numChigiri)
 
     EXPECT_TRUE(found);
 }
+
+TEST(Plan, iterateAvailablePlansInlined)
+{
+    CoreField field("B....."
+                    "BR...."
+                    "BYRBY."
+                    "RBYRBY");
+    KumipuyoSeq seq("RRBY");
+
+    vector<Plan> expected;
+    Plan::IterationCallback callback = [&expected](const RefPlan& plan) {
+        expected.push_back(plan.toPlan());
+    };
+    Plan::iterateAvailablePlans(field, seq, 3, callback);
+
+    vector<Plan> actual;
+    Plan::iterateAvailablePlans(field, seq, 3, [&actual](const RefPlan& plan) {
+        actual.push_back(plan.toPlan());
+    });
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_TRUE(expected == actual);
+}
+
+TEST(Plan, iterateAvailablePlansWithoutFiringInlined)
+{
+    CoreField field("..RR..");
+    KumipuyoSeq seq("RRBB");
+
+    typedef pair<vector<Decision>, bool> Entry;
+    vector<Entry> expected;
+    Plan::RensaIterationCallback callback = [&expected](const CoreField&, const vector<Decision>& decisions,
+                                                        int, int, int, bool shouldFire) {
+        expected.emplace_back(decisions, shouldFire);
+    };
+    Plan::iterateAvailablePlansWithoutFiring(field, seq, 2, callback);
+
+    vector<Entry> actual;
+    Plan::iterateAvailablePlansWithoutFiring(field, seq, 2, [&actual](const CoreField& f, const vector<Decision>& decisions,
+                                                                      int, int, int, bool shouldFire) {
+        // The field should be the one before firing.
+        if (shouldFire)
+            EXPECT_TRUE(f.rensaWillOccurWhenLastDecisionIs(decisions.back()));
+        actual.emplace_back(decisions, shouldFire);
+    });
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, actual);
+}
+
+TEST(Plan, visitAvailablePlans)
+{
+    // Prunes the subtrees except the one of Decision(1, 2).
+    struct Visitor {
+        bool shouldDescend(const CoreField&, const vector<Decision>& decisions, int, int)
+        {
+            EXPECT_EQ(1U, decisions.size());
+            return decisions[0] == Decision(1, 2);
+        }
+        void visit(const RefPlan& plan)
+        {
+            if (plan.decisions().size() == 2) {
+                EXPECT_EQ(Decision(1, 2), plan.decision(0));
+                ++numDepth2Plans;
+            }
+            ++numPlans;
+        }
+
+        int numPlans = 0;
+        int numDepth2Plans = 0;
+    };
+
+    CoreField field;
+    KumipuyoSeq seq("RRBB");
+
+    Visitor visitor;
+    Plan::visitAvailablePlans(field, seq, 2, &visitor);
+
+    // Only one subtree is expanded, and RR has 11 decisions for BB.
+    EXPECT_EQ(11, visitor.numDepth2Plans);
+    EXPECT_EQ(11, visitor.numPlans);
+}
@@ -1,5 +1,6 @@
 #include "core/probability/column_puyo_list_probability.h"
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
 #include <iostream>
@@ -31,7 +32,9 @@ static double necessaryPuyosReverse(const ColumnPuyoList& cpl, unordered_map<Col
     //
     // s = (1 + \sum p_i s_i) / \sum p_i
 
-    auto it = m->find(cpl);
+    // The result doesn't depend on the color permutation, so only the canonical list is memoized.
+    const ColumnPuyoList key = cpl.canonicalize();
+    auto it = m->find(key);
     if (it != m->end())
         return it->second;
 
@@ -109,7 +112,7 @@ static double necessaryPuyosReverse(const ColumnPuyoList& cpl, unordered_map<Col
         }
 
         if (!puttable) {
-            (*m)[cpl] = numeric_limits<double>::infinity();
+            (*m)[key] = numeric_limits<double>::infinity();
             return numeric_limits<double>::infinity();
         }
 
@@ -125,53 +128,23 @@ static double necessaryPuyosReverse(const ColumnPuyoList& cpl, unordered_map<Col
     }
 
     double p = s / puttableCount;
-    (*m)[cpl] = p;
+    (*m)[key] = p;
     return p;
 }
 
-static void iter(int n, int leftX, ColumnPuyoList* cpl, unordered_map<ColumnPuyoList, double>* m)
+// Calls |callback| for each canonical ColumnPuyoList whose size is up to |n| in the
+// order of addition. Since the puyos are added column by column from the bottom, a puyo
+// can take one of the used colors or the next new color.
+template<typename Callback>
+static void iterateCanonical(int n, int leftX, int numUsedColors, ColumnPuyoList* cpl, Callback callback)
 {
-    necessaryPuyosReverse(*cpl, m);
+    callback(*cpl);
 
     for (int x = leftX; x <= 6; ++x) {
-        for (PuyoColor c : NORMAL_PUYO_COLORS) {
-            cpl->add(x, c);
+        for (int i = 0; i < NUM_NORMAL_PUYO_COLORS && i <= numUsedColors; ++i) {
+            cpl->add(x, NORMAL_PUYO_COLORS[i]);
             if (n > 0)
-                iter(n - 1, x, cpl, m);
-            cpl->removeTopFrom(x);
-        }
-    }
-}
-
-static void iterForSave(int n, int leftX, ColumnPuyoList* cpl, const unordered_map<ColumnPuyoList, double>& m,
-                        vector<double>* vs, size_t* index)
-{
-    auto it = m.find(*cpl);
-    CHECK(it != m.end()) << cpl->toString();
-    (*vs)[*index] = it->second;
-    *index += 1;
-
-    for (int x = leftX; x <= 6; ++x) {
-        for (PuyoColor c : NORMAL_PUYO_COLORS) {
-            cpl->add(x, c);
-            if (n > 0)
-                iterForSave(n - 1, x, cpl, m, vs, index);
-            cpl->removeTopFrom(x);
-        }
-    }
-}
-
-static void iterForLoad(int n, int leftX, ColumnPuyoList* cpl, unordered_map<ColumnPuyoList, double>* m,
-                        const vector<double>& vs, size_t* index)
-{
-    (*m)[*cpl] = vs[*index];
-    *index += 1;
-
-    for (int x = leftX; x <= 6; ++x) {
-        for (PuyoColor c : NORMAL_PUYO_COLORS) {
-            cpl->add(x, c);
-            if (n > 0)
-                iterForLoad(n - 1, x, cpl, m, vs, index);
+                iterateCanonical(n - 1, x, std::max(numUsedColors, i + 1), cpl, callback);
             cpl->removeTopFrom(x);
         }
     }
@@ -180,9 +153,9 @@ static void iterForLoad(int n, int leftX, ColumnPuyoList* cpl, unordered_map<Col
 ColumnPuyoListProbability::ColumnPuyoListProbability()
 {
     const int N = 6;
-    const string filename = "column-puyo-possibility-" + std::to_string(N) + ".dat";
+    const string filename = "column-puyo-possibility-canonical-" + std::to_string(N) + ".dat";
 
-    m_.reserve(1000000);
+    m_.reserve(100000);
 
     // try to read from the file.
     ifstream ifs(filename);
@@ -199,16 +172,26 @@ ColumnPuyoListProbability::ColumnPuyoListProbability()
 
         size_t index = 0;
         ColumnPuyoList initial;
-        iterForLoad(N, 1, &initial, &m_, vs, &index);
+        iterateCanonical(N, 1, 0, &initial, [&](const ColumnPuyoList& cpl) {
+            if (index < vs.size())
+                m_[cpl] = vs[index];
+            ++index;
+        });
 
-        return;
+        if (index == vs.size())
+            return;
+
+        LOG(WARNING) << filename << " looks broken. Making it again.";
+        m_.clear();
     }
 
     unordered_map<ColumnPuyoList, double> reverseMap;
-    reverseMap.reserve(1000000);
+    reverseMap.reserve(100000);
     ColumnPuyoList initial;
     reverseMap[initial] = 0.0;
-    iter(N, 1, &initial, &reverseMap);
+    iterateCanonical(N, 1, 0, &initial, [&](const ColumnPuyoList& cpl) {
+        necessaryPuyosReverse(cpl, &reverseMap);
+    });
 
     CHECK(initial.size() == 0);
 
@@ -221,16 +204,18 @@ ColumnPuyoListProbability::ColumnPuyoListProbability()
             }
         }
 
-        m_[cpl] = entry.second;
+        m_[cpl.canonicalize()] = entry.second;
     }
 
-    vector<double> vs(m_.size());
-    size_t index = 0;
-    iterForSave(N, 1, &initial, m_, &vs, &index);
+    vector<double> vs;
+    vs.reserve(m_.size());
+    iterateCanonical(N, 1, 0, &initial, [&](const ColumnPuyoList& cpl) {
+        auto it = m_.find(cpl);
+        CHECK(it != m_.end()) << cpl.toString();
+        vs.push_back(it->second);
+    });
     CHECK(initial.size() == 0);
 
-    CHECK_EQ(vs.size(), index);
-
     ofstream ofs(filename);
     ofs.write(reinterpret_cast<char*>(vs.data()), sizeof(double) * vs.size());
 }
@@ -244,7 +229,7 @@ const ColumnPuyoListProbability* ColumnPuyoListProbability::instanceSlow()
 
 double ColumnPuyoListProbability::necessaryKumipuyos(const ColumnPuyoList& cpl) const
 {
-    auto it = m_.find(cpl);
+    auto it = m_.find(cpl.canonicalize());
     if (it != m_.end())
         return it->second;
 
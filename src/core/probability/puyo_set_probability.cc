@@ -118,7 +118,7 @@ const PuyoSetProbability* PuyoSetProbability::instanceSlow()
     return s_instance.get();
 }
 
-int PuyoSetProbability::necessaryPuyos(const PuyoSet& puyoSet, const KumipuyoSeq& seq, double threshold) const
+int PuyoSetProbability::necessaryPuyos(const PuyoSet& puyoSet, KumipuyoSeqView seq, double threshold) const
 {
     PuyoSet ps(puyoSet);
 
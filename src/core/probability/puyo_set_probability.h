@@ -6,10 +6,9 @@
 #include <algorithm>
 
 #include "base/noncopyable.h"
+#include "core/kumipuyo_seq_view.h"
 #include "core/probability/puyo_set.h"
 
-class KumipuyoSeq;
-
 class PuyoSetProbability : noncopyable, nonmovable {
 public:
     // Returns PuyoSetProbability instance. This might take time.
@@ -52,7 +51,7 @@ public:
 
     // Returns the number of puyos to get |PuyoSet| with possibility |threshold|.
     // Some of kumipuyo seq is provided.
-    int necessaryPuyos(const PuyoSet&, const KumipuyoSeq&, double threshold) const;
+    int necessaryPuyos(const PuyoSet&, KumipuyoSeqView, double threshold) const;
 
 private:
     static const int MAX_N = 16;
@@ -1,12 +1,11 @@
 #include "core/puyo_controller.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
-#include <functional>
-#include <map>
-#include <queue>
+#include <mutex>
 #include <string>
-#include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -18,6 +17,7 @@
 #include "core/key.h"
 #include "core/kumipuyo_pos.h"
 #include "core/kumipuyo_moving_state.h"
+#include "core/plain_field.h"
 #include "core/puyo_color.h"
 
 using namespace std;
@@ -455,139 +455,324 @@ KeySetSeq PuyoController::findKeyStrokeFrom(const CoreField& field, const Kumipu
 
     if (!isReachableFrom(field, mks, decision))
         return KeySetSeq();
-    return findKeyStrokeByDijkstra(field, mks, decision);
+    return findKeyStrokeByDijkstraWithCache(field, mks, decision);
 }
 
-typedef KumipuyoMovingState Vertex;
+namespace {
+
+// KeyStrokeState is a KumipuyoMovingState packed into 29 bits. The fields are packed in
+// the same order as operator< of KumipuyoMovingState, so comparing two packed states
+// gives the same result as comparing the original states.
+typedef unsigned int KeyStrokeState;
+
+KeyStrokeState packState(const KumipuyoMovingState& mks)
+{
+    DCHECK(0 <= mks.pos.x && mks.pos.x < 8) << mks.pos.x;
+    DCHECK(0 <= mks.pos.y && mks.pos.y < 16) << mks.pos.y;
+    DCHECK(0 <= mks.restFramesToAcceptQuickTurn && mks.restFramesToAcceptQuickTurn < 32);
+    DCHECK(0 <= mks.restFramesForFreefall && mks.restFramesForFreefall < 32);
+    DCHECK(0 <= mks.numGrounded && mks.numGrounded < 16);
+
+    return (mks.pos.x << 26) |
+        (mks.pos.y << 22) |
+        (mks.pos.r << 20) |
+        (mks.restFramesTurnProhibited << 18) |
+        (mks.restFramesArrowProhibited << 16) |
+        (mks.restFramesToAcceptQuickTurn << 11) |
+        (mks.restFramesForFreefall << 6) |
+        (mks.numGrounded << 2) |
+        (mks.grounding << 1) |
+        (mks.grounded << 0);
+}
+
+KumipuyoMovingState unpackState(KeyStrokeState s)
+{
+    KumipuyoMovingState mks(KumipuyoPos((s >> 26) & 0x7, (s >> 22) & 0xF, (s >> 20) & 0x3));
+    mks.restFramesTurnProhibited = (s >> 18) & 0x3;
+    mks.restFramesArrowProhibited = (s >> 16) & 0x3;
+    mks.restFramesToAcceptQuickTurn = (s >> 11) & 0x1F;
+    mks.restFramesForFreefall = (s >> 6) & 0x1F;
+    mks.numGrounded = (s >> 2) & 0xF;
+    mks.grounding = (s >> 1) & 0x1;
+    mks.grounded = s & 0x1;
+    return mks;
+}
 
 typedef double Weight;
+
+struct KeyCandidate {
+    KeySet keySet;
+    Weight weight;
+};
+
+// We don't add KeySet(Key::DOWN) intentionally.
+const KeyCandidate KEY_CANDIDATES[] = {
+    { KeySet(), 1 },
+    { KeySet(Key::LEFT), 1.01 },
+    { KeySet(Key::RIGHT), 1.01 },
+    { KeySet(Key::LEFT, Key::LEFT_TURN), 1.03 },
+    { KeySet(Key::LEFT, Key::RIGHT_TURN), 1.03 },
+    { KeySet(Key::RIGHT, Key::LEFT_TURN), 1.03 },
+    { KeySet(Key::RIGHT, Key::RIGHT_TURN), 1.03 },
+    { KeySet(Key::LEFT_TURN), 1.01 },
+    { KeySet(Key::RIGHT_TURN), 1.01 },
+};
+
+const KeyCandidate KEY_CANDIDATES_WITHOUT_TURN[] = {
+    { KeySet(), 1 },
+    { KeySet(Key::LEFT), 1.01 },
+    { KeySet(Key::RIGHT), 1.01 },
+};
+
+const KeyCandidate KEY_CANDIDATES_WITHOUT_ARROW[] = {
+    { KeySet(), 1 },
+    { KeySet(Key::LEFT_TURN), 1.01 },
+    { KeySet(Key::RIGHT_TURN), 1.01 },
+};
+
+const KeyCandidate KEY_CANDIDATES_WITHOUT_TURN_OR_ARROW[] = {
+    { KeySet(), 1 },
+};
+
+// All the weights are multiples of 0.01, so we put edges into buckets by weight * 100.
+// Since every weight * 100 is less than this, a circular bucket queue of this size is enough.
+const int NUM_WEIGHT_BUCKETS = 128;
+
+int weightBucket(Weight weight)
+{
+    return static_cast<int>(std::lround(weight * 100));
+}
+
+// VisitedStates is an open addressing hash table from KeyStrokeState to the index of
+// the visited vertex.
+class VisitedStates {
+public:
+    VisitedStates() : keys_(INITIAL_CAPACITY, EMPTY), values_(INITIAL_CAPACITY) {}
+
+    // Returns -1 if |s| is not visited yet.
+    int find(KeyStrokeState s) const
+    {
+        for (size_t i = slot(s); ; i = (i + 1) & (keys_.size() - 1)) {
+            if (keys_[i] == s)
+                return values_[i];
+            if (keys_[i] == EMPTY)
+                return -1;
+        }
+    }
+
+    void insert(KeyStrokeState s, int value)
+    {
+        if ((size_ + 1) * 2 > keys_.size())
+            rehash(keys_.size() * 2);
+
+        size_t i = slot(s);
+        while (keys_[i] != EMPTY)
+            i = (i + 1) & (keys_.size() - 1);
+        keys_[i] = s;
+        values_[i] = value;
+        ++size_;
+    }
+
+private:
+    static const size_t INITIAL_CAPACITY = 1 << 12;
+    // Since KeyStrokeState has only 29 bits, this won't be a valid state.
+    static const KeyStrokeState EMPTY = ~0U;
+
+    size_t slot(KeyStrokeState s) const { return (s * 2654435761U) & (keys_.size() - 1); }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<KeyStrokeState> keys(capacity, EMPTY);
+        std::vector<int> values(capacity);
+        keys.swap(keys_);
+        values.swap(values_);
+        size_ = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] != EMPTY)
+                insert(keys[i], values[i]);
+        }
+    }
+
+    std::vector<KeyStrokeState> keys_;
+    std::vector<int> values_;
+    size_t size_ = 0;
+};
+
+struct Vertex {
+    KeyStrokeState state;
+    int parent;
+    KeySet keySet;
+};
+
 struct Edge {
-    Edge() {}
-    Edge(const Vertex& src, const Vertex& dest, Weight weight, const KeySet& keySet) :
-        src(src), dest(dest), weight(weight), keySet(keySet) {}
-
-    friend bool operator>(const Edge& lhs, const Edge& rhs) {
-        if (lhs.weight != rhs.weight) { return lhs.weight > rhs.weight; }
-        if (lhs.src != rhs.src) { return lhs.src > rhs.src; }
-        return lhs.dest > rhs.dest;
+    // Edges in the same bucket are ordered by (weight, src, dest).
+    friend bool operator<(const Edge& lhs, const Edge& rhs)
+    {
+        if (lhs.weight != rhs.weight)
+            return lhs.weight < rhs.weight;
+        if (lhs.src != rhs.src)
+            return lhs.src < rhs.src;
+        return lhs.dest < rhs.dest;
     }
 
-    Vertex src;
-    Vertex dest;
     Weight weight;
+    KeyStrokeState src;
+    KeyStrokeState dest;
+    int parent;
     KeySet keySet;
 };
 
-typedef vector<Edge> Edges;
-typedef map<Vertex, tuple<Vertex, KeySet, Weight>> Potential;
+// KeyStrokeCache caches the results of findKeyStrokeByDijkstra.
+// When a field doesn't have floating puyos, the result depends only on the column heights,
+// the moving state and the decision, so they are packed into the key.
+class KeyStrokeCache {
+public:
+    // Returns false if |field| cannot be cached.
+    static bool makeKey(const CoreField& field, const KumipuyoMovingState& mks, const Decision& decision,
+                        unsigned long long* key)
+    {
+        if (field.bitField().hasFloatingPuyo())
+            return false;
+
+        unsigned long long k = 0;
+        for (int x = 1; x <= FieldConstant::WIDTH; ++x)
+            k = (k << 4) | field.height(x);
+        k = (k << 29) | packState(mks);
+        k = (k << 5) | (decision.x << 2) | decision.r;
+        *key = k;
+        return true;
+    }
 
-KeySetSeq PuyoController::findKeyStrokeByDijkstra(const CoreField& field, const KumipuyoMovingState& initialState, const Decision& decision)
-{
-    // We don't add KeySet(Key::DOWN) intentionally.
-    static const pair<KeySet, double> KEY_CANDIDATES[] = {
-        make_pair(KeySet(), 1),
-        make_pair(KeySet(Key::LEFT), 1.01),
-        make_pair(KeySet(Key::RIGHT), 1.01),
-        make_pair(KeySet(Key::LEFT, Key::LEFT_TURN), 1.03),
-        make_pair(KeySet(Key::LEFT, Key::RIGHT_TURN), 1.03),
-        make_pair(KeySet(Key::RIGHT, Key::LEFT_TURN), 1.03),
-        make_pair(KeySet(Key::RIGHT, Key::RIGHT_TURN), 1.03),
-        make_pair(KeySet(Key::LEFT_TURN), 1.01),
-        make_pair(KeySet(Key::RIGHT_TURN), 1.01),
-    };
-    static const int KEY_CANDIDATES_SIZE = ARRAY_SIZE(KEY_CANDIDATES);
+    bool find(unsigned long long key, KeySetSeq* kss)
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = cache_.find(key);
+        if (it == cache_.end())
+            return false;
+        *kss = it->second;
+        return true;
+    }
 
-    static const pair<KeySet, double> KEY_CANDIDATES_WITHOUT_TURN[] = {
-        make_pair(KeySet(), 1),
-        make_pair(KeySet(Key::LEFT), 1.01),
-        make_pair(KeySet(Key::RIGHT), 1.01),
-    };
-    static const int KEY_CANDIDATES_SIZE_WITHOUT_TURN = ARRAY_SIZE(KEY_CANDIDATES_WITHOUT_TURN);
+    void insert(unsigned long long key, const KeySetSeq& kss)
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        // We don't need to be precise here. Just forget everything when the cache is full.
+        if (cache_.size() >= MAX_SIZE)
+            cache_.clear();
+        cache_.emplace(key, kss);
+    }
 
-    static const pair<KeySet, double> KEY_CANDIDATES_WITHOUT_ARROW[] = {
-        make_pair(KeySet(), 1),
-        make_pair(KeySet(Key::LEFT_TURN), 1.01),
-        make_pair(KeySet(Key::RIGHT_TURN), 1.01),
-    };
-    static const int KEY_CANDIDATES_SIZE_WITHOUT_ARROW = ARRAY_SIZE(KEY_CANDIDATES_WITHOUT_ARROW);
+private:
+    static const size_t MAX_SIZE = 1 << 14;
 
-    static const pair<KeySet, double> KEY_CANDIDATES_WITHOUT_TURN_OR_ARROW[] = {
-        make_pair(KeySet(), 1),
-    };
-    static const int KEY_CANDIDATES_SIZE_WITHOUT_TURN_OR_ARROW = ARRAY_SIZE(KEY_CANDIDATES_WITHOUT_TURN_OR_ARROW);
+    std::mutex mu_;
+    std::unordered_map<unsigned long long, KeySetSeq> cache_;
+};
 
-    PlainField plainField = field.toPlainField();
+} // anonymous namespace
 
-    Potential pot;
-    priority_queue<Edge, Edges, greater<Edge> > Q;
+KeySetSeq PuyoController::findKeyStrokeByDijkstra(const CoreField& field, const KumipuyoMovingState& initialState, const Decision& decision)
+{
+    PlainField plainField = field.toPlainField();
 
-    Vertex startV(initialState);
-    Q.push(Edge(startV, startV, 0, KeySet()));
+    std::vector<Vertex> vertices;
+    VisitedStates visited;
+    std::vector<Edge> buckets[NUM_WEIGHT_BUCKETS];
+    int numEdges = 0;
 
-    while (!Q.empty()) {
-        Edge edge = Q.top(); Q.pop();
-        Vertex p = edge.dest;
-        Weight curr = edge.weight;
+    const KeyStrokeState start = packState(initialState);
+    buckets[0].push_back(Edge { 0, start, start, -1, KeySet() });
+    ++numEdges;
 
-        // already visited?
-        if (pot.count(p))
+    for (int currBucket = 0; numEdges > 0; ++currBucket) {
+        std::vector<Edge>& bucket = buckets[currBucket % NUM_WEIGHT_BUCKETS];
+        if (bucket.empty())
             continue;
 
-        pot[p] = make_tuple(edge.src, edge.keySet, curr);
+        numEdges -= bucket.size();
+        std::stable_sort(bucket.begin(), bucket.end());
+
+        for (const Edge& edge : bucket) {
+            // already visited?
+            if (visited.find(edge.dest) >= 0)
+                continue;
+
+            const int index = static_cast<int>(vertices.size());
+            vertices.push_back(Vertex { edge.dest, edge.parent, edge.keySet });
+            visited.insert(edge.dest, index);
+
+            const KumipuyoMovingState p = unpackState(edge.dest);
 
-        // goal.
-        if (p.pos.axisX() == decision.x && p.pos.rot() == decision.r) {
             // goal.
-            vector<KeySet> kss;
-            kss.push_back(KeySet(Key::DOWN));
-            while (pot.count(p)) {
-                if (p == startV)
-                    break;
-                const KeySet ks(std::get<1>(pot[p]));
-                kss.push_back(ks);
-                p = std::get<0>(pot[p]);
+            if (p.pos.axisX() == decision.x && p.pos.rot() == decision.r) {
+                vector<KeySet> kss;
+                kss.push_back(KeySet(Key::DOWN));
+                for (int i = index; vertices[i].state != start; i = vertices[i].parent)
+                    kss.push_back(vertices[i].keySet);
+
+                reverse(kss.begin(), kss.end());
+                return KeySetSeq(kss);
             }
 
-            reverse(kss.begin(), kss.end());
-            return KeySetSeq(kss);
-        }
+            if (p.grounded)
+                continue;
 
-        if (p.grounded)
-            continue;
+            const KeyCandidate* candidates;
+            int size;
+            if (p.restFramesTurnProhibited > 0 && p.restFramesArrowProhibited > 0) {
+                candidates = KEY_CANDIDATES_WITHOUT_TURN_OR_ARROW;
+                size = ARRAY_SIZE(KEY_CANDIDATES_WITHOUT_TURN_OR_ARROW);
+            } else if (p.restFramesTurnProhibited > 0) {
+                candidates = KEY_CANDIDATES_WITHOUT_TURN;
+                size = ARRAY_SIZE(KEY_CANDIDATES_WITHOUT_TURN);
+            } else if (p.restFramesArrowProhibited > 0) {
+                candidates = KEY_CANDIDATES_WITHOUT_ARROW;
+                size = ARRAY_SIZE(KEY_CANDIDATES_WITHOUT_ARROW);
+            } else {
+                candidates = KEY_CANDIDATES;
+                size = ARRAY_SIZE(KEY_CANDIDATES);
+            }
 
-        const pair<KeySet, double>* candidates;
-        int size;
-        if (p.restFramesTurnProhibited > 0 && p.restFramesArrowProhibited > 0) {
-            candidates = KEY_CANDIDATES_WITHOUT_TURN_OR_ARROW;
-            size = KEY_CANDIDATES_SIZE_WITHOUT_TURN_OR_ARROW;
-        } else if (p.restFramesTurnProhibited > 0) {
-            candidates = KEY_CANDIDATES_WITHOUT_TURN;
-            size = KEY_CANDIDATES_SIZE_WITHOUT_TURN;
-        } else if (p.restFramesArrowProhibited > 0) {
-            candidates = KEY_CANDIDATES_WITHOUT_ARROW;
-            size = KEY_CANDIDATES_SIZE_WITHOUT_ARROW;
-        } else {
-            candidates = KEY_CANDIDATES;
-            size = KEY_CANDIDATES_SIZE;
+            for (int i = 0; i < size; ++i) {
+                const KeyCandidate& candidate = candidates[i];
+                KumipuyoMovingState mks(p);
+                bool downAccepted;
+                mks.moveKumipuyo(plainField, candidate.keySet, &downAccepted);
+
+                KeyStrokeState dest = packState(mks);
+                if (visited.find(dest) >= 0)
+                    continue;
+                // TODO(mayah): This is not correct. We'd like to prefer KeySet() to another key sequence a bit.
+                Weight weight = edge.weight + candidate.weight;
+                buckets[weightBucket(weight) % NUM_WEIGHT_BUCKETS].push_back(Edge { weight, edge.dest, dest, index, candidate.keySet });
+                ++numEdges;
+            }
         }
 
-        for (int i = 0; i < size; ++i) {
-            const pair<KeySet, double>& candidate = candidates[i];
-            KumipuyoMovingState mks(p);
-            bool downAccepted;
-            mks.moveKumipuyo(plainField, candidate.first, &downAccepted);
-
-            if (pot.count(mks))
-                continue;
-            // TODO(mayah): This is not correct. We'd like to prefer KeySet() to another key sequence a bit.
-            Q.push(Edge(p, mks, curr + candidate.second, candidate.first));
-        }
+        bucket.clear();
     }
 
     // No way...
     return KeySetSeq();
 }
 
+KeySetSeq PuyoController::findKeyStrokeByDijkstraWithCache(const CoreField& field, const KumipuyoMovingState& mks, const Decision& decision)
+{
+    static KeyStrokeCache cache;
+
+    unsigned long long key;
+    if (!KeyStrokeCache::makeKey(field, mks, decision, &key))
+        return findKeyStrokeByDijkstra(field, mks, decision);
+
+    KeySetSeq kss;
+    if (cache.find(key, &kss))
+        return kss;
+
+    kss = findKeyStrokeByDijkstra(field, mks, decision);
+    cache.insert(key, kss);
+    return kss;
+}
+
 KeySetSeq PuyoController::findKeyStrokeOnline(const CoreField& field, const KumipuyoMovingState& mks, const Decision& decision)
 {
     KeySetSeq kss = findKeyStrokeOnlineInternal(field, mks, decision);
@@ -26,6 +26,8 @@ private:
     static KeySetSeq findKeyStrokeOnline(const CoreField&, const KumipuyoMovingState&, const Decision&);
     // This is slow, but precise.
     static KeySetSeq findKeyStrokeByDijkstra(const CoreField&, const KumipuyoMovingState&, const Decision&);
+    // Same as findKeyStrokeByDijkstra, but the result is cached.
+    static KeySetSeq findKeyStrokeByDijkstraWithCache(const CoreField&, const KumipuyoMovingState&, const Decision&);
 };
 
 #endif  // CORE_PUYO_CONTROLLER_H_
@@ -0,0 +1,103 @@
+#include "core/puyo_controller.h"
+
+#include <glog/logging.h>
+
+#include "base/benchmark.h"
+#include "core/core_field.h"
+#include "core/decision.h"
+#include "core/drop_decision_table.h"
+
+using namespace std;
+
+BENCHMARK(PuyoControllerBenchmark, empty)
+{
+    const CoreField f;
+
+    benchmark.measure([&]() {
+        base::doNotOptimize(PuyoController::findKeyStroke(f, Decision(6, 3)));
+    });
+}
+
+BENCHMARK(PuyoControllerBenchmark, unreachable)
+{
+    const CoreField f(
+        " O O  "
+        " O O  " // 12
+        " O O  "
+        " O O  "
+        " O O  "
+        " O O  " // 8
+        " O O  "
+        " O O  "
+        " O O  "
+        " O O  " // 4
+        " O O  "
+        " O O  "
+        " O O  ");
+
+    benchmark.measure([&]() {
+        base::doNotOptimize(PuyoController::findKeyStroke(f, Decision(6, 3)));
+    });
+}
+
+static void benchmarkReachability(base::Benchmark& benchmark, const CoreField& f)
+{
+    static const Decision DECISIONS[] = {
+        Decision(2, 3), Decision(3, 3), Decision(3, 1), Decision(4, 1),
+        Decision(5, 1), Decision(1, 2), Decision(2, 2), Decision(3, 2),
+        Decision(4, 2), Decision(5, 2), Decision(6, 2), Decision(1, 1),
+        Decision(2, 1), Decision(4, 3), Decision(5, 3), Decision(6, 3),
+        Decision(1, 0), Decision(2, 0), Decision(3, 0), Decision(4, 0),
+        Decision(5, 0), Decision(6, 0),
+    };
+
+    const DropDecisionTable& table = DropDecisionTable::instance();
+
+    auto controllerFrames = [&]() {
+        int frames = 0;
+        for (const Decision& d : DECISIONS) {
+            if (PuyoController::isReachable(f, d))
+                frames += f.framesToDropNext(d);
+        }
+        return frames;
+    };
+
+    auto tableFrames = [&]() {
+        int frames = 0;
+        unsigned int bits = table.reachableDecisionBits(f);
+        for (const Decision& d : DECISIONS) {
+            if (DropDecisionTable::hasDecision(bits, d))
+                frames += table.framesToDropNext(f, d);
+        }
+        return frames;
+    };
+
+    CHECK_EQ(controllerFrames(), tableFrames());
+
+    benchmark.measure("PuyoController", [&]() { base::doNotOptimize(controllerFrames()); });
+    benchmark.measure("DropDecisionTable", [&]() { base::doNotOptimize(tableFrames()); });
+}
+
+BENCHMARK(PuyoControllerBenchmark, reachabilityOnEmptyField)
+{
+    benchmarkReachability(benchmark, CoreField());
+}
+
+BENCHMARK(PuyoControllerBenchmark, reachabilityOnHighField)
+{
+    const CoreField f(
+        "    O "
+        "OO OOO" // 12
+        "OO OOO"
+        "OO OOO"
+        "OO OOO"
+        "OO OOO" // 8
+        "OO OOO"
+        "OO OOO"
+        "OO OOO"
+        "OO OOO" // 4
+        "OO OOO"
+        "OO OOO"
+        "OO OOO");
+    benchmarkReachability(benchmark, f);
+}
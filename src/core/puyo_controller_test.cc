@@ -959,3 +959,55 @@ TEST(PuyoControllerTest, reachable6)
         }
     }
 }
+
+TEST(PuyoControllerTest, findKeyStrokeFrom)
+{
+    CoreField f(
+        "......" // 12
+        "......"
+        ".....O"
+        "OOOOOO"
+        "OOOOOO" // 8
+        "OOOOOO"
+        "OOOOOO"
+        "OOOOOO"
+        "OOOOOO" // 4
+        "OOOOOO"
+        "OOOOOO"
+        "OOOOOO");
+
+    KumipuyoMovingState kms1(KumipuyoPos(1, 11, 0));
+    EXPECT_EQ(KeySetSeq("v"), PuyoController::findKeyStrokeFrom(f, kms1, Decision(1, 0)));
+    EXPECT_EQ(KeySetSeq("B,>,,,B,v"), PuyoController::findKeyStrokeFrom(f, kms1, Decision(3, 2)));
+    EXPECT_EQ(KeySetSeq(">,A,,,>,,,,>,v"), PuyoController::findKeyStrokeFrom(f, kms1, Decision(4, 1)));
+
+    KumipuyoMovingState kms2(KumipuyoPos(5, 10, 1));
+    EXPECT_EQ(KeySetSeq("<,B,,,<,,,,<,,,,<,v"), PuyoController::findKeyStrokeFrom(f, kms2, Decision(1, 0)));
+    EXPECT_EQ(KeySetSeq("A,,,,>A,v"), PuyoController::findKeyStrokeFrom(f, kms2, Decision(6, 3)));
+    EXPECT_EQ(KeySetSeq("<,v"), PuyoController::findKeyStrokeFrom(f, kms2, Decision(4, 1)));
+
+    KumipuyoMovingState kms3(KumipuyoPos(3, 11, 2));
+    EXPECT_EQ(KeySetSeq("<B,,,,<B,v"), PuyoController::findKeyStrokeFrom(f, kms3, Decision(1, 0)));
+    EXPECT_EQ(KeySetSeq("v"), PuyoController::findKeyStrokeFrom(f, kms3, Decision(3, 2)));
+    EXPECT_EQ(KeySetSeq(">B,v"), PuyoController::findKeyStrokeFrom(f, kms3, Decision(4, 1)));
+
+    // The key stroke is frame by frame. The second call should return the same (cached) result.
+    PlainField pf = f.toPlainField();
+    for (int i = 0; i < 2; ++i) {
+        for (int x = 1; x <= 6; ++x) {
+            for (int r = 0; r < 4; ++r) {
+                Decision d(x, r);
+                if (!d.isValid())
+                    continue;
+                KumipuyoMovingState kms(kms2);
+                KeySetSeq kss = PuyoController::findKeyStrokeFrom(f, kms, d);
+                EXPECT_FALSE(kss.empty()) << d;
+                bool downAccepted;
+                for (const auto& ks : kss)
+                    kms.moveKumipuyo(pf, ks, &downAccepted);
+                EXPECT_EQ(x, kms.pos.x) << d;
+                EXPECT_EQ(r, kms.pos.r) << d;
+            }
+        }
+    }
+}
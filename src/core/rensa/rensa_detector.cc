@@ -3,10 +3,14 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <string>
+#include <vector>
 
 #include "base/base.h"
+#include "base/executor.h"
+#include "base/time.h"
 #include "core/column_puyo.h"
 #include "core/column_puyo_list.h"
 #include "core/core_field.h"
@@ -475,24 +479,122 @@ void RensaDetector::detectIteratively(const CoreField& originalField,
     DCHECK_LE(1, maxIteration);
 
     auto detectCallback = [&](CoreField&& complementedField, const ColumnPuyoList& firePuyos) {
-        CoreField cf(complementedField);
-        RensaLastVanishedPositionTracker tracker;
+        detectIterativelyFromFireCandidate(originalField, strategy, maxIteration,
+                                           std::move(complementedField), firePuyos, callback);
+    };
 
-        int chains = cf.simulateFast(&tracker);
-        if (chains == 0)
-            return;
+    bool prohibits[FieldConstant::MAP_WIDTH] {};
+    detect(originalField, strategy, PurposeForFindingRensa::FOR_FIRE, prohibits, detectCallback);
+}
 
-        (void)callback(std::move(complementedField), firePuyos);
+namespace {
 
-        // Don't put key puyo on the column which fire puyo will be placed.
-        bool prohibits[FieldConstant::MAP_WIDTH] {};
-        makeProhibitArray(originalField, strategy, tracker.result(), firePuyos, prohibits);
-        detectIterativelyInternal(originalField, strategy, cf, maxIteration - 1,
-                                  ColumnPuyoList(), firePuyos, chains, prohibits, callback);
+// The state shared by the threads running detectIterativelyInParallel.
+struct ParallelDetectionState {
+    struct Complemented {
+        Complemented(const CoreField& field, const ColumnPuyoList& puyos) : field(field), puyos(puyos) {}
+
+        CoreField field;
+        ColumnPuyoList puyos;
     };
 
+    ParallelDetectionState(const CoreField& originalField, const RensaDetectorStrategy& strategy,
+                           int maxIteration, double deadline) :
+        originalField(originalField), strategy(strategy), maxIteration(maxIteration), deadline(deadline)
+    {
+    }
+
+    const CoreField& originalField;
+    const RensaDetectorStrategy& strategy;
+    const int maxIteration;
+    const double deadline;
+
+    // The fire candidates of the first iteration, and the rensas detected from each of them.
+    std::vector<Complemented> candidates;
+    std::vector<std::vector<Complemented>> detected;
+
+    std::atomic<size_t> nextCandidate { 0 };
+    std::atomic<bool> timedOut { false };
+};
+
+} // anonymous namespace
+
+// static
+bool RensaDetector::detectIterativelyInParallel(const CoreField& originalField,
+                                                const RensaDetectorStrategy& strategy,
+                                                int maxIteration,
+                                                Executor* executor,
+                                                double deadline,
+                                                const RensaSimulationCallback& callback)
+{
+    DCHECK_LE(1, maxIteration);
+
+    typedef ParallelDetectionState::Complemented Complemented;
+    ParallelDetectionState state(originalField, strategy, maxIteration, deadline);
+
+    auto detectCallback = [&](CoreField&& complementedField, const ColumnPuyoList& firePuyos) {
+        state.candidates.emplace_back(complementedField, firePuyos);
+    };
     bool prohibits[FieldConstant::MAP_WIDTH] {};
     detect(originalField, strategy, PurposeForFindingRensa::FOR_FIRE, prohibits, detectCallback);
+    state.detected.resize(state.candidates.size());
+
+    // Takes the candidates one by one, and records the detected rensas of each candidate.
+    auto work = [](ParallelDetectionState* s) {
+        for (size_t i = s->nextCandidate++; i < s->candidates.size(); i = s->nextCandidate++) {
+            if (s->timedOut || s->deadline < currentTime()) {
+                s->timedOut = true;
+                return;
+            }
+
+            vector<Complemented>* detected = &s->detected[i];
+            auto recordCallback = [s, detected](CoreField&& cf, const ColumnPuyoList& cpl) -> RensaResult {
+                if (s->deadline < currentTime()) {
+                    s->timedOut = true;
+                    return RensaResult();
+                }
+                detected->emplace_back(cf, cpl);
+                return cf.simulate();
+            };
+            detectIterativelyFromFireCandidate(s->originalField, s->strategy, s->maxIteration,
+                                               std::move(s->candidates[i].field), s->candidates[i].puyos,
+                                               recordCallback);
+        }
+    };
+
+    Executor::runWithHelpers(executor, static_cast<int>(state.candidates.size()),
+                             [&state, &work]() { work(&state); });
+
+    for (vector<Complemented>& detected : state.detected) {
+        for (Complemented& c : detected)
+            (void)callback(std::move(c.field), c.puyos);
+    }
+
+    return !state.timedOut;
+}
+
+// static
+void RensaDetector::detectIterativelyFromFireCandidate(const CoreField& originalField,
+                                                       const RensaDetectorStrategy& strategy,
+                                                       int maxIteration,
+                                                       CoreField&& complementedField,
+                                                       const ColumnPuyoList& firePuyos,
+                                                       const RensaSimulationCallback& callback)
+{
+    CoreField cf(complementedField);
+    RensaLastVanishedPositionTracker tracker;
+
+    int chains = cf.simulateFast(&tracker);
+    if (chains == 0)
+        return;
+
+    (void)callback(std::move(complementedField), firePuyos);
+
+    // Don't put key puyo on the column which fire puyo will be placed.
+    bool prohibits[FieldConstant::MAP_WIDTH] {};
+    makeProhibitArray(originalField, strategy, tracker.result(), firePuyos, prohibits);
+    detectIterativelyInternal(originalField, strategy, cf, maxIteration - 1,
+                              ColumnPuyoList(), firePuyos, chains, prohibits, callback);
 }
 
 // static
@@ -10,6 +10,7 @@
 #include "core/rensa_tracker/rensa_last_vanished_position_tracker.h"
 
 class ColumnPuyoList;
+class Executor;
 struct RensaResult;
 
 enum class PurposeForFindingRensa {
@@ -43,6 +44,19 @@ public:
                                   int maxIteration,
                                   const RensaSimulationCallback&);
 
+    // Same as detectIteratively(), but the rensas from each fire candidate of the first
+    // iteration are detected in parallel with |executor| (the calling thread also works).
+    // |callback| is called in the calling thread, in the same order as detectIteratively().
+    // Unlike detectIteratively(), the return value of |callback| is not used to prune;
+    // CoreField::simulate() is used instead. When |executor| is nullptr, this works serially.
+    // When currentTime() passes |deadline|, the rest is not detected, and false is returned.
+    static bool detectIterativelyInParallel(const CoreField&,
+                                            const RensaDetectorStrategy&,
+                                            int maxIteration,
+                                            Executor* executor,
+                                            double deadline,
+                                            const RensaSimulationCallback&);
+
     // Finds 2-double (or more).
     static void detectSideChain(const CoreField&,
                                 const RensaDetectorStrategy&,
@@ -99,6 +113,15 @@ public:
                                   bool prohibits[FieldConstant::MAP_WIDTH]);
 
 private:
+    // Detects rensas iteratively from |complementedField|, which is |originalField| with
+    // |firePuyos| complemented.
+    static void detectIterativelyFromFireCandidate(const CoreField& originalField,
+                                                   const RensaDetectorStrategy& strategy,
+                                                   int maxIteration,
+                                                   CoreField&& complementedField,
+                                                   const ColumnPuyoList& firePuyos,
+                                                   const RensaSimulationCallback&);
+
     static void detectIterativelyInternal(const CoreField& originalField,
                                           const RensaDetectorStrategy& strategy,
                                           const CoreField& currentField,
@@ -0,0 +1,64 @@
+#include "core/rensa/rensa_detector.h"
+
+#include <limits>
+#include <memory>
+
+#include "base/benchmark.h"
+#include "base/executor.h"
+#include "core/core_field.h"
+
+class ColumnPuyoList;
+
+using namespace std;
+
+static void benchmarkDetectIteratively(base::Benchmark& benchmark, const RensaDetectorStrategy& strategy)
+{
+    const CoreField original(
+        "  R G "
+        "R GRBG"
+        "RBGRBG"
+        "RBGRBG");
+
+    auto callback = [&](CoreField&& cf, const ColumnPuyoList&) -> RensaResult {
+        return cf.simulate();
+    };
+
+    benchmark.measure([&]() {
+        RensaDetector::detectIteratively(original, strategy, 3, callback);
+    });
+}
+
+BENCHMARK(RensaDetectorBenchmark, detectIteratively_Drop)
+{
+    benchmarkDetectIteratively(benchmark, RensaDetectorStrategy::defaultDropStrategy());
+}
+
+BENCHMARK(RensaDetectorBenchmark, detectIteratively_Float)
+{
+    benchmarkDetectIteratively(benchmark, RensaDetectorStrategy::defaultFloatStrategy());
+}
+
+BENCHMARK(RensaDetectorBenchmark, detectIteratively_Extend)
+{
+    benchmarkDetectIteratively(benchmark, RensaDetectorStrategy::defaultExtendStrategy());
+}
+
+BENCHMARK(RensaDetectorBenchmark, detectIterativelyInParallel_Extend)
+{
+    const CoreField original(
+        "  R G "
+        "R GRBG"
+        "RBGRBG"
+        "RBGRBG");
+
+    auto callback = [&](CoreField&& cf, const ColumnPuyoList&) -> RensaResult {
+        return cf.simulate();
+    };
+
+    unique_ptr<Executor> executor(new Executor(4));
+    executor->start();
+    benchmark.measure([&]() {
+        RensaDetector::detectIterativelyInParallel(original, RensaDetectorStrategy::defaultExtendStrategy(), 3,
+                                                   executor.get(), numeric_limits<double>::infinity(), callback);
+    });
+}
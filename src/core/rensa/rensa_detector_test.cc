@@ -3,10 +3,15 @@
 #include <gtest/gtest.h>
 
 #include <cstddef>
+#include <limits>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/base.h"
+#include "base/executor.h"
+#include "base/time.h"
 #include "core/column_puyo.h"
 #include "core/column_puyo_list.h"
 #include "core/core_field.h"
@@ -711,6 +716,64 @@ TEST(RensaDetectorTest, detectIteratively_DontCrash)
     RensaDetector::detectIteratively(original, RensaDetectorStrategy::defaultDropStrategy(), 2, callback);
 }
 
+TEST(RensaDetectorTest, detectIterativelyInParallel)
+{
+    const CoreField original(
+        "  R G "
+        "R GRBG"
+        "RBGRBG"
+        "RBGRBG");
+
+    vector<pair<CoreField, ColumnPuyoList>> expected;
+    auto expectedCallback = [&](CoreField&& complementedField, const ColumnPuyoList& cpl) -> RensaResult {
+        expected.emplace_back(complementedField, cpl);
+        return complementedField.simulate();
+    };
+    RensaDetector::detectIteratively(original, RensaDetectorStrategy::defaultDropStrategy(), 3, expectedCallback);
+    ASSERT_FALSE(expected.empty());
+
+    unique_ptr<Executor> executor(new Executor(4));
+    executor->start();
+    for (Executor* e : vector<Executor*> { nullptr, executor.get() }) {
+        vector<pair<CoreField, ColumnPuyoList>> actual;
+        auto callback = [&](CoreField&& complementedField, const ColumnPuyoList& cpl) -> RensaResult {
+            actual.emplace_back(complementedField, cpl);
+            return complementedField.simulate();
+        };
+        EXPECT_TRUE(RensaDetector::detectIterativelyInParallel(
+            original, RensaDetectorStrategy::defaultDropStrategy(), 3,
+            e, numeric_limits<double>::infinity(), callback));
+
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(expected[i].first, actual[i].first) << i;
+            EXPECT_EQ(expected[i].second, actual[i].second) << i;
+        }
+    }
+}
+
+TEST(RensaDetectorTest, detectIterativelyInParallel_deadline)
+{
+    const CoreField original(
+        "  R G "
+        "R GRBG"
+        "RBGRBG"
+        "RBGRBG");
+
+    int numCalled = 0;
+    auto callback = [&](CoreField&& complementedField, const ColumnPuyoList&) -> RensaResult {
+        ++numCalled;
+        return complementedField.simulate();
+    };
+
+    unique_ptr<Executor> executor(new Executor(2));
+    executor->start();
+    EXPECT_FALSE(RensaDetector::detectIterativelyInParallel(
+        original, RensaDetectorStrategy::defaultDropStrategy(), 3,
+        executor.get(), currentTime() - 1.0, callback));
+    EXPECT_EQ(0, numCalled);
+}
+
 TEST(RensaDetectorTest, complementKeyPuyosOn13thRow1)
 {
     CoreField original;
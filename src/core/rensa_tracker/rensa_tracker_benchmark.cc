@@ -0,0 +1,43 @@
+#include <glog/logging.h>
+
+#include "base/base.h"
+#include "base/benchmark.h"
+#include "core/core_field.h"
+#include "core/rensa_tracker/rensa_chain_tracker.h"
+
+using namespace std;
+
+BENCHMARK(RensaTrackerBenchmark, filled)
+{
+    const CoreField original(".G.BRG"
+                             "GBRRYR"
+                             "RRYYBY"
+                             "RGYRBR"
+                             "YGYRBY"
+                             "YGBGYR"
+                             "GRBGYR"
+                             "BRBYBY"
+                             "RYYBYY"
+                             "BRBYBR"
+                             "BGBYRR"
+                             "YGBGBG"
+                             "RBGBGG");
+
+    const int expectedChain = CoreField(original).simulate().chains;
+    {
+        CoreField cf(original);
+        RensaChainTracker tracker;
+        CHECK_EQ(expectedChain, cf.simulate(&tracker).chains);
+    }
+
+    benchmark.measureWithSetup("CoreField",
+                               [&]() { return CoreField(original); },
+                               [](CoreField& cf) { base::doNotOptimize(cf.simulate()); });
+
+    benchmark.measureWithSetup("CoreField+RensaChainTracker",
+                               [&]() { return CoreField(original); },
+                               [](CoreField& cf) {
+                                   RensaChainTracker tracker;
+                                   base::doNotOptimize(cf.simulate(&tracker));
+                               });
+}
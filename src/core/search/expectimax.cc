@@ -0,0 +1,209 @@
+#include "core/search/expectimax.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "core/drop_decision_table.h"
+#include "core/kumipuyo_seq.h"
+#include "core/plan/plan.h"
+
+using namespace std;
+
+namespace {
+
+// A mixed pair covers both of the orders, e.g. RB and BR.
+const struct {
+    Kumipuyo kumipuyo;
+    double probability;
+} KUMIPUYO_KINDS[] = {
+    { Kumipuyo(PuyoColor::RED, PuyoColor::RED), 1.0 / 16 },
+    { Kumipuyo(PuyoColor::RED, PuyoColor::BLUE), 2.0 / 16 },
+    { Kumipuyo(PuyoColor::RED, PuyoColor::YELLOW), 2.0 / 16 },
+    { Kumipuyo(PuyoColor::RED, PuyoColor::GREEN), 2.0 / 16 },
+    { Kumipuyo(PuyoColor::BLUE, PuyoColor::BLUE), 1.0 / 16 },
+    { Kumipuyo(PuyoColor::BLUE, PuyoColor::YELLOW), 2.0 / 16 },
+    { Kumipuyo(PuyoColor::BLUE, PuyoColor::GREEN), 2.0 / 16 },
+    { Kumipuyo(PuyoColor::YELLOW, PuyoColor::YELLOW), 1.0 / 16 },
+    { Kumipuyo(PuyoColor::YELLOW, PuyoColor::GREEN), 2.0 / 16 },
+    { Kumipuyo(PuyoColor::GREEN, PuyoColor::GREEN), 1.0 / 16 },
+};
+
+const int NUM_KUMIPUYO_KINDS = 10;
+
+const double INF = numeric_limits<double>::infinity();
+
+} // anonymous namespace
+
+Expectimax::Result Expectimax::search(const CoreField& field, const KumipuyoSeq& seq)
+{
+    CHECK(!seq.isEmpty());
+    CHECK_LE(1, config_.depth);
+
+    field_ = field;
+    seq_ = &seq;
+    decisions_.clear();
+    numChigiri_ = 0;
+    totalFrames_ = 0;
+    cache_.assign(config_.depth, unordered_map<CoreField, double>());
+    result_ = Result();
+
+    Decision decision;
+    double value = searchMaxNode(0, seq.front(), -INF, INF, false, &decision);
+
+    Result result = result_;
+    result.decision = decision;
+    result.value = value;
+    return result;
+}
+
+double Expectimax::searchNode(int depth, double alpha, double beta)
+{
+    if (depth < seq_->size())
+        return searchMaxNode(depth, seq_->get(depth), alpha, beta, false, nullptr);
+    return searchChanceNode(depth, alpha, beta);
+}
+
+double Expectimax::searchMaxNode(int depth, const Kumipuyo& kumipuyo, double alpha, double beta,
+                                 bool probes, Decision* bestDecision)
+{
+    const DropDecisionTable& table = DropDecisionTable::instance();
+    const unsigned int reachableBits = table.reachableDecisionBits(field_);
+    const int numDecisions = kumipuyo.isRep() ? 11 : 22;
+
+    double best = -INF;
+    for (int i = 0; i < numDecisions; ++i) {
+        const Decision& decision = Plan::DECISIONS[i];
+        if (!DropDecisionTable::hasDecision(reachableBits, decision))
+            continue;
+
+        const int numChigiri = numChigiri_ + field_.isChigiriDecision(decision);
+        const int dropFrames = table.framesToDropNext(field_, decision);
+        if (!field_.dropKumipuyo(decision, kumipuyo))
+            continue;
+
+        decisions_.push_back(decision);
+
+        bool isAlive = true;
+        double value = 0.0;
+        if (field_.rensaWillOccurWhenLastDecisionIs(decision)) {
+            CoreField cf(field_);
+            const RensaResult rensaResult = cf.simulate();
+            isAlive = cf.isEmpty(3, 12);
+            if (isAlive)
+                value = evaluate(cf, rensaResult, numChigiri, totalFrames_, dropFrames);
+        } else if (!field_.isEmpty(3, 12)) {
+            isAlive = false;
+        } else if (depth + 1 == config_.depth) {
+            value = evaluate(field_, RensaResult(), numChigiri, totalFrames_, dropFrames);
+        } else {
+            const int savedNumChigiri = numChigiri_;
+            numChigiri_ = numChigiri;
+            totalFrames_ += dropFrames;
+            value = searchNode(depth + 1, std::max(alpha, best), beta);
+            totalFrames_ -= dropFrames;
+            numChigiri_ = savedNumChigiri;
+        }
+
+        decisions_.pop_back();
+        field_.removePuyoFrom(decision.axisX());
+        field_.removePuyoFrom(decision.childX());
+
+        if (!isAlive)
+            continue;
+
+        if (best < value) {
+            best = value;
+            if (bestDecision)
+                *bestDecision = decision;
+        }
+        // A probe needs only one child, which gives a lower bound.
+        if (probes)
+            return best;
+        if (best >= beta) {
+            ++result_.numCutoffs;
+            return best;
+        }
+    }
+
+    if (best == -INF)
+        return config_.lowerBound;
+    return best;
+}
+
+double Expectimax::searchChanceNode(int depth, double alpha, double beta)
+{
+    unordered_map<CoreField, double>& cache = cache_[depth];
+    if (config_.usesCache) {
+        auto it = cache.find(field_);
+        if (it != cache.end()) {
+            ++result_.numCacheHits;
+            return it->second;
+        }
+    }
+
+    const double lowerBound = config_.lowerBound;
+    const double upperBound = config_.upperBound;
+
+    // The lower bounds of the successors. Star2 probing raises them.
+    double lowerBounds[NUM_KUMIPUYO_KINDS];
+    std::fill(lowerBounds, lowerBounds + NUM_KUMIPUYO_KINDS, lowerBound);
+    double restLowerBound = lowerBound;
+
+    if (config_.usesPruning && config_.usesProbing) {
+        for (int i = 0; i < NUM_KUMIPUYO_KINDS; ++i) {
+            const double p = KUMIPUYO_KINDS[i].probability;
+            const double othersLowerBound = restLowerBound - p * lowerBounds[i];
+            const double childBeta = (beta - othersLowerBound) / p;
+            lowerBounds[i] = searchMaxNode(depth, KUMIPUYO_KINDS[i].kumipuyo, -INF, childBeta, true, nullptr);
+            restLowerBound = othersLowerBound + p * lowerBounds[i];
+            if (restLowerBound >= beta) {
+                ++result_.numCutoffs;
+                return restLowerBound;
+            }
+        }
+    }
+
+    double sum = 0.0;
+    double restProbability = 1.0;
+    for (int i = 0; i < NUM_KUMIPUYO_KINDS; ++i) {
+        const double p = KUMIPUYO_KINDS[i].probability;
+        restProbability -= p;
+        restLowerBound -= p * lowerBounds[i];
+
+        double childAlpha = -INF;
+        double childBeta = INF;
+        if (config_.usesPruning) {
+            childAlpha = (alpha - sum - restProbability * upperBound) / p;
+            childBeta = (beta - sum - restLowerBound) / p;
+        }
+
+        sum += p * searchMaxNode(depth, KUMIPUYO_KINDS[i].kumipuyo, childAlpha, childBeta, false, nullptr);
+
+        if (!config_.usesPruning)
+            continue;
+        if (sum + restProbability * upperBound <= alpha) {
+            ++result_.numCutoffs;
+            return sum + restProbability * upperBound;
+        }
+        if (sum + restLowerBound >= beta) {
+            ++result_.numCutoffs;
+            return sum + restLowerBound;
+        }
+    }
+
+    // Only the exact value can be memoized.
+    if (config_.usesCache && alpha < sum && sum < beta)
+        cache.emplace(field_, sum);
+    return sum;
+}
+
+double Expectimax::evaluate(const CoreField& field, const RensaResult& rensaResult,
+                            int numChigiri, int framesToIgnite, int lastDropFrames)
+{
+    ++result_.numEvaluations;
+    double value = evaluator_(RefPlan(field, decisions_, rensaResult, numChigiri,
+                                      framesToIgnite, lastDropFrames, 0, 0, 0, 0, false));
+    // The bounds are needed for pruning.
+    return std::min(std::max(value, config_.lowerBound), config_.upperBound);
+}
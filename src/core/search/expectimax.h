@@ -0,0 +1,83 @@
+#ifndef CORE_SEARCH_EXPECTIMAX_H_
+#define CORE_SEARCH_EXPECTIMAX_H_
+
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "base/noncopyable.h"
+#include "core/core_field.h"
+#include "core/decision.h"
+#include "core/kumipuyo.h"
+#include "core/rensa_result.h"
+
+class KumipuyoSeq;
+class RefPlan;
+
+// Expectimax searches plans beyond the known kumipuyos. When the known kumipuyos run out,
+// a chance node averages the next kumipuyo over the 10 kinds with their probability
+// (1/16 for each double like RR, 2/16 for each mixed pair like RB).
+//
+// Chance nodes are pruned with Star1 (and optionally probed with Star2), which requires
+// that every evaluation is in [Config::lowerBound, Config::upperBound]. Evaluations are
+// clamped to the bounds. The values of chance nodes are memoized by field and depth, so
+// the evaluator should depend only on the field and the rensa result of the plan, not on
+// its decisions or frames.
+class Expectimax : noncopyable {
+public:
+    // Evaluates a plan. A plan ends when the rensa is fired or the depth is reached.
+    // The larger is the better.
+    typedef std::function<double (const RefPlan&)> Evaluator;
+
+    struct Config {
+        int depth = 3;
+        // Every evaluation must be in [lowerBound, upperBound]. Tighter bounds prune more.
+        // A dead node (no decision is available) has the value of lowerBound.
+        double lowerBound = 0.0;
+        double upperBound = 1.0;
+        // When true, the values of chance nodes are memoized.
+        bool usesCache = true;
+        // When true, chance nodes are pruned with Star1 bounds.
+        bool usesPruning = true;
+        // When true, chance nodes are probed with Star2 before the full search.
+        bool usesProbing = false;
+    };
+
+    struct Result {
+        Decision decision;
+        double value = 0.0;
+
+        int numEvaluations = 0;
+        int numCacheHits = 0;
+        int numCutoffs = 0;
+    };
+
+    Expectimax(const Config& config, Evaluator evaluator) : config_(config), evaluator_(std::move(evaluator)) {}
+
+    // Returns the first decision which maximizes the expected value.
+    // |seq| must have at least one kumipuyo.
+    Result search(const CoreField&, const KumipuyoSeq&);
+
+private:
+    double searchNode(int depth, double alpha, double beta);
+    // When |probes| is true, only the first available decision is searched, which gives
+    // a lower bound of the node (Star2 probing).
+    double searchMaxNode(int depth, const Kumipuyo&, double alpha, double beta, bool probes, Decision* bestDecision);
+    double searchChanceNode(int depth, double alpha, double beta);
+    double evaluate(const CoreField&, const RensaResult&, int numChigiri, int framesToIgnite, int lastDropFrames);
+
+    const Config config_;
+    const Evaluator evaluator_;
+
+    // The state of the current search.
+    CoreField field_;
+    const KumipuyoSeq* seq_ = nullptr;
+    std::vector<Decision> decisions_;
+    int numChigiri_ = 0;
+    int totalFrames_ = 0;
+    std::vector<std::unordered_map<CoreField, double>> cache_;
+    Result result_;
+};
+
+#endif // CORE_SEARCH_EXPECTIMAX_H_
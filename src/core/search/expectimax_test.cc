@@ -0,0 +1,96 @@
+#include "core/search/expectimax.h"
+
+#include <gtest/gtest.h>
+
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+#include "core/plan/plan.h"
+
+using namespace std;
+
+namespace {
+
+int countColor(const CoreField& field, PuyoColor c)
+{
+    int count = 0;
+    for (int x = 1; x <= FieldConstant::WIDTH; ++x) {
+        for (int y = 1; y <= field.height(x); ++y) {
+            if (field.color(x, y) == c)
+                ++count;
+        }
+    }
+    return count;
+}
+
+// A pseudo random evaluation which depends only on the field.
+double hashEvaluator(const RefPlan& plan)
+{
+    return (plan.field().hash() % 1000) / 1000.0;
+}
+
+} // anonymous namespace
+
+TEST(ExpectimaxTest, probability)
+{
+    // The evaluation is the square of the number of RED. After BB, RED appears only in the
+    // unknown kumipuyo. RR has 1/16, and RB, RY, RG have 2/16 each, so the expected value is
+    // 4 * 1/16 + 1 * 6/16 = 10/16.
+    Expectimax::Config config;
+    config.depth = 2;
+    config.upperBound = 16;
+    Expectimax expectimax(config, [](const RefPlan& plan) {
+        int n = countColor(plan.field(), PuyoColor::RED);
+        return static_cast<double>(n * n);
+    });
+
+    Expectimax::Result result = expectimax.search(CoreField(), KumipuyoSeq("BB"));
+    EXPECT_TRUE(result.decision.isValid());
+    EXPECT_DOUBLE_EQ(10.0 / 16, result.value);
+}
+
+TEST(ExpectimaxTest, knownKumipuyo)
+{
+    // When the kumipuyos are known, this is the same as the max of iterateAvailablePlans.
+    CoreField field("..RR..");
+    KumipuyoSeq seq("RRBB");
+
+    double expected = 0;
+    Plan::iterateAvailablePlans(field, seq, 2, [&expected](const RefPlan& plan) {
+        expected = std::max(expected, hashEvaluator(plan));
+    });
+
+    Expectimax::Config config;
+    config.depth = 2;
+    Expectimax::Result result = Expectimax(config, hashEvaluator).search(field, seq);
+    EXPECT_DOUBLE_EQ(expected, result.value);
+}
+
+TEST(ExpectimaxTest, pruningAndCache)
+{
+    CoreField field("R....."
+                    "RB...."
+                    "BBY...");
+    KumipuyoSeq seq("RY");
+
+    Expectimax::Config config;
+    config.depth = 3;
+    config.usesCache = false;
+    config.usesPruning = false;
+    Expectimax::Result expected = Expectimax(config, hashEvaluator).search(field, seq);
+
+    config.usesCache = true;
+    Expectimax::Result cached = Expectimax(config, hashEvaluator).search(field, seq);
+    EXPECT_NEAR(expected.value, cached.value, 1e-9);
+    EXPECT_LT(0, cached.numCacheHits);
+    EXPECT_LT(cached.numEvaluations, expected.numEvaluations);
+
+    config.usesPruning = true;
+    Expectimax::Result pruned = Expectimax(config, hashEvaluator).search(field, seq);
+    EXPECT_NEAR(expected.value, pruned.value, 1e-9);
+    EXPECT_LT(0, pruned.numCutoffs);
+    EXPECT_LT(pruned.numEvaluations, cached.numEvaluations);
+
+    config.usesProbing = true;
+    Expectimax::Result probed = Expectimax(config, hashEvaluator).search(field, seq);
+    EXPECT_NEAR(expected.value, probed.value, 1e-9);
+}
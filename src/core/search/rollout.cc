@@ -0,0 +1,187 @@
+#include "core/search/rollout.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include <glog/logging.h>
+
+#include "base/executor.h"
+#include "base/time.h"
+#include "core/drop_decision_table.h"
+#include "core/plan/plan.h"
+#include "core/puyo_color.h"
+
+using namespace std;
+
+namespace {
+
+// The result of one rollout.
+struct Record {
+    Decision firstDecision;
+    double value = 0.0;
+    bool isDead = false;
+    bool done = false;
+};
+
+// The state shared by the threads running the rollouts.
+struct RolloutRunState {
+    RolloutRunState(const CoreField& field, const KumipuyoSeq& seq, const Rollout::Config& config,
+                    const Rollout::Policy& policy, const Rollout::Evaluator& evaluator) :
+        field(field), seq(seq), config(config), policy(policy), evaluator(evaluator),
+        records(config.numRollouts)
+    {
+    }
+
+    const CoreField& field;
+    const KumipuyoSeq& seq;
+    const Rollout::Config& config;
+    const Rollout::Policy& policy;
+    const Rollout::Evaluator& evaluator;
+
+    vector<Record> records;
+
+    atomic<int> nextRollout { 0 };
+    atomic<bool> timedOut { false };
+};
+
+// Drops the next kumipuyo with the decision of |policy|. Returns false if the rollout is dead.
+bool step(RolloutState* state, const Rollout::Policy& policy, mt19937* rnd)
+{
+    const Decision decision = policy(*state, rnd);
+    if (!decision.isValid())
+        return false;
+    if (state->numHands == 0)
+        state->firstDecision = decision;
+
+    const int dropFrames = state->field.framesToDropNext(decision);
+    if (!state->field.dropKumipuyo(decision, state->nextKumipuyo()))
+        return false;
+
+    const RensaResult rensaResult = state->field.simulate();
+    if (!state->field.isEmpty(3, 12))
+        return false;
+
+    ++state->numHands;
+    state->totalScore += rensaResult.score;
+    state->maxScore = std::max(state->maxScore, rensaResult.score);
+    state->maxChains = std::max(state->maxChains, rensaResult.chains);
+    state->totalFrames += dropFrames + rensaResult.frames;
+    return true;
+}
+
+// Takes the rollouts one by one. The PRNG and the state are reused among the rollouts.
+void work(RolloutRunState* s)
+{
+    const Rollout::Config& config = s->config;
+    uniform_int_distribution<int> colorDistribution(0, NUM_NORMAL_PUYO_COLORS - 1);
+
+    mt19937 rnd;
+    RolloutState state;
+    for (int i = s->nextRollout++; i < config.numRollouts; i = s->nextRollout++) {
+        if (s->timedOut || config.deadline < currentTime()) {
+            s->timedOut = true;
+            return;
+        }
+
+        rnd.seed(config.seed + static_cast<uint32_t>(i) * 0x9E3779B9U);
+
+        state.field = s->field;
+        state.seq = s->seq;
+        while (state.seq.size() < config.numHands) {
+            PuyoColor axis = NORMAL_PUYO_COLORS[colorDistribution(rnd)];
+            PuyoColor child = NORMAL_PUYO_COLORS[colorDistribution(rnd)];
+            state.seq.add(Kumipuyo(axis, child));
+        }
+        state.numHands = 0;
+        state.firstDecision = Decision();
+        state.totalScore = 0;
+        state.maxScore = 0;
+        state.maxChains = 0;
+        state.totalFrames = 0;
+        state.isDead = false;
+
+        while (state.numHands < config.numHands) {
+            if (!step(&state, s->policy, &rnd)) {
+                state.isDead = true;
+                break;
+            }
+        }
+
+        Record& record = s->records[i];
+        record.firstDecision = state.firstDecision;
+        record.value = s->evaluator(state);
+        record.isDead = state.isDead;
+        record.done = true;
+    }
+}
+
+} // anonymous namespace
+
+Decision Rollout::Result::bestDecision() const
+{
+    const RolloutStats* best = nullptr;
+    for (const RolloutStats& st : stats) {
+        if (!best || best->mean() < st.mean())
+            best = &st;
+    }
+
+    return best ? best->decision : Decision();
+}
+
+// static
+Rollout::Result Rollout::run(const CoreField& field, const KumipuyoSeq& seq, const Config& config,
+                             const Policy& policy, const Evaluator& evaluator)
+{
+    DCHECK_LE(0, config.numRollouts);
+
+    RolloutRunState state(field, seq, config, policy, evaluator);
+    Executor::runWithHelpers(config.executor, config.numRollouts, [&state]() { work(&state); });
+
+    // Aggregates in the order of the rollouts, so that the result is deterministic.
+    RolloutStats stats[FieldConstant::MAP_WIDTH][4];
+    Result result;
+    for (const Record& record : state.records) {
+        if (!record.done)
+            continue;
+        ++result.numRollouts;
+        if (!record.firstDecision.isValid())
+            continue;
+
+        RolloutStats& st = stats[record.firstDecision.x][record.firstDecision.r];
+        st.decision = record.firstDecision;
+        st.count += 1;
+        st.numDead += record.isDead;
+        st.sum += record.value;
+        st.max = std::max(st.max, record.value);
+    }
+
+    for (int x = 1; x <= 6; ++x) {
+        for (int r = 0; r < 4; ++r) {
+            if (stats[x][r].count > 0)
+                result.stats.push_back(stats[x][r]);
+        }
+    }
+    result.timedOut = state.timedOut;
+    return result;
+}
+
+// static
+Rollout::Policy Rollout::randomPolicy()
+{
+    return [](const RolloutState& state, mt19937* rnd) {
+        const Kumipuyo& kumipuyo = state.nextKumipuyo();
+        const int numDecisions = kumipuyo.isRep() ? 11 : 22;
+        const unsigned int reachableBits = DropDecisionTable::instance().reachableDecisionBits(state.field);
+
+        Decision candidates[22];
+        int n = 0;
+        for (int i = 0; i < numDecisions; ++i) {
+            if (DropDecisionTable::hasDecision(reachableBits, Plan::DECISIONS[i]))
+                candidates[n++] = Plan::DECISIONS[i];
+        }
+        if (n == 0)
+            return Decision();
+
+        return candidates[uniform_int_distribution<int>(0, n - 1)(*rnd)];
+    };
+}
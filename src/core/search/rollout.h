@@ -0,0 +1,94 @@
+#ifndef CORE_SEARCH_ROLLOUT_H_
+#define CORE_SEARCH_ROLLOUT_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "base/noncopyable.h"
+#include "core/core_field.h"
+#include "core/decision.h"
+#include "core/kumipuyo_seq.h"
+
+class Executor;
+
+// RolloutState is the state of one rollout. This is passed to the policy and the evaluator.
+struct RolloutState {
+    const Kumipuyo& nextKumipuyo() const { return seq.get(numHands); }
+
+    CoreField field;
+    // The given kumipuyos followed by the random kumipuyos.
+    KumipuyoSeq seq;
+    // The number of the dropped kumipuyos. The next kumipuyo is seq.get(numHands).
+    int numHands = 0;
+
+    Decision firstDecision;
+    int totalScore = 0;
+    int maxScore = 0;
+    int maxChains = 0;
+    int totalFrames = 0;
+    bool isDead = false;
+};
+
+// The statistics of the rollouts which started with |decision|.
+struct RolloutStats {
+    double mean() const { return count > 0 ? sum / count : 0.0; }
+
+    Decision decision;
+    int count = 0;
+    int numDead = 0;
+    double sum = 0.0;
+    double max = -std::numeric_limits<double>::infinity();
+};
+
+// Rollout runs independent rollouts (playouts with random kumipuyos) on a thread pool,
+// and aggregates the evaluations per first decision. An AI supplies only a policy, which
+// chooses a decision in a rollout, and an evaluator, which evaluates the last state.
+//
+// Each rollout has its own seed derived from Config::seed and the index of the rollout,
+// so the result doesn't depend on the number of threads unless the deadline is reached.
+class Rollout : noncopyable {
+public:
+    // Returns the decision for state.nextKumipuyo(). Returning an invalid decision means
+    // no decision is available, and the rollout becomes dead.
+    typedef std::function<Decision (const RolloutState&, std::mt19937*)> Policy;
+    // Evaluates the last state of a rollout. The larger is the better.
+    typedef std::function<double (const RolloutState&)> Evaluator;
+
+    struct Config {
+        int numRollouts = 100;
+        // The number of hands of a rollout. When the given seq is shorter than this,
+        // random kumipuyos are appended.
+        int numHands = 10;
+        std::uint32_t seed = 1;
+        // No new rollout is started after |deadline| (compared with currentTime()).
+        double deadline = std::numeric_limits<double>::infinity();
+        // When null, the rollouts run on the calling thread.
+        Executor* executor = nullptr;
+    };
+
+    struct Result {
+        // Returns the decision whose mean is the largest. If no rollout has finished,
+        // an invalid decision is returned.
+        Decision bestDecision() const;
+
+        // Sorted by decision. Only the decisions which have at least one rollout are contained.
+        std::vector<RolloutStats> stats;
+        int numRollouts = 0;
+        bool timedOut = false;
+    };
+
+    static Result run(const CoreField&, const KumipuyoSeq&, const Config&,
+                      const Policy&, const Evaluator&);
+
+    // Chooses a reachable decision uniformly at random.
+    static Policy randomPolicy();
+
+private:
+    Rollout() = delete;
+    ~Rollout() = delete;
+};
+
+#endif // CORE_SEARCH_ROLLOUT_H_
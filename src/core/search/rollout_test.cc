@@ -0,0 +1,115 @@
+#include "core/search/rollout.h"
+
+#include <gtest/gtest.h>
+
+#include "base/executor.h"
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+
+using namespace std;
+
+namespace {
+
+double evaluateByScore(const RolloutState& state)
+{
+    return state.isDead ? -1.0 : state.totalScore;
+}
+
+} // anonymous namespace
+
+TEST(RolloutTest, fixedPolicy)
+{
+    Rollout::Config config;
+    config.numRollouts = 10;
+    config.numHands = 3;
+
+    vector<KumipuyoSeq> seqs;
+    auto policy = [&seqs](const RolloutState& state, mt19937*) {
+        if (state.numHands == 0)
+            seqs.push_back(state.seq);
+        return Decision(3, 0);
+    };
+
+    Rollout::Result result = Rollout::run(CoreField(), KumipuyoSeq("RRBB"), config, policy, evaluateByScore);
+    EXPECT_EQ(10, result.numRollouts);
+    EXPECT_FALSE(result.timedOut);
+    ASSERT_EQ(1U, result.stats.size());
+    EXPECT_EQ(Decision(3, 0), result.stats[0].decision);
+    EXPECT_EQ(10, result.stats[0].count);
+    EXPECT_EQ(Decision(3, 0), result.bestDecision());
+
+    // The given kumipuyos are followed by the random ones.
+    ASSERT_EQ(10U, seqs.size());
+    for (const KumipuyoSeq& seq : seqs) {
+        EXPECT_EQ(3, seq.size());
+        EXPECT_EQ(KumipuyoSeq("RRBB"), seq.subsequence(0, 2));
+    }
+}
+
+TEST(RolloutTest, dead)
+{
+    CoreField field("..O..."
+                    "..O..."
+                    "..O..."
+                    "..O..."
+                    "..O..."
+                    "..O..."
+                    "..O..."
+                    "..O..."
+                    "..O..."
+                    "..O..."
+                    "..O...");
+
+    Rollout::Config config;
+    config.numRollouts = 3;
+    config.numHands = 5;
+
+    auto policy = [](const RolloutState&, mt19937*) { return Decision(3, 0); };
+    Rollout::Result result = Rollout::run(field, KumipuyoSeq("RRBB"), config, policy, evaluateByScore);
+    ASSERT_EQ(1U, result.stats.size());
+    EXPECT_EQ(3, result.stats[0].numDead);
+    EXPECT_EQ(-1.0, result.stats[0].mean());
+}
+
+TEST(RolloutTest, parallel)
+{
+    const CoreField field("R....."
+                          "RB...."
+                          "BBY...");
+    const KumipuyoSeq seq("RYBB");
+
+    Rollout::Config config;
+    config.numRollouts = 50;
+    config.numHands = 6;
+    Rollout::Result expected = Rollout::run(field, seq, config, Rollout::randomPolicy(), evaluateByScore);
+
+    Executor executor(3);
+    executor.start();
+    config.executor = &executor;
+    Rollout::Result actual = Rollout::run(field, seq, config, Rollout::randomPolicy(), evaluateByScore);
+    executor.stop();
+
+    // Each rollout has its own seed, so the result doesn't depend on the threads.
+    EXPECT_EQ(50, expected.numRollouts);
+    EXPECT_EQ(50, actual.numRollouts);
+    ASSERT_EQ(expected.stats.size(), actual.stats.size());
+    for (size_t i = 0; i < expected.stats.size(); ++i) {
+        EXPECT_EQ(expected.stats[i].decision, actual.stats[i].decision);
+        EXPECT_EQ(expected.stats[i].count, actual.stats[i].count);
+        EXPECT_EQ(expected.stats[i].sum, actual.stats[i].sum);
+    }
+    EXPECT_EQ(expected.bestDecision(), actual.bestDecision());
+}
+
+TEST(RolloutTest, deadline)
+{
+    Rollout::Config config;
+    config.numRollouts = 10;
+    config.deadline = 0;
+
+    Rollout::Result result = Rollout::run(CoreField(), KumipuyoSeq("RRBB"), config,
+                                          Rollout::randomPolicy(), evaluateByScore);
+    EXPECT_TRUE(result.timedOut);
+    EXPECT_EQ(0, result.numRollouts);
+    EXPECT_FALSE(result.bestDecision().isValid());
+}
@@ -26,7 +26,7 @@ GameResult GameState::gameResult() const
     return GameResult::PLAYING;
 }
 
-string GameState::toJson() const
+void GameState::toJsonValue(Json::Value* value) const
 {
     PlainField f[2] = { playerGameState_[0].field, playerGameState_[1].field };
 
@@ -41,7 +41,7 @@ string GameState::toJson() const
         }
     }
 
-    Json::Value root;
+    Json::Value& root = *value;
     root["p1"] = f[0].toString();
     root["s1"] = playerGameState_[0].score;
     root["o1"] = playerGameState_[0].ojama();
@@ -53,6 +53,12 @@ string GameState::toJson() const
     root["o2"] = playerGameState_[1].ojama();
     root["n2"] = playerGameState_[1].kumipuyoSeq.toString();
     root["m2"] = playerGameState_[1].message;
+}
+
+string GameState::toJson() const
+{
+    Json::Value root;
+    toJsonValue(&root);
 
     Json::StyledWriter writer;
     return writer.write(root);
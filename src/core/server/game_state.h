@@ -14,6 +14,10 @@
 #include "core/game_result.h"
 #include "core/plain_field.h"
 
+namespace Json {
+class Value;
+}
+
 struct PlayerGameState {
     int ojama() const { return pendingOjama + fixedOjama; }
 
@@ -40,6 +44,8 @@ public:
     int frameId() const { return frameId_; }
 
     std::string toJson() const;
+    // Same as toJson(), but returns the JSON object so that a caller can serialize it as it likes.
+    void toJsonValue(Json::Value*) const;
     std::string toDebugString() const;
 
     GameResult gameResult() const;
@@ -0,0 +1,191 @@
+#include "core/server/game_state_broadcaster.h"
+
+#include <glog/logging.h>
+
+using namespace std;
+
+GameStateBroadcaster::GameStateBroadcaster(size_t capacity) :
+    capacity_(capacity),
+    slots_(capacity)
+{
+    CHECK_GT(capacity, 0U);
+}
+
+GameStateBroadcaster::~GameStateBroadcaster()
+{
+    stop();
+}
+
+void GameStateBroadcaster::addObserver(GameStateObserver* observer)
+{
+    DCHECK(observer);
+    CHECK(!started_) << "addObserver() must be called before start()";
+    readers_.emplace_back(new Reader(observer));
+}
+
+void GameStateBroadcaster::start()
+{
+    CHECK(!started_);
+    started_ = true;
+
+    for (auto& reader : readers_) {
+        Reader* r = reader.get();
+        r->th = thread([this, r]() {
+            runReaderLoop(r);
+        });
+    }
+}
+
+void GameStateBroadcaster::stop()
+{
+    {
+        lock_guard<mutex> lock(mu_);
+        shouldStop_ = true;
+    }
+    publishedCondVar_.notify_all();
+
+    for (auto& reader : readers_) {
+        if (reader->th.joinable())
+            reader->th.join();
+    }
+}
+
+void GameStateBroadcaster::waitUntilConsumed()
+{
+    if (!started_)
+        return;
+
+    unique_lock<mutex> lock(mu_);
+    consumedCondVar_.wait(lock, [this]() {
+        uint64_t head = head_.load(memory_order_acquire);
+        for (const auto& reader : readers_) {
+            if (reader->cursor.load(memory_order_acquire) != head)
+                return false;
+        }
+        return true;
+    });
+}
+
+GameStateBroadcaster::Stats GameStateBroadcaster::stats(size_t observerIndex) const
+{
+    CHECK_LT(observerIndex, readers_.size());
+    const Reader& reader = *readers_[observerIndex];
+
+    Stats stats;
+    stats.dropped = reader.dropped.load(memory_order_relaxed);
+    uint64_t cursor = reader.cursor.load(memory_order_acquire);
+    stats.consumed = cursor - stats.dropped;
+    stats.lag = head_.load(memory_order_acquire) - cursor;
+    return stats;
+}
+
+void GameStateBroadcaster::newGameWillStart()
+{
+    publish(Event::Type::NEW_GAME_WILL_START, GameState(0), GameResult::PLAYING);
+}
+
+void GameStateBroadcaster::onUpdate(const GameState& gameState)
+{
+    publish(Event::Type::UPDATE, gameState, GameResult::PLAYING);
+}
+
+void GameStateBroadcaster::gameHasDone(GameResult gameResult)
+{
+    publish(Event::Type::GAME_HAS_DONE, GameState(0), gameResult);
+}
+
+void GameStateBroadcaster::publish(Event::Type type, const GameState& gameState, GameResult gameResult)
+{
+    // Only the producer writes |head_|, so relaxed is enough here.
+    uint64_t seq = head_.load(memory_order_relaxed);
+    shared_ptr<const Event> event = make_shared<Event>(seq, type, gameState, gameResult);
+
+    // A reader that is still looking at the old event keeps it alive by its own reference.
+    // The old event is released after the slot lock is dropped.
+    Slot& slot = slots_[seq % capacity_];
+    {
+        lock_guard<mutex> lock(slot.mu);
+        slot.event.swap(event);
+    }
+
+    // This pairs with the increment of |numSleepingReaders_| in runReaderLoop(). Both are
+    // seq_cst, so either the reader sees the new head, or we see the sleeping reader.
+    head_.store(seq + 1, memory_order_seq_cst);
+    if (numSleepingReaders_.load(memory_order_seq_cst) == 0)
+        return;
+
+    // A sleeping reader holds |mu_| only to check the predicate.
+    {
+        lock_guard<mutex> lock(mu_);
+    }
+    publishedCondVar_.notify_all();
+}
+
+void GameStateBroadcaster::runReaderLoop(Reader* reader)
+{
+    uint64_t cursor = 0;
+    while (true) {
+        uint64_t head = head_.load(memory_order_acquire);
+        if (cursor == head) {
+            unique_lock<mutex> lock(mu_);
+            numSleepingReaders_.fetch_add(1, memory_order_seq_cst);
+            publishedCondVar_.wait(lock, [this, cursor]() {
+                return shouldStop_ || head_.load(memory_order_seq_cst) != cursor;
+            });
+            numSleepingReaders_.fetch_sub(1, memory_order_relaxed);
+            if (head_.load(memory_order_acquire) == cursor) {
+                // Stopped and every event has been consumed.
+                return;
+            }
+            continue;
+        }
+
+        if (head - cursor > capacity_) {
+            uint64_t numDropped = head - capacity_ - cursor;
+            LOG(WARNING) << "GameStateObserver is too slow. " << numDropped << " events are dropped.";
+            reader->dropped.fetch_add(numDropped, memory_order_relaxed);
+            cursor += numDropped;
+        }
+
+        shared_ptr<const Event> event;
+        {
+            Slot& slot = slots_[cursor % capacity_];
+            lock_guard<mutex> lock(slot.mu);
+            event = slot.event;
+        }
+        DCHECK(event);
+        if (event->seq != cursor) {
+            // The producer has overwritten the slot. Retry from the new head.
+            continue;
+        }
+
+        dispatch(reader->observer, *event);
+        ++cursor;
+        reader->cursor.store(cursor, memory_order_release);
+
+        if (cursor == head_.load(memory_order_acquire)) {
+            {
+                lock_guard<mutex> lock(mu_);
+            }
+            consumedCondVar_.notify_all();
+        }
+    }
+}
+
+// static
+void GameStateBroadcaster::dispatch(GameStateObserver* observer, const Event& event)
+{
+    switch (event.type) {
+    case Event::Type::NEW_GAME_WILL_START:
+        observer->newGameWillStart();
+        return;
+    case Event::Type::UPDATE:
+        observer->onUpdate(event.gameState);
+        return;
+    case Event::Type::GAME_HAS_DONE:
+        observer->gameHasDone(event.gameResult);
+        return;
+    }
+
+    CHECK(false) << "Unknown event type";
+}
@@ -0,0 +1,112 @@
+#ifndef CORE_SERVER_GAME_STATE_BROADCASTER_H_
+#define CORE_SERVER_GAME_STATE_BROADCASTER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/base.h"
+#include "core/game_result.h"
+#include "core/server/game_state.h"
+#include "core/server/game_state_observer.h"
+
+// GameStateBroadcaster fans GameState updates out to GameStateObservers asynchronously.
+//
+// The producer (e.g. DuelServer) publishes each event once into a ring buffer,
+// and each observer consumes the ring on its own thread with its own cursor.
+// The producer never waits for an observer callback, so a slow observer (disk,
+// renderer, ...) cannot perturb the game timing. This is not lock-free: each slot has
+// its own mutex, which is held only while the event pointer is swapped or copied, and
+// the wake-up mutex is taken only when some reader is sleeping. When an observer lags
+// behind more than the capacity of the ring, the oldest events are dropped for that
+// observer only.
+//
+// Observers receive newGameWillStart(), onUpdate() and gameHasDone() in the published
+// order, but on the broadcaster's thread instead of the producer's thread.
+class GameStateBroadcaster : public GameStateObserver {
+public:
+    struct Stats {
+        uint64_t consumed = 0;
+        uint64_t dropped = 0;
+        // The number of events published but not consumed yet.
+        uint64_t lag = 0;
+    };
+
+    explicit GameStateBroadcaster(size_t capacity = 1024);
+    virtual ~GameStateBroadcaster();
+
+    // Doesn't take ownership. Must be called before start().
+    void addObserver(GameStateObserver*);
+    size_t numObservers() const { return readers_.size(); }
+
+    void start();
+    // Waits until all the observers consume the published events, and stops them.
+    void stop();
+
+    // Blocks until all the observers consume the events published so far.
+    void waitUntilConsumed();
+
+    Stats stats(size_t observerIndex) const;
+
+    // For GameStateObserver. These must be called from a single producer thread.
+    virtual void newGameWillStart() override;
+    virtual void onUpdate(const GameState&) override;
+    virtual void gameHasDone(GameResult) override;
+
+private:
+    struct Event {
+        enum class Type { NEW_GAME_WILL_START, UPDATE, GAME_HAS_DONE };
+
+        Event(uint64_t seq, Type type, const GameState& gameState, GameResult gameResult) :
+            seq(seq), type(type), gameState(gameState), gameResult(gameResult) {}
+
+        const uint64_t seq;
+        const Type type;
+        const GameState gameState;
+        const GameResult gameResult;
+    };
+
+    struct Slot {
+        // Held only to swap or copy |event|.
+        std::mutex mu;
+        std::shared_ptr<const Event> event;
+    };
+
+    struct Reader {
+        explicit Reader(GameStateObserver* observer) : observer(observer) {}
+
+        GameStateObserver* observer;
+        std::thread th;
+        std::atomic<uint64_t> cursor { 0 };
+        std::atomic<uint64_t> dropped { 0 };
+    };
+
+    void publish(Event::Type, const GameState&, GameResult);
+    void runReaderLoop(Reader*);
+    static void dispatch(GameStateObserver*, const Event&);
+
+    const size_t capacity_;
+    std::vector<Slot> slots_;
+    std::atomic<uint64_t> head_ { 0 };
+    // The number of readers waiting on |publishedCondVar_|. The producer skips the
+    // wake-up when this is 0.
+    std::atomic<int> numSleepingReaders_ { 0 };
+
+    std::vector<std::unique_ptr<Reader>> readers_;
+    bool started_ = false;
+
+    // Guards only the wake-ups. Observers are never called with this locked.
+    // The producer takes this only when a reader is sleeping.
+    std::mutex mu_;
+    std::condition_variable publishedCondVar_;
+    std::condition_variable consumedCondVar_;
+    bool shouldStop_ = false;
+
+    DISALLOW_COPY_AND_ASSIGN(GameStateBroadcaster);
+};
+
+#endif // CORE_SERVER_GAME_STATE_BROADCASTER_H_
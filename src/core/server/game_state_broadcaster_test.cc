@@ -0,0 +1,125 @@
+#include "core/server/game_state_broadcaster.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+
+class RecordingObserver : public GameStateObserver {
+public:
+    void newGameWillStart() override { events.push_back("start"); }
+    void onUpdate(const GameState& gameState) override { events.push_back(to_string(gameState.frameId())); }
+    void gameHasDone(GameResult) override { events.push_back("done"); }
+
+    vector<string> events;
+};
+
+// BlockingObserver blocks in onUpdate() until release() is called.
+class BlockingObserver : public GameStateObserver {
+public:
+    void onUpdate(const GameState& gameState) override
+    {
+        unique_lock<mutex> lock(mu_);
+        condVar_.wait(lock, [this]() { return released_; });
+        frameIds.push_back(gameState.frameId());
+    }
+
+    void release()
+    {
+        lock_guard<mutex> lock(mu_);
+        released_ = true;
+        condVar_.notify_all();
+    }
+
+    vector<int> frameIds;
+
+private:
+    mutex mu_;
+    condition_variable condVar_;
+    bool released_ = false;
+};
+
+} // anonymous namespace
+
+TEST(GameStateBroadcasterTest, deliversInOrder)
+{
+    RecordingObserver observer1;
+    RecordingObserver observer2;
+
+    GameStateBroadcaster broadcaster(16);
+    broadcaster.addObserver(&observer1);
+    broadcaster.addObserver(&observer2);
+    broadcaster.start();
+
+    broadcaster.newGameWillStart();
+    for (int i = 1; i <= 5; ++i)
+        broadcaster.onUpdate(GameState(i));
+    broadcaster.gameHasDone(GameResult::DRAW);
+
+    broadcaster.waitUntilConsumed();
+
+    vector<string> expected { "start", "1", "2", "3", "4", "5", "done" };
+    EXPECT_EQ(expected, observer1.events);
+    EXPECT_EQ(expected, observer2.events);
+
+    GameStateBroadcaster::Stats stats = broadcaster.stats(0);
+    EXPECT_EQ(7U, stats.consumed);
+    EXPECT_EQ(0U, stats.dropped);
+    EXPECT_EQ(0U, stats.lag);
+
+    broadcaster.stop();
+}
+
+TEST(GameStateBroadcasterTest, slowObserverDropsOldEvents)
+{
+    BlockingObserver slowObserver;
+
+    GameStateBroadcaster broadcaster(4);
+    broadcaster.addObserver(&slowObserver);
+    broadcaster.start();
+
+    // The slow observer is blocked, so the producer overruns it without waiting.
+    for (int i = 1; i <= 20; ++i)
+        broadcaster.onUpdate(GameState(i));
+
+    slowObserver.release();
+    broadcaster.waitUntilConsumed();
+
+    GameStateBroadcaster::Stats stats = broadcaster.stats(0);
+    EXPECT_GT(stats.dropped, 0U);
+    EXPECT_EQ(20U, stats.consumed + stats.dropped);
+    EXPECT_EQ(0U, stats.lag);
+
+    // The latest events are always delivered.
+    ASSERT_FALSE(slowObserver.frameIds.empty());
+    EXPECT_EQ(20, slowObserver.frameIds.back());
+    for (size_t i = 1; i < slowObserver.frameIds.size(); ++i)
+        EXPECT_LT(slowObserver.frameIds[i - 1], slowObserver.frameIds[i]);
+
+    broadcaster.stop();
+}
+
+TEST(GameStateBroadcasterTest, stopDrainsEvents)
+{
+    RecordingObserver observer;
+
+    {
+        GameStateBroadcaster broadcaster(16);
+        broadcaster.addObserver(&observer);
+        broadcaster.start();
+
+        broadcaster.newGameWillStart();
+        broadcaster.onUpdate(GameState(1));
+        broadcaster.gameHasDone(GameResult::P1_WIN);
+        broadcaster.stop();
+    }
+
+    vector<string> expected { "start", "1", "done" };
+    EXPECT_EQ(expected, observer.events);
+}
@@ -152,7 +152,6 @@ public:
                 }
             }
         }
-        //fprintf(stderr, "simCount: %d\n", simCount);
         int bestAns = 0;
         int bestCnt = 0;
         for(int i=0; i<22; ++i) {
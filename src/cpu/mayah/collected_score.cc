@@ -12,15 +12,15 @@ using namespace std;
 string CollectedFeatureMoveScore::toString() const
 {
     stringstream ss;
-    for (const auto& entry : collectedFeatures) {
-        ss << toFeature(entry.first).name() << "=" << to_string(entry.second) << endl;
-    }
-    for (const auto& entry : collectedSparseFeatures) {
-        ss << toFeature(entry.first).name() << "=";
-        for (int v : entry.second)
+    collectedFeatures.forEach([&ss](EvaluationMoveFeatureKey key, double value) {
+        ss << toFeature(key).name() << "=" << to_string(value) << endl;
+    });
+    collectedSparseFeatures.forEach([&ss](EvaluationMoveSparseFeatureKey key, const vector<int>& values) {
+        ss << toFeature(key).name() << "=";
+        for (int v : values)
             ss << v << ' ';
         ss << endl;
-    }
+    });
 
     return ss.str();
 }
@@ -28,16 +28,16 @@ string CollectedFeatureMoveScore::toString() const
 string CollectedFeatureRensaScore::toString() const
 {
     stringstream ss;
-    for (const auto& entry : collectedFeatures) {
-        ss << toFeature(entry.first).name() << "=" << to_string(entry.second) << endl;
-    }
+    collectedFeatures.forEach([&ss](EvaluationRensaFeatureKey key, double value) {
+        ss << toFeature(key).name() << "=" << to_string(value) << endl;
+    });
 
-    for (const auto& entry : collectedSparseFeatures) {
-        ss << toFeature(entry.first).name() << "=";
-        for (int v : entry.second)
+    collectedSparseFeatures.forEach([&ss](EvaluationRensaSparseFeatureKey key, const vector<int>& values) {
+        ss << toFeature(key).name() << "=";
+        for (int v : values)
             ss << v << ' ';
         ss << endl;
-    }
+    });
 
     return ss.str();
 }
@@ -64,20 +64,16 @@ static string scoreComparisonStringSub(const CollectedScore& lhs,
     typedef typename FeatureSet::SparseFeatureKey SparseFeatureKey;
 
     set<FeatureKey> featureKeys;
-    for (const auto& entry : lhs.collectedFeatures) {
-        featureKeys.insert(entry.first);
-    }
-    for (const auto& entry : rhs.collectedFeatures) {
-        featureKeys.insert(entry.first);
-    }
+    auto insertFeatureKey = [&featureKeys](FeatureKey key, double) { featureKeys.insert(key); };
+    lhs.collectedFeatures.forEach(insertFeatureKey);
+    rhs.collectedFeatures.forEach(insertFeatureKey);
 
     set<SparseFeatureKey> sparseFeatureKeys;
-    for (const auto& entry : lhs.collectedSparseFeatures) {
-        sparseFeatureKeys.insert(entry.first);
-    }
-    for (const auto& entry : rhs.collectedSparseFeatures) {
-        sparseFeatureKeys.insert(entry.first);
-    }
+    auto insertSparseFeatureKey = [&sparseFeatureKeys](SparseFeatureKey key, const vector<int>&) {
+        sparseFeatureKeys.insert(key);
+    };
+    lhs.collectedSparseFeatures.forEach(insertSparseFeatureKey);
+    rhs.collectedSparseFeatures.forEach(insertSparseFeatureKey);
 
     stringstream ss;
 
@@ -2,9 +2,12 @@
 #define CPU_MAYAH_COLLECTED_SCORE_H_
 
 #include <array>
+#include <string>
+#include <vector>
 
 #include "core/column_puyo_list.h"
 
+#include "dense_feature_map.h"
 #include "evaluation_feature.h"
 #include "evaluation_parameter.h"
 
@@ -50,25 +53,8 @@ struct CollectedFeatureMoveScore {
     double score(EvaluationMode mode) const { return simpleScore.score(mode); }
     double score(const CollectedCoef& coef) const { return simpleScore.score(coef); }
 
-    double feature(EvaluationMoveFeatureKey key) const
-    {
-        auto it = collectedFeatures.find(key);
-        if (it != collectedFeatures.end())
-            return it->second;
-
-        return 0.0;
-    }
-
-    const std::vector<int>& feature(EvaluationMoveSparseFeatureKey key) const
-    {
-        auto it = collectedSparseFeatures.find(key);
-        if (it != collectedSparseFeatures.end())
-            return it->second;
-
-        // This should be thread-safe in C++11.
-        static std::vector<int> emptyVector;
-        return emptyVector;
-    }
+    double feature(EvaluationMoveFeatureKey key) const { return collectedFeatures.get(key); }
+    const std::vector<int>& feature(EvaluationMoveSparseFeatureKey key) const { return collectedSparseFeatures.get(key); }
 
     double scoreFor(EvaluationMoveFeatureKey key,
                     const CollectedCoef& coef,
@@ -97,33 +83,16 @@ struct CollectedFeatureMoveScore {
     std::string toString() const;
 
     CollectedSimpleMoveScore simpleScore;
-    std::map<EvaluationMoveFeatureKey, double> collectedFeatures;
-    std::map<EvaluationMoveSparseFeatureKey, std::vector<int>> collectedSparseFeatures;
+    DenseFeatureMap<EvaluationMoveFeatureKey, NUM_EVALUATION_MOVE_FEATURE_KEYS, double> collectedFeatures;
+    DenseFeatureMap<EvaluationMoveSparseFeatureKey, NUM_EVALUATION_MOVE_SPARSE_FEATURE_KEYS, std::vector<int>> collectedSparseFeatures;
 };
 
 struct CollectedFeatureRensaScore {
     double score(EvaluationMode mode) const { return simpleScore.score(mode); }
     double score(const CollectedCoef& coef) const { return simpleScore.score(coef); }
 
-    double feature(EvaluationRensaFeatureKey key) const
-    {
-        auto it = collectedFeatures.find(key);
-        if (it != collectedFeatures.end())
-            return it->second;
-
-        return 0.0;
-    }
-
-    const std::vector<int>& feature(EvaluationRensaSparseFeatureKey key) const
-    {
-        auto it = collectedSparseFeatures.find(key);
-        if (it != collectedSparseFeatures.end())
-            return it->second;
-
-        // This should be thread-safe in C++11.
-        static std::vector<int> emptyVector;
-        return emptyVector;
-    }
+    double feature(EvaluationRensaFeatureKey key) const { return collectedFeatures.get(key); }
+    const std::vector<int>& feature(EvaluationRensaSparseFeatureKey key) const { return collectedSparseFeatures.get(key); }
 
     double scoreFor(EvaluationRensaFeatureKey key,
                     const CollectedCoef& coef,
@@ -152,8 +121,8 @@ struct CollectedFeatureRensaScore {
     std::string toString() const;
 
     CollectedSimpleRensaScore simpleScore;
-    std::map<EvaluationRensaFeatureKey, double> collectedFeatures;
-    std::map<EvaluationRensaSparseFeatureKey, std::vector<int>> collectedSparseFeatures;
+    DenseFeatureMap<EvaluationRensaFeatureKey, NUM_EVALUATION_RENSA_FEATURE_KEYS, double> collectedFeatures;
+    DenseFeatureMap<EvaluationRensaSparseFeatureKey, NUM_EVALUATION_RENSA_SPARSE_FEATURE_KEYS, std::vector<int>> collectedSparseFeatures;
     std::string bookname;
     ColumnPuyoList puyosToComplement;
 };
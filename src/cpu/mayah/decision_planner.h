@@ -6,12 +6,13 @@
 #include <vector>
 
 #include "base/executor.h"
+#include "base/trace.h"
 #include "base/wait_group.h"
 #include "core/plan/plan.h"
 #include "core/core_field.h"
+#include "core/drop_decision_table.h"
 #include "core/kumipuyo_seq.h"
 #include "core/player_state.h"
-#include "core/puyo_controller.h"
 
 template<typename MidEvaluationResult>
 class DecisionPlanner {
@@ -35,6 +36,8 @@ public:
 
     // When decision sequence is specified, we consider only this decision sequence.
     void setSpecifiedDecisions(const std::vector<Decision>& decisions) { decisions_ = decisions; }
+    // The priority and the deadline of the tasks submitted to the executor.
+    void setTaskOptions(const Executor::TaskOptions& options) { taskOptions_ = options; }
 
     void iterate(int frameId, const CoreField& originalField, const KumipuyoSeq& kumipuyoSeq,
                  const PlayerState& me, const PlayerState& enemy, int maxDepth);
@@ -63,6 +66,7 @@ private:
     void iterateKumipuyoDrop(int currentDepth, const CoreField& currentField, const Kumipuyo& kumipuyo, Callback callback);
 
     Executor* executor_;
+    Executor::TaskOptions taskOptions_;
     std::vector<Decision> decisions_;
     MidEvaluationCallback midEval_;
     EvaluationCallback eval_;
@@ -121,21 +125,12 @@ void DecisionPlanner<MidEvaluationResult>::iterateKumipuyoDrop(int currentDepth,
                                                                const Kumipuyo& kumipuyo,
                                                                Callback callback)
 {
-    static const Decision DECISIONS[] = {
-        Decision(2, 3), Decision(3, 3), Decision(3, 1), Decision(4, 1),
-        Decision(5, 1), Decision(1, 2), Decision(2, 2), Decision(3, 2),
-        Decision(4, 2), Decision(5, 2), Decision(6, 2),
-        Decision(1, 1), Decision(2, 1), Decision(4, 3), Decision(5, 3),
-        Decision(6, 3), Decision(1, 0), Decision(2, 0), Decision(3, 0),
-        Decision(4, 0), Decision(5, 0), Decision(6, 0),
-    };
-
     DCHECK(isNormalColor(kumipuyo.axis)) << kumipuyo.axis;
     DCHECK(isNormalColor(kumipuyo.child)) << kumipuyo.child;
 
     // Since copying CoreField is not so fast, we'd like to skip copying as many as possible.
     int numDecisions = kumipuyo.axis == kumipuyo.child ? 11 : 22;
-    const Decision* decisionsHead = DECISIONS;
+    const Decision* decisionsHead = Plan::DECISIONS;
 
     // When decisions are specified, we consider only such decision.
     if (static_cast<size_t>(currentDepth) < decisions_.size()) {
@@ -143,10 +138,13 @@ void DecisionPlanner<MidEvaluationResult>::iterateKumipuyoDrop(int currentDepth,
         decisionsHead = &decisions_[currentDepth];
     }
 
+    const DropDecisionTable& table = DropDecisionTable::instance();
+    const unsigned int reachableBits = table.reachableDecisionBits(currentField);
+
     for (int i = 0; i < numDecisions; ++i) {
         const Decision& decision = decisionsHead[i];
 
-        if (!PuyoController::isReachable(currentField, decision))
+        if (!DropDecisionTable::hasDecision(reachableBits, decision))
             continue;
 
         CoreField nextField(currentField);
@@ -154,7 +152,7 @@ void DecisionPlanner<MidEvaluationResult>::iterateKumipuyoDrop(int currentDepth,
             continue;
 
         bool isChigiri = currentField.isChigiriDecision(decision);
-        int dropFrames = currentField.framesToDropNext(decision);
+        int dropFrames = table.framesToDropNext(currentField, decision);
 
         callback(std::move(nextField), decision, isChigiri, dropFrames);
     }
@@ -228,7 +226,7 @@ void DecisionPlanner<MidEvaluationResult>::iterateRest(int initialFrameId,
                             newFixedOjama, newPendingOjama, newOjamaCommittingFrameId, newHasZenkeshi, midEvaluationResult, wg);
 
                 wg->done();
-            });
+            }, taskOptions_);
         } else {
             iterateRest(initialFrameId, fieldAfterDecision, kumipuyoSeq, decisions, numChigiri, totalFrames, currentDepth + 1, maxDepth,
                         fallenOjama + ojamaCount, newFixedOjama, newPendingOjama, newOjamaCommittingFrameId, newHasZenkeshi, midEvaluationResult, wg);
@@ -249,6 +247,7 @@ void DecisionPlanner<MidEvaluationResult>::iterate(int initialFrameId,
     DCHECK(maxDepth >= 2);
     DCHECK(kumipuyoSeq.size() >= maxDepth);
 
+    TRACE_SCOPE("DecisionPlanner::iterate");
     WaitGroup wg;
 
     auto f = [&](const CoreField& fieldAfterDecision, const Decision& decision, bool isChigiri, int dropFrames) {
@@ -329,7 +328,7 @@ void DecisionPlanner<MidEvaluationResult>::parallelEval(int currentDepth, const
         executor_->submit([this, plan, midEvaluationResult, wg]() {
                 this->eval_(RefPlan(plan), midEvaluationResult);
                 wg->done();
-        });
+        }, taskOptions_);
     } else {
         eval_(refPlan, midEvaluationResult);
     }
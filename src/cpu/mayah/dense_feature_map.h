@@ -0,0 +1,50 @@
+#ifndef CPU_MAYAH_DENSE_FEATURE_MAP_H_
+#define CPU_MAYAH_DENSE_FEATURE_MAP_H_
+
+#include <array>
+#include <bitset>
+
+#include <glog/logging.h>
+
+// DenseFeatureMap is a map from a feature key to a value, backed by a fixed size array.
+// Since a feature key is a small enum, this is much cheaper than std::map to update,
+// to look up, and to copy. It also remembers which keys have been set, so that
+// we can iterate only the collected features.
+template<typename Key, int N, typename Value>
+class DenseFeatureMap {
+public:
+    bool has(Key key) const { return has_[index(key)]; }
+    bool empty() const { return has_.none(); }
+
+    // Returns the value of |key|. A value-initialized value is returned if |key| has not been set.
+    const Value& get(Key key) const { return values_[index(key)]; }
+
+    // Returns the reference to the value of |key|. |key| is marked as set.
+    Value& operator[](Key key)
+    {
+        has_.set(index(key));
+        return values_[index(key)];
+    }
+
+    // Calls f(key, value) for each key that has been set, in the order of key.
+    template<typename F>
+    void forEach(F f) const
+    {
+        for (int i = 0; i < N; ++i) {
+            if (has_[i])
+                f(static_cast<Key>(i), values_[i]);
+        }
+    }
+
+private:
+    static int index(Key key)
+    {
+        DCHECK(0 <= static_cast<int>(key) && static_cast<int>(key) < N) << key;
+        return static_cast<int>(key);
+    }
+
+    std::array<Value, N> values_ {};
+    std::bitset<N> has_;
+};
+
+#endif // CPU_MAYAH_DENSE_FEATURE_MAP_H_
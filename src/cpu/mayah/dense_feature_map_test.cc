@@ -0,0 +1,43 @@
+#include "dense_feature_map.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "evaluation_feature.h"
+
+using namespace std;
+
+TEST(DenseFeatureMapTest, getAndSet)
+{
+    DenseFeatureMap<EvaluationMoveFeatureKey, NUM_EVALUATION_MOVE_FEATURE_KEYS, double> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.has(TOTAL_FRAMES));
+    EXPECT_EQ(0.0, m.get(TOTAL_FRAMES));
+
+    m[TOTAL_FRAMES] += 3.0;
+    m[TOTAL_FRAMES] += 2.0;
+    EXPECT_FALSE(m.empty());
+    EXPECT_TRUE(m.has(TOTAL_FRAMES));
+    EXPECT_EQ(5.0, m.get(TOTAL_FRAMES));
+}
+
+TEST(DenseFeatureMapTest, forEach)
+{
+    DenseFeatureMap<EvaluationMoveSparseFeatureKey, NUM_EVALUATION_MOVE_SPARSE_FEATURE_KEYS, vector<int>> m;
+    m[VALLEY_DEPTH].push_back(3);
+    m[RIDGE_HEIGHT].push_back(1);
+    m[RIDGE_HEIGHT].push_back(2);
+
+    vector<EvaluationMoveSparseFeatureKey> keys;
+    size_t numValues = 0;
+    m.forEach([&](EvaluationMoveSparseFeatureKey key, const vector<int>& values) {
+        keys.push_back(key);
+        numValues += values.size();
+    });
+
+    ASSERT_EQ(2U, keys.size());
+    EXPECT_LT(keys[0], keys[1]);
+    EXPECT_EQ(3U, numValues);
+    EXPECT_TRUE(m.get(VALLEY_DEPTH_EDGE).empty());
+}
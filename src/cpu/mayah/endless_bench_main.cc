@@ -0,0 +1,72 @@
+#include "mayah_ai.h"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "solver/endless_bench.h"
+
+#include "evaluation_parameter.h"
+
+DECLARE_string(feature);
+
+DEFINE_int32(size, 100, "the number of case size.");
+DEFINE_int32(offset, 0, "offset for random seed");
+DEFINE_int32(workers, 4, "the number of worker threads.");
+DEFINE_string(format, "text", "report format. one of text, json, csv.");
+DEFINE_string(output, "", "the path to write the report. stdout if empty.");
+DEFINE_bool(verbose, false, "show the result of each case.");
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+#if !defined(_MSC_VER)
+    google::InstallFailureSignalHandler();
+#endif
+
+    EvaluationParameterMap paramMap;
+    if (!paramMap.load(FLAGS_feature)) {
+        std::string filename = string(SRC_DIR) + "/cpu/mayah/" + FLAGS_feature;
+        if (!paramMap.load(filename))
+            CHECK(false) << "parameter cannot be loaded correctly.";
+    }
+    paramMap.removeNontokopuyoParameter();
+
+    EndlessBench bench([&paramMap]() {
+        DebuggableMayahAI* ai = new DebuggableMayahAI;
+        ai->setUsesRensaHandTree(false);
+        ai->setEvaluationParameterMap(paramMap);
+        return unique_ptr<AI>(ai);
+    }, FLAGS_workers);
+    bench.setVerbose(FLAGS_verbose);
+
+    EndlessBenchReport report = bench.run(FLAGS_size, FLAGS_offset);
+
+    string str;
+    if (FLAGS_format == "text") {
+        str = report.toString();
+    } else if (FLAGS_format == "json") {
+        str = report.toJson();
+    } else if (FLAGS_format == "csv") {
+        str = report.toCSV();
+    } else {
+        CHECK(false) << "Unknown format: " << FLAGS_format;
+    }
+
+    if (FLAGS_output.empty()) {
+        cout << str;
+    } else {
+        ofstream ofs(FLAGS_output);
+        CHECK(ofs) << "cannot open " << FLAGS_output;
+        ofs << str;
+    }
+
+    return 0;
+}
@@ -63,6 +63,54 @@ enum EvaluationRensaSparseFeatureKey {
 #undef DEFINE_RENSA_SPARSE_PARAM
 };
 
+const int NUM_EVALUATION_MOVE_FEATURE_KEYS = 0
+#define DEFINE_MOVE_PARAM(NAME, tweakability) + 1
+#define DEFINE_MOVE_SPARSE_PARAM(NAME, numValue, tweakability) /* ignored */
+#define DEFINE_RENSA_PARAM(NAME, tweakability) /* ignored */
+#define DEFINE_RENSA_SPARSE_PARAM(NAME, numValue, tweakability) /* ignored */
+#include "evaluation_feature.tab"
+#undef DEFINE_MOVE_PARAM
+#undef DEFINE_MOVE_SPARSE_PARAM
+#undef DEFINE_RENSA_PARAM
+#undef DEFINE_RENSA_SPARSE_PARAM
+;
+
+const int NUM_EVALUATION_RENSA_FEATURE_KEYS = 0
+#define DEFINE_MOVE_PARAM(NAME, tweakability) /* ignored */
+#define DEFINE_MOVE_SPARSE_PARAM(NAME, numValue, tweakability) /* ignored */
+#define DEFINE_RENSA_PARAM(NAME, tweakability) + 1
+#define DEFINE_RENSA_SPARSE_PARAM(NAME, numValue, tweakability) /* ignored */
+#include "evaluation_feature.tab"
+#undef DEFINE_MOVE_PARAM
+#undef DEFINE_MOVE_SPARSE_PARAM
+#undef DEFINE_RENSA_PARAM
+#undef DEFINE_RENSA_SPARSE_PARAM
+;
+
+const int NUM_EVALUATION_MOVE_SPARSE_FEATURE_KEYS = 0
+#define DEFINE_MOVE_PARAM(NAME, tweakability) /* ignored */
+#define DEFINE_MOVE_SPARSE_PARAM(NAME, numValue, tweakability) + 1
+#define DEFINE_RENSA_PARAM(NAME, tweakability) /* ignored */
+#define DEFINE_RENSA_SPARSE_PARAM(NAME, numValue, tweakability) /* ignored */
+#include "evaluation_feature.tab"
+#undef DEFINE_MOVE_PARAM
+#undef DEFINE_MOVE_SPARSE_PARAM
+#undef DEFINE_RENSA_PARAM
+#undef DEFINE_RENSA_SPARSE_PARAM
+;
+
+const int NUM_EVALUATION_RENSA_SPARSE_FEATURE_KEYS = 0
+#define DEFINE_MOVE_PARAM(NAME, tweakability) /* ignored */
+#define DEFINE_MOVE_SPARSE_PARAM(NAME, numValue, tweakability) /* ignored */
+#define DEFINE_RENSA_PARAM(NAME, tweakability) /* ignored */
+#define DEFINE_RENSA_SPARSE_PARAM(NAME, numValue, tweakability) + 1
+#include "evaluation_feature.tab"
+#undef DEFINE_MOVE_PARAM
+#undef DEFINE_MOVE_SPARSE_PARAM
+#undef DEFINE_RENSA_PARAM
+#undef DEFINE_RENSA_SPARSE_PARAM
+;
+
 template<typename FeatureKey>
 class EvaluationFeature {
 public:
@@ -38,6 +38,8 @@ bool EvaluationParameterMap::load(const string& filename)
 bool EvaluationParameterMap::save(const string& filename) const
 {
     toml::Value value = toTomlValue();
+    if (!value.valid())
+        return false;
 
     try {
         ofstream ofs(filename, ios::out | ios::trunc);
@@ -53,9 +55,10 @@ bool EvaluationParameterMap::save(const string& filename) const
 bool EvaluationParameterMap::loadValue(const toml::Value& v)
 {
     // Check v has only |mode| key
-    CHECK(v.is<toml::Table>()) << "value is not table?";
-    CHECK_EQ(v.size(), 1U);
-    CHECK(v.find("mode") != nullptr);
+    if (!v.is<toml::Table>() || v.size() != 1U || v.find("mode") == nullptr) {
+        LOG(ERROR) << "parameter should have only |mode| table";
+        return false;
+    }
 
     if (!moveParamSet_.loadValue(v, "move"))
         return false;
@@ -71,17 +74,16 @@ toml::Value EvaluationParameterMap::toTomlValue() const
 {
     toml::Value v = toml::Table();
 
-    toml::Value v1 = moveParamSet_.toTomlValue("move");
-    if (v1.valid())
-        CHECK(v.merge(v1));
-
-    toml::Value v2 = mainRensaParamSet_.toTomlValue("main");
-    if (v2.valid())
-        CHECK(v.merge(v2));
-
-    toml::Value v3 = sideRensaParamSet_.toTomlValue("side");
-    if (v3.valid())
-        CHECK(v.merge(v3));
+    for (const toml::Value& paramValue : { moveParamSet_.toTomlValue("move"),
+                                           mainRensaParamSet_.toTomlValue("main"),
+                                           sideRensaParamSet_.toTomlValue("side") }) {
+        if (!paramValue.valid())
+            continue;
+        if (!v.merge(paramValue)) {
+            LOG(ERROR) << "failed to merge the parameters";
+            return toml::Value();
+        }
+    }
 
     return v;
 }
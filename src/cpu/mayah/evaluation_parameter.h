@@ -12,8 +12,10 @@
 #include <toml/toml.h>
 
 #include "base/base.h"
+#include "base/lazy_rebuild.h"
 #include "evaluation_feature.h"
 #include "evaluation_mode.h"
+#include "packed_evaluation_parameter.h"
 
 template<typename FeatureSet>
 class EvaluationParameter {
@@ -164,7 +166,8 @@ public:
                 }
                 ss << key;
             }
-            CHECK(false) << "Unknown feature key is specified: " << ss.str();
+            LOG(ERROR) << "Unknown feature key is specified: " << ss.str();
+            return false;
         }
 
         return true;
@@ -198,6 +201,21 @@ public:
     typedef typename FeatureSet::FeatureKey FeatureKey;
     typedef typename FeatureSet::SparseFeatureKey SparseFeatureKey;
 
+    EvaluationParameterSet() {}
+    EvaluationParameterSet(const EvaluationParameterSet& other) :
+        defaultParam_(other.defaultParam_),
+        params_(other.params_)
+    {
+    }
+
+    EvaluationParameterSet& operator=(const EvaluationParameterSet& other)
+    {
+        defaultParam_ = other.defaultParam_;
+        params_ = other.params_;
+        invalidatePacked();
+        return *this;
+    }
+
     double param(EvaluationMode mode, FeatureKey key) const
     {
         if (params_[ordinal(mode)].hasParam(key))
@@ -212,28 +230,54 @@ public:
         return defaultParam_.param(key, idx);
     }
 
+    // Returns the parameters of all modes packed into a matrix. The matrix is rebuilt
+    // on the first call after the parameters are modified.
+    //
+    // The matrix is rebuilt in place, and the score collectors keep a reference to it.
+    // So the parameters must not be modified while they are used for evaluation.
+    // MayahAI never modifies a published EvaluationParameterMap: the maps in
+    // MayahAISnapshot are immutable, and an update publishes a new map (see
+    // MayahAI::setEvaluationParameterMapToSnapshot). Concurrent calls of packed() on an
+    // unmodified set are safe.
+    const PackedEvaluationParameter<FeatureSet>& packed() const
+    {
+        packedRebuild_.rebuildIfNeeded([this]() { packed_.pack(*this); });
+        return packed_;
+    }
+
     void setParam(EvaluationMode mode, FeatureKey key, double value)
     {
         params_[ordinal(mode)].setParam(key, value);
+        invalidatePacked();
     }
 
     void setParam(EvaluationMode mode, SparseFeatureKey key, int index, double value)
     {
         params_[ordinal(mode)].setParam(key, index, value);
+        invalidatePacked();
     }
 
     void setDefault(FeatureKey key, double value)
     {
         defaultParam_.setParam(key, value);
+        invalidatePacked();
     }
 
     void setDefault(SparseFeatureKey key, int index, double value)
     {
         defaultParam_.setParam(key, index, value);
+        invalidatePacked();
     }
 
+    const Param& defaultParam() const { return defaultParam_; }
+    const Param& modeParam(EvaluationMode mode) const { return params_[ordinal(mode)]; }
+    // The caller will modify the returned parameter, so the packed matrix is invalidated here.
+    Param* mutableDefaultParam() { invalidatePacked(); return &defaultParam_; }
+    Param* mutableModeParam(EvaluationMode mode) { invalidatePacked(); return &params_[ordinal(mode)]; }
+
     void removeNontokopuyoParameter()
     {
+        invalidatePacked();
         defaultParam_.removeNontokopuyoParameter();
         for (auto& param : params_) {
             param.removeNontokopuyoParameter();
@@ -242,6 +286,7 @@ public:
 
     void clear()
     {
+        invalidatePacked();
         defaultParam_.clear();
         for (auto& param : params_) {
             param.clear();
@@ -266,9 +311,15 @@ public:
     bool loadValue(const toml::Value& value, const std::string& anotherKey)
     {
         CHECK(!anotherKey.empty()) << "another key should not be empty.";
+        invalidatePacked();
 
         // Checks mode does not have unnecessary value.
         if (const toml::Value* v = value.find("mode")) {
+            if (!v->is<toml::Table>()) {
+                LOG(ERROR) << "mode is not a table";
+                return false;
+            }
+
             std::set<std::string> keys;
             for (const auto& kv : v->as<toml::Table>()) {
                 keys.insert(kv.first);
@@ -279,7 +330,10 @@ public:
             }
             keys.erase("default");
 
-            CHECK(keys.empty());
+            if (!keys.empty()) {
+                LOG(ERROR) << "Unknown mode is specified: " << *keys.begin();
+                return false;
+            }
         }
 
         for (const auto& mode : ALL_EVALUATION_MODES) {
@@ -295,7 +349,10 @@ public:
         {
             std::string defaultKey = std::string("mode.default.") + anotherKey;
             const toml::Value* v = value.find(defaultKey);
-            CHECK(v != nullptr) << defaultKey << "was not found.";
+            if (!v) {
+                LOG(ERROR) << defaultKey << " was not found.";
+                return false;
+            }
             if (!defaultParam_.loadValue(*v))
                 return false;
         }
@@ -304,8 +361,13 @@ public:
     }
 
 private:
+    void invalidatePacked() { packedRebuild_.invalidate(); }
+
     Param defaultParam_;
     std::array<Param, NUM_EVALUATION_MODES> params_;
+
+    mutable PackedEvaluationParameter<FeatureSet> packed_;
+    mutable base::LazyRebuild packedRebuild_;
 };
 
 typedef EvaluationParameterSet<EvaluationMoveParameter, EvaluationMoveFeatureSet> EvaluationMoveParameterSet;
@@ -24,3 +24,27 @@ TEST(EvaluationParameterTest, setter)
     EXPECT_EQ(2.0, m.moveParamSet().param(EvaluationMode::EARLY, TOTAL_FRAMES));
     EXPECT_EQ(1.0, m.moveParamSet().param(EvaluationMode::MIDDLE, TOTAL_FRAMES));
 }
+
+TEST(EvaluationParameterTest, loadInvalidValue)
+{
+    EvaluationParameterMap m;
+    m.mutableMoveParamSet()->setDefault(TOTAL_FRAMES, 1.0);
+
+    {
+        toml::Value v = m.toTomlValue();
+        v.set("mode.default.move.UNKNOWN_FEATURE", 1.0);
+        EvaluationParameterMap loaded;
+        EXPECT_FALSE(loaded.loadValue(v));
+    }
+    {
+        toml::Value v = m.toTomlValue();
+        v.set("foo", 1);
+        EvaluationParameterMap loaded;
+        EXPECT_FALSE(loaded.loadValue(v));
+    }
+    {
+        EvaluationParameterMap loaded;
+        EXPECT_TRUE(loaded.loadValue(m.toTomlValue()));
+        EXPECT_EQ(1.0, loaded.moveParamSet().param(EvaluationMode::EARLY, TOTAL_FRAMES));
+    }
+}
@@ -25,6 +25,7 @@
 #include "gazer.h"
 #include "move_evaluator.h"
 #include "pattern_rensa_detector.h"
+#include "rensa_detection_memo.h"
 #include "rensa_evaluator.h"
 #include "rensa_hand_tree.h"
 #include "shape_evaluator.h"
@@ -231,9 +232,9 @@ template<typename ScoreCollector>
 void Evaluator<ScoreCollector>::evalMidEval(const MidEvalResult& midEvalResult)
 {
     // Copy midEvalResult.
-    for (const auto& entry : midEvalResult.collectedFeatures()) {
-        sc_->addScore(entry.first, entry.second);
-    }
+    midEvalResult.collectedFeatures().forEach([this](EvaluationMoveFeatureKey key, double value) {
+        sc_->addScore(key, value);
+    });
 }
 
 template<typename ScoreCollector>
@@ -286,7 +287,7 @@ CollectedCoef Evaluator<ScoreCollector>::calculateDefaultCoef(const PlayerState&
 
 template<typename ScoreCollector>
 void Evaluator<ScoreCollector>::eval(const RefPlan& plan,
-                                     const KumipuyoSeq& restSeq,
+                                     KumipuyoSeqView restSeq,
                                      int currentFrameId,
                                      int maxIteration,
                                      const PlayerState& me,
@@ -333,6 +334,8 @@ void Evaluator<ScoreCollector>::eval(const RefPlan& plan,
         RensaCollectedScore collectedScore;
     } sideRensa;
 
+    // Without the memo, the hand tree is made while detecting, as the detected rensas are not kept.
+    const bool makesHandTree = !fast && usesRensaHandTree;
     RensaHandNodeMaker handTreeMaker(2, restSeq);
     auto evalCallback = [&](const CoreField& fieldAfterRensa,
                             const RensaResult& rensaResult,
@@ -403,25 +406,60 @@ void Evaluator<ScoreCollector>::eval(const RefPlan& plan,
             fastChain10MaxScore = rensaResult.score;
         }
 
-        // Now, we can simulate complementedField.
-        if (!fast && usesRensaHandTree) {
+        if (!memo_ && makesHandTree) {
             handTreeMaker.add(std::move(complementedField), puyosToComplement, 0, PuyoSet());
         }
     };
 
-    PatternRensaDetector detector(patternBook(), fieldBeforeRensa, evalCallback);
-    detector.iteratePossibleRensas(maxIteration);
+    auto detect = [&](const PatternRensaDetector::Callback& callback) {
+        PatternRensaDetector detector(patternBook(), fieldBeforeRensa, callback);
+        detector.iteratePossibleRensas(maxIteration);
 
-    RensaDetector::detectSideChain(fieldBeforeRensa, RensaDetectorStrategy::defaultDropStrategy(),
-                                   [&](CoreField&& cf, const ColumnPuyoList& cpl) {
-        // TODO(mayah): fireColor is not PuyoColor::EMPTY.
-        RensaResult rensaResult = cf.simulate();
-        evalCallback(cf, rensaResult, cpl, PuyoColor::EMPTY, string(), 0.0);
-    });
+        RensaDetector::detectSideChain(fieldBeforeRensa, RensaDetectorStrategy::defaultDropStrategy(),
+                                       [&callback](CoreField&& cf, const ColumnPuyoList& cpl) {
+            // TODO(mayah): fireColor is not PuyoColor::EMPTY.
+            RensaResult rensaResult = cf.simulate();
+            callback(cf, rensaResult, cpl, PuyoColor::EMPTY, string(), 0.0);
+        });
+    };
+
+    // The memo keeps the detected rensas, so that the other evaluations of the same field can
+    // replay them. Without the memo, they are evaluated as soon as detected.
+    shared_ptr<const RensaDetectionMemo::DetectedRensas> detectedRensas;
+    if (memo_) {
+        detectedRensas = memo_->detectedRensas(fieldBeforeRensa, maxIteration, [&](RensaDetectionMemo::DetectedRensas* rensas) {
+            detect([rensas](const CoreField& fieldAfterRensa, const RensaResult& rensaResult,
+                            const ColumnPuyoList& puyosToComplement, PuyoColor firePuyoColor,
+                            const string& patternName, double patternScore) {
+                rensas->emplace_back(fieldAfterRensa, rensaResult, puyosToComplement, firePuyoColor, patternName, patternScore);
+            });
+        });
+        for (const auto& r : *detectedRensas)
+            evalCallback(r.fieldAfterRensa, r.rensaResult, r.puyosToComplement, r.firePuyoColor, r.patternName, r.patternScore);
+    } else {
+        detect(evalCallback);
+    }
 
     int rensaHandValue = 0;
-    if (!fast && usesRensaHandTree) {
-        RensaHandTree myRensaTree(vector<RensaHandNode>{ handTreeMaker.makeNode() });
+    if (makesHandTree) {
+        RensaHandNode handNode;
+        if (memo_) {
+            handNode = *memo_->handNode(fieldBeforeRensa, restSeq.size(), [&](RensaHandNode* node) {
+                RensaHandNodeMaker maker(2, restSeq);
+                for (const auto& r : *detectedRensas) {
+                    // Now, we can simulate complementedField.
+                    CoreField complementedField(fieldBeforeRensa);
+                    if (!complementedField.dropPuyoList(r.puyosToComplement))
+                        continue;
+                    maker.add(std::move(complementedField), r.puyosToComplement, 0, PuyoSet());
+                }
+                *node = maker.makeNode();
+            });
+        } else {
+            handNode = handTreeMaker.makeNode();
+        }
+
+        RensaHandTree myRensaTree(vector<RensaHandNode>{ std::move(handNode) });
         // TODO(mayah): num ojama is correct? frame id is correct? not sure...
         int myOjama = plan.totalOjama();
         int myOjamaCommittingFrameId = plan.ojamaCommittingFrameId();
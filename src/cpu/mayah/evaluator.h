@@ -1,19 +1,20 @@
 #ifndef CPU_MAYAH_EVALUATOR_H_
 #define CPU_MAYAH_EVALUATOR_H_
 
-#include <map>
 #include <vector>
 
+#include "core/kumipuyo_seq_view.h"
 #include "core/pattern/pattern_book.h"
 
+#include "dense_feature_map.h"
 #include "evaluation_feature.h"
 #include "score_collector.h"
 
 class ColumnPuyoList;
 class CoreField;
 class GazeResult;
-class KumipuyoSeq;
 class RefPlan;
+class RensaDetectionMemo;
 
 struct PlayerState;
 struct RensaResult;
@@ -50,19 +51,13 @@ public:
         collectedFeatures_[key] = value;
     }
 
-    double feature(EvaluationMoveFeatureKey key) const
-    {
-        auto it = collectedFeatures_.find(key);
-        if (it == collectedFeatures_.end())
-            return 0;
-
-        return it->second;
-    }
+    double feature(EvaluationMoveFeatureKey key) const { return collectedFeatures_.get(key); }
 
-    const std::map<EvaluationMoveFeatureKey, double>& collectedFeatures() const { return collectedFeatures_; }
+    typedef DenseFeatureMap<EvaluationMoveFeatureKey, NUM_EVALUATION_MOVE_FEATURE_KEYS, double> FeatureMap;
+    const FeatureMap& collectedFeatures() const { return collectedFeatures_; }
 
 private:
-    std::map<EvaluationMoveFeatureKey, double> collectedFeatures_;
+    FeatureMap collectedFeatures_;
 };
 
 class MidEvaluator : public EvaluatorBase {
@@ -88,12 +83,14 @@ private:
 template<typename ScoreCollector>
 class Evaluator : public EvaluatorBase {
 public:
-    // Don't take ownership of |sc|.
-    Evaluator(const PatternBook& patternBook, ScoreCollector* sc) :
+    // Don't take ownership of |sc| and |memo|.
+    // When |memo| is specified, the rensa detection results are shared through it.
+    Evaluator(const PatternBook& patternBook, ScoreCollector* sc, RensaDetectionMemo* memo = nullptr) :
         EvaluatorBase(patternBook),
-        sc_(sc) {}
+        sc_(sc),
+        memo_(memo) {}
 
-    void eval(const RefPlan&, const KumipuyoSeq&, int currentFrameId, int maxIteration,
+    void eval(const RefPlan&, KumipuyoSeqView restSeq, int currentFrameId, int maxIteration,
               const PlayerState& me, const PlayerState& enemy,
               const PreEvalResult&, const MidEvalResult&, bool fast, bool usesRensaHandTree, const GazeResult&);
 
@@ -111,6 +108,7 @@ private:
     CollectedCoef calculateDefaultCoef(const PlayerState& me, const PlayerState& enemy) const;
 
     ScoreCollector* sc_;
+    RensaDetectionMemo* memo_;
 };
 
 #endif // CPU_MAYAH_EVALUATOR_H_
@@ -7,6 +7,7 @@
 
 #include <glog/logging.h>
 
+#include "base/trace.h"
 #include "core/plan/plan.h"
 #include "core/rensa/rensa_detector.h"
 #include "core/field_checker.h"
@@ -147,8 +148,9 @@ void Gazer::initialize(int frameIdGameWillBegin)
     gazeResult_.reset(frameIdGameWillBegin, 72);
 }
 
-void Gazer::gaze(int frameId, const CoreField& originalField, const KumipuyoSeq& kumipuyoSeq)
+void Gazer::gaze(int frameId, const CoreField& originalField, const KumipuyoSeq& kumipuyoSeq, Executor* executor)
 {
+    TRACE_SCOPE("Gazer::gaze");
     LOG(INFO) << "Gaze: \n" << originalField.toDebugString() << "\nSeq: " << kumipuyoSeq.toString();
 
     int numReachableSpaces = originalField.countConnectedPuyos(3, 12);
@@ -192,7 +194,7 @@ void Gazer::gaze(int frameId, const CoreField& originalField, const KumipuyoSeq&
 
     // PossibleRensaHandTree.
     // We'd like make the depth 3, but eval() gets really slow (2~3 ms each hand.)
-    RensaHandTree tree = RensaHandTree::makeTree(2, originalField, PuyoSet(), 0, kumipuyoSeq);
+    RensaHandTree tree = RensaHandTree::makeTree(2, originalField, PuyoSet(), 0, kumipuyoSeq, executor);
     LOG(INFO) << "Possible:" << endl << tree.toString();
 
     gazeResult_.setPossibleRensaHandTree(std::move(tree));
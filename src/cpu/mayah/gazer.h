@@ -11,6 +11,7 @@
 
 #include "rensa_hand_tree.h"
 
+class Executor;
 class KumipuyoSeq;
 
 class GazeResult {
@@ -46,7 +47,8 @@ private:
 class Gazer : noncopyable {
 public:
     void initialize(int frameIdGameWillBegin);
-    void gaze(int frameId, const CoreField&, const KumipuyoSeq&);
+    // When |executor| is specified, the possible rensas are detected in parallel.
+    void gaze(int frameId, const CoreField&, const KumipuyoSeq&, Executor* executor = nullptr);
 
     const GazeResult& gazeResult() const { return gazeResult_; }
 private:
@@ -0,0 +1,49 @@
+#include "gazer.h"
+
+#include "base/benchmark.h"
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+
+using namespace std;
+
+static void benchmarkGaze(base::Benchmark& benchmark, const CoreField& cf, const KumipuyoSeq& seq)
+{
+    benchmark.measure([&]() {
+        Gazer gazer;
+        gazer.initialize(1);
+        gazer.gaze(100, cf, seq);
+    });
+}
+
+BENCHMARK(GazerBenchmark, pattern1)
+{
+    const CoreField f(
+        "    RB"
+        " B GGG"
+        "GG YBR"
+        "YG YGR"
+        "GBYBGR"
+        "BBYYBG"
+        "GYBGRG"
+        "GGYGGR"
+        "YYBBBR");
+    const KumipuyoSeq seq("RBRGRYYG");
+
+    benchmarkGaze(benchmark, f, seq);
+}
+
+BENCHMARK(GazerBenchmark, pattern2)
+{
+    const CoreField cf(
+        "B....."
+        "YY...."
+        "BRY..."
+        "BRY..."
+        "BGRB.."
+        "RBGRBG"
+        "RBGRBG"
+        "RBGRBG");
+    const KumipuyoSeq seq("RBRGRYYG");
+
+    benchmarkGaze(benchmark, cf, seq);
+}
@@ -173,14 +173,17 @@ int main(int argc, char* argv[])
                                                              ai.myPlayerState(), ai.enemyPlayerState(),
                                                              MayahAI::DEFAULT_DEPTH, MayahAI::DEFAULT_NUM_ITERATION, false, &decisions);
 
-                const PreEvalResult preEvalResult = ai.preEval(currentField);
+                const shared_ptr<const MayahAISnapshot> snapshot = ai.snapshot();
+                const PreEvalResult preEvalResult = ai.preEval(*snapshot, currentField);
                 CollectedFeatureCoefScore mycf = ai.evalWithCollectingFeature(
+                    *snapshot,
                     RefPlan(myThoughtResult.plan),
                     seq.subsequence(0, 2).subsequence(myThoughtResult.plan.decisions().size()),
                     frameId, MayahAI::DEFAULT_NUM_ITERATION,
                     ai.myPlayerState(), ai.enemyPlayerState(), preEvalResult, myThoughtResult.midEvalResult, false,
                     ai.gazer().gazeResult());
                 CollectedFeatureCoefScore aicf = ai.evalWithCollectingFeature(
+                    *snapshot,
                     RefPlan(aiThoughtResult.plan),
                     seq.subsequence(0, 2).subsequence(aiThoughtResult.plan.decisions().size()),
                     frameId, MayahAI::DEFAULT_NUM_ITERATION,
@@ -198,7 +201,7 @@ int main(int argc, char* argv[])
                     { myThoughtResult.plan.field().toPlainField(), aiThoughtResult.plan.field().toPlainField(), myTargetField.toPlainField(), aiTargetField.toPlainField() },
                     { seqToShow, seqToShow, KumipuyoSeq(), KumipuyoSeq() });
 
-                cout << CollectedFeatureCoefScore::scoreComparisionString(mycf, aicf, ai.evaluationParameterMap()) << endl;
+                cout << CollectedFeatureCoefScore::scoreComparisionString(mycf, aicf, *snapshot->evaluationParameterMap) << endl;
                 cout << "MY: " << myThoughtResult.message << endl;
                 cout << "AI: " << aiThoughtResult.message << endl;
             }
@@ -7,11 +7,18 @@
 
 #include "core/probability/puyo_set_probability.h"
 #include "core/probability/column_puyo_list_probability.h"
+#if defined(USE_TCP) && defined(OS_POSIX)
+#include "core/client/ai/ai_host.h"
+#endif
 
 using namespace std;
 
+DECLARE_bool(hot_reload);
 DECLARE_int32(num_threads);
 
+DEFINE_string(host, "", "When specified, serve many games on this unix domain socket path.");
+DEFINE_int32(num_think_slots, 1, "The number of games that can think at the same time with --host.");
+
 int main(int argc, char* argv[])
 {
     google::ParseCommandLineFlags(&argc, &argv, true);
@@ -26,6 +33,27 @@ int main(int argc, char* argv[])
 
     LOG(INFO) << "num_threads = " << FLAGS_num_threads;
 
+#if defined(USE_TCP) && defined(OS_POSIX)
+    if (!FLAGS_host.empty()) {
+        // The sessions share one snapshot, and a session made with a snapshot doesn't watch
+        // the files. So the files would never be reloaded.
+        if (FLAGS_hot_reload) {
+            LOG(ERROR) << "--hot_reload cannot be used with --host.";
+            return 1;
+        }
+
+        // All the games share the books and the executor.
+        unique_ptr<Executor> executor = Executor::makeDefaultExecutor();
+        shared_ptr<const MayahAISnapshot> snapshot = MayahAI::loadSnapshot();
+        AIHost host([&](unique_ptr<ClientConnector> connector) {
+            return unique_ptr<AI>(new MayahAI(argc, argv, executor.get(), snapshot, std::move(connector)));
+        }, FLAGS_num_think_slots);
+        CHECK(host.listen(FLAGS_host)) << FLAGS_host;
+        host.run();
+        return 0;
+    }
+#endif
+
     if (FLAGS_num_threads > 1) {
         unique_ptr<Executor> executor = Executor::makeDefaultExecutor();
         MayahAI(argc, argv, executor.get()).runLoop();
@@ -7,7 +7,10 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include "base/file/file.h"
+#include "base/file/path.h"
 #include "base/time.h"
+#include "base/trace.h"
 #include "base/wait_group.h"
 #include "core/plan/plan.h"
 #include "core/frame_request.h"
@@ -17,18 +20,55 @@
 #include "evaluation_parameter.h"
 #include "evaluator.h"
 #include "gazer.h"
+#include "rensa_detection_memo.h"
 
 DEFINE_string(feature, "feature.toml", "the path to feature parameter");
 DEFINE_string(decision_book, SRC_DIR "/cpu/mayah/decision.toml", "the path to decision book");
+DEFINE_string(opening_book, "", "the path to opening book generated by opening_book_generator. Not used if empty.");
 DEFINE_string(pattern_book, SRC_DIR "/cpu/mayah/pattern.toml", "the path to pattern book");
 DEFINE_bool(from_wrapper, false, "Make this true in wrapper script.");
+DEFINE_bool(trace, false, "Trace the hot paths, and log the summary for each decision.");
+DEFINE_string(trace_dir, "", "When specified, the trace of each decision is written into this directory in Chrome trace format.");
+DEFINE_bool(hot_reload, false, "Reload the feature, the decision book and the pattern book when they're modified. Not supported with --host.");
+DEFINE_bool(rensa_detection_memo, false, "Share the rensa detection results between midEval and eval in a think.");
 
 using namespace std;
 
-MayahAI::MayahAI(int argc, char* argv[], Executor* executor) :
-    AI(argc, argv, "mayah"),
+namespace {
+
+// The time that we have to decide. c.f. AI::think().
+const double FAST_THOUGHT_SECONDS = 0.03;
+const double THOUGHT_SECONDS = 0.3;
+
+// Loads the feature parameter from |filename|. When not found, we try to load from
+// the source directory. |*loadedPath| is set to the path where it's loaded from.
+bool loadEvaluationParameterMap(const string& filename, EvaluationParameterMap* map, string* loadedPath)
+{
+    if (map->load(filename)) {
+        *loadedPath = filename;
+        return true;
+    }
+
+    std::string path = string(SRC_DIR) + "/cpu/mayah/" + filename;
+    if (map->load(path)) {
+        *loadedPath = path;
+        return true;
+    }
+
+    return false;
+}
+
+} // anonymous namespace
+
+MayahAI::MayahAI(int argc, char* argv[], Executor* executor, shared_ptr<const MayahAISnapshot> snapshot,
+                 unique_ptr<ClientConnector> connector) :
+    AI("mayah", connector ? std::move(connector) : AIBase::makeConnector()),
+    usesRensaDetectionMemo_(FLAGS_rensa_detection_memo),
     executor_(executor)
 {
+    UNUSED_VARIABLE(argc);
+    UNUSED_VARIABLE(argv);
+
     if (!FLAGS_from_wrapper) {
         LOG(ERROR) << "mayah was not run with run.sh?" << endl
                    << "Use run.sh instead of using mayah_cpu directly.";
@@ -36,35 +76,142 @@ MayahAI::MayahAI(int argc, char* argv[], Executor* executor) :
 
     setBehaviorRethinkAfterOpponentRensa(true);
 
-    loadEvaluationParameter();
-    CHECK(decisionBook_.load(FLAGS_decision_book));
-    CHECK(patternBook_.load(FLAGS_pattern_book));
+    if (FLAGS_trace || !FLAGS_trace_dir.empty()) {
+        base::Trace::setEnabled(true);
+        traceBeginCycles_ = base::Trace::now();
+    }
 
-    VLOG(1) << evaluationParameterMap_.toString();
+    if (snapshot) {
+        snapshot_ = std::move(snapshot);
+        google::FlushLogFiles(google::GLOG_INFO);
+        return;
+    }
+
+    snapshot_ = loadSnapshot(&evaluationParameterPath_);
+    decisionBookPath_ = FLAGS_decision_book;
+    patternBookPath_ = FLAGS_pattern_book;
+
+    if (FLAGS_hot_reload) {
+        fileWatcher_.reset(new file::FileWatcher([this](const string& path) { reload(path); }));
+        if (!evaluationParameterPath_.empty())
+            fileWatcher_->addPath(evaluationParameterPath_);
+        fileWatcher_->addPath(decisionBookPath_);
+        fileWatcher_->addPath(patternBookPath_);
+        if (!fileWatcher_->start()) {
+            LOG(ERROR) << "failed to watch the files. hot reload is disabled.";
+            fileWatcher_.reset();
+        }
+    }
 
     google::FlushLogFiles(google::GLOG_INFO);
 }
 
+// static
+shared_ptr<const MayahAISnapshot> MayahAI::loadSnapshot(string* evaluationParameterPath)
+{
+    shared_ptr<EvaluationParameterMap> evaluationParameterMap = make_shared<EvaluationParameterMap>();
+    string path;
+    loadEvaluationParameterMap(FLAGS_feature, evaluationParameterMap.get(), &path);
+    if (evaluationParameterPath)
+        *evaluationParameterPath = path;
+    shared_ptr<DecisionBook> decisionBook = make_shared<DecisionBook>();
+    CHECK(decisionBook->load(FLAGS_decision_book));
+    shared_ptr<PatternBook> patternBook = make_shared<PatternBook>();
+    CHECK(patternBook->load(FLAGS_pattern_book));
+    shared_ptr<OpeningBook> openingBook = make_shared<OpeningBook>();
+    if (!FLAGS_opening_book.empty())
+        CHECK(openingBook->load(FLAGS_opening_book)) << FLAGS_opening_book;
+
+    VLOG(1) << evaluationParameterMap->toString();
+
+    shared_ptr<MayahAISnapshot> snapshot = make_shared<MayahAISnapshot>();
+    snapshot->evaluationParameterMap = std::move(evaluationParameterMap);
+    snapshot->decisionBook = std::move(decisionBook);
+    snapshot->patternBook = std::move(patternBook);
+    snapshot->openingBook = std::move(openingBook);
+    return snapshot;
+}
+
 MayahAI::~MayahAI()
 {
+    // Stops the watcher thread before the members it uses are destructed.
+    fileWatcher_.reset();
 }
 
 bool MayahAI::saveEvaluationParameter() const
 {
-    return evaluationParameterMap_.save(FLAGS_feature);
+    return snapshot()->evaluationParameterMap->save(FLAGS_feature);
 }
 
 bool MayahAI::loadEvaluationParameter()
 {
-    if (evaluationParameterMap_.load(FLAGS_feature))
-        return true;
+    shared_ptr<EvaluationParameterMap> map = make_shared<EvaluationParameterMap>();
+    string path;
+    if (!loadEvaluationParameterMap(FLAGS_feature, map.get(), &path))
+        return false;
 
-    // When not found, we try to load from the source directory.
-    std::string filename = string(SRC_DIR) + "/cpu/mayah/" + FLAGS_feature;
-    if (evaluationParameterMap_.load(filename))
-        return true;
+    setEvaluationParameterMapToSnapshot(std::move(map));
+    return true;
+}
 
-    return false;
+void MayahAI::setEvaluationParameterMapToSnapshot(shared_ptr<const EvaluationParameterMap> map)
+{
+    lock_guard<mutex> lock(snapshotUpdateMu_);
+    shared_ptr<MayahAISnapshot> snapshot = make_shared<MayahAISnapshot>(*snapshot_);
+    snapshot->evaluationParameterMap = std::move(map);
+    std::atomic_store(&snapshot_, shared_ptr<const MayahAISnapshot>(std::move(snapshot)));
+}
+
+void MayahAI::setDecisionBookToSnapshot(shared_ptr<const DecisionBook> book)
+{
+    lock_guard<mutex> lock(snapshotUpdateMu_);
+    shared_ptr<MayahAISnapshot> snapshot = make_shared<MayahAISnapshot>(*snapshot_);
+    snapshot->decisionBook = std::move(book);
+    std::atomic_store(&snapshot_, shared_ptr<const MayahAISnapshot>(std::move(snapshot)));
+}
+
+void MayahAI::setPatternBookToSnapshot(shared_ptr<const PatternBook> book)
+{
+    lock_guard<mutex> lock(snapshotUpdateMu_);
+    shared_ptr<MayahAISnapshot> snapshot = make_shared<MayahAISnapshot>(*snapshot_);
+    snapshot->patternBook = std::move(book);
+    std::atomic_store(&snapshot_, shared_ptr<const MayahAISnapshot>(std::move(snapshot)));
+}
+
+void MayahAI::reload(const string& path)
+{
+    // A malformed file might make the loader throw a type error.
+    try {
+        if (path == evaluationParameterPath_) {
+            shared_ptr<EvaluationParameterMap> map = make_shared<EvaluationParameterMap>();
+            if (!map->load(path)) {
+                LOG(ERROR) << "failed to reload " << path << ". The current parameter is kept.";
+                return;
+            }
+            setEvaluationParameterMapToSnapshot(std::move(map));
+        } else if (path == decisionBookPath_) {
+            shared_ptr<DecisionBook> book = make_shared<DecisionBook>();
+            if (!book->load(path)) {
+                LOG(ERROR) << "failed to reload " << path << ". The current decision book is kept.";
+                return;
+            }
+            setDecisionBookToSnapshot(std::move(book));
+        } else if (path == patternBookPath_) {
+            shared_ptr<PatternBook> book = make_shared<PatternBook>();
+            if (!book->load(path)) {
+                LOG(ERROR) << "failed to reload " << path << ". The current pattern book is kept.";
+                return;
+            }
+            setPatternBookToSnapshot(std::move(book));
+        } else {
+            return;
+        }
+    } catch (std::exception& e) {
+        LOG(ERROR) << "failed to reload " << path << ": " << e.what();
+        return;
+    }
+
+    LOG(INFO) << "reloaded " << path;
 }
 
 DropDecision MayahAI::think(int frameId, const CoreField& f, const KumipuyoSeq& kumipuyoSeq,
@@ -81,6 +228,8 @@ DropDecision MayahAI::think(int frameId, const CoreField& f, const KumipuyoSeq&
     }
 
     ThoughtResult thoughtResult = thinkPlan(frameId, f, kumipuyoSeq, me, enemy, depth, iteration, fast);
+    if (base::Trace::isEnabled())
+        dumpTrace(frameId);
 
     const Plan& plan = thoughtResult.plan;
     if (plan.decisions().empty())
@@ -97,6 +246,7 @@ ThoughtResult MayahAI::thinkPlan(int frameId, const CoreField& field, const Kumi
     // CHECK(field, me.field);
     // CHECK(kumipuyoSeq, me.kumipuyoSeq);
 
+    TRACE_SCOPE("MayahAI::thinkPlan");
     double beginTime = currentTime();
 
     LOG(INFO) << "\n" << field.toDebugString() << "\n" << kumipuyoSeq.toString();
@@ -125,8 +275,25 @@ ThoughtResult MayahAI::thinkPlan(int frameId, const CoreField& field, const Kumi
         return tr;
     }
 
+    // The whole of this thought uses this snapshot, even if the files are reloaded meanwhile.
+    const shared_ptr<const MayahAISnapshot> currentSnapshot = snapshot();
+    const MayahAISnapshot& snapshot = *currentSnapshot;
+
+    if (usesDecisionBook_ && !enemy.hasZenkeshi && !snapshot.openingBook->isEmpty()) {
+        Decision d = snapshot.openingBook->nextDecision(field, kumipuyoSeq);
+        if (d.isValid()) {
+            CoreField cf(field);
+            cf.dropKumipuyo(d, kumipuyoSeq.front());
+            vector<Decision> decisions { d };
+
+            ThoughtResult tr(Plan(cf, decisions, RensaResult(), 0, 0, 0, 0, 0, 0, 0, false),
+                             0.0, 0.0, MidEvalResult(), "BY OPENING BOOK");
+            return tr;
+        }
+    }
+
     if (usesDecisionBook_ && !enemy.hasZenkeshi) {
-        Decision d = decisionBook_.nextDecision(field, kumipuyoSeq);
+        Decision d = snapshot.decisionBook->nextDecision(field, kumipuyoSeq);
         if (d.isValid()) {
             CoreField cf(field);
             cf.dropKumipuyo(d, kumipuyoSeq.front());
@@ -141,7 +308,7 @@ ThoughtResult MayahAI::thinkPlan(int frameId, const CoreField& field, const Kumi
     const GazeResult& gazeResult = gazer_.gazeResult();
 
     // Before evaling, check Book.
-    const PreEvalResult preEvalResult = preEval(field);
+    const PreEvalResult preEvalResult = preEval(snapshot, field);
 
     Plan bestPlan;
     double bestScore = -100000000.0;
@@ -156,11 +323,18 @@ ThoughtResult MayahAI::thinkPlan(int frameId, const CoreField& field, const Kumi
 
     bool ojamaFallen = false;
 
+    // With --rensa_detection_memo, midEval and eval share the rensa detection results in this think.
+    // It is off by default, since few fields are detected twice in a think, and the memo costs more
+    // than it saves on most fields.
+    unique_ptr<RensaDetectionMemo> memo;
+    if (usesRensaDetectionMemo_)
+        memo.reset(new RensaDetectionMemo);
+
     mutex mu;
     auto evalRefPlan = [&, this, frameId, maxIteration](const RefPlan& plan, const MidEvalResult& midEvalResult) {
-        KumipuyoSeq restSeq(kumipuyoSeq.subsequence(plan.decisions().size()));
+        KumipuyoSeqView restSeq = KumipuyoSeqView(kumipuyoSeq).subsequence(plan.decisions().size());
         // Here, we iterate enemy's possible rensa.
-        EvalResult evalResult = eval(plan, restSeq, frameId, maxIteration, me, enemy, preEvalResult, midEvalResult, fast, gazeResult);
+        EvalResult evalResult = eval(snapshot, plan, restSeq, frameId, maxIteration, me, enemy, preEvalResult, midEvalResult, fast, gazeResult, memo.get());
         Plan evaledPlan = plan.toPlan();
 
         // Hmm, it looks weaker if we search this...
@@ -227,26 +401,34 @@ ThoughtResult MayahAI::thinkPlan(int frameId, const CoreField& field, const Kumi
         }
     };
     auto evalMidEval = [&](const RefPlan& plan) {
-        return midEval(plan, field, kumipuyoSeq.subsequence(plan.decisions().size()),
-                       frameId, maxIteration, me, enemy, preEvalResult, gazeResult);
+        return midEval(snapshot, plan, field, KumipuyoSeqView(kumipuyoSeq).subsequence(plan.decisions().size()),
+                       frameId, maxIteration, me, enemy, preEvalResult, gazeResult, memo.get());
     };
 
+    // A fast thought (e.g. after ojama has dropped) should not wait for the tasks of the others,
+    // e.g. gaze or the thoughts of the other games in the same process.
+    Executor::TaskOptions taskOptions;
+    taskOptions.priority = fast ? Executor::Priority::HIGH : Executor::Priority::NORMAL;
+    taskOptions.deadline = beginTime + (fast ? FAST_THOUGHT_SECONDS : THOUGHT_SECONDS);
+
     DecisionPlanner<MidEvalResult> planner(executor_, evalMidEval, evalRefPlan);
+    planner.setTaskOptions(taskOptions);
     if (specifiedDecisions)
         planner.setSpecifiedDecisions(*specifiedDecisions);
     planner.iterate(frameId, field, kumipuyoSeq, me, enemy, depth);
-
+    if (memo)
+        VLOG(1) << "rensa detection memo: " << memo->toString();
 
     double endTime = currentTime();
     if (!ojamaFallen && bestVirtualRensaScore < bestRensaScore) {
-        std::string message = makeMessageFrom(frameId, kumipuyoSeq, maxIteration,
+        std::string message = makeMessageFrom(snapshot, frameId, kumipuyoSeq, maxIteration,
                                               me, enemy,
                                               preEvalResult, bestRensaMidEvalResult, gazeResult,
                                               bestRensaPlan, bestRensaScore, bestVirtualRensaScore,
                                               true, fast, endTime - beginTime);
         return ThoughtResult(bestRensaPlan, bestRensaScore, bestVirtualRensaScore, bestRensaMidEvalResult, message);
     } else {
-        std::string message = makeMessageFrom(frameId, kumipuyoSeq, maxIteration,
+        std::string message = makeMessageFrom(snapshot, frameId, kumipuyoSeq, maxIteration,
                                               me, enemy,
                                               preEvalResult, bestMidEvalResult, gazeResult,
                                               bestPlan, bestRensaScore, bestVirtualRensaScore,
@@ -255,52 +437,61 @@ ThoughtResult MayahAI::thinkPlan(int frameId, const CoreField& field, const Kumi
     }
 }
 
-PreEvalResult MayahAI::preEval(const CoreField& currentField) const
+PreEvalResult MayahAI::preEval(const MayahAISnapshot& snapshot, const CoreField& currentField) const
 {
-    PreEvaluator preEvaluator(patternBook_);
+    PreEvaluator preEvaluator(*snapshot.patternBook);
     return preEvaluator.preEval(currentField);
 }
 
-MidEvalResult MayahAI::midEval(const RefPlan& plan,
+MidEvalResult MayahAI::midEval(const MayahAISnapshot& snapshot,
+                               const RefPlan& plan,
                                const CoreField& currentField,
-                               const KumipuyoSeq& restSeq,
+                               KumipuyoSeqView restSeq,
                                int currentFrameId, int maxIteration,
                                const PlayerState& me,
                                const PlayerState& enemy,
                                const PreEvalResult& preEvalResult,
-                               const GazeResult& gazeResult) const
+                               const GazeResult& gazeResult,
+                               RensaDetectionMemo* memo) const
 
 {
-    SimpleScoreCollector sc(evaluationParameterMap_);
-    Evaluator<SimpleScoreCollector> evaluator(patternBook_, &sc);
+    TRACE_SCOPE("MayahAI::midEval");
+    SimpleScoreCollector sc(*snapshot.evaluationParameterMap);
+    // eval never sees the field of a plan that doesn't fire a rensa here, since eval is
+    // called with the plans that have one more decision.
+    Evaluator<SimpleScoreCollector> evaluator(*snapshot.patternBook, &sc, plan.isRensaPlan() ? memo : nullptr);
 
     // MidEval always sets 'fast'.
     evaluator.eval(plan, restSeq, currentFrameId, maxIteration, me, enemy, preEvalResult, MidEvalResult(), true, usesRensaHandTree_, gazeResult);
 
-    MidEvaluator midEvaluator(patternBook_);
+    MidEvaluator midEvaluator(*snapshot.patternBook);
     const CollectedSimpleScore& simpleScore = sc.collectedScore();
     return midEvaluator.eval(plan, currentField, simpleScore.score(sc.collectedCoef()));
 }
 
-EvalResult MayahAI::eval(const RefPlan& plan,
-                         const KumipuyoSeq& restSeq,
+EvalResult MayahAI::eval(const MayahAISnapshot& snapshot,
+                         const RefPlan& plan,
+                         KumipuyoSeqView restSeq,
                          int currentFrameId, int maxIteration,
                          const PlayerState& me, const PlayerState& enemy,
                          const PreEvalResult& preEvalResult,
                          const MidEvalResult& midEvalResult,
                          bool fast,
-                         const GazeResult& gazeResult) const
+                         const GazeResult& gazeResult,
+                         RensaDetectionMemo* memo) const
 {
-    SimpleScoreCollector sc(evaluationParameterMap_);
-    Evaluator<SimpleScoreCollector> evaluator(patternBook_, &sc);
+    TRACE_SCOPE("MayahAI::eval");
+    SimpleScoreCollector sc(*snapshot.evaluationParameterMap);
+    Evaluator<SimpleScoreCollector> evaluator(*snapshot.patternBook, &sc, memo);
     evaluator.eval(plan, restSeq, currentFrameId, maxIteration, me, enemy, preEvalResult, midEvalResult, fast, usesRensaHandTree_, gazeResult);
 
     const CollectedSimpleScore& simpleScore = sc.collectedScore();
     return EvalResult(simpleScore.score(sc.collectedCoef()), sc.estimatedRensaScore());
 }
 
-CollectedFeatureCoefScore MayahAI::evalWithCollectingFeature(const RefPlan& plan,
-                                                             const KumipuyoSeq& restSeq,
+CollectedFeatureCoefScore MayahAI::evalWithCollectingFeature(const MayahAISnapshot& snapshot,
+                                                             const RefPlan& plan,
+                                                             KumipuyoSeqView restSeq,
                                                              int currentFrameId,
                                                              int maxIteration,
                                                              const PlayerState& me,
@@ -310,14 +501,32 @@ CollectedFeatureCoefScore MayahAI::evalWithCollectingFeature(const RefPlan& plan
                                                              bool fast,
                                                              const GazeResult& gazeResult) const
 {
-    FeatureScoreCollector sc(evaluationParameterMap_);
-    Evaluator<FeatureScoreCollector> evaluator(patternBook_, &sc);
+    FeatureScoreCollector sc(*snapshot.evaluationParameterMap);
+    Evaluator<FeatureScoreCollector> evaluator(*snapshot.patternBook, &sc);
     evaluator.eval(plan, restSeq, currentFrameId, maxIteration, me, enemy, preEvalResult, midEvalResult, fast, usesRensaHandTree_, gazeResult);
 
     return CollectedFeatureCoefScore(sc.collectedCoef(), sc.collectedScore());
 }
 
-std::string MayahAI::makeMessageFrom(int frameId, const KumipuyoSeq& kumipuyoSeq, int maxIteration,
+void MayahAI::dumpTrace(int frameId) const
+{
+    // The events since the last decision, including the gazes, belong to this decision.
+    unsigned long long endCycles = base::Trace::now();
+    vector<base::TraceEvent> events = base::Trace::collect(traceBeginCycles_);
+    traceBeginCycles_ = endCycles;
+
+    LOG(INFO) << "trace: frameId=" << frameId << " events=" << events.size() << endl
+              << base::Trace::toSummaryString(events);
+
+    if (FLAGS_trace_dir.empty())
+        return;
+
+    string filename = file::joinPath(FLAGS_trace_dir, "mayah-" + to_string(frameId) + ".json");
+    if (!file::writeFile(filename, base::Trace::toChromeTraceJson(events)))
+        LOG(ERROR) << "failed to write trace to " << filename;
+}
+
+std::string MayahAI::makeMessageFrom(const MayahAISnapshot& snapshot, int frameId, const KumipuyoSeq& kumipuyoSeq, int maxIteration,
                                      const PlayerState& me, const PlayerState& enemy,
                                      const PreEvalResult& preEvalResult, const MidEvalResult& midEvalResult,
                                      const GazeResult& gazeResult,
@@ -331,7 +540,7 @@ std::string MayahAI::makeMessageFrom(int frameId, const KumipuyoSeq& kumipuyoSeq
 
     RefPlan refPlan(plan);
     CollectedFeatureCoefScore cf =
-        evalWithCollectingFeature(refPlan, kumipuyoSeq.subsequence(refPlan.decisions().size()),
+        evalWithCollectingFeature(snapshot, refPlan, KumipuyoSeqView(kumipuyoSeq).subsequence(refPlan.decisions().size()),
                                   frameId, maxIteration, me, enemy, preEvalResult, midEvalResult, fast, gazeResult);
 
 
@@ -451,10 +660,22 @@ void MayahAI::onGameWillBegin(const FrameRequest& frameRequest)
 
 void MayahAI::gaze(int frameId, const CoreField& enemyField, const KumipuyoSeq& kumipuyoSeq)
 {
-    gazer_.gaze(frameId, enemyField, kumipuyoSeq);
+    gazer_.gaze(frameId, enemyField, kumipuyoSeq, executor_);
+}
+
+void DebuggableMayahAI::removeNontokopuyoParameter()
+{
+    shared_ptr<EvaluationParameterMap> map = make_shared<EvaluationParameterMap>(*snapshot()->evaluationParameterMap);
+    map->removeNontokopuyoParameter();
+    setEvaluationParameterMapToSnapshot(std::move(map));
 }
 
 void DebuggableMayahAI::setEvaluationParameterMap(const EvaluationParameterMap& map)
 {
-    evaluationParameterMap_.loadValue(map.toTomlValue());
+    shared_ptr<EvaluationParameterMap> newMap = make_shared<EvaluationParameterMap>();
+    if (!newMap->loadValue(map.toTomlValue())) {
+        LOG(ERROR) << "failed to set the parameter. The current parameter is kept.";
+        return;
+    }
+    setEvaluationParameterMapToSnapshot(std::move(newMap));
 }
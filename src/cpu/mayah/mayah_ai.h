@@ -2,22 +2,27 @@
 #define CPU_MAYAH_MAYAH_AI_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "base/executor.h"
+#include "base/file/file_watcher.h"
 #include "core/plan/plan.h"
 #include "core/client/ai/ai.h"
+#include "core/kumipuyo_seq_view.h"
 #include "core/pattern/decision_book.h"
 #include "core/pattern/pattern_book.h"
 
 #include "evaluation_parameter.h"
 #include "evaluator.h"
 #include "gazer.h"
+#include "opening_book.h"
 
 class CoreField;
 class DropDecision;
 class KumipuyoSeq;
+class RensaDetectionMemo;
 
 struct ThoughtResult {
     ThoughtResult() {}
@@ -35,6 +40,17 @@ struct ThoughtResult {
     std::string message;
 };
 
+// MayahAISnapshot is the evaluation parameters and the books which MayahAI evaluates with.
+// A snapshot is immutable once it's published. A search takes the snapshot when it starts,
+// and keeps using it even if the files are reloaded meanwhile.
+struct MayahAISnapshot {
+    std::shared_ptr<const EvaluationParameterMap> evaluationParameterMap;
+    std::shared_ptr<const DecisionBook> decisionBook;
+    std::shared_ptr<const PatternBook> patternBook;
+    // This is not reloaded.
+    std::shared_ptr<const OpeningBook> openingBook;
+};
+
 class MayahAI : public AI {
 public:
     static const int DEFAULT_DEPTH = 2;
@@ -42,7 +58,13 @@ public:
     static const int FAST_DEPTH = 2;
     static const int FAST_NUM_ITERATION = 2;
 
-    MayahAI(int argc, char* argv[], Executor* executor = nullptr);
+    // When |snapshot| is specified, the AI evaluates with it instead of loading the files.
+    // This is for sharing the books among the AIs in one process. Such an AI doesn't
+    // reload the files.
+    // When |connector| is specified, the AI uses it instead of making one from --connector.
+    MayahAI(int argc, char* argv[], Executor* executor = nullptr,
+            std::shared_ptr<const MayahAISnapshot> snapshot = nullptr,
+            std::unique_ptr<ClientConnector> connector = nullptr);
     ~MayahAI() override;
 
     DropDecision think(int frameId, const CoreField&, const KumipuyoSeq&,
@@ -59,41 +81,72 @@ public:
                             int depth, int maxIteration, bool fast = false,
                             std::vector<Decision>* specifiedDecisions = nullptr) const;
 
+    // Loads a snapshot from --feature, --decision_book, --pattern_book and --opening_book.
+    // |*evaluationParameterPath| is set to the path where the feature is loaded from.
+    static std::shared_ptr<const MayahAISnapshot> loadSnapshot(std::string* evaluationParameterPath = nullptr);
+
+    // Returns the current snapshot. This is safe to call from any thread.
+    std::shared_ptr<const MayahAISnapshot> snapshot() const { return std::atomic_load(&snapshot_); }
+
 protected:
-    PreEvalResult preEval(const CoreField& currentField) const;
-    MidEvalResult midEval(const RefPlan&, const CoreField& currentField,
-                          const KumipuyoSeq& restSeq,
+    PreEvalResult preEval(const MayahAISnapshot&, const CoreField& currentField) const;
+    MidEvalResult midEval(const MayahAISnapshot&, const RefPlan&, const CoreField& currentField,
+                          KumipuyoSeqView restSeq,
                           int currentFrameId, int maxIteration,
                           const PlayerState& me, const PlayerState& enemy,
-                          const PreEvalResult&, const GazeResult&) const;
-    EvalResult eval(const RefPlan&, const KumipuyoSeq& restSeq, int currentFrameId, int maxIteration,
+                          const PreEvalResult&, const GazeResult&,
+                          RensaDetectionMemo* memo = nullptr) const;
+    EvalResult eval(const MayahAISnapshot&, const RefPlan&, KumipuyoSeqView restSeq, int currentFrameId, int maxIteration,
                     const PlayerState& me, const PlayerState& enemy,
-                    const PreEvalResult&, const MidEvalResult&, bool fast, const GazeResult&) const;
+                    const PreEvalResult&, const MidEvalResult&, bool fast, const GazeResult&,
+                    RensaDetectionMemo* memo = nullptr) const;
     CollectedFeatureCoefScore evalWithCollectingFeature(
-        const RefPlan&, const KumipuyoSeq& restSeq, int currentFrameId, int maxIteration,
+        const MayahAISnapshot&, const RefPlan&, KumipuyoSeqView restSeq, int currentFrameId, int maxIteration,
         const PlayerState& me, const PlayerState& enemy,
         const PreEvalResult&, const MidEvalResult&, bool fast, const GazeResult&) const;
 
-    std::string makeMessageFrom(int frameId, const KumipuyoSeq&, int maxIteration,
+    std::string makeMessageFrom(const MayahAISnapshot&, int frameId, const KumipuyoSeq&, int maxIteration,
                                 const PlayerState& me, const PlayerState& enemy,
                                 const PreEvalResult&, const MidEvalResult&, const GazeResult&,
                                 const Plan& plan, double rensaScore, double virutalRensaScore,
                                 bool saturated, bool fast,
                                 double thoughtTimeInSeconds) const;
 
+    // Logs the trace of the hot paths since the last decision, and writes it to --trace_dir.
+    void dumpTrace(int frameId) const;
+
     bool saveEvaluationParameter() const;
     bool loadEvaluationParameter();
 
-    EvaluationParameterMap evaluationParameterMap_;
-    DecisionBook decisionBook_;
-    PatternBook patternBook_;
+    // Replaces a part of the current snapshot, and publishes it.
+    void setEvaluationParameterMapToSnapshot(std::shared_ptr<const EvaluationParameterMap>);
+    void setDecisionBookToSnapshot(std::shared_ptr<const DecisionBook>);
+    void setPatternBookToSnapshot(std::shared_ptr<const PatternBook>);
+
+    // Called on the watcher thread when |path| is written. The file is parsed and validated
+    // there. When it's invalid, the current snapshot is kept.
+    void reload(const std::string& path);
+
+    // Publish a new snapshot instead of modifying this. Read with snapshot().
+    std::shared_ptr<const MayahAISnapshot> snapshot_;
+    // Serializes the updates of |snapshot_|.
+    std::mutex snapshotUpdateMu_;
+
+    // The paths where the snapshot has been loaded from.
+    std::string evaluationParameterPath_;
+    std::string decisionBookPath_;
+    std::string patternBookPath_;
+    std::unique_ptr<file::FileWatcher> fileWatcher_;
 
     bool usesDecisionBook_ = true;
     bool usesRensaHandTree_ = true;
+    bool usesRensaDetectionMemo_;
 
     Executor* executor_;
 
     Gazer gazer_;
+
+    mutable unsigned long long traceBeginCycles_ = 0;
 };
 
 class DebuggableMayahAI : public MayahAI {
@@ -122,12 +175,16 @@ public:
 
     const Gazer& gazer() const { return gazer_; }
 
+    void setUsesDecisionBook(bool flag) { usesDecisionBook_ = flag; }
     void setUsesRensaHandTree(bool flag) { usesRensaHandTree_ = flag; }
+    void setUsesRensaDetectionMemo(bool flag) { usesRensaDetectionMemo_ = flag; }
 
-    void removeNontokopuyoParameter() { evaluationParameterMap_.removeNontokopuyoParameter(); }
+    void removeNontokopuyoParameter();
 
-    const EvaluationParameterMap& evaluationParameterMap() const { return evaluationParameterMap_; }
+    EvaluationParameterMap evaluationParameterMap() const { return *snapshot()->evaluationParameterMap; }
     void setEvaluationParameterMap(const EvaluationParameterMap&);
+
+    using MayahAI::reload;
 };
 
 #endif // CPU_MAYAH_MAYAH_AI_H_
@@ -1,9 +1,6 @@
-#include <iostream>
+#include <glog/logging.h>
 
-#include <gflags/gflags.h>
-#include <gtest/gtest.h>
-
-#include "base/time_stamp_counter.h"
+#include "base/benchmark.h"
 #include "core/plan/plan.h"
 #include "core/core_field.h"
 #include "core/frame_request.h"
@@ -14,7 +11,7 @@
 
 using namespace std;
 
-unique_ptr<MayahAI> makeAI(Executor* executor)
+static unique_ptr<MayahAI> makeAI(Executor* executor)
 {
     int argc = 1;
     char arg[] = "mayah";
@@ -30,7 +27,7 @@ unique_ptr<MayahAI> makeAI(Executor* executor)
     return unique_ptr<MayahAI>(ai);
 }
 
-CoreField fulfilledField() {
+static CoreField fulfilledField() {
     return CoreField(
             "G   YG"
             "R   YY"
@@ -44,7 +41,7 @@ CoreField fulfilledField() {
             "RGYRGY");
 }
 
-KumipuyoSeq defaultKumipuyoSeq(int n)
+static KumipuyoSeq defaultKumipuyoSeq(int n)
 {
     switch (n) {
     case 2:
@@ -58,73 +55,69 @@ KumipuyoSeq defaultKumipuyoSeq(int n)
     }
 }
 
-void runTest(int depth, int iteration, const CoreField& cf, const KumipuyoSeq& kumipuyoSeq)
+static void benchmarkThinkPlan(base::Benchmark& benchmark, int depth, int iteration,
+                    const CoreField& cf, const KumipuyoSeq& kumipuyoSeq)
 {
-    TimeStampCounterData tsc;
-
     unique_ptr<Executor> executor(Executor::makeDefaultExecutor());
     unique_ptr<MayahAI> ai(makeAI(executor.get()));
     int frameId = 1;
 
-    for (int i = 0; i < 3; ++i) {
-        ScopedTimeStampCounter stsc(&tsc);
-        (void)ai->thinkPlan(frameId, cf, kumipuyoSeq, PlayerState(), PlayerState(), depth, iteration);
-    }
-
-    tsc.showStatistics();
+    benchmark.measure([&]() {
+        base::doNotOptimize(ai->thinkPlan(frameId, cf, kumipuyoSeq, PlayerState(), PlayerState(), depth, iteration));
+    });
 }
 
-TEST(MayahAIPerformanceTest, seq2_depth2_iter2)
+BENCHMARK(MayahAIBenchmark, seq2_depth2_iter2)
 {
-    runTest(2, 2, CoreField(), defaultKumipuyoSeq(2));
+    benchmarkThinkPlan(benchmark, 2, 2, CoreField(), defaultKumipuyoSeq(2));
 }
 
-TEST(MayahAIPerformanceTest, seq2_depth2_iter2_fulfilled)
+BENCHMARK(MayahAIBenchmark, seq2_depth2_iter2_fulfilled)
 {
-    runTest(2, 2, fulfilledField(), defaultKumipuyoSeq(2));
+    benchmarkThinkPlan(benchmark, 2, 2, fulfilledField(), defaultKumipuyoSeq(2));
 }
 
-TEST(MayahAIPerformanceTest, seq2_depth2_iter3)
+BENCHMARK(MayahAIBenchmark, seq2_depth2_iter3)
 {
-    runTest(2, 3, CoreField(), defaultKumipuyoSeq(2));
+    benchmarkThinkPlan(benchmark, 2, 3, CoreField(), defaultKumipuyoSeq(2));
 }
 
-TEST(MayahAIPerformanceTest, seq2_depth2_iter3_fulfilled)
+BENCHMARK(MayahAIBenchmark, seq2_depth2_iter3_fulfilled)
 {
-    runTest(2, 3, fulfilledField(), defaultKumipuyoSeq(2));
+    benchmarkThinkPlan(benchmark, 2, 3, fulfilledField(), defaultKumipuyoSeq(2));
 }
 
-TEST(MayahAIPerformanceTest, seq3_depth3_iter1)
+BENCHMARK(MayahAIBenchmark, seq3_depth3_iter1)
 {
-    runTest(3, 1, CoreField(), defaultKumipuyoSeq(3));
+    benchmarkThinkPlan(benchmark, 3, 1, CoreField(), defaultKumipuyoSeq(3));
 }
 
-TEST(MayahAIPerformanceTest, seq3_depth3_iter1_fulfilled)
+BENCHMARK(MayahAIBenchmark, seq3_depth3_iter1_fulfilled)
 {
-    runTest(3, 1, fulfilledField(), defaultKumipuyoSeq(3));
+    benchmarkThinkPlan(benchmark, 3, 1, fulfilledField(), defaultKumipuyoSeq(3));
 }
 
-TEST(MayahAIPerformanceTest, seq3_depth3_iter2)
+BENCHMARK(MayahAIBenchmark, seq3_depth3_iter2)
 {
-    runTest(3, 2, CoreField(), defaultKumipuyoSeq(3));
+    benchmarkThinkPlan(benchmark, 3, 2, CoreField(), defaultKumipuyoSeq(3));
 }
 
-TEST(MayahAIPerformanceTest, seq3_depth3_iter2_fulfilled)
+BENCHMARK(MayahAIBenchmark, seq3_depth3_iter2_fulfilled)
 {
-    runTest(3, 2, fulfilledField(), defaultKumipuyoSeq(3));
+    benchmarkThinkPlan(benchmark, 3, 2, fulfilledField(), defaultKumipuyoSeq(3));
 }
 
-TEST(MayahAIPerformanceTest, seq3_depth3_iter3)
+BENCHMARK(MayahAIBenchmark, seq3_depth3_iter3)
 {
-    runTest(3, 3, CoreField(), defaultKumipuyoSeq(3));
+    benchmarkThinkPlan(benchmark, 3, 3, CoreField(), defaultKumipuyoSeq(3));
 }
 
-TEST(MayahAIPerformanceTest, seq3_depth3_iter3_fulfilled)
+BENCHMARK(MayahAIBenchmark, seq3_depth3_iter3_fulfilled)
 {
-    runTest(3, 3, fulfilledField(), defaultKumipuyoSeq(3));
+    benchmarkThinkPlan(benchmark, 3, 3, fulfilledField(), defaultKumipuyoSeq(3));
 }
 
-TEST(MayahAIPerformanceTest, seq4_depth3_iter1_real)
+BENCHMARK(MayahAIBenchmark, seq4_depth3_iter1_real)
 {
     CoreField f(
         "    RB"
@@ -138,10 +131,10 @@ TEST(MayahAIPerformanceTest, seq4_depth3_iter1_real)
         "YYBBBR");
     KumipuyoSeq seq("RBRGRYYG");
 
-    runTest(3, 1, f, seq);
+    benchmarkThinkPlan(benchmark, 3, 1, f, seq);
 }
 
-TEST(MayahAIPerformanceTest, slow_pattern_from_real_1)
+BENCHMARK(MayahAIBenchmark, slow_pattern_from_real_1)
 {
     CoreField f(
         "    RB"
@@ -155,10 +148,10 @@ TEST(MayahAIPerformanceTest, slow_pattern_from_real_1)
         "YYBBBR");
     KumipuyoSeq seq("RBRGRYYG");
 
-    runTest(3, 2, f, seq);
+    benchmarkThinkPlan(benchmark, 3, 2, f, seq);
 }
 
-TEST(MayahAIPerformanceTest, slow_pattern_from_real_2)
+BENCHMARK(MayahAIBenchmark, slow_pattern_from_real_2)
 {
     CoreField f(
         "   B  "
@@ -172,10 +165,10 @@ TEST(MayahAIPerformanceTest, slow_pattern_from_real_2)
         "YYYGBR");
     KumipuyoSeq seq("GYRYRG");
 
-    runTest(3, 2, f, seq);
+    benchmarkThinkPlan(benchmark, 3, 2, f, seq);
 }
 
-TEST(MayahAIPerformanceTest, slow_pattern_from_real_3)
+BENCHMARK(MayahAIBenchmark, slow_pattern_from_real_3)
 {
     CoreField f(
         "  G   "
@@ -186,10 +179,10 @@ TEST(MayahAIPerformanceTest, slow_pattern_from_real_3)
         "YYYRRR");
     KumipuyoSeq seq("BYBGYB");
 
-    runTest(3, 2, f, seq);
+    benchmarkThinkPlan(benchmark, 3, 2, f, seq);
 }
 
-TEST(MayahAIPerformanceTest, slow_pattern_from_real_4)
+BENCHMARK(MayahAIBenchmark, slow_pattern_from_real_4)
 {
     CoreField f("R     "
                 "R     "
@@ -200,10 +193,10 @@ TEST(MayahAIPerformanceTest, slow_pattern_from_real_4)
                 "BRRYRR");
     KumipuyoSeq seq("GBBYRB");
 
-    runTest(MayahAI::DEFAULT_DEPTH, MayahAI::DEFAULT_NUM_ITERATION, f, seq);
+    benchmarkThinkPlan(benchmark, MayahAI::DEFAULT_DEPTH, MayahAI::DEFAULT_NUM_ITERATION, f, seq);
 }
 
-TEST(MayahAIPerformanceTest, slow_pattern_from_real_5)
+BENCHMARK(MayahAIBenchmark, slow_pattern_from_real_5)
 {
     CoreField f("   R  "
                 "   BY "
@@ -215,10 +208,10 @@ TEST(MayahAIPerformanceTest, slow_pattern_from_real_5)
                 "BBBRRR");
     KumipuyoSeq seq("GBGBRGBB");
 
-    runTest(MayahAI::DEFAULT_DEPTH, MayahAI::DEFAULT_NUM_ITERATION, f, seq);
+    benchmarkThinkPlan(benchmark, MayahAI::DEFAULT_DEPTH, MayahAI::DEFAULT_NUM_ITERATION, f, seq);
 }
 
-TEST(MayahAIPerformanceTest, slow_pattern_from_real_6)
+BENCHMARK(MayahAIBenchmark, slow_pattern_from_real_6)
 {
     CoreField cf("    B "
                  "Y   R "
@@ -233,14 +226,5 @@ TEST(MayahAIPerformanceTest, slow_pattern_from_real_6)
                  "RRRYRR");
 
     KumipuyoSeq seq("BRGY");
-    runTest(MayahAI::DEFAULT_DEPTH, MayahAI::DEFAULT_NUM_ITERATION, cf, seq);
-}
-
-int main(int argc, char* argv[])
-{
-    google::InitGoogleLogging(argv[0]);
-    testing::InitGoogleTest(&argc, argv);
-    google::ParseCommandLineFlags(&argc, &argv, true);
-
-    return RUN_ALL_TESTS();
+    benchmarkThinkPlan(benchmark, MayahAI::DEFAULT_DEPTH, MayahAI::DEFAULT_NUM_ITERATION, cf, seq);
 }
@@ -1,14 +1,24 @@
 #include "mayah_ai.h"
 
+#include <stdlib.h>
+#include <unistd.h>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
 #include "base/executor.h"
+#include "base/file/file.h"
+#include "base/file/path.h"
 #include "core/frame_request.h"
 #include "core/kumipuyo_seq.h"
 #include "core/probability/puyo_set_probability.h"
 
+DECLARE_string(feature);
+DECLARE_string(decision_book);
+DECLARE_string(pattern_book);
+DECLARE_bool(hot_reload);
+
 using namespace std;
 
 static unique_ptr<DebuggableMayahAI> makeAI(Executor* executor = nullptr)
@@ -266,6 +276,168 @@ TEST(MayahAITest, DontCrash3)
     (void)ai->think(100, f, seq, me, enemy, false);
 }
 
+TEST(MayahAITest, snapshotIsKeptWhileUpdated)
+{
+    auto ai = makeAI();
+
+    shared_ptr<const MayahAISnapshot> snapshot = ai->snapshot();
+    const double totalFrames = snapshot->evaluationParameterMap->moveParamSet().param(EvaluationMode::EARLY, TOTAL_FRAMES);
+
+    EvaluationParameterMap map = ai->evaluationParameterMap();
+    map.mutableMoveParamSet()->setParam(EvaluationMode::EARLY, TOTAL_FRAMES, totalFrames + 1.0);
+    ai->setEvaluationParameterMap(map);
+
+    // The old snapshot is not modified.
+    EXPECT_EQ(totalFrames, snapshot->evaluationParameterMap->moveParamSet().param(EvaluationMode::EARLY, TOTAL_FRAMES));
+
+    shared_ptr<const MayahAISnapshot> newSnapshot = ai->snapshot();
+    EXPECT_NE(snapshot, newSnapshot);
+    EXPECT_EQ(totalFrames + 1.0, newSnapshot->evaluationParameterMap->moveParamSet().param(EvaluationMode::EARLY, TOTAL_FRAMES));
+    // The books are shared.
+    EXPECT_EQ(snapshot->decisionBook, newSnapshot->decisionBook);
+    EXPECT_EQ(snapshot->patternBook, newSnapshot->patternBook);
+}
+
+class MayahAIReloadTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/mayah_ai_test.XXXXXX";
+        ASSERT_TRUE(mkdtemp(tmpl) != nullptr);
+        dir_ = tmpl;
+        featurePath_ = file::joinPath(dir_, "feature.toml");
+
+        decisionBookPath_ = file::joinPath(dir_, "decision.toml");
+        patternBookPath_ = file::joinPath(dir_, "pattern.toml");
+
+        ASSERT_TRUE(writeFeature(1.0));
+        ASSERT_TRUE(file::copyFile(FLAGS_decision_book, decisionBookPath_));
+        ASSERT_TRUE(file::copyFile(FLAGS_pattern_book, patternBookPath_));
+
+        originalFeature_ = FLAGS_feature;
+        originalDecisionBook_ = FLAGS_decision_book;
+        originalPatternBook_ = FLAGS_pattern_book;
+        FLAGS_feature = featurePath_;
+        FLAGS_decision_book = decisionBookPath_;
+        FLAGS_pattern_book = patternBookPath_;
+    }
+
+    void TearDown() override
+    {
+        FLAGS_feature = originalFeature_;
+        FLAGS_decision_book = originalDecisionBook_;
+        FLAGS_pattern_book = originalPatternBook_;
+        FLAGS_hot_reload = false;
+        file::remove(featurePath_);
+        file::remove(decisionBookPath_);
+        file::remove(patternBookPath_);
+        rmdir(dir_.c_str());
+    }
+
+    bool writeFeature(double totalFrames)
+    {
+        return file::writeFile(featurePath_,
+                               "[mode.default.move]\nTOTAL_FRAMES = " + to_string(totalFrames) + "\n"
+                               "[mode.default.main]\n"
+                               "[mode.default.side]\n");
+    }
+
+    static double totalFrames(const MayahAISnapshot& snapshot)
+    {
+        return snapshot.evaluationParameterMap->moveParamSet().param(EvaluationMode::EARLY, TOTAL_FRAMES);
+    }
+
+    string dir_;
+    string featurePath_;
+    string decisionBookPath_;
+    string patternBookPath_;
+    string originalFeature_;
+    string originalDecisionBook_;
+    string originalPatternBook_;
+};
+
+TEST_F(MayahAIReloadTest, reload)
+{
+    auto ai = makeAI();
+    shared_ptr<const MayahAISnapshot> snapshot = ai->snapshot();
+    EXPECT_EQ(1.0, totalFrames(*snapshot));
+
+    // An invalid file is ignored.
+    ASSERT_TRUE(file::writeFile(featurePath_, "[mode.default.move]\nUNKNOWN_FEATURE = 1.0\n"));
+    ai->reload(featurePath_);
+    EXPECT_EQ(snapshot, ai->snapshot());
+
+    ASSERT_TRUE(writeFeature(2.0));
+    ai->reload(featurePath_);
+
+    EXPECT_EQ(1.0, totalFrames(*snapshot));
+    EXPECT_EQ(2.0, totalFrames(*ai->snapshot()));
+    EXPECT_EQ(snapshot->patternBook, ai->snapshot()->patternBook);
+}
+
+TEST_F(MayahAIReloadTest, malformedFilesAreIgnored)
+{
+    auto ai = makeAI();
+    shared_ptr<const MayahAISnapshot> snapshot = ai->snapshot();
+
+    string fourteenRows = "\"A.....\"";
+    for (int i = 1; i < 14; ++i)
+        fourteenRows += ", \"A.....\"";
+
+    const struct {
+        string path;
+        string content;
+    } malformedFiles[] = {
+        // An unacceptable character in the field.
+        { patternBookPath_, "[[pattern]]\nfield = [\"AA!...\"]\n" },
+        // A not-var without the var.
+        { patternBookPath_, "[[pattern]]\nfield = [\"AA....\"]\nnot_field = [\"B.....\"]\n" },
+        // A precondition out of the field.
+        { patternBookPath_, "[[pattern]]\nfield = [\"AA....\"]\nprecondition = [[9, 20]]\n" },
+        // Too many rows.
+        { patternBookPath_, "[[pattern]]\nfield = [" + fourteenRows + "]\n" },
+        // No book.
+        { decisionBookPath_, "[[field]]\n" },
+        // An unacceptable character in the field.
+        { decisionBookPath_, "[[book]]\nfield = [\"AA!...\"]\nAABB = [3, 0]\n" },
+        // A variable which cannot be matched with a color.
+        { decisionBookPath_, "[[book]]\nfield = [\"E.....\"]\nAABB = [3, 0]\n" },
+        // A next which is not 4 variables.
+        { decisionBookPath_, "[[book]]\nfield = [\"......\"]\nAAB = [3, 0]\n" },
+        // An invalid decision.
+        { decisionBookPath_, "[[book]]\nfield = [\"......\"]\nAABB = [7, 0]\n" },
+        // Not a number.
+        { featurePath_, "[mode.default.move]\nTOTAL_FRAMES = \"a\"\n[mode.default.main]\n[mode.default.side]\n" },
+    };
+
+    for (const auto& f : malformedFiles) {
+        ASSERT_TRUE(file::writeFile(f.path, f.content));
+        ai->reload(f.path);
+        EXPECT_EQ(snapshot, ai->snapshot()) << f.content;
+    }
+
+    // The AI keeps running with the current snapshot.
+    CoreField field(
+        "  G   "
+        "RRBBGG");
+    ThoughtResult thoughtResult = ai->thinkPlan(1, field, KumipuyoSeq("RRBB"), PlayerState(), PlayerState(), 2, 2);
+    EXPECT_FALSE(thoughtResult.plan.decisions().empty());
+}
+
+TEST_F(MayahAIReloadTest, hotReload)
+{
+    FLAGS_hot_reload = true;
+    auto ai = makeAI();
+    EXPECT_EQ(1.0, totalFrames(*ai->snapshot()));
+
+    ASSERT_TRUE(writeFeature(2.0));
+
+    // The file is reloaded on the watcher thread.
+    for (int i = 0; i < 500 && totalFrames(*ai->snapshot()) != 2.0; ++i)
+        usleep(10 * 1000);
+    EXPECT_EQ(2.0, totalFrames(*ai->snapshot()));
+}
+
 #if 0
 TEST(MayahAITest, setEvaluationParameter)
 {
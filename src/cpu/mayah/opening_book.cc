@@ -0,0 +1,125 @@
+#include "opening_book.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "base/file/file.h"
+#include "base/strings.h"
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+#include "core/puyo_color.h"
+
+using namespace std;
+
+namespace {
+
+// Renames the normal colors in the order of appearance.
+class ColorCanonicalizer {
+public:
+    char canonical(PuyoColor c)
+    {
+        if (!isNormalColor(c))
+            return c == PuyoColor::OJAMA ? 'O' : toChar(c);
+
+        int i = normalColorIndex(c);
+        if (names_[i] == 0)
+            names_[i] = static_cast<char>('A' + numNames_++);
+        return names_[i];
+    }
+
+private:
+    char names_[NUM_NORMAL_PUYO_COLORS] {};
+    int numNames_ = 0;
+};
+
+} // anonymous namespace
+
+const int OpeningBook::NUM_KUMIPUYOS;
+
+// static
+string OpeningBook::makeKey(const CoreField& field, const KumipuyoSeq& seq)
+{
+    if (seq.size() < NUM_KUMIPUYOS)
+        return string();
+
+    ColorCanonicalizer canonicalizer;
+    string key;
+    key.reserve(NUM_KUMIPUYOS * 2 + 1 + 6 * 13 + 5);
+    for (int i = 0; i < NUM_KUMIPUYOS; ++i) {
+        key += canonicalizer.canonical(seq.axis(i));
+        key += canonicalizer.canonical(seq.child(i));
+    }
+
+    key += '/';
+    for (int x = 1; x <= FieldConstant::WIDTH; ++x) {
+        if (x > 1)
+            key += '.';
+        for (int y = 1; y <= field.height(x); ++y)
+            key += canonicalizer.canonical(field.color(x, y));
+    }
+
+    return key;
+}
+
+Decision OpeningBook::nextDecision(const CoreField& field, const KumipuyoSeq& seq) const
+{
+    auto it = decisions_.find(makeKey(field, seq));
+    if (it == decisions_.end())
+        return Decision();
+    return it->second;
+}
+
+bool OpeningBook::load(const string& filename)
+{
+    string content;
+    if (!file::readFile(filename, &content))
+        return false;
+
+    return loadFromString(content);
+}
+
+bool OpeningBook::loadFromString(const string& content)
+{
+    istringstream iss(content);
+    string line;
+    int lineNo = 0;
+    while (getline(iss, line)) {
+        ++lineNo;
+        line = strings::trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        istringstream lss(line);
+        string key;
+        int x, r;
+        if (!(lss >> key >> x >> r) || !Decision(x, r).isValid()) {
+            LOG(ERROR) << "invalid opening book entry at line " << lineNo << ": " << line;
+            return false;
+        }
+        add(key, Decision(x, r));
+    }
+
+    return true;
+}
+
+bool OpeningBook::save(const string& filename) const
+{
+    return file::writeFile(filename, toString());
+}
+
+string OpeningBook::toString() const
+{
+    vector<pair<string, Decision>> entries(decisions_.begin(), decisions_.end());
+    sort(entries.begin(), entries.end(), [](const pair<string, Decision>& lhs, const pair<string, Decision>& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    ostringstream oss;
+    for (const auto& entry : entries)
+        oss << entry.first << ' ' << entry.second.x << ' ' << entry.second.r << '\n';
+    return oss.str();
+}
@@ -0,0 +1,53 @@
+#ifndef CPU_MAYAH_OPENING_BOOK_H_
+#define CPU_MAYAH_OPENING_BOOK_H_
+
+#include <string>
+#include <unordered_map>
+
+#include "base/noncopyable.h"
+#include "core/decision.h"
+
+class CoreField;
+class KumipuyoSeq;
+
+// OpeningBook is a table from a (field, the first 3 kumipuyos) to the decision.
+// Unlike DecisionBook, this is generated offline by opening_book_generator, and
+// looked up with one hash lookup.
+//
+// The key is color-canonical: the colors are renamed to 'A', 'B', 'C', 'D' in the
+// order they appear in the kumipuyos and then in the field (column by column from
+// the bottom), so the color permutations of the same state share one entry.
+//
+// The file has one entry in a line: "<key> <x> <r>". A line starting with '#' is a comment.
+class OpeningBook : noncopyable {
+public:
+    static const int NUM_KUMIPUYOS = 3;
+
+    OpeningBook() {}
+
+    bool load(const std::string& filename);
+    bool loadFromString(const std::string&);
+    bool save(const std::string& filename) const;
+    // The entries are sorted by the key.
+    std::string toString() const;
+
+    void add(const std::string& key, const Decision& decision) { decisions_[key] = decision; }
+    void add(const CoreField& field, const KumipuyoSeq& seq, const Decision& decision) { add(makeKey(field, seq), decision); }
+
+    // Returns the decision for |field| and |seq|. If not found, invalid Decision will be returned.
+    Decision nextDecision(const CoreField& field, const KumipuyoSeq& seq) const;
+
+    size_t size() const { return decisions_.size(); }
+    bool isEmpty() const { return decisions_.empty(); }
+
+    // Returns the key of |field| and the first NUM_KUMIPUYOS kumipuyos of |seq|.
+    // An empty string is returned if |seq| is too short.
+    // e.g. "ABBACC/AB....." means the kumipuyos are AB, BA, CC, and the field has A and B
+    // on the 1st column. The columns are separated by '.'.
+    static std::string makeKey(const CoreField& field, const KumipuyoSeq& seq);
+
+private:
+    std::unordered_map<std::string, Decision> decisions_;
+};
+
+#endif // CPU_MAYAH_OPENING_BOOK_H_
@@ -0,0 +1,166 @@
+#include "mayah_ai.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "base/executor.h"
+#include "base/time.h"
+#include "base/wait_group.h"
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+
+#include "opening_book.h"
+
+// Generates the opening book. All the color-canonical kumipuyo sequences of the first
+// --num_hands hands are searched with MayahAI::thinkPlan. The number of threads is
+// specified with --num_threads.
+DEFINE_int32(num_hands, 3, "the number of hands to generate the book for.");
+DEFINE_int32(depth, 3, "the depth of thinkPlan.");
+DEFINE_int32(max_iteration, 3, "the max iteration of thinkPlan.");
+DEFINE_string(output, "opening_book.txt", "the path to write the book.");
+
+using namespace std;
+
+namespace {
+
+const PuyoColor COLORS[NUM_NORMAL_PUYO_COLORS] = {
+    PuyoColor::RED, PuyoColor::BLUE, PuyoColor::YELLOW, PuyoColor::GREEN,
+};
+
+struct State {
+    CoreField field;
+    KumipuyoSeq seq;
+};
+
+// Iterates all the kumipuyo sequences of |numPuyos| puyos whose colors appear in the order
+// of RED, BLUE, YELLOW, GREEN. The other sequences are the color permutations of them.
+void iterateCanonicalSeqs(int numPuyos, const function<void (const KumipuyoSeq&)>& callback)
+{
+    vector<int> colors(numPuyos);
+    function<void (int, int)> iter = [&](int i, int numUsedColors) {
+        if (i == numPuyos) {
+            KumipuyoSeq seq;
+            for (int j = 0; j < numPuyos; j += 2)
+                seq.add(Kumipuyo(COLORS[colors[j]], COLORS[colors[j + 1]]));
+            callback(seq);
+            return;
+        }
+
+        for (int c = 0; c < numUsedColors + 1 && c < NUM_NORMAL_PUYO_COLORS; ++c) {
+            colors[i] = c;
+            iter(i + 1, std::max(numUsedColors, c + 1));
+        }
+    };
+    iter(0, 0);
+}
+
+// Makes the states of the next hand from |state| and its |decision|.
+void addNextStates(const State& state, const Decision& decision, map<string, State>* nextStates)
+{
+    CoreField field(state.field);
+    if (!field.dropKumipuyo(decision, state.seq.front()))
+        return;
+    field.simulate();
+    if (!field.isEmpty(3, 12))
+        return;
+
+    KumipuyoSeq restSeq(state.seq.subsequence(1));
+    for (PuyoColor axis : COLORS) {
+        for (PuyoColor child : COLORS) {
+            KumipuyoSeq seq(restSeq);
+            seq.add(Kumipuyo(axis, child));
+            string key = OpeningBook::makeKey(field, seq);
+            if (!nextStates->count(key))
+                nextStates->emplace(key, State { field, seq });
+        }
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+#if !defined(_MSC_VER)
+    google::InstallFailureSignalHandler();
+#endif
+
+    // Every state has exactly NUM_KUMIPUYOS kumipuyos, and thinkPlan cannot look further than that.
+    if (FLAGS_depth < 1 || OpeningBook::NUM_KUMIPUYOS < FLAGS_depth) {
+        cerr << "--depth must be between 1 and " << OpeningBook::NUM_KUMIPUYOS
+             << ", but " << FLAGS_depth << " is given." << endl;
+        return 1;
+    }
+
+    DebuggableMayahAI ai;
+    // We'd like to find better decisions than the decision book.
+    ai.setUsesDecisionBook(false);
+
+    unique_ptr<Executor> executor = Executor::makeDefaultExecutor();
+
+    map<string, State> states;
+    iterateCanonicalSeqs(OpeningBook::NUM_KUMIPUYOS * 2, [&](const KumipuyoSeq& seq) {
+        CoreField field;
+        states.emplace(OpeningBook::makeKey(field, seq), State { field, seq });
+    });
+
+    OpeningBook book;
+    for (int hand = 0; hand < FLAGS_num_hands; ++hand) {
+        cout << "hand " << (hand + 1) << ": " << states.size() << " states" << endl;
+        double beginTime = currentTime();
+
+        vector<const State*> stateList;
+        for (const auto& entry : states)
+            stateList.push_back(&entry.second);
+        vector<Decision> decisions(stateList.size());
+
+        atomic<int> numDone(0);
+        WaitGroup wg;
+        wg.add(stateList.size());
+        for (size_t i = 0; i < stateList.size(); ++i) {
+            executor->submit([&, i]() {
+                const State& state = *stateList[i];
+                ThoughtResult tr = ai.thinkPlan(1, state.field, state.seq, PlayerState(), PlayerState(),
+                                                FLAGS_depth, FLAGS_max_iteration);
+                if (!tr.plan.decisions().empty())
+                    decisions[i] = tr.plan.decisions().front();
+
+                int n = ++numDone;
+                if (n % 1000 == 0)
+                    LOG(INFO) << "hand " << (hand + 1) << ": " << n << "/" << stateList.size();
+                wg.done();
+            });
+        }
+        wg.waitUntilDone();
+
+        map<string, State> nextStates;
+        for (size_t i = 0; i < stateList.size(); ++i) {
+            if (!decisions[i].isValid())
+                continue;
+            book.add(stateList[i]->field, stateList[i]->seq, decisions[i]);
+            if (hand + 1 < FLAGS_num_hands)
+                addNextStates(*stateList[i], decisions[i], &nextStates);
+        }
+        states.swap(nextStates);
+
+        cout << "  done in " << (currentTime() - beginTime) << " [s]" << endl;
+    }
+
+    if (!book.save(FLAGS_output)) {
+        cerr << "failed to write " << FLAGS_output << endl;
+        return 1;
+    }
+    cout << book.size() << " entries are written to " << FLAGS_output << endl;
+
+    return 0;
+}
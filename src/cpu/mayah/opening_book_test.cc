@@ -0,0 +1,45 @@
+#include "opening_book.h"
+
+#include <gtest/gtest.h>
+
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+
+using namespace std;
+
+TEST(OpeningBookTest, makeKey)
+{
+    EXPECT_EQ("AABBAC/.....", OpeningBook::makeKey(CoreField(), KumipuyoSeq("RRBBRY")));
+    EXPECT_EQ("AABBAC/.....", OpeningBook::makeKey(CoreField(), KumipuyoSeq("GGYYGB")));
+    EXPECT_EQ("ABBACC/A.B....", OpeningBook::makeKey(CoreField("RB...."), KumipuyoSeq("RBBRYYGG")));
+    EXPECT_EQ("ABBACC/B..D...", OpeningBook::makeKey(CoreField("G.R..."), KumipuyoSeq("YGGYBB")));
+
+    // Too short.
+    EXPECT_EQ("", OpeningBook::makeKey(CoreField(), KumipuyoSeq("RRBB")));
+}
+
+TEST(OpeningBookTest, nextDecision)
+{
+    OpeningBook book;
+    book.add(CoreField(), KumipuyoSeq("RRBBRY"), Decision(3, 2));
+    EXPECT_EQ(1U, book.size());
+
+    EXPECT_EQ(Decision(3, 2), book.nextDecision(CoreField(), KumipuyoSeq("YYRRYG")));
+    EXPECT_FALSE(book.nextDecision(CoreField(), KumipuyoSeq("YYRRRG")).isValid());
+    EXPECT_FALSE(book.nextDecision(CoreField("R....."), KumipuyoSeq("RRBBRY")).isValid());
+}
+
+TEST(OpeningBookTest, loadFromString)
+{
+    OpeningBook book;
+    book.add("AABBAC/.....", Decision(3, 2));
+    book.add("AAAAAA/.....", Decision(1, 0));
+
+    OpeningBook loaded;
+    ASSERT_TRUE(loaded.loadFromString("# comment\n" + book.toString()));
+    EXPECT_EQ(2U, loaded.size());
+    EXPECT_EQ("AAAAAA/..... 1 0\nAABBAC/..... 3 2\n", loaded.toString());
+    EXPECT_EQ(Decision(1, 0), loaded.nextDecision(CoreField(), KumipuyoSeq("RRRRRR")));
+
+    EXPECT_FALSE(loaded.loadFromString("AAAAAA/..... 7 0\n"));
+}
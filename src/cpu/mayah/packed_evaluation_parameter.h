@@ -0,0 +1,127 @@
+#ifndef CPU_MAYAH_PACKED_EVALUATION_PARAMETER_H_
+#define CPU_MAYAH_PACKED_EVALUATION_PARAMETER_H_
+
+#include <array>
+#include <vector>
+
+#include <glog/logging.h>
+
+#if defined(__AVX__)
+#include "base/avx.h"
+#endif
+
+#include "evaluation_mode.h"
+
+// A collected feature vector. Each entry is a row of PackedEvaluationParameter and
+// its value. Features are collected here first, and scored for all modes at once later.
+// A collector is made for each detected rensa, so the entries are stored inline instead
+// of on the heap. When the vector is full, the collector should score it and clear it.
+class PackedFeatureVector {
+public:
+    static const int CAPACITY = 64;
+
+    struct Entry {
+        int row;
+        double value;
+    };
+
+    void add(int row, double value)
+    {
+        DCHECK(!full());
+        entries_[size_].row = row;
+        entries_[size_].value = value;
+        ++size_;
+    }
+    void clear() { size_ = 0; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == CAPACITY; }
+    int size() const { return size_; }
+
+    const Entry* begin() const { return entries_.data(); }
+    const Entry* end() const { return entries_.data() + size_; }
+
+private:
+    // Not initialized, since only the first |size_| entries are used.
+    std::array<Entry, CAPACITY> entries_;
+    int size_ = 0;
+};
+
+// PackedEvaluationParameter is a feature x mode matrix of the parameters.
+// Each feature (each index of a sparse feature) has a row, and a row has the parameters
+// of all modes, whose defaults are already resolved. A row is padded to NUM_COLUMNS
+// doubles so that it can be loaded into two AVX registers.
+template<typename FeatureSet>
+class PackedEvaluationParameter {
+public:
+    typedef typename FeatureSet::FeatureKey FeatureKey;
+    typedef typename FeatureSet::SparseFeatureKey SparseFeatureKey;
+
+    static const int NUM_COLUMNS = 8;
+    static_assert(NUM_EVALUATION_MODES <= NUM_COLUMNS, "NUM_COLUMNS is too small");
+
+    PackedEvaluationParameter() :
+        sparseOffsets_(FeatureSet::sparseFeatures().size())
+    {
+        int numRows = FeatureSet::features().size();
+        for (const auto& feature : FeatureSet::sparseFeatures()) {
+            sparseOffsets_[feature.key()] = numRows;
+            numRows += feature.size();
+        }
+        matrix_.resize(numRows * NUM_COLUMNS);
+    }
+
+    int row(FeatureKey key) const { return key; }
+    int row(SparseFeatureKey key, int idx) const { return sparseOffsets_[key] + idx; }
+
+    double param(EvaluationMode mode, FeatureKey key) const { return matrix_[row(key) * NUM_COLUMNS + ordinal(mode)]; }
+    double param(EvaluationMode mode, SparseFeatureKey key, int idx) const
+    {
+        return matrix_[row(key, idx) * NUM_COLUMNS + ordinal(mode)];
+    }
+
+    // Copies the parameters of all modes from |paramSet|.
+    template<typename ParamSet>
+    void pack(const ParamSet& paramSet)
+    {
+        for (const auto& mode : ALL_EVALUATION_MODES) {
+            for (const auto& feature : FeatureSet::features())
+                matrix_[row(feature.key()) * NUM_COLUMNS + ordinal(mode)] = paramSet.param(mode, feature.key());
+            for (const auto& feature : FeatureSet::sparseFeatures()) {
+                for (size_t i = 0; i < feature.size(); ++i)
+                    matrix_[row(feature.key(), i) * NUM_COLUMNS + ordinal(mode)] = paramSet.param(mode, feature.key(), i);
+            }
+        }
+    }
+
+    // Adds the scores of |features| for all modes to |scores|, which has NUM_COLUMNS elements.
+    void score(const PackedFeatureVector& features, double* scores) const
+    {
+#if defined(__AVX__)
+        __m256d lo = _mm256_loadu_pd(scores);
+        __m256d hi = _mm256_loadu_pd(scores + 4);
+        for (const auto& entry : features) {
+            const double* p = &matrix_[entry.row * NUM_COLUMNS];
+            const __m256d v = _mm256_set1_pd(entry.value);
+            lo = _mm256_add_pd(lo, _mm256_mul_pd(_mm256_loadu_pd(p), v));
+            hi = _mm256_add_pd(hi, _mm256_mul_pd(_mm256_loadu_pd(p + 4), v));
+        }
+        _mm256_storeu_pd(scores, lo);
+        _mm256_storeu_pd(scores + 4, hi);
+#else
+        for (const auto& entry : features) {
+            const double* p = &matrix_[entry.row * NUM_COLUMNS];
+            for (int i = 0; i < NUM_EVALUATION_MODES; ++i)
+                scores[i] += p[i] * entry.value;
+        }
+#endif
+    }
+
+private:
+    std::vector<int> sparseOffsets_;
+    std::vector<double> matrix_;
+};
+
+template<typename FeatureSet>
+const int PackedEvaluationParameter<FeatureSet>::NUM_COLUMNS;
+
+#endif // CPU_MAYAH_PACKED_EVALUATION_PARAMETER_H_
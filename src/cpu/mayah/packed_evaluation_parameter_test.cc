@@ -0,0 +1,71 @@
+#include "packed_evaluation_parameter.h"
+
+#include <gtest/gtest.h>
+
+#include "evaluation_parameter.h"
+
+using namespace std;
+
+TEST(PackedEvaluationParameterTest, pack)
+{
+    EvaluationMoveParameterSet paramSet;
+    paramSet.setDefault(TOTAL_FRAMES, 1.0);
+    paramSet.setParam(EvaluationMode::EARLY, TOTAL_FRAMES, 2.0);
+    paramSet.setDefault(VALLEY_DEPTH, 3, -10.0);
+    paramSet.setParam(EvaluationMode::LATE, VALLEY_DEPTH, 3, -20.0);
+
+    const PackedEvaluationParameter<EvaluationMoveFeatureSet>& packed = paramSet.packed();
+    for (const auto& mode : ALL_EVALUATION_MODES) {
+        EXPECT_EQ(paramSet.param(mode, TOTAL_FRAMES), packed.param(mode, TOTAL_FRAMES));
+        EXPECT_EQ(paramSet.param(mode, NUM_CHIGIRI), packed.param(mode, NUM_CHIGIRI));
+        for (int i = 0; i < 5; ++i)
+            EXPECT_EQ(paramSet.param(mode, VALLEY_DEPTH, i), packed.param(mode, VALLEY_DEPTH, i));
+    }
+    EXPECT_EQ(2.0, packed.param(EvaluationMode::EARLY, TOTAL_FRAMES));
+    EXPECT_EQ(1.0, packed.param(EvaluationMode::MIDDLE, TOTAL_FRAMES));
+    EXPECT_EQ(-20.0, packed.param(EvaluationMode::LATE, VALLEY_DEPTH, 3));
+    // LATE has VALLEY_DEPTH, so the default is not used for the other indices.
+    EXPECT_EQ(0.0, packed.param(EvaluationMode::LATE, VALLEY_DEPTH, 2));
+}
+
+TEST(PackedEvaluationParameterTest, invalidate)
+{
+    EvaluationMoveParameterSet paramSet;
+    paramSet.setDefault(TOTAL_FRAMES, 1.0);
+    EXPECT_EQ(1.0, paramSet.packed().param(EvaluationMode::EARLY, TOTAL_FRAMES));
+
+    paramSet.mutableModeParam(EvaluationMode::EARLY)->setParam(TOTAL_FRAMES, 5.0);
+    EXPECT_EQ(5.0, paramSet.packed().param(EvaluationMode::EARLY, TOTAL_FRAMES));
+
+    EvaluationMoveParameterSet copied;
+    copied = paramSet;
+    EXPECT_EQ(5.0, copied.packed().param(EvaluationMode::EARLY, TOTAL_FRAMES));
+}
+
+TEST(PackedEvaluationParameterTest, score)
+{
+    EvaluationMoveParameterSet paramSet;
+    paramSet.setDefault(TOTAL_FRAMES, 1.0);
+    paramSet.setParam(EvaluationMode::EARLY, TOTAL_FRAMES, 2.0);
+    paramSet.setDefault(NUM_CHIGIRI, -3.0);
+    paramSet.setDefault(VALLEY_DEPTH, 1, 7.0);
+
+    const PackedEvaluationParameter<EvaluationMoveFeatureSet>& packed = paramSet.packed();
+    PackedFeatureVector features;
+    features.add(packed.row(TOTAL_FRAMES), 10.0);
+    features.add(packed.row(NUM_CHIGIRI), 2.0);
+    features.add(packed.row(VALLEY_DEPTH, 1), 1.0);
+
+    double scores[PackedEvaluationParameter<EvaluationMoveFeatureSet>::NUM_COLUMNS] {};
+    scores[0] = 100.0;
+    packed.score(features, scores);
+
+    for (const auto& mode : ALL_EVALUATION_MODES) {
+        double expected = (mode == EvaluationMode::INITIAL ? 100.0 : 0.0) +
+            paramSet.param(mode, TOTAL_FRAMES) * 10.0 +
+            paramSet.param(mode, NUM_CHIGIRI) * 2.0 +
+            paramSet.param(mode, VALLEY_DEPTH, 1) * 1.0;
+        EXPECT_EQ(expected, scores[ordinal(mode)]) << toString(mode);
+    }
+    EXPECT_EQ(20.0 - 6.0 + 7.0, scores[ordinal(EvaluationMode::EARLY)]);
+}
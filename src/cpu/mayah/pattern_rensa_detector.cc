@@ -4,6 +4,8 @@
 
 #include <gflags/gflags.h>
 
+#include "base/trace.h"
+
 using namespace std;
 
 DEFINE_bool(use_side_chain, false, "Use sidechain iteration");
@@ -11,16 +13,30 @@ DEFINE_bool(use_side_chain, false, "Use sidechain iteration");
 namespace {
 const int MAX_UNUSED_VARIABLES_FOR_FIRST_PATTERN = 0;
 const int MAX_UNUSED_VARIABLES = 1;
+
+// Vanishes and drops one step of |field|. Unlike CoreField, BitField doesn't have to
+// recalculate the heights after that.
+bool vanishDropFast(BitField* field, RensaExistingPositionTracker* tracker)
+{
+    BitField::SimulationContext context;
+#if defined(__AVX2__) && defined(__BMI2__)
+    return field->vanishDropFastAVX2(&context, tracker);
+#else
+    return field->vanishDropFast(&context, tracker);
+#endif
+}
+
 }
 
 void PatternRensaDetector::iteratePossibleRensas(int maxIteration)
 {
     DCHECK_GE(maxIteration, 1);
+    TRACE_SCOPE("PatternRensaDetector::iteratePossibleRensas");
 
     const int maxHeight = strategy_.allowsPuttingKeyPuyoOn13thRow() ? 13 : 12;
 
     // --- Iterate with complementing pattern.
-    auto callback = [&](CoreField&& complementedField, const ColumnPuyoList& cpl,
+    auto callback = [&](const BitField& complementedField, const ColumnPuyoList& cpl,
                         int numFilledUnusedVariables, const FieldBits& matchedBits,
                         const PatternBookField& pbf) {
         int x = pbf.ignitionColumn();
@@ -42,7 +58,8 @@ void PatternRensaDetector::iteratePossibleRensas(int maxIteration)
             return;
 
         RensaExistingPositionTracker tracker(originalField_.bitField().normalColorBits());
-        if (!complementedField.vanishDropFast(&tracker)) {
+        BitField field(complementedField);
+        if (!vanishDropFast(&field, &tracker)) {
             CoreField tmp(originalField_);
             tmp.dropPuyoListWithMaxHeight(cpl, maxHeight);
 
@@ -54,11 +71,11 @@ void PatternRensaDetector::iteratePossibleRensas(int maxIteration)
         // For here, we don't need to make AND to RensaExistingPositionTracker.
         double patternScore = pbf.score() * matchedBits.popcount() / pbf.numVariables();
         int restUnusedVariables = MAX_UNUSED_VARIABLES - numFilledUnusedVariables;
-        iteratePossibleRensasInternal(complementedField, tracker, 1, firePuyo, keyPuyos,
+        iteratePossibleRensasInternal(field, tracker, 1, firePuyo, keyPuyos,
                                       maxIteration - 1, restUnusedVariables,
                                       pbf.name(), patternScore);
     };
-    patternBook_.complement(originalField_, MAX_UNUSED_VARIABLES_FOR_FIRST_PATTERN, callback);
+    patternBook_.complement(originalField_.bitField(), MAX_UNUSED_VARIABLES_FOR_FIRST_PATTERN, callback);
 
     // --- Iterate without complementing.
     auto detectCallback = [&](const CoreField& complementedField, const ColumnPuyoList& cpl) {
@@ -80,7 +97,7 @@ void PatternRensaDetector::iteratePossibleRensas(int maxIteration)
             return;
 
         RensaExistingPositionTracker tracker(originalField_.bitField().normalColorBits());
-        iteratePossibleRensasInternal(complementedField, tracker, 0,
+        iteratePossibleRensasInternal(complementedField.bitField(), tracker, 0,
                                       firePuyo, keyPuyos, maxIteration - 1, 0, string(), 0.0, false);
 
         if (FLAGS_use_side_chain) {
@@ -99,7 +116,7 @@ void PatternRensaDetector::iteratePossibleRensas(int maxIteration)
     RensaDetector::detect(originalField_, strategy_, PurposeForFindingRensa::FOR_FIRE, prohibits, detectCallback);
 }
 
-void PatternRensaDetector::iteratePossibleRensasInternal(const CoreField& currentField,
+void PatternRensaDetector::iteratePossibleRensasInternal(const BitField& currentField,
                                                          const RensaExistingPositionTracker& currentFieldTracker,
                                                          int currentChains,
                                                          const ColumnPuyo& firePuyo,
@@ -118,7 +135,7 @@ void PatternRensaDetector::iteratePossibleRensasInternal(const CoreField& curren
         return;
 
     bool needsToProceedWithoutComplement = true;
-    auto callback = [&](CoreField&& complementedField, const ColumnPuyoList& cpl,
+    auto callback = [&](const BitField& complementedField, const ColumnPuyoList& cpl,
                         int numFilledUnusedVariables, const FieldBits& matchedBits,
                         const PatternBookField& pbf) {
         double patternScore = currentPatternScore;
@@ -131,9 +148,10 @@ void PatternRensaDetector::iteratePossibleRensasInternal(const CoreField& curren
             needsToProceedWithoutComplement = false;
 
             RensaExistingPositionTracker tracker(currentFieldTracker);
-            CHECK(complementedField.vanishDropFast(&tracker));
+            BitField field(complementedField);
+            CHECK(vanishDropFast(&field, &tracker));
 
-            iteratePossibleRensasInternal(complementedField, tracker, currentChains + 1, firePuyo, originalKeyPuyos,
+            iteratePossibleRensasInternal(field, tracker, currentChains + 1, firePuyo, originalKeyPuyos,
                                           restIteration, restUnusedVariables,
                                           patternName.empty() ? pbf.name() : patternName,
                                           patternScore);
@@ -153,12 +171,13 @@ void PatternRensaDetector::iteratePossibleRensasInternal(const CoreField& curren
             return;
 
         RensaExistingPositionTracker tracker(currentFieldTracker);
-        if (!complementedField.vanishDropFast(&tracker)) {
-            LOG(ERROR) << complementedField.toDebugString();
+        BitField field(complementedField);
+        if (!vanishDropFast(&field, &tracker)) {
+            LOG(ERROR) << field;
             return;
         }
 
-        iteratePossibleRensasInternal(complementedField, tracker, currentChains + 1, firePuyo, keyPuyos,
+        iteratePossibleRensasInternal(field, tracker, currentChains + 1, firePuyo, keyPuyos,
                                       restIteration - 1,
                                       restUnusedVariables - numFilledUnusedVariables,
                                       patternName.empty() ? pbf.name() : patternName,
@@ -170,13 +189,13 @@ void PatternRensaDetector::iteratePossibleRensasInternal(const CoreField& curren
         return;
 
     // proceed one without complementing.
-    CoreField cf(currentField);
+    BitField field(currentField);
     RensaExistingPositionTracker tracker(currentFieldTracker);
-    CHECK(cf.vanishDropFast(&tracker)) << cf.toDebugString();
+    CHECK(vanishDropFast(&field, &tracker)) << field;
 
     // If rensa continues, proceed to next.
-    if (cf.rensaWillOccur()) {
-        iteratePossibleRensasInternal(cf, tracker, currentChains + 1, firePuyo, originalKeyPuyos,
+    if (field.rensaWillOccur()) {
+        iteratePossibleRensasInternal(field, tracker, currentChains + 1, firePuyo, originalKeyPuyos,
                                       restIteration, restUnusedVariables, patternName, currentPatternScore);
         return;
     }
@@ -197,22 +216,43 @@ void PatternRensaDetector::iteratePossibleRensasInternal(const CoreField& curren
         if (!checkDup(firePuyo, keyPuyos))
             return;
 
-        iteratePossibleRensasInternal(cf2, tracker, currentChains + 1,
+        iteratePossibleRensasInternal(cf2.bitField(), tracker, currentChains + 1,
                                       firePuyo, keyPuyos, restIteration - 1, restUnusedVariables,
                                       patternName, currentPatternScore);
     };
-    RensaDetector::detect(cf, strategy_, PurposeForFindingRensa::FOR_KEY, prohibits, detectCallback);
+    // RensaDetector needs the heights, so CoreField is made only here.
+    RensaDetector::detect(CoreField(field), strategy_, PurposeForFindingRensa::FOR_KEY, prohibits, detectCallback);
 }
 
 bool PatternRensaDetector::checkDup(const ColumnPuyo& firePuyo,
                                     const ColumnPuyoList& keyPuyos)
 {
-    ColumnPuyoList whole(keyPuyos);
-    whole.add(firePuyo);
-    if (usedSet_.count(whole))
-        return false;
-    usedSet_.insert(whole);
-    return true;
+    return usedSet_.insert(makeSignature(firePuyo, keyPuyos));
+}
+
+// static
+uint64_t PatternRensaDetector::makeSignature(const ColumnPuyo& firePuyo,
+                                             const ColumnPuyoList& keyPuyos)
+{
+    // A column has at most 9 puyos (including |firePuyo|), so the size and the colors
+    // of a column fit in 31 bits. Then the columns are mixed into 64 bits.
+    uint64_t signature = 0;
+    for (int x = 1; x <= 6; ++x) {
+        int size = keyPuyos.sizeOn(x);
+        uint64_t column = 0;
+        for (int i = 0; i < size; ++i)
+            column = column * 8 + ordinal(keyPuyos.get(x, i));
+        if (firePuyo.x == x) {
+            column = column * 8 + ordinal(firePuyo.color);
+            ++size;
+        }
+        column = column * 16 + size;
+
+        signature = (signature ^ column) * 0x9E3779B97F4A7C15ULL;
+        signature ^= signature >> 29;
+    }
+
+    return signature;
 }
 
 bool PatternRensaDetector::checkRensa(int currentChains,
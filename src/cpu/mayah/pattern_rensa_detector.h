@@ -1,9 +1,12 @@
 #ifndef CPU_MAYAH_PATTERN_RENSA_DETECTOR_H_
 #define CPU_MAYAH_PATTERN_RENSA_DETECTOR_H_
 
+#include <cstdint>
 #include <string>
-#include <unordered_set>
 
+#include "base/signature_set.h"
+
+#include "core/bit_field.h"
 #include "core/column_puyo_list.h"
 #include "core/core_field.h"
 #include "core/pattern/pattern_book.h"
@@ -32,7 +35,9 @@ public:
 
 
 private:
-    void iteratePossibleRensasInternal(const CoreField& currentField,
+    // The fields are handled as BitField inside. BitField is smaller than CoreField,
+    // and it doesn't need to recalculate the heights after vanishing.
+    void iteratePossibleRensasInternal(const BitField& currentField,
                                        const RensaExistingPositionTracker& currentFieldTracker,
                                        int currentChains,
                                        const ColumnPuyo& firePuyo,
@@ -43,9 +48,13 @@ private:
                                        double currentPatternScore,
                                        bool addsPatternScore = true);
 
+    // Returns false if |firePuyo| and |keyPuyos| has been already checked.
     bool checkDup(const ColumnPuyo& firePuyo,
                   const ColumnPuyoList& keyPuyos);
 
+    static std::uint64_t makeSignature(const ColumnPuyo& firePuyo,
+                                       const ColumnPuyoList& keyPuyos);
+
     bool checkRensa(int currentChains,
                     const ColumnPuyo& firePuyo,
                     const ColumnPuyoList& keyPuyos,
@@ -58,7 +67,9 @@ private:
     Callback callback_;
     const RensaDetectorStrategy strategy_;
 
-    std::unordered_set<ColumnPuyoList> usedSet_;
+    // The signatures of the checked (firePuyo, keyPuyos). Since a ColumnPuyoList is
+    // hashed into 64 bits, a collision might skip a rensa, but it's very rare.
+    SignatureSet usedSet_;
 };
 
 #endif // CPU_MAYAH_PATTERN_RENSA_DETECTOR_H_
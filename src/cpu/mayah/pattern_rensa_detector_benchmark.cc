@@ -0,0 +1,167 @@
+#include "pattern_rensa_detector.h"
+
+#include <glog/logging.h>
+
+#include "base/benchmark.h"
+#include "core/core_field.h"
+#include "core/pattern/pattern_book.h"
+
+using namespace std;
+
+// The same books as pattern_rensa_detector_test.
+static const char TEST_BOOK[] = R"(
+[[pattern]]
+field = [
+    "A.....",
+    "ABC...",
+    "AABCC.",
+    "BBC&&.",
+]
+ignition = 1
+score = 72
+name = "GTR"
+)";
+
+static const char TEST_BOOK4[] = R"(
+[[pattern]]
+field = [
+    ".A....",
+    "BA....",
+    "AA....",
+    "BC....",
+    "BBC...",
+    "CC....",
+]
+ignition = 2
+
+[[pattern]]
+field = [
+    "......",
+    "A.....",
+    "ABC...",
+    "AABCC.",
+    "BBC...",
+]
+ignition = 1
+
+[[pattern]]
+field = [
+    ".....C",
+    "...BBC",
+    "..AAAB",
+    "..ACCB",
+]
+ignition = 3
+)";
+
+static const char TEST_BOOK7[] = R"(
+[[pattern]]
+field = [
+    "A.....",
+    "ABC...",
+    "AABCC.",
+    "BBC...",
+]
+ignition = 1
+score = 10
+
+[[pattern]]
+field = [
+    "......",
+    "..B.C.",
+    ".AABB.",
+    "AABCCC",
+]
+ignition = 2
+score = 9
+)";
+
+static void benchmarkIteratePossibleRensas(base::Benchmark& benchmark, const PatternBook& patternBook, const CoreField& field)
+{
+    benchmark.measure([&]() {
+        int numRensas = 0;
+        auto callback = [&](const CoreField&, const RensaResult&, const ColumnPuyoList&,
+                            PuyoColor, const std::string&, double) {
+            ++numRensas;
+        };
+        PatternRensaDetector(patternBook, field, callback).iteratePossibleRensas(3);
+        base::doNotOptimize(numRensas);
+    });
+}
+
+static void benchmarkIteratePossibleRensas(base::Benchmark& benchmark, const char* book, const CoreField& field)
+{
+    PatternBook patternBook;
+    CHECK(patternBook.loadFromString(book));
+
+    benchmarkIteratePossibleRensas(benchmark, patternBook, field);
+}
+
+// mayah's pattern book, which has much more patterns than the test books.
+static void benchmarkIteratePossibleRensasWithMayahBook(base::Benchmark& benchmark, const CoreField& field)
+{
+    PatternBook patternBook;
+    CHECK(patternBook.load(SRC_DIR "/cpu/mayah/pattern.toml"));
+
+    benchmarkIteratePossibleRensas(benchmark, patternBook, field);
+}
+
+BENCHMARK(PatternRensaDetectorBenchmark, pattern1_complement2)
+{
+    const CoreField field(
+        "....GG"
+        ".G.GRR"
+        ".B.RGR"
+        "BRRGYY"
+        "BYYRGG");
+
+    benchmarkIteratePossibleRensas(benchmark, TEST_BOOK, field);
+}
+
+BENCHMARK(PatternRensaDetectorBenchmark, pattern4)
+{
+    const CoreField field(
+        "G....."
+        "RBR..."
+        "RRBRR."
+        "BBRYY.");
+
+    benchmarkIteratePossibleRensas(benchmark, TEST_BOOK4, field);
+}
+
+BENCHMARK(PatternRensaDetectorBenchmark, pattern7)
+{
+    const CoreField field(
+        "......"
+        ".GBRR."
+        ".BRYY.");
+
+    benchmarkIteratePossibleRensas(benchmark, TEST_BOOK7, field);
+}
+
+BENCHMARK(PatternRensaDetectorBenchmark, mayahBook_real1)
+{
+    const CoreField field(
+        "  G   "
+        " BG   "
+        "RGRY  "
+        "RGYG  "
+        "BBBYG "
+        "YYYRRR");
+
+    benchmarkIteratePossibleRensasWithMayahBook(benchmark, field);
+}
+
+BENCHMARK(PatternRensaDetectorBenchmark, mayahBook_real2)
+{
+    const CoreField field(
+        "R     "
+        "R     "
+        "B   GY"
+        "R   GG"
+        "RB  RY"
+        "BYYRYY"
+        "BRRYRR");
+
+    benchmarkIteratePossibleRensasWithMayahBook(benchmark, field);
+}
@@ -0,0 +1,15 @@
+#include "rensa_detection_memo.h"
+
+#include <sstream>
+
+using namespace std;
+
+string RensaDetectionMemo::toString() const
+{
+    stringstream ss;
+    ss << "detectedRensas: fields=" << detectedRensas_.size() << " hits=" << detectedRensas_.hits()
+       << " dropped=" << detectedRensas_.dropped()
+       << " handNodes: fields=" << handNodes_.size() << " hits=" << handNodes_.hits()
+       << " dropped=" << handNodes_.dropped();
+    return ss.str();
+}
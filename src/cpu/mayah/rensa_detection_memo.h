@@ -0,0 +1,219 @@
+#ifndef CPU_MAYAH_RENSA_DETECTION_MEMO_H_
+#define CPU_MAYAH_RENSA_DETECTION_MEMO_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/base.h"
+#include "core/column_puyo_list.h"
+#include "core/core_field.h"
+#include "core/puyo_color.h"
+#include "core/rensa_result.h"
+
+#include "rensa_hand_tree.h"
+
+// A rensa detected by PatternRensaDetector or RensaDetector::detectSideChain.
+struct DetectedRensa {
+    DetectedRensa(const CoreField& fieldAfterRensa, const RensaResult& rensaResult,
+                  const ColumnPuyoList& puyosToComplement, PuyoColor firePuyoColor,
+                  const std::string& patternName, double patternScore) :
+        fieldAfterRensa(fieldAfterRensa), rensaResult(rensaResult),
+        puyosToComplement(puyosToComplement), firePuyoColor(firePuyoColor),
+        patternName(patternName), patternScore(patternScore)
+    {
+    }
+
+    CoreField fieldAfterRensa;
+    RensaResult rensaResult;
+    ColumnPuyoList puyosToComplement;
+    PuyoColor firePuyoColor;
+    std::string patternName;
+    double patternScore;
+};
+
+// ConcurrentFieldMemo memoizes a value computed from a field and an int parameter.
+// The value of each key is computed only once even when several threads ask it at
+// the same time; the others wait for the first one.
+// At most |capacity| keys are kept. When the memo is full, the value of a new key is
+// computed but not kept.
+template<typename Value>
+class ConcurrentFieldMemo {
+public:
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    explicit ConcurrentFieldMemo(size_t capacity = DEFAULT_CAPACITY) :
+        capacityPerShard_((capacity + NUM_SHARDS - 1) / NUM_SHARDS)
+    {
+    }
+
+    // Returns the value for (|field|, |param|). |compute| is called to fill the value if
+    // it's not computed yet.
+    std::shared_ptr<const Value> get(const CoreField& field, int param, const std::function<void (Value*)>& compute)
+    {
+        Key key { field, param };
+        Shard& shard = shards_[shardIndex(KeyHash()(key))];
+
+        std::shared_ptr<Slot> slot;
+        {
+            std::lock_guard<std::mutex> lock(shard.mu);
+            auto it = shard.slots.find(key);
+            if (it != shard.slots.end()) {
+                ++shard.hits;
+                slot = it->second;
+            } else {
+                slot = std::make_shared<Slot>();
+                if (shard.slots.size() < capacityPerShard_)
+                    shard.slots.emplace(key, slot);
+                else
+                    ++shard.dropped;
+            }
+        }
+
+        std::call_once(slot->once, [&]() { compute(&slot->value); });
+        return std::shared_ptr<const Value>(slot, &slot->value);
+    }
+
+    void clear()
+    {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mu);
+            shard.slots.clear();
+            shard.hits = 0;
+            shard.dropped = 0;
+        }
+    }
+
+    // The number of keys, the number of requests answered from the memo, and the number
+    // of the values that were not kept since the memo was full.
+    size_t size() const;
+    size_t hits() const;
+    size_t dropped() const;
+
+private:
+    static const size_t NUM_SHARDS = 16;
+
+    struct Key {
+        CoreField field;
+        int param;
+
+        friend bool operator==(const Key& lhs, const Key& rhs) { return lhs.param == rhs.param && lhs.field == rhs.field; }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const { return key.field.hash() * 31 + key.param; }
+    };
+
+    // The lower bits of CoreField::hash() are almost constant (they come from the wall),
+    // so the upper bits of the mixed hash are used.
+    static size_t shardIndex(size_t h)
+    {
+        static_assert(NUM_SHARDS == 16, "shardIndex() takes 4 bits");
+        return static_cast<size_t>((static_cast<std::uint64_t>(h) * 0x9E3779B97F4A7C15ULL) >> 60);
+    }
+
+    struct Slot {
+        std::once_flag once;
+        Value value;
+    };
+
+    struct Shard {
+        mutable std::mutex mu;
+        std::unordered_map<Key, std::shared_ptr<Slot>, KeyHash> slots;
+        size_t hits = 0;
+        size_t dropped = 0;
+    };
+
+    const size_t capacityPerShard_;
+    std::array<Shard, NUM_SHARDS> shards_;
+};
+
+// RensaDetectionMemo keeps the rensa detection results during one think, so that
+// midEval and eval don't detect rensas of the same field twice.
+// A field is evaluated twice when a plan fires a rensa (midEval and eval both see the
+// field after the rensa), or when two orders of decisions make the same field. So the
+// caller should use the memo only for such plans. The memo is bounded anyway.
+class RensaDetectionMemo {
+public:
+    typedef std::vector<DetectedRensa> DetectedRensas;
+
+    explicit RensaDetectionMemo(size_t capacity = ConcurrentFieldMemo<DetectedRensas>::DEFAULT_CAPACITY) :
+        detectedRensas_(capacity),
+        handNodes_(capacity)
+    {
+    }
+
+    // Returns the rensas detected from |field| with |maxIteration|.
+    std::shared_ptr<const DetectedRensas> detectedRensas(const CoreField& field, int maxIteration,
+                                                         const std::function<void (DetectedRensas*)>& detect)
+    {
+        return detectedRensas_.get(field, maxIteration, detect);
+    }
+
+    // Returns the RensaHandNode of |field| for the rest kumipuyo sequence of size |restSeqSize|.
+    std::shared_ptr<const RensaHandNode> handNode(const CoreField& field, int restSeqSize,
+                                                  const std::function<void (RensaHandNode*)>& make)
+    {
+        return handNodes_.get(field, restSeqSize, make);
+    }
+
+    void clear()
+    {
+        detectedRensas_.clear();
+        handNodes_.clear();
+    }
+
+    std::string toString() const;
+
+private:
+    ConcurrentFieldMemo<DetectedRensas> detectedRensas_;
+    ConcurrentFieldMemo<RensaHandNode> handNodes_;
+
+    DISALLOW_COPY_AND_ASSIGN(RensaDetectionMemo);
+};
+
+template<typename Value>
+size_t ConcurrentFieldMemo<Value>::size() const
+{
+    size_t n = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mu);
+        n += shard.slots.size();
+    }
+    return n;
+}
+
+template<typename Value>
+size_t ConcurrentFieldMemo<Value>::hits() const
+{
+    size_t n = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mu);
+        n += shard.hits;
+    }
+    return n;
+}
+
+template<typename Value>
+size_t ConcurrentFieldMemo<Value>::dropped() const
+{
+    size_t n = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mu);
+        n += shard.dropped;
+    }
+    return n;
+}
+
+template<typename Value>
+const size_t ConcurrentFieldMemo<Value>::DEFAULT_CAPACITY;
+
+template<typename Value>
+const size_t ConcurrentFieldMemo<Value>::NUM_SHARDS;
+
+#endif // CPU_MAYAH_RENSA_DETECTION_MEMO_H_
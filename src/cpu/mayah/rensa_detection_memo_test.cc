@@ -0,0 +1,124 @@
+#include "rensa_detection_memo.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/plan/plan.h"
+#include "core/decision.h"
+
+#include "evaluator.h"
+#include "gazer.h"
+
+using namespace std;
+
+TEST(RensaDetectionMemoTest, computeOnce)
+{
+    ConcurrentFieldMemo<int> memo;
+    CoreField f("R     "
+                "RGG   ");
+
+    atomic<int> numComputed(0);
+    auto compute = [&](int* value) {
+        ++numComputed;
+        *value = 42;
+    };
+
+    vector<thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < 100; ++j)
+                EXPECT_EQ(42, *memo.get(f, 1, compute));
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    EXPECT_EQ(1, numComputed);
+    EXPECT_EQ(1U, memo.size());
+    EXPECT_EQ(399U, memo.hits());
+
+    // Another parameter is another key.
+    EXPECT_EQ(42, *memo.get(f, 2, compute));
+    EXPECT_EQ(2, numComputed);
+
+    memo.clear();
+    EXPECT_EQ(0U, memo.size());
+    EXPECT_EQ(42, *memo.get(f, 1, compute));
+    EXPECT_EQ(3, numComputed);
+}
+
+TEST(RensaDetectionMemoTest, capacity)
+{
+    // One key per shard.
+    ConcurrentFieldMemo<int> memo(16);
+
+    int numComputed = 0;
+    auto compute = [&](int* value) {
+        ++numComputed;
+        *value = numComputed;
+    };
+
+    CoreField f("RGG   ");
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(i + 1, *memo.get(f, i, compute));
+
+    EXPECT_EQ(100, numComputed);
+    EXPECT_GE(16U, memo.size());
+    EXPECT_EQ(100U, memo.size() + memo.dropped());
+
+    // The kept values are still answered from the memo, and the dropped values are
+    // computed again.
+    size_t numKept = memo.size();
+    for (int i = 0; i < 100; ++i)
+        memo.get(f, i, compute);
+    EXPECT_EQ(numKept, memo.hits());
+    EXPECT_EQ(200 - static_cast<int>(numKept), numComputed);
+
+    // A returned value is valid after clear().
+    shared_ptr<const int> value = memo.get(f, 0, compute);
+    memo.clear();
+    EXPECT_EQ(1, *value);
+}
+
+TEST(RensaDetectionMemoTest, sameScoreWithMemo)
+{
+    EvaluationParameterMap evaluationParameterMap;
+    PatternBook patternBook;
+    Gazer gazer;
+    gazer.initialize(100);
+
+    CoreField f("R     "
+                "RGG   "
+                "BBYG  "
+                "RRBYY ");
+    vector<Decision> decisions { Decision(3, 0) };
+    RensaResult rensaResult;
+    RefPlan plan(f, decisions, rensaResult, 0, 10, 10, 0, 0, 0, 0, false);
+    KumipuyoSeq seq("RRGGBB");
+    PreEvalResult preEvalResult = PreEvaluator(patternBook).preEval(f);
+
+    auto eval = [&](RensaDetectionMemo* memo) {
+        FeatureScoreCollector sc(evaluationParameterMap);
+        Evaluator<FeatureScoreCollector> evaluator(patternBook, &sc, memo);
+        evaluator.eval(plan, seq, 1, 2, PlayerState(), PlayerState(), preEvalResult, MidEvalResult(), false, true, gazer.gazeResult());
+        return sc.collectedScore();
+    };
+
+    RensaDetectionMemo memo;
+    CollectedFeatureScore expected = eval(nullptr);
+    CollectedFeatureScore first = eval(&memo);
+    CollectedFeatureScore second = eval(&memo);
+
+    EXPECT_FALSE(expected.moveScore.collectedFeatures.empty());
+    expected.moveScore.collectedFeatures.forEach([&](EvaluationMoveFeatureKey key, double value) {
+        EXPECT_EQ(value, first.moveScore.feature(key)) << key;
+        EXPECT_EQ(value, second.moveScore.feature(key)) << key;
+    });
+    EXPECT_EQ(expected.mainRensaScore.puyosToComplement, second.mainRensaScore.puyosToComplement);
+    EXPECT_EQ(expected.mainRensaScore.bookname, second.mainRensaScore.bookname);
+    EXPECT_EQ("detectedRensas: fields=1 hits=1 dropped=0 handNodes: fields=1 hits=1 dropped=0", memo.toString());
+}
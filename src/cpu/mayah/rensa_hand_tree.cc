@@ -1,8 +1,10 @@
 #include "rensa_hand_tree.h"
 
 #include <iostream>
+#include <limits>
 #include <sstream>
 
+#include "base/trace.h"
 #include "core/rensa/rensa_detector.h"
 #include "core/core_field.h"
 #include "core/frame.h"
@@ -64,11 +66,14 @@ RensaHandTree RensaHandTree::makeTree(int restIteration,
                                       const CoreField& currentField,
                                       const PuyoSet& usedPuyoSet,
                                       int usedPuyoMoveFrames,
-                                      const KumipuyoSeq& wholeKumipuyoSeq)
+                                      KumipuyoSeqView wholeKumipuyoSeq,
+                                      Executor* executor)
 {
     if (restIteration <= 0)
         return RensaHandTree();
 
+    TRACE_SCOPE("RensaHandTree::makeTree");
+
     vector<RensaHandNode> nodes(6);
     for (int ojamaLines = 0; ojamaLines <= 5; ++ojamaLines) {
         CoreField field(currentField);
@@ -78,7 +83,12 @@ RensaHandTree RensaHandTree::makeTree(int restIteration,
         auto callback = [&](CoreField&& cf, const ColumnPuyoList& puyosToComplement) -> RensaResult {
             return maker.add(std::move(cf), puyosToComplement, usedPuyoMoveFrames + dropFrames, usedPuyoSet);
         };
-        RensaDetector::detectIteratively(field, RensaDetectorStrategy::defaultDropStrategy(), 3, callback);
+        if (executor) {
+            RensaDetector::detectIterativelyInParallel(field, RensaDetectorStrategy::defaultDropStrategy(), 3,
+                                                       executor, numeric_limits<double>::infinity(), callback);
+        } else {
+            RensaDetector::detectIteratively(field, RensaDetectorStrategy::defaultDropStrategy(), 3, callback);
+        }
         nodes[ojamaLines] = maker.makeNode();
     }
 
@@ -96,6 +106,23 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
                         int enemyOjamaLineIndex,
                         int enemyNumOjama,
                         int enemyOjamaCommittingFrameId)
+{
+    TRACE_SCOPE("RensaHandTree::eval");
+    return evalInternal(myTree, myStartingFrameId, myOjamaLineIndex, myNumOjama, myOjamaCommittingFrameId,
+                        enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama, enemyOjamaCommittingFrameId);
+}
+
+// static
+int RensaHandTree::evalInternal(const RensaHandTree& myTree,
+                                int myStartingFrameId,
+                                int myOjamaLineIndex,
+                                int myNumOjama,
+                                int myOjamaCommittingFrameId,
+                                const RensaHandTree& enemyTree,
+                                int enemyStartingFrameId,
+                                int enemyOjamaLineIndex,
+                                int enemyNumOjama,
+                                int enemyOjamaCommittingFrameId)
 {
     DCHECK(0 <= myOjamaLineIndex && myOjamaLineIndex <= 5) << myOjamaLineIndex;
     DCHECK(0 <= enemyOjamaLineIndex && enemyOjamaLineIndex <= 5) << enemyOjamaLineIndex;
@@ -134,8 +161,8 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
                 if (myNumOjama < rensaHand.score() / 70) {
                     int plusOjama = rensaHand.score() / 70 - myNumOjama;
                     int finishingFrameId = myStartingFrameId + rensaHand.totalFrames();
-                    int s = eval(edge.tree(), finishingFrameId, 0, 0, 0,
-                                 enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama + plusOjama, finishingFrameId);
+                    int s = evalInternal(edge.tree(), finishingFrameId, 0, 0, 0,
+                                         enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama + plusOjama, finishingFrameId);
                     if (best < s)
                         best = s;
                 } else {
@@ -145,8 +172,8 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
                     if (fallOjamaLine <= 5) {
                         int fallOjamaFrames = FRAMES_TO_DROP[6] + framesGroundingOjama(fallOjamaAmount);
                         int finishingFrameId = myStartingFrameId + rensaHand.totalFrames() + fallOjamaFrames;
-                        int s = eval(edge.tree(), finishingFrameId, fallOjamaLine, 0, 0,
-                                     enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama, enemyOjamaCommittingFrameId);
+                        int s = evalInternal(edge.tree(), finishingFrameId, fallOjamaLine, 0, 0,
+                                             enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama, enemyOjamaCommittingFrameId);
                         if (best < s)
                             best = s;
                     }
@@ -159,8 +186,8 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
                     if (myNumOjama < score / 70) {
                         int plusOjama = score / 70 - myNumOjama;
                         int finishingFrameId = myOjamaCommittingFrameId + rensaHand.totalFrames();
-                        int s = eval(edge.tree(), finishingFrameId, 0, 0, 0,
-                                     enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama + plusOjama, finishingFrameId);
+                        int s = evalInternal(edge.tree(), finishingFrameId, 0, 0, 0,
+                                             enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama + plusOjama, finishingFrameId);
                         if (best < s)
                             best = s;
                     }
@@ -188,8 +215,8 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
                         best = s;
                 } else {
                     int rensaFrame = NUM_FRAMES_OF_ONE_RENSA * plusRensa;
-                    int s = eval(myTree, myStartingFrameId + rensaFrame, 0, 0,
-                                 enemyTree, enemyStartingFrameId, enemyNumOjama + plusOjama - myNumOjama, myStartingFrameId + rensaFrame);
+                    int s = evalInternal(myTree, myStartingFrameId + rensaFrame, 0, 0,
+                                         enemyTree, enemyStartingFrameId, enemyNumOjama + plusOjama - myNumOjama, myStartingFrameId + rensaFrame);
                     if (best < s)
                         best = s;
                 }
@@ -206,8 +233,8 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
                 best = std::max(best, -newMyOjamaLineIndex * 6);
             } else if (myOjamaLineIndex < newMyOjamaLineIndex) {
                 int fallOjamaFrames = FRAMES_TO_DROP[6] + framesGroundingOjama(myNumOjama);
-                int s = eval(myTree, myStartingFrameId + fallOjamaFrames, newMyOjamaLineIndex, 0, 0,
-                             enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, 0, 0);
+                int s = evalInternal(myTree, myStartingFrameId + fallOjamaFrames, newMyOjamaLineIndex, 0, 0,
+                                     enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, 0, 0);
                 // Since we got |myNumOjama|, we need to reduce the score.
                 s -= myNumOjama;
                 if (best < s)
@@ -219,8 +246,8 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
 
         return best;
     } else if (enemyNumOjama > 2) {
-        return -eval(enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama, enemyOjamaCommittingFrameId,
-                     myTree, myStartingFrameId, myOjamaLineIndex, myNumOjama, myOjamaCommittingFrameId);
+        return -evalInternal(enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, enemyNumOjama, enemyOjamaCommittingFrameId,
+                             myTree, myStartingFrameId, myOjamaLineIndex, myNumOjama, myOjamaCommittingFrameId);
     } else {
         int best = -10000;
         int worst = 0;
@@ -292,8 +319,8 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
 
                 const RensaHand& rensaHand = candidate.edge->rensaHand();
                 int ojama = rensaHand.score() / 70;
-                int s = eval(candidate.edge->tree(), candidate.frameIdToFinish, 0, 0, 0,
-                             enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, ojama, candidate.frameIdToFinish);
+                int s = evalInternal(candidate.edge->tree(), candidate.frameIdToFinish, 0, 0, 0,
+                                     enemyTree, enemyStartingFrameId, enemyOjamaLineIndex, ojama, candidate.frameIdToFinish);
                 if (best < s)
                     best = s;
                 if (6 <= ojama && candidate.frameIdToFinish < myFastFinishingFrameId)
@@ -304,8 +331,8 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
 
                 const RensaHand& rensaHand = candidate.edge->rensaHand();
                 int ojama = rensaHand.score() / 70;
-                int s = eval(myTree, myStartingFrameId, myOjamaLineIndex, ojama, candidate.frameIdToFinish,
-                             candidate.edge->tree(), candidate.frameIdToFinish, 0, 0, 0);
+                int s = evalInternal(myTree, myStartingFrameId, myOjamaLineIndex, ojama, candidate.frameIdToFinish,
+                                     candidate.edge->tree(), candidate.frameIdToFinish, 0, 0, 0);
                 if (s < worst)
                     worst = s;
                 if (6 <= ojama && candidate.frameIdToFinish < enemyFastFinishingFrameId)
@@ -320,7 +347,7 @@ int RensaHandTree::eval(const RensaHandTree& myTree,
     return 0;
 }
 
-RensaHandNodeMaker::RensaHandNodeMaker(int restIteration, const KumipuyoSeq& kumipuyoSeq) :
+RensaHandNodeMaker::RensaHandNodeMaker(int restIteration, KumipuyoSeqView kumipuyoSeq) :
     restIteration_(restIteration),
     kumipuyoSeq_(kumipuyoSeq)
 {
@@ -7,14 +7,14 @@
 
 #include "core/core_field.h"
 #include "core/frame.h"
-#include "core/kumipuyo_seq.h"
+#include "core/kumipuyo_seq_view.h"
 #include "core/probability/puyo_set.h"
 #include "core/rensa_result.h"
 #include "core/rensa_tracker/rensa_coef_tracker.h"
 
 class ColumnPuyoList;
 class CoreField;
-class KumipuyoSeq;
+class Executor;
 class PuyoSet;
 
 class RensaHandEdge;
@@ -53,11 +53,13 @@ public:
     explicit RensaHandTree(std::vector<RensaHandNode> nodes) :
         nodes_(std::move(nodes)) {}
 
+    // When |executor| is specified, the rensas of the first level are detected in parallel.
     static RensaHandTree makeTree(int restIteration,
                                   const CoreField& currentField,
                                   const PuyoSet& usedPuyoSet,
                                   int usedPuyoMoveFrames,
-                                  const KumipuyoSeq& wholeKumipuyoSeq);
+                                  KumipuyoSeqView wholeKumipuyoSeq,
+                                  Executor* executor = nullptr);
 
     static int eval(const RensaHandTree& myTree,
                     int myStartingFrameId,
@@ -80,6 +82,17 @@ public:
     void dumpTo(int depth, std::ostream* os) const;
 
 private:
+    static int evalInternal(const RensaHandTree& myTree,
+                            int myStartingFrameId,
+                            int myOjamaIndex,
+                            int myNumOjama,
+                            int myOjamaCommittingFrameId,
+                            const RensaHandTree& enemyTree,
+                            int enemyStartingFrameId,
+                            int enemyOjamaIndex,
+                            int enemyNumOjama,
+                            int enemyOjamaCommittingFrameId);
+
     std::vector<RensaHandNode> nodes_;  // by ojama lines
 };
 
@@ -146,7 +159,8 @@ struct RensaHandCandidate {
 
 class RensaHandNodeMaker {
 public:
-    RensaHandNodeMaker(int restIteration, const KumipuyoSeq& kumipuyoSeq);
+    // |kumipuyoSeq| must outlive this.
+    RensaHandNodeMaker(int restIteration, KumipuyoSeqView kumipuyoSeq);
     ~RensaHandNodeMaker();
 
     int restIteration() const { return restIteration_; }
@@ -161,7 +175,7 @@ public:
 
 private:
     const int restIteration_;
-    const KumipuyoSeq kumipuyoSeq_;
+    const KumipuyoSeqView kumipuyoSeq_;
     std::vector<RensaHandCandidate> data_;
 };
 
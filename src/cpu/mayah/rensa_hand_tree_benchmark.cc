@@ -0,0 +1,59 @@
+#include "rensa_hand_tree.h"
+
+#include "base/benchmark.h"
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+#include "core/probability/puyo_set_probability.h"
+
+using namespace std;
+
+static void benchmarkMakeTree(base::Benchmark& benchmark, int depth, const CoreField& cf, const KumipuyoSeq& seq)
+{
+    benchmark.measure([&]() {
+        RensaHandTree tree = RensaHandTree::makeTree(depth, cf, PuyoSet(), 0, seq);
+        base::doNotOptimize(tree);
+    });
+}
+
+static const CoreField& pattern1Field()
+{
+    static const CoreField cf(
+        "    RB"
+        " B GGG"
+        "GG YBR"
+        "YG YGR"
+        "GBYBGR"
+        "BBYYBG"
+        "GYBGRG"
+        "GGYGGR"
+        "YYBBBR");
+    return cf;
+}
+
+BENCHMARK(RensaHandTreeBenchmark, pattern1_depth1)
+{
+    benchmarkMakeTree(benchmark, 1, pattern1Field(), KumipuyoSeq("RBRGRYYG"));
+}
+
+BENCHMARK(RensaHandTreeBenchmark, pattern1_depth2)
+{
+    benchmarkMakeTree(benchmark, 2, pattern1Field(), KumipuyoSeq("RBRGRYYG"));
+}
+
+BENCHMARK(RensaHandTreeBenchmark, pattern1_depth3)
+{
+    benchmarkMakeTree(benchmark, 3, pattern1Field(), KumipuyoSeq("RBRGRYYG"));
+}
+
+BENCHMARK(RensaHandTreeBenchmark, pattern2_depth2)
+{
+    const CoreField cf(
+        "..BG.."
+        "..RYYY"
+        "RRGRRR"
+        "RYRBYB"
+        "BBBYBB"
+        "YYYBYY");
+
+    benchmarkMakeTree(benchmark, 2, cf, KumipuyoSeq("RGRY"));
+}
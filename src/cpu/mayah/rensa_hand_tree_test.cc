@@ -1,10 +1,12 @@
 #include "rensa_hand_tree.h"
 
 #include <iostream>
+#include <memory>
 
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include "base/executor.h"
 #include "core/core_field.h"
 #include "core/kumipuyo_seq.h"
 #include "core/probability/puyo_set_probability.h"
@@ -143,3 +145,22 @@ TEST(RensaHandTreeTest, eval_actual2)
 
     EXPECT_LT(0, s) << endl;
 }
+
+TEST(RensaHandTreeTest, makeTreeWithExecutor)
+{
+    const CoreField cf(
+        ".....R"
+        "....GR"
+        "G..YYY"
+        "YYYGGR"
+        "GRBGYR"
+        "GGRBBB"
+        "RRBYYY");
+
+    unique_ptr<Executor> executor(new Executor(4));
+    executor->start();
+
+    RensaHandTree expected = RensaHandTree::makeTree(2, cf, PuyoSet(), 0, KumipuyoSeq("YYYY"));
+    RensaHandTree actual = RensaHandTree::makeTree(2, cf, PuyoSet(), 0, KumipuyoSeq("YYYY"), executor.get());
+    EXPECT_EQ(expected.toString(), actual.toString());
+}
@@ -1,6 +1,7 @@
 #ifndef CPU_MAYAH_SCORE_COLLECTOR_H_
 #define CPU_MAYAH_SCORE_COLLECTOR_H_
 
+#include <algorithm>
 #include <array>
 #include <map>
 #include <string>
@@ -11,44 +12,67 @@
 #include "collected_score.h"
 #include "evaluation_feature.h"
 #include "evaluation_parameter.h"
-
+#include "packed_evaluation_parameter.h"
+
+// Adds the scores of |features| for all modes to |score|.
+template<typename FeatureSet>
+inline void addPackedScore(const PackedEvaluationParameter<FeatureSet>& param,
+                           const PackedFeatureVector& features,
+                           CollectedSimpleSubScore* score)
+{
+    double scores[PackedEvaluationParameter<FeatureSet>::NUM_COLUMNS] {};
+    std::copy(score->scoreMap.begin(), score->scoreMap.end(), scores);
+    param.score(features, scores);
+    std::copy(scores, scores + NUM_EVALUATION_MODES, score->scoreMap.begin());
+}
+
+// The simple collectors only collect features in addScore(), and score them for all modes
+// with the packed parameters when the collected score is requested.
 class SimpleRensaScoreCollector {
 public:
     typedef CollectedSimpleRensaScore CollectedScore;
     explicit SimpleRensaScoreCollector(const EvaluationRensaParameterSet& mainRensaParamSet,
                                        const EvaluationRensaParameterSet& sideRensaParamSet) :
-        mainRensaParamSet_(mainRensaParamSet),
-        sideRensaParamSet_(sideRensaParamSet)
+        mainRensaParam_(mainRensaParamSet.packed()),
+        sideRensaParam_(sideRensaParamSet.packed())
     {
     }
 
     void addScore(EvaluationRensaFeatureKey key, double v)
     {
-        for (const auto& mode : ALL_EVALUATION_MODES) {
-            mainRensaScore_.scoreMap[ordinal(mode)] += mainRensaParamSet_.param(mode, key) * v;
-            sideRensaScore_.scoreMap[ordinal(mode)] += sideRensaParamSet_.param(mode, key) * v;
-        }
+        if (features_.full())
+            flush();
+        features_.add(mainRensaParam_.row(key), v);
     }
 
     void addScore(EvaluationRensaSparseFeatureKey key, int idx, int n = 1)
     {
-        for (const auto& mode : ALL_EVALUATION_MODES) {
-            mainRensaScore_.scoreMap[ordinal(mode)] += mainRensaParamSet_.param(mode, key, idx) * n;
-            sideRensaScore_.scoreMap[ordinal(mode)] += sideRensaParamSet_.param(mode, key, idx) * n;
-        }
+        if (features_.full())
+            flush();
+        features_.add(mainRensaParam_.row(key, idx), n);
     }
 
     void setBookname(const std::string&) {}
     void setPuyosToComplement(const ColumnPuyoList&) {}
 
-    const CollectedScore& mainRensaScore() const { return mainRensaScore_; }
-    const CollectedScore& sideRensaScore() const { return sideRensaScore_; }
+    const CollectedScore& mainRensaScore() const { flush(); return mainRensaScore_; }
+    const CollectedScore& sideRensaScore() const { flush(); return sideRensaScore_; }
 
 private:
-    const EvaluationRensaParameterSet& mainRensaParamSet_;
-    const EvaluationRensaParameterSet& sideRensaParamSet_;
-    CollectedSimpleRensaScore mainRensaScore_;
-    CollectedSimpleRensaScore sideRensaScore_;
+    void flush() const
+    {
+        if (features_.empty())
+            return;
+        addPackedScore(mainRensaParam_, features_, &mainRensaScore_);
+        addPackedScore(sideRensaParam_, features_, &sideRensaScore_);
+        features_.clear();
+    }
+
+    const PackedEvaluationParameter<EvaluationRensaFeatureSet>& mainRensaParam_;
+    const PackedEvaluationParameter<EvaluationRensaFeatureSet>& sideRensaParam_;
+    mutable PackedFeatureVector features_;
+    mutable CollectedSimpleRensaScore mainRensaScore_;
+    mutable CollectedSimpleRensaScore sideRensaScore_;
 };
 
 // This collector collects only score.
@@ -58,7 +82,8 @@ public:
     typedef SimpleRensaScoreCollector RensaScoreCollector;
 
     explicit SimpleScoreCollector(const EvaluationParameterMap& paramMap) :
-        paramMap_(paramMap)
+        paramMap_(paramMap),
+        moveParam_(paramMap.moveParamSet().packed())
     {
     }
 
@@ -66,16 +91,16 @@ public:
 
     void addScore(EvaluationMoveFeatureKey key, double v)
     {
-        for (const auto& mode : ALL_EVALUATION_MODES) {
-            collectedSimpleScore_.moveScore.scoreMap[ordinal(mode)] += moveParamSet().param(mode, key) * v;
-        }
+        if (features_.full())
+            flush();
+        features_.add(moveParam_.row(key), v);
     }
 
     void addScore(EvaluationMoveSparseFeatureKey key, int idx, int n = 1)
     {
-        for (const auto& mode : ALL_EVALUATION_MODES) {
-            collectedSimpleScore_.moveScore.scoreMap[ordinal(mode)] += moveParamSet().param(mode, key, idx) * n;
-        }
+        if (features_.full())
+            flush();
+        features_.add(moveParam_.row(key, idx), n);
     }
 
     void mergeMainRensaScore(const CollectedSimpleRensaScore& rensaScore)
@@ -90,7 +115,7 @@ public:
     void setCoef(const CollectedCoef& coef) { collectedCoef_ = coef; }
     const CollectedCoef& collectedCoef() const { return collectedCoef_; }
 
-    const CollectedSimpleScore& collectedScore() const { return collectedSimpleScore_; }
+    const CollectedSimpleScore& collectedScore() const { flush(); return collectedSimpleScore_; }
 
     const EvaluationMoveParameterSet& moveParamSet() const { return paramMap_.moveParamSet(); }
     const EvaluationRensaParameterSet& mainRensaParamSet() const { return paramMap_.mainRensaParamSet(); }
@@ -100,9 +125,19 @@ public:
     int estimatedRensaScore() const { return estimatedRensaScore_; }
 
 private:
+    void flush() const
+    {
+        if (features_.empty())
+            return;
+        addPackedScore(moveParam_, features_, &collectedSimpleScore_.moveScore);
+        features_.clear();
+    }
+
     const EvaluationParameterMap& paramMap_;
+    const PackedEvaluationParameter<EvaluationMoveFeatureSet>& moveParam_;
+    mutable PackedFeatureVector features_;
     CollectedCoef collectedCoef_;
-    CollectedSimpleScore collectedSimpleScore_;
+    mutable CollectedSimpleScore collectedSimpleScore_;
     int estimatedRensaScore_ = 0;
 };
 
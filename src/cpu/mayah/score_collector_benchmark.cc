@@ -0,0 +1,35 @@
+#include "score_collector.h"
+
+#include "base/benchmark.h"
+
+#include "evaluation_parameter.h"
+
+using namespace std;
+
+// Collects the features of one detected rensa, as Evaluator does for each rensa.
+BENCHMARK(ScoreCollectorBenchmark, simpleRensaScoreCollector)
+{
+    EvaluationParameterMap paramMap;
+    paramMap.mutableMainRensaParamSet()->setDefault(SCORE, 1.0);
+    paramMap.mutableMainRensaParamSet()->setDefault(MAX_CHAINS, 10, 100.0);
+    paramMap.mutableSideRensaParamSet()->setDefault(VIRTUAL_SCORE, 1.0);
+
+    const CollectedCoef coef;
+    benchmark.measure([&]() {
+        SimpleRensaScoreCollector sc(paramMap.mainRensaParamSet(), paramMap.sideRensaParamSet());
+        sc.addScore(SCORE, 1000);
+        sc.addScore(VIRTUAL_SCORE, 800);
+        sc.addScore(MAX_CHAINS, 10);
+        sc.addScore(CONNECTION_AFTER_DROP_2, 3);
+        sc.addScore(CONNECTION_AFTER_DROP_3, 1);
+        sc.addScore(RENSA_VALLEY_DEPTH, 2);
+        sc.addScore(RENSA_RIDGE_HEIGHT, 1);
+        sc.addScore(RENSA_FIELD_USHAPE_LINEAR, 12);
+        sc.addScore(RENSA_FIELD_USHAPE_SQUARE, 40);
+        sc.addScore(IGNITION_HEIGHT, 3);
+        sc.addScore(NECESSARY_PUYOS_LINEAR, 4);
+        sc.addScore(NECESSARY_PUYOS_SQUARE, 16);
+        base::doNotOptimize(sc.mainRensaScore().score(coef));
+        base::doNotOptimize(sc.sideRensaScore().score(coef));
+    });
+}
@@ -16,3 +16,18 @@ TEST(ScoreCollectorTest, score)
     EXPECT_EQ(50.0, collector.collectedScore().score(EvaluationMode::EARLY));
     EXPECT_EQ(30.0, collector.collectedScore().score(EvaluationMode::MIDDLE));
 }
+
+TEST(ScoreCollectorTest, moreFeaturesThanCapacity)
+{
+    EvaluationParameterMap m;
+    m.mutableMainRensaParamSet()->setDefault(SCORE, 1.0);
+    m.mutableSideRensaParamSet()->setDefault(SCORE, 2.0);
+
+    SimpleRensaScoreCollector collector(m.mainRensaParamSet(), m.sideRensaParamSet());
+    const int n = PackedFeatureVector::CAPACITY * 2 + 1;
+    for (int i = 0; i < n; ++i)
+        collector.addScore(SCORE, 1.0);
+
+    EXPECT_EQ(n, collector.mainRensaScore().score(EvaluationMode::MIDDLE));
+    EXPECT_EQ(2 * n, collector.sideRensaScore().score(EvaluationMode::MIDDLE));
+}
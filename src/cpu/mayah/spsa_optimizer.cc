@@ -0,0 +1,130 @@
+#include "spsa_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <glog/logging.h>
+
+using namespace std;
+
+SPSAOptimizer::SPSAOptimizer(const vector<double>& theta, const Config& config, unsigned int seed) :
+    config_(config),
+    theta_(theta),
+    delta_(theta.size()),
+    mt_(seed)
+{
+}
+
+void SPSAOptimizer::setTheta(const vector<double>& theta)
+{
+    CHECK_EQ(theta.size(), theta_.size());
+    theta_ = theta;
+}
+
+double SPSAOptimizer::currentA() const
+{
+    return config_.a / std::pow(iteration_ + 1 + config_.A, config_.alpha);
+}
+
+double SPSAOptimizer::currentC() const
+{
+    return config_.c / std::pow(iteration_ + 1, config_.gamma);
+}
+
+void SPSAOptimizer::perturb()
+{
+    // Rademacher distribution.
+    bernoulli_distribution dist(0.5);
+    for (auto& d : delta_)
+        d = dist(mt_) ? 1.0 : -1.0;
+}
+
+vector<double> SPSAOptimizer::thetaPlus() const
+{
+    double c = currentC();
+    vector<double> result(theta_);
+    for (size_t i = 0; i < result.size(); ++i)
+        result[i] += c * delta_[i];
+    return result;
+}
+
+vector<double> SPSAOptimizer::thetaMinus() const
+{
+    double c = currentC();
+    vector<double> result(theta_);
+    for (size_t i = 0; i < result.size(); ++i)
+        result[i] -= c * delta_[i];
+    return result;
+}
+
+vector<double> SPSAOptimizer::update(double yPlus, double yMinus)
+{
+    double a = currentA();
+    double c = currentC();
+
+    vector<double> step(theta_.size());
+    for (size_t i = 0; i < theta_.size(); ++i) {
+        DCHECK(delta_[i] == 1.0 || delta_[i] == -1.0) << "perturb() is not called?";
+        double gradient = (yPlus - yMinus) / (2 * c * delta_[i]);
+        step[i] = std::min(std::max(a * gradient, -config_.maxStep), config_.maxStep);
+        theta_[i] += step[i];
+    }
+
+    ++iteration_;
+    return step;
+}
+
+Json::Value SPSAOptimizer::toJson() const
+{
+    Json::Value root;
+    root["iteration"] = iteration_;
+
+    Json::Value& config = root["config"];
+    config["a"] = config_.a;
+    config["c"] = config_.c;
+    config["A"] = config_.A;
+    config["alpha"] = config_.alpha;
+    config["gamma"] = config_.gamma;
+    config["max_step"] = config_.maxStep;
+
+    root["theta"] = Json::Value(Json::arrayValue);
+    for (double t : theta_)
+        root["theta"].append(t);
+
+    stringstream ss;
+    ss << mt_;
+    root["random_state"] = ss.str();
+
+    return root;
+}
+
+bool SPSAOptimizer::loadJson(const Json::Value& root)
+{
+    const Json::Value& theta = root["theta"];
+    if (!theta.isArray() || theta.size() != theta_.size()) {
+        LOG(ERROR) << "theta size mismatch: expected " << theta_.size();
+        return false;
+    }
+
+    const Json::Value& config = root["config"];
+    config_.a = config["a"].asDouble();
+    config_.c = config["c"].asDouble();
+    config_.A = config["A"].asDouble();
+    config_.alpha = config["alpha"].asDouble();
+    config_.gamma = config["gamma"].asDouble();
+    config_.maxStep = config["max_step"].asDouble();
+
+    iteration_ = root["iteration"].asInt();
+    for (Json::ArrayIndex i = 0; i < theta.size(); ++i)
+        theta_[i] = theta[i].asDouble();
+
+    stringstream ss(root["random_state"].asString());
+    ss >> mt_;
+    if (!ss) {
+        LOG(ERROR) << "failed to restore random_state";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef CPU_MAYAH_SPSA_OPTIMIZER_H_
+#define CPU_MAYAH_SPSA_OPTIMIZER_H_
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+// SPSAOptimizer maximizes a noisy objective with Simultaneous Perturbation Stochastic
+// Approximation. Each iteration needs only two evaluations (theta + c_k * delta and
+// theta - c_k * delta) whatever the dimension is, which fits the evaluation parameter
+// that has hundreds of values.
+//
+// Usage:
+//   optimizer.perturb();
+//   double yPlus = f(optimizer.thetaPlus());
+//   double yMinus = f(optimizer.thetaMinus());
+//   optimizer.update(yPlus, yMinus);
+//
+// To reduce the variance of the gradient estimate, yPlus and yMinus should be evaluated
+// with the same random seeds.
+class SPSAOptimizer {
+public:
+    // Gains are a_k = a / (k + 1 + A)^alpha and c_k = c / (k + 1)^gamma as Spall recommends.
+    struct Config {
+        double a = 0.05;
+        double c = 0.05;
+        double A = 10;
+        double alpha = 0.602;
+        double gamma = 0.101;
+        // Each step of an element is clipped to [-maxStep, maxStep].
+        double maxStep = 0.2;
+    };
+
+    SPSAOptimizer(const std::vector<double>& theta, const Config&, unsigned int seed);
+
+    int iteration() const { return iteration_; }
+    const std::vector<double>& theta() const { return theta_; }
+    void setTheta(const std::vector<double>& theta);
+
+    double currentA() const;
+    double currentC() const;
+
+    // Draws the next simultaneous perturbation.
+    void perturb();
+    std::vector<double> thetaPlus() const;
+    std::vector<double> thetaMinus() const;
+    // Moves theta toward the estimated gradient, and proceeds to the next iteration.
+    // Returns the update of theta.
+    std::vector<double> update(double yPlus, double yMinus);
+
+    // Checkpoint. The random engine is saved too, so a resumed run draws the same
+    // perturbations as the original run would do.
+    Json::Value toJson() const;
+    bool loadJson(const Json::Value&);
+
+private:
+    Config config_;
+    std::vector<double> theta_;
+    std::vector<double> delta_;
+    int iteration_ = 0;
+    std::mt19937 mt_;
+};
+
+#endif // CPU_MAYAH_SPSA_OPTIMIZER_H_
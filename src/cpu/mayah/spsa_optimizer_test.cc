@@ -0,0 +1,80 @@
+#include "spsa_optimizer.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+
+// Maximized at (1, -2, 3).
+double objective(const vector<double>& x)
+{
+    return -(x[0] - 1) * (x[0] - 1) - (x[1] + 2) * (x[1] + 2) - (x[2] - 3) * (x[2] - 3);
+}
+
+void step(SPSAOptimizer* optimizer)
+{
+    optimizer->perturb();
+    double yPlus = objective(optimizer->thetaPlus());
+    double yMinus = objective(optimizer->thetaMinus());
+    optimizer->update(yPlus, yMinus);
+}
+
+} // anonymous namespace
+
+TEST(SPSAOptimizerTest, maximizeQuadratic)
+{
+    SPSAOptimizer::Config config;
+    config.a = 0.5;
+    config.c = 0.1;
+    SPSAOptimizer optimizer(vector<double> { 0, 0, 0 }, config, 1);
+
+    for (int i = 0; i < 1000; ++i)
+        step(&optimizer);
+
+    EXPECT_EQ(1000, optimizer.iteration());
+    EXPECT_NEAR(1.0, optimizer.theta()[0], 0.05);
+    EXPECT_NEAR(-2.0, optimizer.theta()[1], 0.05);
+    EXPECT_NEAR(3.0, optimizer.theta()[2], 0.05);
+}
+
+TEST(SPSAOptimizerTest, stepIsClipped)
+{
+    SPSAOptimizer::Config config;
+    config.maxStep = 0.1;
+    SPSAOptimizer optimizer(vector<double> { 0, 0 }, config, 1);
+
+    optimizer.perturb();
+    vector<double> s = optimizer.update(1000, 0);
+    EXPECT_DOUBLE_EQ(0.1, std::abs(s[0]));
+    EXPECT_DOUBLE_EQ(0.1, std::abs(s[1]));
+}
+
+TEST(SPSAOptimizerTest, resumeFromCheckpoint)
+{
+    SPSAOptimizer::Config config;
+    SPSAOptimizer original(vector<double> { 0, 0, 0 }, config, 1);
+    for (int i = 0; i < 10; ++i)
+        step(&original);
+
+    SPSAOptimizer resumed(vector<double> { 0, 0, 0 }, SPSAOptimizer::Config(), 2);
+    ASSERT_TRUE(resumed.loadJson(original.toJson()));
+    EXPECT_EQ(original.iteration(), resumed.iteration());
+    EXPECT_EQ(original.theta(), resumed.theta());
+
+    // The resumed optimizer should draw the same perturbations.
+    for (int i = 0; i < 10; ++i) {
+        step(&original);
+        step(&resumed);
+    }
+    EXPECT_EQ(original.theta(), resumed.theta());
+}
+
+TEST(SPSAOptimizerTest, loadJsonWithWrongSize)
+{
+    SPSAOptimizer original(vector<double> { 0, 0, 0 }, SPSAOptimizer::Config(), 1);
+    SPSAOptimizer other(vector<double> { 0, 0 }, SPSAOptimizer::Config(), 1);
+    EXPECT_FALSE(other.loadJson(original.toJson()));
+}
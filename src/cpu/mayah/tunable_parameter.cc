@@ -0,0 +1,159 @@
+#include "tunable_parameter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glog/logging.h>
+
+using namespace std;
+
+namespace {
+
+template<typename Param, typename FeatureSet>
+const Param& scopedParam(const EvaluationParameterSet<Param, FeatureSet>& paramSet, int mode)
+{
+    if (mode < 0)
+        return paramSet.defaultParam();
+    return paramSet.modeParam(ALL_EVALUATION_MODES[mode]);
+}
+
+template<typename Param, typename FeatureSet>
+Param* mutableScopedParam(EvaluationParameterSet<Param, FeatureSet>* paramSet, int mode)
+{
+    if (mode < 0)
+        return paramSet->mutableDefaultParam();
+    return paramSet->mutableModeParam(ALL_EVALUATION_MODES[mode]);
+}
+
+string scopeName(int mode)
+{
+    if (mode < 0)
+        return "default";
+    return toString(ALL_EVALUATION_MODES[mode]);
+}
+
+} // anonymous namespace
+
+TunableParameterVector::TunableParameterVector(const EvaluationParameterMap& original)
+{
+    collect(Target::MOVE, "move", original.moveParamSet());
+    collect(Target::MAIN_RENSA, "main", original.mainRensaParamSet());
+    collect(Target::SIDE_RENSA, "side", original.sideRensaParamSet());
+}
+
+template<typename Param, typename FeatureSet>
+void TunableParameterVector::collect(Target target, const string& targetName,
+                                     const EvaluationParameterSet<Param, FeatureSet>& paramSet)
+{
+    for (int mode = -1; mode < NUM_EVALUATION_MODES; ++mode) {
+        const Param& param = scopedParam(paramSet, mode);
+        string prefix = "mode." + scopeName(mode) + "." + targetName + ".";
+
+        for (const auto& feature : FeatureSet::features()) {
+            if (!feature.isTweakable() || !param.hasParam(feature.key()))
+                continue;
+            double v = param.param(feature.key());
+            entries_.push_back(Entry { prefix + feature.name(), target, mode, false,
+                                       feature.key(), 0, std::max(std::abs(v), 1.0) });
+        }
+
+        for (const auto& feature : FeatureSet::sparseFeatures()) {
+            if (!feature.isTweakable() || !param.hasParam(feature.key()))
+                continue;
+
+            // All the values in a sparse parameter share the scale, so that the monotonicity
+            // is kept in the normalized space.
+            double scale = 1.0;
+            for (size_t i = 0; i < feature.size(); ++i)
+                scale = std::max(scale, std::abs(param.param(feature.key(), i)));
+
+            size_t begin = entries_.size();
+            for (size_t i = 0; i < feature.size(); ++i) {
+                string name = prefix + feature.name() + "[" + std::to_string(i) + "]";
+                entries_.push_back(Entry { name, target, mode, true,
+                                           feature.key(), static_cast<int>(i), scale });
+            }
+            monotoneRanges_.push_back(MonotoneRange { begin, entries_.size(), feature.isAscending() });
+        }
+    }
+}
+
+template<typename Param, typename FeatureSet>
+double TunableParameterVector::value(const Entry& entry, const EvaluationParameterSet<Param, FeatureSet>& paramSet)
+{
+    const Param& param = scopedParam(paramSet, entry.mode);
+    if (entry.sparse)
+        return param.param(static_cast<typename FeatureSet::SparseFeatureKey>(entry.key), entry.index);
+    return param.param(static_cast<typename FeatureSet::FeatureKey>(entry.key));
+}
+
+template<typename Param, typename FeatureSet>
+void TunableParameterVector::setValue(const Entry& entry, double v, EvaluationParameterSet<Param, FeatureSet>* paramSet)
+{
+    Param* param = mutableScopedParam(paramSet, entry.mode);
+    if (entry.sparse)
+        param->setParam(static_cast<typename FeatureSet::SparseFeatureKey>(entry.key), entry.index, v);
+    else
+        param->setParam(static_cast<typename FeatureSet::FeatureKey>(entry.key), v);
+}
+
+vector<double> TunableParameterVector::toVector(const EvaluationParameterMap& paramMap) const
+{
+    vector<double> values;
+    values.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        double v = 0;
+        switch (entry.target) {
+        case Target::MOVE:
+            v = value(entry, paramMap.moveParamSet());
+            break;
+        case Target::MAIN_RENSA:
+            v = value(entry, paramMap.mainRensaParamSet());
+            break;
+        case Target::SIDE_RENSA:
+            v = value(entry, paramMap.sideRensaParamSet());
+            break;
+        }
+        values.push_back(v / entry.scale);
+    }
+
+    return values;
+}
+
+void TunableParameterVector::apply(const vector<double>& values, EvaluationParameterMap* paramMap) const
+{
+    CHECK_EQ(values.size(), entries_.size());
+
+    vector<double> projected(values);
+    project(&projected);
+
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& entry = entries_[i];
+        double v = projected[i] * entry.scale;
+        switch (entry.target) {
+        case Target::MOVE:
+            setValue(entry, v, paramMap->mutableMoveParamSet());
+            break;
+        case Target::MAIN_RENSA:
+            setValue(entry, v, paramMap->mutableMainRensaParamSet());
+            break;
+        case Target::SIDE_RENSA:
+            setValue(entry, v, paramMap->mutableSideRensaParamSet());
+            break;
+        }
+    }
+}
+
+void TunableParameterVector::project(vector<double>* values) const
+{
+    CHECK_EQ(values->size(), entries_.size());
+
+    for (const auto& range : monotoneRanges_) {
+        for (size_t i = range.begin + 1; i < range.end; ++i) {
+            if (range.ascending)
+                (*values)[i] = std::max((*values)[i], (*values)[i - 1]);
+            else
+                (*values)[i] = std::min((*values)[i], (*values)[i - 1]);
+        }
+    }
+}
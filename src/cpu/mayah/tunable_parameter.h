@@ -0,0 +1,65 @@
+#ifndef CPU_MAYAH_TUNABLE_PARAMETER_H_
+#define CPU_MAYAH_TUNABLE_PARAMETER_H_
+
+#include <string>
+#include <vector>
+
+#include "evaluation_parameter.h"
+
+// TunableParameterVector flattens the tweakable parameters of EvaluationParameterMap
+// into a vector so that a numerical optimizer can handle them.
+//
+// Only the parameters which are explicitly specified in the original map are collected,
+// i.e. a value which falls back to the default parameter is not tuned separately.
+// Each value is divided by its scale (the magnitude of the original value), so that
+// all the elements of the vector have roughly the same order.
+class TunableParameterVector {
+public:
+    explicit TunableParameterVector(const EvaluationParameterMap& original);
+
+    size_t size() const { return entries_.size(); }
+    // e.g. "mode.default.move.CONNECTION_2" or "mode.early.main.IGNITION_HEIGHT[3]".
+    const std::string& name(size_t i) const { return entries_[i].name; }
+    double scale(size_t i) const { return entries_[i].scale; }
+
+    // Returns the normalized values of |paramMap|.
+    std::vector<double> toVector(const EvaluationParameterMap& paramMap) const;
+    // Writes |values| back into |paramMap|. |values| is projected before writing.
+    void apply(const std::vector<double>& values, EvaluationParameterMap* paramMap) const;
+
+    // Makes the sparse parameters monotone as their tweakability says.
+    void project(std::vector<double>* values) const;
+
+private:
+    enum class Target { MOVE, MAIN_RENSA, SIDE_RENSA };
+
+    struct Entry {
+        std::string name;
+        Target target;
+        // -1 for the default parameter.
+        int mode;
+        bool sparse;
+        int key;
+        int index;
+        double scale;
+    };
+
+    // A range of entries which comes from the same sparse parameter.
+    struct MonotoneRange {
+        size_t begin;
+        size_t end;
+        bool ascending;
+    };
+
+    template<typename Param, typename FeatureSet>
+    void collect(Target, const std::string& targetName, const EvaluationParameterSet<Param, FeatureSet>&);
+    template<typename Param, typename FeatureSet>
+    static double value(const Entry&, const EvaluationParameterSet<Param, FeatureSet>&);
+    template<typename Param, typename FeatureSet>
+    static void setValue(const Entry&, double, EvaluationParameterSet<Param, FeatureSet>*);
+
+    std::vector<Entry> entries_;
+    std::vector<MonotoneRange> monotoneRanges_;
+};
+
+#endif // CPU_MAYAH_TUNABLE_PARAMETER_H_
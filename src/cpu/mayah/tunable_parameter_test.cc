@@ -0,0 +1,75 @@
+#include "tunable_parameter.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "evaluation_parameter.h"
+
+using namespace std;
+
+TEST(TunableParameterVectorTest, collectsSpecifiedTweakableParameters)
+{
+    EvaluationParameterMap paramMap;
+    paramMap.mutableMoveParamSet()->setDefault(CONNECTION_2, 30);
+    paramMap.mutableMoveParamSet()->setParam(EvaluationMode::EARLY, CONNECTION_3, -0.5);
+    // Not tweakable.
+    paramMap.mutableMoveParamSet()->setDefault(NUM_CHIGIRI, -50);
+
+    TunableParameterVector tunable(paramMap);
+    ASSERT_EQ(2U, tunable.size());
+    EXPECT_EQ("mode.default.move.CONNECTION_2", tunable.name(0));
+    EXPECT_EQ("mode.early.move.CONNECTION_3", tunable.name(1));
+
+    // Values are normalized. The scale is at least 1.
+    EXPECT_EQ((vector<double> { 1.0, -0.5 }), tunable.toVector(paramMap));
+}
+
+TEST(TunableParameterVectorTest, apply)
+{
+    EvaluationParameterMap paramMap;
+    paramMap.mutableMoveParamSet()->setDefault(CONNECTION_2, 30);
+    paramMap.mutableMainRensaParamSet()->setDefault(SCORE, 2);
+
+    TunableParameterVector tunable(paramMap);
+    ASSERT_EQ(2U, tunable.size());
+
+    tunable.apply(vector<double> { 0.5, 1.5 }, &paramMap);
+    EXPECT_EQ(15, paramMap.moveParamSet().param(EvaluationMode::EARLY, CONNECTION_2));
+    EXPECT_EQ(3, paramMap.mainRensaParamSet().param(EvaluationMode::EARLY, SCORE));
+}
+
+TEST(TunableParameterVectorTest, sparseParameterIsProjected)
+{
+    EvaluationParameterMap paramMap;
+    for (int i = 0; i < 15; ++i)
+        paramMap.mutableMoveParamSet()->setDefault(VALLEY_DEPTH, i, -10.0 * i);
+
+    TunableParameterVector tunable(paramMap);
+    ASSERT_EQ(15U, tunable.size());
+    EXPECT_EQ("mode.default.move.VALLEY_DEPTH[3]", tunable.name(3));
+
+    vector<double> values = tunable.toVector(paramMap);
+    // The scale is the max absolute value in the sparse parameter.
+    EXPECT_DOUBLE_EQ(-1.0, values[14]);
+
+    // VALLEY_DEPTH is DESCENDING.
+    values[5] = 1.0;
+    tunable.apply(values, &paramMap);
+    EXPECT_EQ(-40, paramMap.moveParamSet().param(EvaluationMode::EARLY, VALLEY_DEPTH, 4));
+    EXPECT_EQ(-40, paramMap.moveParamSet().param(EvaluationMode::EARLY, VALLEY_DEPTH, 5));
+    EXPECT_EQ(-60, paramMap.moveParamSet().param(EvaluationMode::EARLY, VALLEY_DEPTH, 6));
+}
+
+TEST(TunableParameterVectorTest, roundTripWithFeatureToml)
+{
+    EvaluationParameterMap paramMap;
+    ASSERT_TRUE(paramMap.load(SRC_DIR "/cpu/mayah/feature.toml"));
+    EvaluationParameterMap original(paramMap);
+
+    TunableParameterVector tunable(paramMap);
+    EXPECT_LT(0U, tunable.size());
+
+    tunable.apply(tunable.toVector(paramMap), &paramMap);
+    EXPECT_EQ(original.toString(), paramMap.toString());
+}
@@ -0,0 +1,508 @@
+// tuner tunes the evaluation parameter with SPSA.
+//
+// The master process evaluates candidate parameters by running Endless on worker processes.
+// Local workers are forked from the master. Workers on other hosts can join by running
+//   tuner --tuner_master=<master host>:<port>
+// Master and workers talk with length-prefixed JSON messages over TCP:
+//   master -> worker: {"id": <job id>, "feature": <feature toml>, "seeds": [<seed>, ...]}
+//   worker -> master: {"id": <job id>, "scores": [<score>, ...]}
+// A worker exits when the connection is closed.
+
+#include "mayah_ai.h"
+
+#include <arpa/inet.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <json/json.h>
+#include <toml/toml.h>
+
+#include "base/blocking_queue.h"
+#include "build/build_config.h"
+#include "core/kumipuyo_seq_generator.h"
+#include "net/socket/socket_factory.h"
+#include "solver/endless.h"
+
+#include "evaluation_parameter.h"
+#include "spsa_optimizer.h"
+#include "tunable_parameter.h"
+
+DECLARE_string(feature);
+
+DEFINE_string(tuner_master, "", "Run as a worker which connects to the master at host:port.");
+DEFINE_int32(port, 24250, "port to wait for workers.");
+DEFINE_int32(local_workers, 4, "the number of worker processes forked locally.");
+DEFINE_int32(iterations, 100, "the number of SPSA iterations.");
+DEFINE_int32(seeds_per_iteration, 50, "the number of endless cases for each candidate.");
+DEFINE_int32(worker_timeout, 60, "the master fails when no worker is connected for this many seconds.");
+DEFINE_int32(seeds_per_job, 5, "the number of endless cases sent to a worker at once.");
+DEFINE_int32(seed_offset, 0, "offset for random seed of KumipuyoSeq.");
+DEFINE_int32(spsa_seed, 1, "random seed for SPSA perturbation.");
+DEFINE_double(spsa_a, 0.05, "SPSA step size a.");
+DEFINE_double(spsa_c, 0.05, "SPSA perturbation size c.");
+DEFINE_double(score_unit, 10000, "an objective value is (average endless score) / score_unit.");
+DEFINE_string(checkpoint, "tuner_checkpoint.json", "the path to write the checkpoint after each iteration.");
+DEFINE_bool(resume, false, "resume from --checkpoint.");
+DEFINE_string(output, "tuned_feature.toml", "the path to write the tuned parameter after each iteration.");
+
+using namespace std;
+
+namespace {
+
+// A message is a feature toml and a few numbers, so it's far smaller than this.
+// A larger size means a broken or unexpected peer.
+const uint32_t MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+
+bool writeMessage(net::Socket* socket, const Json::Value& value)
+{
+    Json::FastWriter writer;
+    string payload = writer.write(value);
+
+    uint32_t size = htonl(static_cast<uint32_t>(payload.size()));
+    if (!socket->writeExactly(&size, sizeof(size)))
+        return false;
+    return socket->writeExactly(payload.data(), payload.size());
+}
+
+bool readMessage(net::Socket* socket, Json::Value* value)
+{
+    uint32_t size;
+    if (!socket->readExactly(&size, sizeof(size)))
+        return false;
+
+    size = ntohl(size);
+    if (size > MAX_MESSAGE_SIZE) {
+        LOG(ERROR) << "message is too large: " << size << " bytes";
+        return false;
+    }
+
+    string payload(size, '\0');
+    if (!socket->readExactly(&payload[0], payload.size()))
+        return false;
+
+    Json::Reader reader;
+    return reader.parse(payload, *value);
+}
+
+bool parseHostPort(const string& hostPort, string* host, int* port)
+{
+    string::size_type pos = hostPort.rfind(':');
+    if (pos == string::npos)
+        return false;
+    *host = hostPort.substr(0, pos);
+    *port = atoi(hostPort.substr(pos + 1).c_str());
+    return *port > 0;
+}
+
+bool parseParameterMap(const string& str, EvaluationParameterMap* paramMap)
+{
+    istringstream iss(str);
+    toml::ParseResult result = toml::parse(iss);
+    if (!result.valid()) {
+        LOG(ERROR) << result.errorReason;
+        return false;
+    }
+    return paramMap->loadValue(result.value);
+}
+
+// ----------------------------------------------------------------------
+// worker
+
+int runWorker()
+{
+    string host;
+    int port;
+    CHECK(parseHostPort(FLAGS_tuner_master, &host, &port)) << FLAGS_tuner_master;
+
+    net::TCPClientSocket socket = net::SocketFactory::instance()->makeTCPClientSocket();
+    CHECK(socket.valid());
+    if (!socket.connect(host.c_str(), port)) {
+        LOG(ERROR) << "cannot connect to " << FLAGS_tuner_master;
+        return 1;
+    }
+    socket.setTCPNodelay();
+
+    Json::Value job;
+    while (readMessage(&socket, &job)) {
+        EvaluationParameterMap paramMap;
+        CHECK(parseParameterMap(job["feature"].asString(), &paramMap));
+        paramMap.removeNontokopuyoParameter();
+
+        auto ai = new DebuggableMayahAI;
+        ai->setUsesRensaHandTree(false);
+        ai->setEvaluationParameterMap(paramMap);
+
+        std::unique_ptr<AI> ai_ptr(ai);
+        Endless endless(std::move(ai_ptr));
+
+        Json::Value result;
+        result["id"] = job["id"];
+        result["scores"] = Json::Value(Json::arrayValue);
+        for (const auto& seed : job["seeds"]) {
+            KumipuyoSeq seq = KumipuyoSeqGenerator::generateACPuyo2SequenceWithSeed(seed.asInt());
+            EndlessResult r = endless.run(seq);
+            result["scores"].append(std::max(r.score, 0));
+        }
+
+        if (!writeMessage(&socket, result))
+            return 1;
+    }
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------
+// master
+
+struct Job {
+    int id;
+    string feature;
+    vector<int> seeds;
+};
+
+struct JobResult {
+    int id;
+    vector<int> scores;
+};
+
+// WorkerPool serves jobs to the connected workers. When a worker is disconnected,
+// its running job is pushed back to the queue, so that another worker takes it.
+class WorkerPool {
+public:
+    explicit WorkerPool(int port) :
+        serverSocket_(net::SocketFactory::instance()->makeTCPServerSocket())
+    {
+        CHECK(serverSocket_.valid());
+        CHECK(serverSocket_.bindFromAny(port)) << "cannot bind port " << port;
+        CHECK(serverSocket_.listen());
+    }
+
+    // Starts accepting workers. This never returns until the process ends, so detach it.
+    void startAccepting()
+    {
+        thread th([this]() {
+            while (true) {
+                net::TCPSocket socket = serverSocket_.accept();
+                if (!socket.valid())
+                    continue;
+                socket.setTCPNodelay();
+                LOG(INFO) << "worker connected: sd=" << socket.get();
+                ++numWorkers_;
+                // net::Socket is move-only. Give the ownership to the serving thread.
+                auto s = std::make_shared<net::TCPSocket>(std::move(socket));
+                thread([this, s]() { serve(s.get()); }).detach();
+            }
+        });
+        th.detach();
+    }
+
+    int numWorkers() const { return numWorkers_; }
+
+    // Runs all the |jobs| on the workers, and sets the results in the same order.
+    // Returns false when no worker has been connected for |workerTimeout|.
+    bool run(const vector<Job>& jobs, const chrono::seconds& workerTimeout, vector<JobResult>* results)
+    {
+        map<int, size_t> indices;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            indices[jobs[i].id] = i;
+            jobs_.push(jobs[i]);
+        }
+
+        results->assign(jobs.size(), JobResult());
+        auto lastSeenWorker = chrono::steady_clock::now();
+        for (size_t n = 0; n < jobs.size(); ) {
+            JobResult result;
+            if (!results_.takeWithTimeout(chrono::seconds(1), &result)) {
+                auto now = chrono::steady_clock::now();
+                if (numWorkers_ > 0) {
+                    lastSeenWorker = now;
+                } else if (now - lastSeenWorker >= workerTimeout) {
+                    LOG(ERROR) << "no worker has been connected for " << workerTimeout.count() << " seconds";
+                    return false;
+                }
+                continue;
+            }
+
+            auto it = indices.find(result.id);
+            if (it == indices.end())
+                continue;
+            (*results)[it->second] = std::move(result);
+            indices.erase(it);
+            ++n;
+        }
+
+        return true;
+    }
+
+private:
+    void serve(net::Socket* socket)
+    {
+        while (true) {
+            Job job = jobs_.take();
+
+            Json::Value message;
+            message["id"] = job.id;
+            message["feature"] = job.feature;
+            message["seeds"] = Json::Value(Json::arrayValue);
+            for (int seed : job.seeds)
+                message["seeds"].append(seed);
+
+            Json::Value reply;
+            if (!writeMessage(socket, message) || !readMessage(socket, &reply) || reply["id"].asInt() != job.id) {
+                LOG(WARNING) << "worker disconnected: sd=" << socket->get();
+                --numWorkers_;
+                jobs_.push(job);
+                return;
+            }
+
+            JobResult result;
+            result.id = job.id;
+            for (const auto& score : reply["scores"])
+                result.scores.push_back(score.asInt());
+            results_.push(result);
+        }
+    }
+
+    net::TCPServerSocket serverSocket_;
+    atomic<int> numWorkers_ { 0 };
+    base::InfiniteBlockingQueue<Job> jobs_;
+    base::InfiniteBlockingQueue<JobResult> results_;
+};
+
+vector<pid_t> forkLocalWorkers(const char* programName, int n)
+{
+    string masterFlag = "--tuner_master=127.0.0.1:" + std::to_string(FLAGS_port);
+
+    vector<pid_t> pids;
+    for (int i = 0; i < n; ++i) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            PLOG(FATAL) << "failed to fork";
+            return pids;
+        }
+
+        if (pid == 0) {
+            // child
+            // |programName| is argv[0], which might not be a path from the current directory
+            // (e.g. when the tuner is run via PATH). So /proc/self/exe is tried first.
+            char* const args[] = {
+                const_cast<char*>(programName),
+                const_cast<char*>(masterFlag.c_str()),
+                const_cast<char*>("--from_wrapper"),
+                nullptr,
+            };
+#if defined(OS_LINUX)
+            execv("/proc/self/exe", args);
+            PLOG(ERROR) << "failed to exec /proc/self/exe";
+#endif
+            execvp(programName, args);
+            PLOG(ERROR) << "failed to exec " << programName;
+            _exit(1);
+        }
+
+        pids.push_back(pid);
+    }
+
+    return pids;
+}
+
+// Sets (average score) / score_unit of each candidate to |objectives|. All the candidates
+// are evaluated on the same seeds (common random numbers), so that the difference between
+// candidates doesn't suffer from the variance of KumipuyoSeq.
+// Returns false when the workers are gone.
+bool evaluate(WorkerPool* pool, const vector<EvaluationParameterMap>& candidates, const vector<int>& seeds,
+              vector<double>* objectives)
+{
+    static int nextJobId = 0;
+
+    vector<Job> jobs;
+    vector<size_t> candidateIndices;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        string feature = candidates[i].toString();
+        for (size_t j = 0; j < seeds.size(); j += FLAGS_seeds_per_job) {
+            size_t end = std::min(seeds.size(), j + FLAGS_seeds_per_job);
+            jobs.push_back(Job { nextJobId++, feature, vector<int>(seeds.begin() + j, seeds.begin() + end) });
+            candidateIndices.push_back(i);
+        }
+    }
+
+    vector<JobResult> results;
+    if (!pool->run(jobs, chrono::seconds(FLAGS_worker_timeout), &results))
+        return false;
+
+    vector<double> sums(candidates.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        for (int score : results[i].scores)
+            sums[candidateIndices[i]] += score;
+    }
+
+    objectives->clear();
+    for (double sum : sums)
+        objectives->push_back(sum / seeds.size() / FLAGS_score_unit);
+    return true;
+}
+
+bool saveCheckpoint(const SPSAOptimizer& optimizer, const TunableParameterVector& tunable)
+{
+    Json::Value root;
+    root["spsa"] = optimizer.toJson();
+    root["names"] = Json::Value(Json::arrayValue);
+    for (size_t i = 0; i < tunable.size(); ++i)
+        root["names"].append(tunable.name(i));
+
+    // Write to a temporary file first not to break the checkpoint on crash.
+    string tmp = FLAGS_checkpoint + ".tmp";
+    {
+        ofstream ofs(tmp);
+        if (!ofs)
+            return false;
+        Json::StyledWriter writer;
+        ofs << writer.write(root);
+        if (!ofs)
+            return false;
+    }
+    return rename(tmp.c_str(), FLAGS_checkpoint.c_str()) == 0;
+}
+
+bool loadCheckpoint(const TunableParameterVector& tunable, SPSAOptimizer* optimizer)
+{
+    ifstream ifs(FLAGS_checkpoint);
+    if (!ifs)
+        return false;
+
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(ifs, root))
+        return false;
+
+    const Json::Value& names = root["names"];
+    if (names.size() != tunable.size()) {
+        LOG(ERROR) << "checkpoint has " << names.size() << " parameters, but " << tunable.size() << " expected";
+        return false;
+    }
+    for (Json::ArrayIndex i = 0; i < names.size(); ++i) {
+        if (names[i].asString() != tunable.name(i)) {
+            LOG(ERROR) << "parameter mismatch: " << names[i].asString() << " vs " << tunable.name(i);
+            return false;
+        }
+    }
+
+    return optimizer->loadJson(root["spsa"]);
+}
+
+int runMaster(const char* programName)
+{
+    EvaluationParameterMap original;
+    if (!original.load(FLAGS_feature)) {
+        std::string filename = string(SRC_DIR) + "/cpu/mayah/" + FLAGS_feature;
+        if (!original.load(filename))
+            CHECK(false) << "parameter cannot be loaded correctly.";
+    }
+
+    // Candidates are sent with the non-tokopuyo parameters (workers remove them), so that
+    // the tuned parameter can be used as a feature file as is. Only the tokopuyo parameters
+    // are tuned.
+    EvaluationParameterMap tokopuyo(original);
+    tokopuyo.removeNontokopuyoParameter();
+    TunableParameterVector tunable(tokopuyo);
+    LOG(INFO) << "tuning " << tunable.size() << " parameters";
+
+    SPSAOptimizer::Config config;
+    config.a = FLAGS_spsa_a;
+    config.c = FLAGS_spsa_c;
+    SPSAOptimizer optimizer(tunable.toVector(original), config, FLAGS_spsa_seed);
+    if (FLAGS_resume) {
+        CHECK(loadCheckpoint(tunable, &optimizer)) << "cannot resume from " << FLAGS_checkpoint;
+        cout << "resumed from iteration " << optimizer.iteration() << endl;
+    }
+
+    // The pool is never deleted, since the detached threads keep using it until the process ends.
+    WorkerPool* pool = new WorkerPool(FLAGS_port);
+    pool->startAccepting();
+    vector<pid_t> pids = forkLocalWorkers(programName, FLAGS_local_workers);
+
+    int exitCode = 0;
+    while (optimizer.iteration() < FLAGS_iterations) {
+        int k = optimizer.iteration();
+
+        // A new set of seeds is used in each iteration not to overfit to particular sequences.
+        vector<int> seeds;
+        for (int i = 0; i < FLAGS_seeds_per_iteration; ++i)
+            seeds.push_back(FLAGS_seed_offset + k * FLAGS_seeds_per_iteration + i);
+
+        optimizer.perturb();
+        vector<double> thetaPlus = optimizer.thetaPlus();
+        vector<double> thetaMinus = optimizer.thetaMinus();
+        tunable.project(&thetaPlus);
+        tunable.project(&thetaMinus);
+
+        vector<EvaluationParameterMap> candidates(2, original);
+        tunable.apply(thetaPlus, &candidates[0]);
+        tunable.apply(thetaMinus, &candidates[1]);
+
+        vector<double> ys;
+        if (!evaluate(pool, candidates, seeds, &ys)) {
+            LOG(ERROR) << "stopped at iteration " << k << ". Resume with --resume.";
+            exitCode = 1;
+            break;
+        }
+        vector<double> step = optimizer.update(ys[0], ys[1]);
+
+        vector<double> theta = optimizer.theta();
+        tunable.project(&theta);
+        optimizer.setTheta(theta);
+
+        double maxStep = 0;
+        for (double s : step)
+            maxStep = std::max(maxStep, std::abs(s));
+        cout << "iteration " << setw(4) << k
+             << ": y+ = " << ys[0] << " y- = " << ys[1]
+             << " max step = " << maxStep
+             << " (" << pool->numWorkers() << " workers)" << endl;
+
+        EvaluationParameterMap current(original);
+        tunable.apply(optimizer.theta(), &current);
+        CHECK(current.save(FLAGS_output));
+        CHECK(saveCheckpoint(optimizer, tunable));
+    }
+
+    for (pid_t pid : pids) {
+        kill(pid, SIGTERM);
+        waitpid(pid, nullptr, 0);
+    }
+
+    return exitCode;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+#if !defined(_MSC_VER)
+    google::InstallFailureSignalHandler();
+#endif
+
+    if (!FLAGS_tuner_master.empty())
+        return runWorker();
+    return runMaster(argv[0]);
+}
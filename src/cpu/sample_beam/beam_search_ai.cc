@@ -1,7 +1,8 @@
 #include "cpu/sample_beam/beam_search_ai.h"
 
-#include <array>
+#include <algorithm>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <sstream>
 #include <vector>
@@ -11,10 +12,12 @@
 
 #include "base/base.h"
 #include "base/time.h"
+#include "base/wait_group.h"
 #include "core/plan/plan.h"
 #include "core/rensa/rensa_detector.h"
 #include "core/core_field.h"
 #include "core/kumipuyo_seq_generator.h"
+#include "cpu/sample_beam/concurrent_min_key_table.h"
 
 #define RECORD_RANK_LOG 0
 
@@ -31,27 +34,17 @@ DEFINE_string(type, "2dub", "Type of AI. Choose \"2dub\" or \"full\".");
 
 namespace sample {
 
-struct SearchState {
-  CoreField field;
-  Decision decision;
-  int from;
-  std::array<int, 3> features;
-  // Fill: [0: # of ojama, 1: expected score, 2: -frames]
-  // 2Dub: [0: # of 2dub, 1: # of ojama, 2: expected score]
-};
-
 BeamFullAI::BeamFullAI() : BeamSearchAI("Full") {}
 
 bool BeamFullAI::skipRensaPlan(const RensaResult&) const {
   return false;
 }
 
-SearchState BeamFullAI::generateNextRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan) const {
+SearchState BeamFullAI::generateNextRensaState(int from, const SearchState& state, const RefPlan& plan) const {
   int ojama = std::min(plan.score() / 70, 60);
   int neg_frame = state.features[2] - plan.totalFrames();
 
   SearchState ret;
-  ret.field = field;
   ret.decision = (state.decision.x == 0) ? plan.decision(0) : state.decision;
   ret.from = from;
   ret.features[0] = ojama;
@@ -60,11 +53,10 @@ SearchState BeamFullAI::generateNextRensaState(const CoreField& field, int from,
   return ret;
 }
 
-SearchState BeamFullAI::generateNextNonRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan, int expect) const {
+SearchState BeamFullAI::generateNextNonRensaState(int from, const SearchState& state, const RefPlan& plan, int expect) const {
   int neg_frame = state.features[2] - plan.totalFrames();
 
   SearchState ret;
-  ret.field = field;
   ret.decision = (state.decision.x == 0) ? plan.decision(0) : state.decision;
   ret.from = from;
   ret.features[0] = 0;
@@ -89,10 +81,9 @@ bool Beam2DubAI::skipRensaPlan(const RensaResult& result) const {
   return result.chains > 2 || result.score < 680;
 }
 
-SearchState Beam2DubAI::generateNextRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan) const {
+SearchState Beam2DubAI::generateNextRensaState(int from, const SearchState& state, const RefPlan& plan) const {
   int ojama = plan.score() / 70;
   SearchState ret;
-  ret.field = field;
   ret.decision = (state.decision.x == 0) ? plan.decision(0) : state.decision;
   ret.from = from;
   ret.features[0] = state.features[0] + 1;
@@ -101,9 +92,8 @@ SearchState Beam2DubAI::generateNextRensaState(const CoreField& field, int from,
   return ret;
 }
 
-SearchState Beam2DubAI::generateNextNonRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan, int expect) const {
+SearchState Beam2DubAI::generateNextNonRensaState(int from, const SearchState& state, const RefPlan& plan, int expect) const {
   SearchState ret;
-  ret.field = field;
   ret.decision = (state.decision.x == 0) ? plan.decision(0) : state.decision;
   ret.from = from;
   ret.features[0] = state.features[0];
@@ -148,6 +138,36 @@ DropDecision Beam2DubAI::think(int frame_id, const CoreField& field, const Kumip
 
 // ===================================================================
 
+// A plan found in the expansion, which is not evaluated yet.
+struct BeamCandidate {
+  CoreField field;
+  RensaResult rensa_result;
+  Decision decision;
+  int num_chigiri;
+  int frames_to_ignite;
+  int last_drop_frames;
+  int from;
+  std::uint64_t hash;
+  std::uint64_t key;
+};
+
+// The buffers for a contiguous range of the beam. They are reused among the turns.
+// The field of states[i] is candidates[survivors[i]].field, which is copied only when
+// the state is selected into the next beam.
+struct BeamSlice {
+  std::vector<BeamCandidate> candidates;
+  std::vector<SearchState> states;
+  std::vector<int> survivors;
+};
+
+BeamSearchAI::BeamSearchAI(const std::string& name) :
+  AI(name),
+  executor_(Executor::makeDefaultExecutor()) {
+}
+
+BeamSearchAI::~BeamSearchAI() {
+}
+
 DropDecision BeamSearchAI::think(
     int frame_id, const CoreField& field, const KumipuyoSeq& seq,
     const PlayerState&, const PlayerState&, bool) const {
@@ -208,36 +228,86 @@ SearchState BeamSearchAI::search(
     const CoreField& field, const KumipuyoSeq& vseq, int search_turns) const {
   CHECK_GE(vseq.size(), search_turns);
 
+  // Only the fields of the current beam are kept.
   std::vector<std::vector<SearchState>> q_states(search_turns + 1);
+  std::vector<CoreField> fields { field };
+  std::vector<CoreField> next_fields;
 
   SearchState init_state;
-  init_state.field = field;
   init_state.decision = Decision(0, 0);
+  init_state.from = 0;
   init_state.features[0] = 0;
   init_state.features[1] = 0;
   init_state.features[2] = std::numeric_limits<int>::min();
 
+  auto compare = [](const SearchState& a, const SearchState& b) {
+    if (a.features[0] == b.features[0]) {
+      if (a.features[1] == b.features[1])
+        return a.features[2] > b.features[2];
+      return a.features[1] > b.features[1];
+    }
+    return a.features[0] > b.features[0];
+  };
+
+  const int max_slices = std::max(1, executor_->numThreads() * 4);
+  std::vector<BeamSlice> slices(max_slices);
+  ConcurrentMinKeyTable dedup;
+  std::vector<SearchState> candidate_states;
+  std::vector<const CoreField*> candidate_fields;
+  std::vector<int> order;
+
   q_states[0].push_back(init_state);
   for (int t = 0; t < search_turns; ++t) {
-    std::unordered_set<uint64> visited;
-    const auto& que = q_states[t];
-    std::vector<SearchState>& next_states = q_states[t + 1];
-    for (size_t i = 0; i < que.size(); ++i)
-      generateNextStates(que[i], i, vseq.get(t), visited, next_states);
-
-    if (next_states.empty())
+    const std::vector<SearchState>& que = q_states[t];
+    const int num_states = que.size();
+    const int num_slices = std::min(max_slices, num_states);
+    const KumipuyoSeq kumi { vseq.get(t) };
+
+    // Expands the beam slice by slice, and then evaluates the deduplicated candidates.
+    dedup.reset(num_states * 22);
+    runInParallel(num_slices, [&](int i) {
+      expandSlice(fields, num_states * i / num_slices, num_states * (i + 1) / num_slices,
+                  kumi, &dedup, &slices[i]);
+    });
+    runInParallel(num_slices, [&](int i) {
+      evaluateSlice(que, dedup, &slices[i]);
+    });
+
+    candidate_states.clear();
+    candidate_fields.clear();
+    for (int i = 0; i < num_slices; ++i) {
+      BeamSlice& slice = slices[i];
+      candidate_states.insert(candidate_states.end(), slice.states.begin(), slice.states.end());
+      for (int j : slice.survivors)
+        candidate_fields.push_back(&slice.candidates[j].field);
+    }
+    if (candidate_states.empty())
       break;
-    std::sort(next_states.begin(), next_states.end(),
-              [](const SearchState& a, const SearchState& b) {
-                if (a.features[0] == b.features[0]) {
-                  if (a.features[1] == b.features[1])
-                    return a.features[2] > b.features[2];
-                  return a.features[1] > b.features[1];
-                }
-                return a.features[0] > b.features[0];
-              });
-    if (static_cast<int>(next_states.size()) >= FLAGS_beam_width)
-      next_states.erase(next_states.begin() + FLAGS_beam_width, next_states.end());
+
+    // Selects the best FLAGS_beam_width states without sorting all the candidates.
+    order.resize(candidate_states.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto compare_index = [&](int a, int b) {
+      if (compare(candidate_states[a], candidate_states[b]))
+        return true;
+      if (compare(candidate_states[b], candidate_states[a]))
+        return false;
+      return a < b;
+    };
+    if (static_cast<int>(order.size()) > FLAGS_beam_width) {
+      std::nth_element(order.begin(), order.begin() + FLAGS_beam_width, order.end(), compare_index);
+      order.resize(FLAGS_beam_width);
+    }
+    std::sort(order.begin(), order.end(), compare_index);
+
+    std::vector<SearchState>& next_states = q_states[t + 1];
+    next_states.clear();
+    next_fields.clear();
+    for (int i : order) {
+      next_states.push_back(candidate_states[i]);
+      next_fields.push_back(*candidate_fields[i]);
+    }
+    fields.swap(next_fields);
 
     const SearchState best = *next_states.begin();
     if (std::all_of(next_states.begin(), next_states.end(),
@@ -282,26 +352,53 @@ SearchState BeamSearchAI::search(
   return result;
 }
 
-void BeamSearchAI::generateNextStates(
-    const SearchState& state, int from, const Kumipuyo& kumi,
-    std::unordered_set<uint64>& visited, std::vector<SearchState>& states) const {
-  const BeamSearchAI* th = this;
-  auto callback = [&th, &state, &from, &visited, &states](const RefPlan& plan) {
-    const CoreField field = plan.field();
-    RensaResult result = plan.rensaResult();
+void BeamSearchAI::expandSlice(
+    const std::vector<CoreField>& fields, int begin, int end, const KumipuyoSeq& kumi,
+    ConcurrentMinKeyTable* dedup, BeamSlice* slice) const {
+  slice->candidates.clear();
+  for (int from = begin; from < end; ++from) {
+    std::uint64_t key = static_cast<std::uint64_t>(from) << 8;
+    Plan::iterateAvailablePlans(fields[from], kumi, 1, [&](const RefPlan& plan) {
+      slice->candidates.emplace_back();
+      BeamCandidate& c = slice->candidates.back();
+      c.field = plan.field();
+      c.rensa_result = plan.rensaResult();
+      c.decision = plan.decision(0);
+      c.num_chigiri = plan.numChigiri();
+      c.frames_to_ignite = plan.framesToIgnite();
+      c.last_drop_frames = plan.lastDropFrames();
+      c.from = from;
+      c.hash = c.field.hash();
+      c.key = key++;
+      dedup->recordMin(c.hash, c.key);
+    });
+  }
+}
 
-    uint64 h = field.hash();
-    if (!visited.insert(h).second)
-      return;
+void BeamSearchAI::evaluateSlice(
+    const std::vector<SearchState>& states, const ConcurrentMinKeyTable& dedup,
+    BeamSlice* slice) const {
+  slice->states.clear();
+  slice->survivors.clear();
 
-    if (plan.isRensaPlan()) {
-      if (th->skipRensaPlan(result))
-        return;
+  std::vector<Decision> decisions(1);
+  for (int i = 0; i < static_cast<int>(slice->candidates.size()); ++i) {
+    const BeamCandidate& c = slice->candidates[i];
+    if (dedup.minKey(c.hash) != c.key)
+      continue;
 
-      SearchState next = th->generateNextRensaState(field, from, state, plan);
-      states.push_back(next);
+    decisions[0] = c.decision;
+    RefPlan plan(c.field, decisions, c.rensa_result, c.num_chigiri,
+                 c.frames_to_ignite, c.last_drop_frames, 0, 0, 0, 0, false);
+    const SearchState& state = states[c.from];
 
-      return;
+    if (plan.isRensaPlan()) {
+      if (skipRensaPlan(c.rensa_result))
+        continue;
+
+      slice->states.push_back(generateNextRensaState(c.from, state, plan));
+      slice->survivors.push_back(i);
+      continue;
     }
 
     // Expected number of Ojama puyos to send in future.
@@ -311,15 +408,31 @@ void BeamSearchAI::generateNextStates(
       expect = std::max(expect, r.score);
     };
     bool prohibits[FieldConstant::MAP_WIDTH] {};
-    RensaDetector::detectByDropStrategy(field, prohibits,
+    RensaDetector::detectByDropStrategy(c.field, prohibits,
                                         PurposeForFindingRensa::FOR_FIRE, 2, 13,
                                         detect_callback);
 
-    SearchState next = th->generateNextNonRensaState(field, from, state, plan, expect);
-    states.push_back(next);
-  };
+    slice->states.push_back(generateNextNonRensaState(c.from, state, plan, expect));
+    slice->survivors.push_back(i);
+  }
+}
 
-  Plan::iterateAvailablePlans(state.field, {kumi}, 1, callback);
+void BeamSearchAI::runInParallel(int n, const std::function<void (int)>& f) const {
+  if (n == 1 || executor_->numThreads() <= 1) {
+    for (int i = 0; i < n; ++i)
+      f(i);
+    return;
+  }
+
+  WaitGroup wg;
+  wg.add(n);
+  for (int i = 0; i < n; ++i) {
+    executor_->submit([&f, &wg, i]() {
+      f(i);
+      wg.done();
+    });
+  }
+  wg.waitUntilDone();
 }
 
 }  // namespace sample
@@ -4,43 +4,71 @@
 // BeamSearchAI is a skelton AI to implement AIs using beam search algorithm.
 // This file also creates 2 different type AIs ineriting from BeamSearchAI.
 
+#include <array>
+#include <functional>
+#include <memory>
 #include <string>
-#include <unordered_set>
+#include <vector>
 
+#include "base/executor.h"
 #include "core/client/ai/ai.h"
+#include "core/decision.h"
 
 struct RensaResult;
 class RefPlan;
 
 namespace sample {
 
-struct SearchState;
+struct BeamSlice;
+class ConcurrentMinKeyTable;
+
+// The field of a state is kept only while the state is in the current beam.
+// The past states point their parents with |from|.
+struct SearchState {
+  Decision decision;
+  int from;
+  std::array<int, 3> features;
+  // Fill: [0: # of ojama, 1: expected score, 2: -frames]
+  // 2Dub: [0: # of 2dub, 1: # of ojama, 2: expected score]
+};
 
 // BeamSearchAI is a base AI to implement an AI with beam search algorithm.
 // It uses some virtual methods to change its behavior.
+// The beam is expanded in parallel with --num_threads threads. The result doesn't depend
+// on the number of threads.
 
 class BeamSearchAI : public AI {
   using uint64 = std::uint64_t;
   using int64 = std::int64_t;
  public:
-  BeamSearchAI(const std::string& name) : AI(name) {}
-  virtual ~BeamSearchAI() {}
+  BeamSearchAI(const std::string& name);
+  virtual ~BeamSearchAI();
 
   virtual DropDecision think(int frame_id, const CoreField& field, const KumipuyoSeq& seq,
                              const PlayerState&, const PlayerState&, bool fast) const;
 
  private:
+  friend class BeamSearchAITest;
+
   SearchState search(const CoreField& field, const KumipuyoSeq& vseq, int search_turns) const;
 
-  void generateNextStates(const SearchState& state, int from, const Kumipuyo& kumi,
-                          std::unordered_set<uint64>& visited,
-                          std::vector<SearchState>& states) const;
+  // Enumerates the next fields of fields[begin, end) into |slice|. The first one of the
+  // same fields (in the order of the parents) is recorded in |dedup|.
+  void expandSlice(const std::vector<CoreField>& fields, int begin, int end, const KumipuyoSeq& kumi,
+                   ConcurrentMinKeyTable* dedup, BeamSlice* slice) const;
+  // Makes the next states from the deduplicated candidates in |slice|.
+  void evaluateSlice(const std::vector<SearchState>& states, const ConcurrentMinKeyTable& dedup,
+                     BeamSlice* slice) const;
+  // Runs f(0), ..., f(n - 1) on the executor, and waits for them.
+  void runInParallel(int n, const std::function<void (int)>& f) const;
 
   // pure virtual methods to change the behavior.
   virtual bool skipRensaPlan(const RensaResult& result) const = 0;
-  virtual SearchState generateNextRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan) const = 0;
-  virtual SearchState generateNextNonRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan, int expect) const = 0;
+  virtual SearchState generateNextRensaState(int from, const SearchState& state, const RefPlan& plan) const = 0;
+  virtual SearchState generateNextNonRensaState(int from, const SearchState& state, const RefPlan& plan, int expect) const = 0;
   virtual bool shouldUpdateState(const SearchState& orig, const SearchState& res) const = 0;
+
+  std::unique_ptr<Executor> executor_;
 };
 
 // Type specified AIs ------------------------------------------------
@@ -53,8 +81,8 @@ public:
 
 private:
   bool skipRensaPlan(const RensaResult&) const override;
-  SearchState generateNextRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan) const override;
-  SearchState generateNextNonRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan, int expect) const override;
+  SearchState generateNextRensaState(int from, const SearchState& state, const RefPlan& plan) const override;
+  SearchState generateNextNonRensaState(int from, const SearchState& state, const RefPlan& plan, int expect) const override;
   bool shouldUpdateState(const SearchState& orig, const SearchState& res) const override;
 };
 
@@ -68,8 +96,8 @@ private:
                      const PlayerState&, const PlayerState&, bool) const override;
 
   bool skipRensaPlan(const RensaResult& result) const override;
-  SearchState generateNextRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan) const override;
-  SearchState generateNextNonRensaState(const CoreField& field, int from, const SearchState& state, const RefPlan& plan, int expect) const override;
+  SearchState generateNextRensaState(int from, const SearchState& state, const RefPlan& plan) const override;
+  SearchState generateNextNonRensaState(int from, const SearchState& state, const RefPlan& plan, int expect) const override;
   bool shouldUpdateState(const SearchState& orig, const SearchState& res) const override;
 };
 
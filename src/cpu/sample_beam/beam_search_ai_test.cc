@@ -0,0 +1,72 @@
+#include "cpu/sample_beam/beam_search_ai.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "core/core_field.h"
+#include "core/kumipuyo_seq.h"
+#include "core/kumipuyo_seq_generator.h"
+
+DECLARE_int32(beam_width);
+DECLARE_int32(num_threads);
+
+namespace sample {
+
+class BeamSearchAITest : public testing::Test {
+ protected:
+  void SetUp() override {
+    saved_beam_width_ = FLAGS_beam_width;
+    saved_num_threads_ = FLAGS_num_threads;
+    FLAGS_beam_width = 100;
+  }
+
+  void TearDown() override {
+    FLAGS_beam_width = saved_beam_width_;
+    FLAGS_num_threads = saved_num_threads_;
+  }
+
+  static SearchState search(const BeamSearchAI& ai, const CoreField& field,
+                            const KumipuyoSeq& seq, int search_turns) {
+    return ai.search(field, seq, search_turns);
+  }
+
+  // The search with 1 thread and with 4 threads should return the same state.
+  template<typename AIType>
+  void checkThreadIndependence() {
+    const CoreField field(
+        "R....."
+        "RB...."
+        "BBY.G."
+        "YYGGB.");
+    const int search_turns = 8;
+
+    FLAGS_num_threads = 1;
+    AIType ai1;
+    FLAGS_num_threads = 4;
+    AIType ai4;
+
+    for (int seed = 1; seed <= 3; ++seed) {
+      KumipuyoSeq seq = KumipuyoSeqGenerator::generateRandomSequenceWithSeed(search_turns, seed);
+      SearchState expected = search(ai1, field, seq, search_turns);
+      SearchState actual = search(ai4, field, seq, search_turns);
+
+      EXPECT_EQ(expected.decision, actual.decision) << "seed=" << seed;
+      EXPECT_EQ(expected.from, actual.from) << "seed=" << seed;
+      EXPECT_EQ(expected.features, actual.features) << "seed=" << seed;
+    }
+  }
+
+ private:
+  int saved_beam_width_;
+  int saved_num_threads_;
+};
+
+TEST_F(BeamSearchAITest, searchDoesNotDependOnThreads2Dub) {
+  checkThreadIndependence<Beam2DubAI>();
+}
+
+TEST_F(BeamSearchAITest, searchDoesNotDependOnThreadsFull) {
+  checkThreadIndependence<BeamFullAI>();
+}
+
+}  // namespace sample
@@ -0,0 +1,96 @@
+#ifndef CPU_SAMPLE_BEAM_CONCURRENT_MIN_KEY_TABLE_H_
+#define CPU_SAMPLE_BEAM_CONCURRENT_MIN_KEY_TABLE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "base/noncopyable.h"
+
+namespace sample {
+
+// ConcurrentMinKeyTable is a hash table from a field hash to the smallest key recorded
+// for it. Worker threads can record keys concurrently. After all the keys are recorded,
+// the candidate which has the smallest key for its field survives the deduplication.
+// Since the key is the order in the serial expansion, the survivor doesn't depend on
+// the thread timing.
+class ConcurrentMinKeyTable : noncopyable {
+ public:
+  ConcurrentMinKeyTable() {}
+
+  // Clears the table for |n| hashes at most.
+  void reset(size_t n) {
+    size_t capacity = 16;
+    int bits = 4;
+    while (capacity < n * 2) {
+      capacity *= 2;
+      ++bits;
+    }
+    if (capacity_ < capacity) {
+      hashes_.reset(new std::atomic<std::uint64_t>[capacity]);
+      keys_.reset(new std::atomic<std::uint64_t>[capacity]);
+      capacity_ = capacity;
+    }
+    mask_ = capacity - 1;
+    shift_ = 64 - bits;
+    for (size_t i = 0; i < capacity; ++i) {
+      hashes_[i].store(0, std::memory_order_relaxed);
+      keys_[i].store(NO_KEY, std::memory_order_relaxed);
+    }
+    zeroHashKey_.store(NO_KEY, std::memory_order_relaxed);
+  }
+
+  void recordMin(std::uint64_t hash, std::uint64_t key) {
+    std::atomic<std::uint64_t>& slot = hash == 0 ? zeroHashKey_ : keys_[findSlot(hash)];
+    std::uint64_t current = slot.load();
+    while (key < current && !slot.compare_exchange_weak(current, key)) {}
+  }
+
+  // Returns the max value of uint64_t if no key is recorded for |hash|.
+  std::uint64_t minKey(std::uint64_t hash) const {
+    if (hash == 0)
+      return zeroHashKey_.load();
+    for (size_t i = indexOf(hash); ; i = (i + 1) & mask_) {
+      std::uint64_t h = hashes_[i].load();
+      if (h == hash)
+        return keys_[i].load();
+      if (h == 0)
+        return NO_KEY;
+    }
+  }
+
+ private:
+  static const std::uint64_t NO_KEY = std::numeric_limits<std::uint64_t>::max();
+
+  // The low bits of CoreField::hash() are biased, so the hash is mixed here.
+  size_t indexOf(std::uint64_t hash) const {
+    return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+
+  size_t findSlot(std::uint64_t hash) {
+    for (size_t i = indexOf(hash); ; i = (i + 1) & mask_) {
+      std::uint64_t h = hashes_[i].load();
+      if (h == hash)
+        return i;
+      if (h == 0 && hashes_[i].compare_exchange_strong(h, hash))
+        return i;
+      // Another thread might have taken this slot for the same hash.
+      if (h == hash)
+        return i;
+    }
+  }
+
+  std::unique_ptr<std::atomic<std::uint64_t>[]> hashes_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> keys_;
+  // 0 is used as an empty slot marker, so the key for hash 0 is kept here.
+  std::atomic<std::uint64_t> zeroHashKey_ { NO_KEY };
+  size_t capacity_ = 0;
+  size_t mask_ = 0;
+  int shift_ = 60;
+};
+
+}  // namespace sample
+
+#endif  // CPU_SAMPLE_BEAM_CONCURRENT_MIN_KEY_TABLE_H_
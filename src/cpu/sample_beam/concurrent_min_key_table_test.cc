@@ -0,0 +1,107 @@
+#include "cpu/sample_beam/concurrent_min_key_table.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace sample {
+
+namespace {
+const uint64_t NO_KEY = numeric_limits<uint64_t>::max();
+}
+
+TEST(ConcurrentMinKeyTableTest, recordMin)
+{
+  ConcurrentMinKeyTable table;
+  table.reset(4);
+
+  EXPECT_EQ(NO_KEY, table.minKey(100));
+
+  table.recordMin(100, 5);
+  table.recordMin(100, 3);
+  table.recordMin(100, 7);
+  table.recordMin(200, 9);
+
+  EXPECT_EQ(3U, table.minKey(100));
+  EXPECT_EQ(9U, table.minKey(200));
+  EXPECT_EQ(NO_KEY, table.minKey(300));
+
+  // reset() forgets the recorded keys.
+  table.reset(4);
+  EXPECT_EQ(NO_KEY, table.minKey(100));
+}
+
+TEST(ConcurrentMinKeyTableTest, zeroHash)
+{
+  ConcurrentMinKeyTable table;
+  table.reset(4);
+
+  // 0 is the empty slot marker inside. It must not be confused with the other hashes.
+  table.recordMin(0, 10);
+  EXPECT_EQ(10U, table.minKey(0));
+  EXPECT_EQ(NO_KEY, table.minKey(1));
+
+  table.recordMin(1, 20);
+  table.recordMin(0, 15);
+  EXPECT_EQ(10U, table.minKey(0));
+  EXPECT_EQ(20U, table.minKey(1));
+
+  table.reset(4);
+  EXPECT_EQ(NO_KEY, table.minKey(0));
+}
+
+TEST(ConcurrentMinKeyTableTest, concurrentRecordMin)
+{
+  // 1000 hashes in 2048 slots, so a lot of them share the first probed slot.
+  // Hashes that differ only in the high bits are contained, too.
+  const int NUM_HASHES = 1000;
+  const int NUM_THREADS = 4;
+  const int NUM_KEYS_PER_THREAD = 50;
+
+  vector<uint64_t> hashes;
+  for (int i = 0; i < NUM_HASHES / 2; ++i) {
+    hashes.push_back(i);
+    hashes.push_back(static_cast<uint64_t>(i + 1) << 48);
+  }
+
+  // Each thread records its own keys for every hash in a different order.
+  auto key_of = [](int thread, int hash_index, int k) -> uint64_t {
+    return (static_cast<uint64_t>(k) * NUM_THREADS + thread) * 7919 + hash_index % 13;
+  };
+
+  ConcurrentMinKeyTable table;
+  for (int trial = 0; trial < 5; ++trial) {
+    table.reset(hashes.size());
+
+    vector<thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int k = NUM_KEYS_PER_THREAD - 1; k >= 0; --k) {
+          for (int i = 0; i < NUM_HASHES; ++i) {
+            int j = (t % 2 == 0) ? i : NUM_HASHES - 1 - i;
+            table.recordMin(hashes[j], key_of(t, j, k));
+          }
+        }
+      });
+    }
+    for (thread& th : threads)
+      th.join();
+
+    for (int i = 0; i < NUM_HASHES; ++i) {
+      uint64_t expected = NO_KEY;
+      for (int t = 0; t < NUM_THREADS; ++t) {
+        for (int k = 0; k < NUM_KEYS_PER_THREAD; ++k)
+          expected = std::min(expected, key_of(t, i, k));
+      }
+      EXPECT_EQ(expected, table.minKey(hashes[i])) << "hash=" << hashes[i];
+    }
+  }
+}
+
+}  // namespace sample
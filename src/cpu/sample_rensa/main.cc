@@ -1,11 +1,18 @@
+#include <algorithm>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include "base/base.h"
+#include "base/time.h"
 #include "core/plan/plan.h"
 #include "core/client/ai/ai.h"
 #include "core/core_field.h"
 #include "core/frame_request.h"
+#include "core/search/expectimax.h"
+
+DEFINE_bool(expectimax, false, "Search with Expectimax, which looks beyond the known kumipuyos.");
+DEFINE_int32(expectimax_depth, 4, "The depth of Expectimax. The depth beyond the known kumipuyos is averaged.");
 
 class SampleRensaAI : public AI {
 public:
@@ -18,10 +25,47 @@ public:
         UNUSED_VARIABLE(frameId);
         UNUSED_VARIABLE(me);
         UNUSED_VARIABLE(enemy);
+        if (FLAGS_expectimax)
+            return evalWithExpectimax(f, seq, fast ? 2 : FLAGS_expectimax_depth);
         return eval(f, seq, fast ? 2 : 3);
     }
 
 private:
+    // Expectimax memoizes by field, so this depends only on the field and the rensa result.
+    // The value is in [0, 1]: a rensa with 3 or more chains is in [0.5, 1], and the others are
+    // in [0, 0.5] by the heights like eval().
+    static double expectimaxValue(const RefPlan& plan)
+    {
+        if (plan.isRensaPlan() && plan.rensaResult().chains >= 3)
+            return 0.5 + 0.5 * std::min(plan.rensaResult().score, 70000) / 70000.0;
+
+        const CoreField& field = plan.field();
+        int penalty = field.height(2) * 5 + field.height(3) * 20 + field.height(4) * 10 + field.height(5) * 5;
+        return 0.5 - 0.5 * penalty / (13 * 40);
+    }
+
+    DropDecision evalWithExpectimax(const CoreField& f, const KumipuyoSeq& nexts, int depth) const
+    {
+        LOG(INFO) << f.toDebugString() << nexts.toString();
+
+        Expectimax::Config config;
+        config.depth = depth;
+        Expectimax expectimax(config, expectimaxValue);
+
+        long long beginTimeMs = currentTimeInMillis();
+        Expectimax::Result result = expectimax.search(f, nexts);
+        LOG(INFO) << "expectimax: depth=" << depth
+                  << " time=" << (currentTimeInMillis() - beginTimeMs) << "ms"
+                  << " value=" << result.value
+                  << " evaluations=" << result.numEvaluations
+                  << " cacheHits=" << result.numCacheHits
+                  << " cutoffs=" << result.numCutoffs;
+
+        if (!result.decision.isValid())
+            return DropDecision(Decision(3, 0));
+        return DropDecision(result.decision);
+    }
+
     DropDecision eval(const CoreField& f, const KumipuyoSeq& nexts, int depth) const
     {
         LOG(INFO) << f.toDebugString() << nexts.toString();
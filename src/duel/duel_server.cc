@@ -24,13 +24,18 @@ using namespace std;
 DEFINE_int32(num_duel, -1, "After num_duel times of duel, the server will stop. negative is infinity.");
 DEFINE_int32(num_win, -1, "After num_win times of 1p or 2p win, the server will stop. negative is infinity");
 DEFINE_bool(use_even, false, "the match gets even after 2 minutes.");
+DEFINE_int32(observer_buffer_size, 1024,
+             "the number of events buffered for each observer. A slower observer drops the oldest events.");
+DEFINE_string(field_engine, "plain",
+              "the engine to simulate the fields. 'plain' (PlainField) or 'bit' (BitField, faster for headless duels).");
 
 #ifdef USE_SDL2
 DECLARE_bool(use_gui);
 #endif
 
 struct DuelServer::DuelState {
-    explicit DuelState(const KumipuyoSeq& seq) : field { FieldRealtime(0, seq), FieldRealtime(1, seq) } {}
+    DuelState(const KumipuyoSeq& seq, FieldRealtime::Engine engine) :
+        field { FieldRealtime(0, seq, engine), FieldRealtime(1, seq, engine) } {}
 
     GameState toGameState() const
     {
@@ -60,6 +65,17 @@ struct DuelServer::DuelState {
     string message[2];
 };
 
+static FieldRealtime::Engine fieldEngine()
+{
+    if (FLAGS_field_engine == "plain")
+        return FieldRealtime::Engine::PLAIN_FIELD;
+    if (FLAGS_field_engine == "bit")
+        return FieldRealtime::Engine::BIT_FIELD;
+
+    CHECK(false) << "Unknown field engine: " << FLAGS_field_engine;
+    return FieldRealtime::Engine::PLAIN_FIELD;
+}
+
 /**
  * Updates decision when an applicable one is found.
  * Returns:
@@ -106,22 +122,25 @@ static int updateDecision(int frameId, const vector<FrameResponse>& data, const
 
 DuelServer::DuelServer(ConnectorManager* manager) :
     shouldStop_(false),
-    manager_(manager)
+    manager_(manager),
+    broadcaster_(FLAGS_observer_buffer_size)
 {
 }
 
 DuelServer::~DuelServer()
 {
+    join();
 }
 
 void DuelServer::addObserver(GameStateObserver* observer)
 {
     DCHECK(observer);
-    observers_.push_back(observer);
+    broadcaster_.addObserver(observer);
 }
 
 bool DuelServer::start()
 {
+    broadcaster_.start();
     th_ = thread([this](){
         this->runDuelLoop();
     });
@@ -131,14 +150,14 @@ bool DuelServer::start()
 void DuelServer::stop()
 {
     shouldStop_ = true;
-    if (th_.joinable())
-        th_.join();
+    join();
 }
 
 void DuelServer::join()
 {
     if (th_.joinable())
         th_.join();
+    broadcaster_.stop();
 }
 
 void DuelServer::runDuelLoop()
@@ -191,6 +210,13 @@ void DuelServer::runDuelLoop()
         num_match++;
     }
 
+    // Let the observers see the last game before exiting.
+    broadcaster_.waitUntilConsumed();
+    for (size_t i = 0; i < broadcaster_.numObservers(); ++i) {
+        GameStateBroadcaster::Stats stats = broadcaster_.stats(i);
+        LOG(INFO) << "observer " << i << ": consumed=" << stats.consumed << " dropped=" << stats.dropped;
+    }
+
     if (callbackDuelServerWillExit_) {
         callbackDuelServerWillExit_();
     }
@@ -198,14 +224,13 @@ void DuelServer::runDuelLoop()
 
 GameResult DuelServer::runGame(ConnectorManager* manager)
 {
-    for (auto observer : observers_)
-        observer->newGameWillStart();
+    broadcaster_.newGameWillStart();
 
     KumipuyoSeq kumipuyoSeq = KumipuyoSeqGenerator::generateACPuyo2Sequence();
 
     LOG(INFO) << "Puyo sequence=" << kumipuyoSeq.toString();
 
-    DuelState duelState(kumipuyoSeq);
+    DuelState duelState(kumipuyoSeq, fieldEngine());
 
     GameResult gameResult = GameResult::GAME_HAS_STOPPED;
     while (!shouldStop_) {
@@ -235,8 +260,7 @@ GameResult DuelServer::runGame(ConnectorManager* manager)
         // --- Play with input.
         play(&duelState, data);
         gameState = duelState.toGameState();
-        for (GameStateObserver* observer : observers_)
-            observer->onUpdate(gameState);
+        broadcaster_.onUpdate(gameState);
 
         // --- Check the result
         gameResult = gameState.gameResult();
@@ -263,8 +287,7 @@ GameResult DuelServer::runGame(ConnectorManager* manager)
         }
     }
 
-    for (auto observer : observers_)
-        observer->gameHasDone(gameResult);
+    broadcaster_.gameHasDone(gameResult);
 
     return gameResult;
 }
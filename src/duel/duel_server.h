@@ -1,12 +1,14 @@
 #ifndef DUEL_DUEL_SERVER_H_
 #define DUEL_DUEL_SERVER_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include "core/game_result.h"
+#include "core/server/game_state_broadcaster.h"
 
 class ConnectorManager;
 class GameStateObserver;
@@ -17,7 +19,8 @@ public:
     explicit DuelServer(ConnectorManager*);
     ~DuelServer();
 
-    // Doesn't take ownership.
+    // Doesn't take ownership. Observers are called on their own threads,
+    // so they should not assume they run on the duel server thread.
     void addObserver(GameStateObserver*);
 
     bool start();
@@ -43,7 +46,7 @@ private:
     volatile bool shouldStop_;
 
     ConnectorManager* manager_;
-    std::vector<GameStateObserver*> observers_;
+    GameStateBroadcaster broadcaster_;
     std::function<void ()> callbackDuelServerWillExit_;
 };
 
@@ -40,8 +40,9 @@ DEFINE_bool(delay_wnext, true, "Delay wnext appear");
 //  v
 // STATE_DEAD
 
-FieldRealtime::FieldRealtime(int playerId, const KumipuyoSeq& seq) :
-    playerId_(playerId)
+FieldRealtime::FieldRealtime(int playerId, const KumipuyoSeq& seq, Engine engine) :
+    playerId_(playerId),
+    engine_(engine)
 {
     // Since we don't use the first kumipuyo, we need to put EMPTY/EMPTY.
     vector<Kumipuyo> kps;
@@ -115,13 +116,13 @@ bool FieldRealtime::onStatePlayable(const KeySet& keySet, bool* accepted)
     *accepted = true;
 
     bool downAccepted = false;
-    kms_.moveKumipuyo(field_, keySet, &downAccepted);
+    kms_.moveKumipuyo(field(), keySet, &downAccepted);
     if (downAccepted)
         ++score_;
 
     if (kms_.grounded) {
-        field_.setColor(kms_.pos.axisX(), kms_.pos.axisY(), kumipuyoSeq_.axis(0));
-        field_.setColor(kms_.pos.childX(), kms_.pos.childY(), kumipuyoSeq_.child(0));
+        setFieldColor(kms_.pos.axisX(), kms_.pos.axisY(), kumipuyoSeq_.axis(0));
+        setFieldColor(kms_.pos.childX(), kms_.pos.childY(), kumipuyoSeq_.child(0));
         playable_ = false;
         userEvent_.grounded = true;
         dropFast_ = false;
@@ -162,8 +163,18 @@ bool FieldRealtime::onStateGrounding()
 bool FieldRealtime::onStateVanish(FrameContext* context)
 {
     // Don't vanish puyo here. Vanish it on onStateVanishing, to be consistent with wii_server.
-    PlainField field(field_);
-    int score = field.vanish(++current_chains_);
+    int score;
+    bool isZenkeshi;
+    if (engine_ == Engine::BIT_FIELD) {
+        BitField field(bitField_);
+        score = field.vanishWithoutDrop(++current_chains_);
+        isZenkeshi = field.isZenkeshi();
+    } else {
+        PlainField field(field_);
+        score = field.vanish(++current_chains_);
+        isZenkeshi = field.isZenkeshi();
+    }
+
     if (score == 0) {
         if (context)
             context->commitOjama();
@@ -189,7 +200,7 @@ bool FieldRealtime::onStateVanish(FrameContext* context)
     // After ojama is calculated, we add ZENKESHI score,
     // because score for ZENKESHI is added, but not used for ojama calculation.
     hasZenkeshi_ = false;
-    if (field.isZenkeshi()) {
+    if (isZenkeshi) {
         score_ += ZENKESHI_BONUS;
         hasZenkeshi_ = true;
     }
@@ -207,7 +218,13 @@ bool FieldRealtime::onStateVanish(FrameContext* context)
 
 bool FieldRealtime::onStateVanishing()
 {
-    int score = field_.vanish(current_chains_);
+    int score;
+    if (engine_ == Engine::BIT_FIELD) {
+        score = bitField_.vanishWithoutDrop(current_chains_);
+        field_ = bitField_.toPlainField();
+    } else {
+        score = field_.vanish(current_chains_);
+    }
     DCHECK_GT(score, 0);
     simulationState_ = SimulationState::STATE_DROPPING;
     return false;
@@ -238,8 +255,8 @@ bool FieldRealtime::onStateOjamaDropping()
     if (ojama_dropping_) {
         for (int i = 0; i < 6; i++) {
             if (ojama_position_[i] > 0) {
-                if (field_.color(i + 1, 13) == PuyoColor::EMPTY) {
-                    field_.setColor(i + 1, 13, PuyoColor::OJAMA);
+                if (fieldColor(i + 1, 13) == PuyoColor::EMPTY) {
+                    setFieldColor(i + 1, 13, PuyoColor::OJAMA);
                     ojama_position_[i]--;
                 }
             }
@@ -266,7 +283,7 @@ bool FieldRealtime::onStateOjamaGrounding()
         userEvent_.ojamaDropped = true;
     ojama_dropping_ = false;
 
-    if (field_.color(3, 12) != PuyoColor::EMPTY) {
+    if (fieldColor(3, 12) != PuyoColor::EMPTY) {
         simulationState_ = SimulationState::STATE_DEAD;
         return false;
     }
@@ -364,15 +381,22 @@ bool FieldRealtime::drop1Frame()
     // Puyo in 14th row will not drop to 13th row. If there is a puyo on
     // 14th row, it'll stay there forever. This behavior is a famous bug in
     // Puyo2.
-    for (int x = 1; x <= FieldConstant::WIDTH; x++) {
-        for (int y = 1; y < 13; y++) {
-            if (field_.color(x, y) != PuyoColor::EMPTY)
-                continue;
-
-            if (field_.color(x, y + 1) != PuyoColor::EMPTY) {
-                stillDropping = true;
-                field_.setColor(x, y, field_.color(x, y + 1));
-                field_.setColor(x, y + 1, PuyoColor::EMPTY);
+    if (engine_ == Engine::BIT_FIELD) {
+        // Every puyo in the air drops by one row, which is the same as the loop below.
+        stillDropping = bitField_.dropFloatingPuyosOneRow();
+        if (stillDropping)
+            field_ = bitField_.toPlainField();
+    } else {
+        for (int x = 1; x <= FieldConstant::WIDTH; x++) {
+            for (int y = 1; y < 13; y++) {
+                if (field_.color(x, y) != PuyoColor::EMPTY)
+                    continue;
+
+                if (field_.color(x, y + 1) != PuyoColor::EMPTY) {
+                    stillDropping = true;
+                    field_.setColor(x, y, field_.color(x, y + 1));
+                    field_.setColor(x, y + 1, PuyoColor::EMPTY);
+                }
             }
         }
     }
@@ -389,6 +413,27 @@ bool FieldRealtime::drop1Frame()
     return stillDropping;
 }
 
+void FieldRealtime::forceSetField(const PlainField& pf)
+{
+    field_ = pf;
+    if (engine_ == Engine::BIT_FIELD)
+        bitField_ = BitField(pf);
+}
+
+PuyoColor FieldRealtime::fieldColor(int x, int y) const
+{
+    if (engine_ == Engine::BIT_FIELD)
+        return bitField_.color(x, y);
+    return field_.color(x, y);
+}
+
+void FieldRealtime::setFieldColor(int x, int y, PuyoColor c)
+{
+    if (engine_ == Engine::BIT_FIELD)
+        bitField_.setColor(x, y, c);
+    field_.setColor(x, y, c);
+}
+
 int FieldRealtime::reduceOjama(int n)
 {
     if (numPendingOjama_ >= n) {
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "core/bit_field.h"
 #include "core/decision.h"
 #include "core/key_set_seq.h"
 #include "core/kumipuyo_moving_state.h"
@@ -29,9 +30,18 @@ public:
         STATE_DEAD,
     };
 
-    FieldRealtime(int playerId, const KumipuyoSeq&);
+    // The field representation the simulation runs on. PLAIN_FIELD moves the puyos in the air
+    // cell by cell on PlainField. BIT_FIELD keeps the field in BitField, and drops all the puyos
+    // in the air at once with bit operations. Both give the same result frame by frame.
+    enum class Engine {
+        PLAIN_FIELD,
+        BIT_FIELD,
+    };
+
+    FieldRealtime(int playerId, const KumipuyoSeq&, Engine = Engine::PLAIN_FIELD);
 
     int playerId() const { return playerId_; }
+    Engine engine() const { return engine_; }
 
     bool isDead() const { return simulationState_ == SimulationState::STATE_DEAD; }
     bool userPlayable() const { return simulationState_ == SimulationState::STATE_PLAYABLE; }
@@ -80,7 +90,7 @@ public:
     void skipPreparingNext();
     SimulationState simulationState() const { return simulationState_; }
     bool isSleeping() const { return sleepFor_ > 0; }
-    void forceSetField(const PlainField& pf) { field_ = pf; }
+    void forceSetField(const PlainField&);
 
 private:
     void init();
@@ -88,6 +98,9 @@ private:
     // Returns true if we need to drop more.
     bool drop1Frame();
 
+    PuyoColor fieldColor(int x, int y) const;
+    void setFieldColor(int x, int y, PuyoColor);
+
     void transitToStatePreparingNext();
 
     bool onStateLevelSelect();
@@ -102,11 +115,16 @@ private:
     bool onStateDead();
 
     int playerId_;
+    Engine engine_;
 
     SimulationState simulationState_ = SimulationState::STATE_LEVEL_SELECT;
     int sleepFor_ = 0;
 
-    PlainField field_; // Since there will be puyos in the air, CoreField cannot be used.
+    // Since there will be puyos in the air, CoreField cannot be used.
+    // When the engine is BIT_FIELD, |bitField_| is the field, and |field_| is rebuilt from it
+    // whenever it changes, so that field() is a plain const read.
+    PlainField field_;
+    BitField bitField_;
     KumipuyoSeq kumipuyoSeq_;
     UserEvent userEvent_;
     bool playable_;
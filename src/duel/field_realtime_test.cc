@@ -361,3 +361,84 @@ TEST_F(FieldRealtimeTest, Move4)
 
     EXPECT_EQ(expected, f_->field());
 }
+
+// Plays the same key inputs on both the engines, and checks they are the same frame by frame.
+// After |decisions| are used up, puyos are just dropped until the player dies.
+static void expectSameFrameByFrame(const PlainField& pf, const vector<Decision>& decisions, int numOjama)
+{
+    const string sequence = "RRBBYYGGRBYGRRBBYYGGRBYGRRBBYYGG";
+    FieldRealtime plain(0, sequence, FieldRealtime::Engine::PLAIN_FIELD);
+    FieldRealtime bit(0, sequence, FieldRealtime::Engine::BIT_FIELD);
+
+    for (FieldRealtime* f : { &plain, &bit }) {
+        f->forceSetField(pf);
+        f->addPendingOjama(numOjama);
+        f->commitOjama();
+        f->skipLevelSelect();
+    }
+
+    size_t decisionIndex = 0;
+    bool hasKeySetSeq = false;
+    int frame = 0;
+    for (; frame < 3000 && !plain.isDead(); ++frame) {
+        if (!plain.userPlayable()) {
+            hasKeySetSeq = false;
+        } else if (!hasKeySetSeq && decisionIndex < decisions.size()) {
+            CoreField cf(CoreField::fromPlainFieldWithDrop(plain.field()));
+            KeySetSeq kss = PuyoController::findKeyStrokeFrom(cf, plain.kumipuyoMovingState(), decisions[decisionIndex++]);
+            plain.setKeySetSeq(kss);
+            bit.setKeySetSeq(kss);
+            hasKeySetSeq = true;
+        }
+
+        KeySet keySet = plain.frontKeySet();
+        plain.dropFrontKeySet();
+        bit.dropFrontKeySet();
+
+        FrameContext plainContext;
+        FrameContext bitContext;
+        bool plainAccepted = plain.playOneFrame(keySet, &plainContext);
+        bool bitAccepted = bit.playOneFrame(keySet, &bitContext);
+
+        ASSERT_EQ(plain.field(), bit.field()) << "frame=" << frame;
+        ASSERT_EQ(plain.simulationState(), bit.simulationState()) << "frame=" << frame;
+        EXPECT_EQ(plainAccepted, bitAccepted) << "frame=" << frame;
+        EXPECT_EQ(plain.score(), bit.score()) << "frame=" << frame;
+        EXPECT_EQ(plain.hasZenkeshi(), bit.hasZenkeshi()) << "frame=" << frame;
+        EXPECT_EQ(plain.ojama(), bit.ojama()) << "frame=" << frame;
+        EXPECT_EQ(plainContext.numSentOjama(), bitContext.numSentOjama()) << "frame=" << frame;
+        EXPECT_EQ(plain.userEvent().toString(), bit.userEvent().toString()) << "frame=" << frame;
+    }
+
+    EXPECT_EQ(decisions.size(), decisionIndex);
+    EXPECT_TRUE(plain.isDead());
+    EXPECT_TRUE(bit.isDead());
+}
+
+TEST(FieldRealtimeEngineTest, rensa)
+{
+    PlainField pf(
+        " B    " // 4
+        "BY    "
+        "BR    "
+        "BRR   ");
+    // Puyos on the 13th row drop, but the ones on the 14th row don't.
+    pf.setColor(5, 13, PuyoColor::OJAMA);
+    pf.setColor(4, 14, PuyoColor::RED);
+
+    expectSameFrameByFrame(pf, vector<Decision> { Decision(3, 0), Decision(6, 2), Decision(5, 1) }, 0);
+}
+
+TEST(FieldRealtimeEngineTest, zenkeshi)
+{
+    expectSameFrameByFrame(PlainField("  RR  "), vector<Decision> { Decision(3, 0) }, 0);
+}
+
+TEST(FieldRealtimeEngineTest, ojama)
+{
+    // 30 ojama puyos drop 5 rows on every column, so the result doesn't depend on rand().
+    PlainField pf(
+        "Y     "
+        "YB  G ");
+    expectSameFrameByFrame(pf, vector<Decision> { Decision(1, 0), Decision(4, 1) }, 30);
+}
@@ -25,6 +25,8 @@
 #include "duel/puyofu_recorder.h"
 
 #ifdef USE_HTTPD
+#include <json/json.h>
+#include "net/httpd/http_event_stream.h"
 #include "net/httpd/http_handler.h"
 #include "net/httpd/http_server.h"
 #endif
@@ -68,31 +70,59 @@ DEFINE_bool(use_cui, true, "use CUI version drawer");
 DEFINE_bool(use_audio, false, "use audio commentator");
 #endif
 
+#if USE_HTTPD
+// GameStateHandler serializes each GameState once, and serves it to the viewers.
+// "/data" returns the latest state, and "/stream" pushes a snapshot followed by
+// deltas, which contain only the changed members.
 class GameStateHandler : public GameStateObserver {
 public:
     GameStateHandler() {}
     virtual ~GameStateHandler() {}
 
-#if USE_HTTPD
     void handle(const HttpRequest& req, HttpResponse* resp) {
         UNUSED_VARIABLE(req);
 
-        lock_guard<mutex> lock(mu_);
-        if (!gameState_)
+        shared_ptr<const string> json;
+        {
+            lock_guard<mutex> lock(mu_);
+            json = json_;
+        }
+        if (!json)
             return;
-        resp->setContent(gameState_->toJson());
+        resp->setContent(*json);
     }
-#endif
+
+    HttpEventStream* eventStream() { return &eventStream_; }
 
     virtual void onUpdate(const GameState& gameState) override {
+        Json::Value root;
+        gameState.toJsonValue(&root);
+
+        Json::Value delta(Json::objectValue);
+        const Json::Value& lastRoot = lastRoot_;
+        for (const auto& name : root.getMemberNames()) {
+            if (lastRoot[name] != root[name])
+                delta[name] = root[name];
+        }
+        lastRoot_ = root;
+
+        Json::FastWriter writer;
+        shared_ptr<const string> json = make_shared<const string>(writer.write(root));
+        eventStream_.publish(*json, writer.write(delta));
+
         lock_guard<mutex> lock(mu_);
-        gameState_.reset(new GameState(gameState));
+        json_ = move(json);
     }
 
 private:
     mutex mu_;
-    unique_ptr<GameState> gameState_;
+    shared_ptr<const string> json_;
+
+    // Only touched from onUpdate().
+    Json::Value lastRoot_;
+    HttpEventStream eventStream_;
 };
+#endif
 
 #if !defined(_MSC_VER)
 static void ignoreSIGPIPE()
@@ -147,6 +177,7 @@ int main(int argc, char* argv[])
         httpServer->installHandler("/data", [&](const HttpRequest& req, HttpResponse* res){
             gameStateHandler->handle(req, res);
         });
+        httpServer->installEventStreamHandler("/stream", gameStateHandler->eventStream());
         httpServer->setAssetDirectory(file::joinPath(FLAGS_data_dir, "assets"));
     }
 #endif
@@ -11,10 +11,24 @@
 #include <sstream>
 #include <string>
 
+#include "base/avx.h"
+#include "base/executor.h"
 #include "base/file/file.h"
+#include "base/wait_group.h"
 
 namespace {
 
+// The number of samples that are computed together in the batched computation.
+// The intermediate values of these samples should fit in L2 cache.
+const int SAMPLE_BLOCK_SIZE = 64;
+// The number of samples that are multiplied with a panel at once.
+const int MICRO_BLOCK_SIZE = 4;
+// A mini-batch is not split into chunks smaller than this.
+const int MIN_SAMPLES_PER_CHUNK = 32;
+// A mini-batch is split into at most this number of chunks. The chunks don't depend on
+// the executor, so that the result doesn't depend on it either.
+const int MAX_CHUNKS = 8;
+
 inline float activator(float x)
 {
     return std::tanh(x);
@@ -25,10 +39,112 @@ inline float d_activator(float x)
     return 1 / std::cosh(x) / std::cosh(x);
 }
 
+template<typename T>
+inline float toFloat(T w) { return static_cast<float>(w); }
+
+// Computes out[s] = x[s] * W for NUM_SAMPLES samples and a panel of 8 columns.
+// |x| is the rows of the samples (|stride| floats each), and |w| is a panel, whose
+// |num_in| rows have 8 weights each.
+#if defined(__AVX2__) && defined(__FMA__)
+
+inline __m256 loadPanelRow(const float* w)
+{
+    return _mm256_loadu_ps(w);
+}
+
+inline __m256 loadPanelRow(const std::int8_t* w)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(w))));
+}
+
+template<int NUM_SAMPLES, typename T>
+void multiplyPanel(const float x[], int stride, int num_in, const T w[], float out[][8])
+{
+    __m256 acc[NUM_SAMPLES];
+    for (int s = 0; s < NUM_SAMPLES; ++s)
+        acc[s] = _mm256_setzero_ps();
+
+    for (int r = 0; r < num_in; ++r) {
+        const __m256 row = loadPanelRow(w + r * 8);
+        for (int s = 0; s < NUM_SAMPLES; ++s)
+            acc[s] = _mm256_fmadd_ps(_mm256_set1_ps(x[s * stride + r]), row, acc[s]);
+    }
+
+    for (int s = 0; s < NUM_SAMPLES; ++s)
+        _mm256_storeu_ps(out[s], acc[s]);
+}
+
+#else
+
+template<int NUM_SAMPLES, typename T>
+void multiplyPanel(const float x[], int stride, int num_in, const T w[], float out[][8])
+{
+    for (int s = 0; s < NUM_SAMPLES; ++s)
+        std::fill(out[s], out[s] + 8, 0.0f);
+
+    for (int r = 0; r < num_in; ++r) {
+        const T* row = w + r * 8;
+        for (int s = 0; s < NUM_SAMPLES; ++s) {
+            const float v = x[s * stride + r];
+            for (int c = 0; c < 8; ++c)
+                out[s][c] += v * toFloat(row[c]);
+        }
+    }
+}
+
+#endif
+
+// Computes y = x * W + bias with a packed layer, whose panels have |num_in| + 1 rows.
+// When |scales| is specified, the columns are multiplied with them.
+template<typename T>
+void multiplyPackedLayer(const float x[], int num_samples, int num_in, int num_out, int num_panels,
+                         const T w[], const float scales[], float y[])
+{
+    const int panel_size = (num_in + 1) * 8;
+    float out[MICRO_BLOCK_SIZE][8];
+
+    for (int begin = 0; begin < num_samples; begin += SAMPLE_BLOCK_SIZE) {
+        const int end = std::min(num_samples, begin + SAMPLE_BLOCK_SIZE);
+        for (int p = 0; p < num_panels; ++p) {
+            const T* panel = w + p * panel_size;
+            const T* bias = panel + num_in * 8;
+            const int num_columns = std::min(8, num_out - p * 8);
+            for (int s = begin; s < end; s += MICRO_BLOCK_SIZE) {
+                const int n = std::min(MICRO_BLOCK_SIZE, end - s);
+                const float* xs = x + s * num_in;
+                switch (n) {
+                case 4: multiplyPanel<4>(xs, num_in, num_in, panel, out); break;
+                case 3: multiplyPanel<3>(xs, num_in, num_in, panel, out); break;
+                case 2: multiplyPanel<2>(xs, num_in, num_in, panel, out); break;
+                default: multiplyPanel<1>(xs, num_in, num_in, panel, out); break;
+                }
+
+                for (int i = 0; i < n; ++i) {
+                    float* ys = y + (s + i) * num_out + p * 8;
+                    for (int c = 0; c < num_columns; ++c) {
+                        float v = out[i][c] + toFloat(bias[c]);
+                        if (scales)
+                            v *= scales[p * 8 + c];
+                        ys[c] = v;
+                    }
+                }
+            }
+        }
+    }
+}
+
 } // namespace
 
 namespace learning {
 
+struct MultiLayerPerceptron::BatchGradient {
+    BatchGradient(int w2_size, int w3_size) : gw2(w2_size), gw3(w3_size) {}
+
+    std::vector<float> gw2;
+    std::vector<float> gw3;
+    int num_correct = 0;
+};
+
 MultiLayerPerceptron::MultiLayerPerceptron(int in, int hid, int out) :
     num_input_(in),
     num_hidden_(hid),
@@ -136,9 +252,142 @@ bool MultiLayerPerceptron::train(int correct_label,
         }
     }
 
+    invalidatePacked();
     return correct_label == predicted_label;
 }
 
+int MultiLayerPerceptron::trainMiniBatch(const int correct_labels[],
+                                         const float x[],
+                                         int num_samples,
+                                         float learning_rate,
+                                         float l2_normalization,
+                                         Executor* executor)
+{
+    if (num_samples <= 0)
+        return 0;
+
+    // Each chunk accumulates its own gradients, which are summed up in the order of the chunks.
+    const int num_chunks = std::min(MAX_CHUNKS, (num_samples + MIN_SAMPLES_PER_CHUNK - 1) / MIN_SAMPLES_PER_CHUNK);
+    const int chunk_size = (num_samples + num_chunks - 1) / num_chunks;
+
+    // Packs the weights here, so that the chunks don't wait for the others.
+    packIfDirty();
+
+    std::vector<BatchGradient> gradients(num_chunks, BatchGradient(hidden_layer_weight_size(), output_layer_weight_size()));
+    auto accumulate = [&](int chunk) {
+        const int begin = chunk * chunk_size;
+        const int n = std::min(num_samples, begin + chunk_size) - begin;
+        if (n > 0)
+            accumulateGradient(correct_labels + begin, x + begin * num_input_, n, &gradients[chunk]);
+    };
+
+    if (executor) {
+        WaitGroup wg;
+        wg.add(num_chunks - 1);
+        for (int chunk = 1; chunk < num_chunks; ++chunk) {
+            executor->submit([&, chunk]() {
+                accumulate(chunk);
+                wg.done();
+            });
+        }
+        accumulate(0);
+        wg.waitUntilDone();
+    } else {
+        for (int chunk = 0; chunk < num_chunks; ++chunk)
+            accumulate(chunk);
+    }
+
+    BatchGradient& gradient = gradients[0];
+    for (int chunk = 1; chunk < num_chunks; ++chunk) {
+        for (int i = 0; i < hidden_layer_weight_size(); ++i)
+            gradient.gw2[i] += gradients[chunk].gw2[i];
+        for (int i = 0; i < output_layer_weight_size(); ++i)
+            gradient.gw3[i] += gradients[chunk].gw3[i];
+        gradient.num_correct += gradients[chunk].num_correct;
+    }
+
+    const float rate = learning_rate / num_samples;
+    for (int i = 0; i < hidden_layer_weight_size(); ++i)
+        w2_[i] -= rate * gradient.gw2[i];
+    for (int i = 0; i < output_layer_weight_size(); ++i)
+        w3_[i] -= rate * gradient.gw3[i];
+
+    // normalization
+    if (l2_normalization != 0.0) {
+        for (int i = 0; i < hidden_layer_weight_size(); ++i) {
+            w2_[i] -= learning_rate * l2_normalization * w2_[i];
+        }
+        for (int i = 0; i < output_layer_weight_size(); ++i) {
+            w3_[i] -= learning_rate * l2_normalization * w3_[i];
+        }
+    }
+
+    invalidatePacked();
+    return gradient.num_correct;
+}
+
+void MultiLayerPerceptron::accumulateGradient(const int correct_labels[],
+                                              const float x[],
+                                              int num_samples,
+                                              BatchGradient* gradient) const
+{
+    std::vector<float> i2(SAMPLE_BLOCK_SIZE * num_hidden_);
+    std::vector<float> o2(SAMPLE_BLOCK_SIZE * num_hidden_);
+    std::vector<float> i3(SAMPLE_BLOCK_SIZE * num_output_);
+    std::vector<float> e2(num_hidden_);
+    std::vector<float> e3(num_output_);
+
+    float* gw2 = gradient->gw2.data();
+    float* gw3 = gradient->gw3.data();
+
+    for (int begin = 0; begin < num_samples; begin += SAMPLE_BLOCK_SIZE) {
+        const int n = std::min(SAMPLE_BLOCK_SIZE, num_samples - begin);
+        const float* xs = x + begin * num_input_;
+        forwardBatchInternal(xs, n, i2.data(), o2.data(), i3.data(), Precision::FLOAT32);
+
+        for (int s = 0; s < n; ++s) {
+            const int correct_label = correct_labels[begin + s];
+            const float* x_s = xs + s * num_input_;
+            const float* i2_s = i2.data() + s * num_hidden_;
+            const float* o2_s = o2.data() + s * num_hidden_;
+            const float* i3_s = i3.data() + s * num_output_;
+
+            if (std::max_element(i3_s, i3_s + num_output_) - i3_s == correct_label)
+                ++gradient->num_correct;
+
+            for (int i = 0; i < num_output_; ++i)
+                e3[i] = (correct_label == i) ? i3_s[i] - 1 : i3_s[i];
+
+            for (int i = 0; i < num_hidden_; ++i) {
+                float t = 0;
+                for (int j = 0; j < num_output_; ++j) {
+                    t += w3_[i * num_output_ + j] * e3[j];
+                }
+                e2[i] = t * d_activator(i2_s[i]);
+            }
+
+            for (int i = 0; i < num_hidden_; ++i) {
+                float* g = gw3 + i * num_output_;
+                for (int j = 0; j < num_output_; ++j)
+                    g[j] += o2_s[i] * e3[j];
+            }
+            for (int j = 0; j < num_output_; ++j)
+                gw3[num_hidden_ * num_output_ + j] += e3[j];
+
+            // The input is often sparse, so zero rows are skipped.
+            for (int i = 0; i < num_input_; ++i) {
+                if (x_s[i] == 0)
+                    continue;
+                float* g = gw2 + i * num_hidden_;
+                for (int j = 0; j < num_hidden_; ++j)
+                    g[j] += x_s[i] * e2[j];
+            }
+            for (int j = 0; j < num_hidden_; ++j)
+                gw2[num_input_ * num_hidden_ + j] += e2[j];
+        }
+    }
+}
+
 void MultiLayerPerceptron::forward(const float x[], ForwardingIntermediateStorage* data) const
 {
     for (int i = 0; i < num_input_; ++i) {
@@ -166,14 +415,114 @@ void MultiLayerPerceptron::forward(const float x[], ForwardingIntermediateStorag
     }
 }
 
+void MultiLayerPerceptron::forwardBatch(const float x[], int num_samples, float y[], Precision precision) const
+{
+    std::vector<float> i2(SAMPLE_BLOCK_SIZE * num_hidden_);
+    std::vector<float> o2(SAMPLE_BLOCK_SIZE * num_hidden_);
+
+    for (int begin = 0; begin < num_samples; begin += SAMPLE_BLOCK_SIZE) {
+        const int n = std::min(SAMPLE_BLOCK_SIZE, num_samples - begin);
+        forwardBatchInternal(x + begin * num_input_, n, i2.data(), o2.data(), y + begin * num_output_, precision);
+    }
+}
+
+void MultiLayerPerceptron::predictBatch(const float x[], int num_samples, int labels[], Precision precision) const
+{
+    std::vector<float> y(num_samples * num_output_);
+    forwardBatch(x, num_samples, y.data(), precision);
+
+    for (int s = 0; s < num_samples; ++s) {
+        const float* ys = y.data() + s * num_output_;
+        labels[s] = std::max_element(ys, ys + num_output_) - ys;
+    }
+}
+
+void MultiLayerPerceptron::forwardBatchInternal(const float x[], int num_samples,
+                                                float i2[], float o2[], float i3[],
+                                                Precision precision) const
+{
+    packedHiddenLayer().multiply(x, num_samples, i2, precision);
+    for (int i = 0; i < num_samples * num_hidden_; ++i) {
+        o2[i] = activator(i2[i]);
+    }
+    packedOutputLayer().multiply(o2, num_samples, i3, precision);
+}
+
+const MultiLayerPerceptron::PackedLayer& MultiLayerPerceptron::packedHiddenLayer() const
+{
+    packIfDirty();
+    return packed_w2_;
+}
+
+const MultiLayerPerceptron::PackedLayer& MultiLayerPerceptron::packedOutputLayer() const
+{
+    packIfDirty();
+    return packed_w3_;
+}
+
+void MultiLayerPerceptron::packIfDirty() const
+{
+    packedRebuild_.rebuildIfNeeded([this]() {
+        packed_w2_.pack(w2_.get(), num_input_, num_hidden_);
+        packed_w3_.pack(w3_.get(), num_hidden_, num_output_);
+    });
+}
+
+void MultiLayerPerceptron::PackedLayer::pack(const float w[], int in, int out)
+{
+    num_in = in;
+    num_out = out;
+    num_panels = (out + PANEL_WIDTH - 1) / PANEL_WIDTH;
+
+    const int panel_size = (in + 1) * PANEL_WIDTH;
+    weights.assign(num_panels * panel_size, 0.0f);
+    quantized_weights.assign(num_panels * panel_size, 0);
+    scales.assign(num_panels * PANEL_WIDTH, 0.0f);
+
+    for (int r = 0; r < in + 1; ++r) {
+        for (int j = 0; j < out; ++j) {
+            weights[(j / PANEL_WIDTH) * panel_size + r * PANEL_WIDTH + j % PANEL_WIDTH] = w[r * out + j];
+        }
+    }
+
+    // Each column (including the bias) is quantized with its own scale.
+    for (int j = 0; j < out; ++j) {
+        float max_abs = 0;
+        for (int r = 0; r < in + 1; ++r)
+            max_abs = std::max(max_abs, std::abs(w[r * out + j]));
+        const float scale = max_abs > 0 ? max_abs / 127 : 1;
+        scales[j] = scale;
+        for (int r = 0; r < in + 1; ++r) {
+            const int q = static_cast<int>(std::round(w[r * out + j] / scale));
+            quantized_weights[(j / PANEL_WIDTH) * panel_size + r * PANEL_WIDTH + j % PANEL_WIDTH] =
+                static_cast<std::int8_t>(std::max(-127, std::min(127, q)));
+        }
+    }
+}
+
+void MultiLayerPerceptron::PackedLayer::multiply(const float x[], int num_samples, float y[], Precision precision) const
+{
+    static_assert(PANEL_WIDTH == 8, "the kernel assumes 8 columns");
+
+    if (precision == Precision::INT8) {
+        multiplyPackedLayer(x, num_samples, num_in, num_out, num_panels,
+                            quantized_weights.data(), scales.data(), y);
+    } else {
+        multiplyPackedLayer(x, num_samples, num_in, num_out, num_panels,
+                            weights.data(), static_cast<const float*>(nullptr), y);
+    }
+}
+
 void MultiLayerPerceptron::setHiddenLayerParameter(const float values[])
 {
-    memcpy(w2_.get(), values, hidden_layer_weight_size());
+    memcpy(w2_.get(), values, sizeof(float) * hidden_layer_weight_size());
+    invalidatePacked();
 }
 
 void MultiLayerPerceptron::setOutputLayerParameter(const float values[])
 {
-    memcpy(w3_.get(), values, output_layer_weight_size());
+    memcpy(w3_.get(), values, sizeof(float) * output_layer_weight_size());
+    invalidatePacked();
 }
 
 bool MultiLayerPerceptron::saveParameterAsCSource(const char* path, const char* prefix) const
@@ -1,14 +1,28 @@
 #ifndef LEARNING_MULTILAYER_PERCEPTRON_H_
 #define LEARNING_MULTILAYER_PERCEPTRON_H_
 
+#include <cstdint>
 #include <memory>
+#include <vector>
+
+#include "base/lazy_rebuild.h"
+
+class Executor;
 
 namespace learning {
 
 // Defines a 3-layer perceptron.
-// This is not thread-safe.
+// The const methods can be called from multiple threads, unless the parameter is being
+// modified (e.g. train()) at the same time.
 class MultiLayerPerceptron {
 public:
+    // The precision of the weights used in the batched inference. With INT8, the weights are
+    // quantized per output neuron. It's less accurate, but the weights are 4x smaller.
+    enum class Precision {
+        FLOAT32,
+        INT8,
+    };
+
     struct ForwardingIntermediateStorage {
         std::unique_ptr<float[]> o1; // input layer output (= input layer input)
         std::unique_ptr<float[]> i2; // hidden layer input
@@ -30,6 +44,13 @@ public:
     // |x| should have |num_input_| size.
     int predict(const float x[], ForwardingIntermediateStorage* data) const;
 
+    // Computes the output layer of |num_samples| samples at once.
+    // |x| should have |num_samples| * |num_input_| size (row-major), and
+    // |y| should have |num_samples| * |num_output_| size.
+    void forwardBatch(const float x[], int num_samples, float y[], Precision = Precision::FLOAT32) const;
+    // Sets the labels of |num_samples| samples to |labels|.
+    void predictBatch(const float x[], int num_samples, int labels[], Precision = Precision::FLOAT32) const;
+
     // Train single data.
     // |x| should have |num_input_| size.
     bool train(int correct_label,
@@ -39,23 +60,77 @@ public:
                float learning_rate = 0.1,
                float l2_normalization = 0.001);
 
+    // Train a mini-batch with the mean of the gradients of the samples.
+    // |x| should have |num_samples| * |num_input_| size (row-major).
+    // The samples are split into chunks, and the gradients of the chunks are summed up in
+    // a fixed order. When |executor| is specified, the chunks run on the threads. The result
+    // is the same with or without |executor|.
+    // This waits for the chunks submitted to |executor|. So don't call this from a task of
+    // |executor|: when all of its threads are waiting like this (e.g. with a single thread),
+    // the chunks never run.
+    // Returns the number of the samples which were predicted correctly before training.
+    int trainMiniBatch(const int correct_labels[],
+                       const float x[],
+                       int num_samples,
+                       float learning_rate = 0.1,
+                       float l2_normalization = 0.001,
+                       Executor* executor = nullptr);
+
     void setHiddenLayerParameter(const float values[]);
     void setOutputLayerParameter(const float values[]);
 
     bool saveParameterAsCSource(const char* path, const char* prefix) const;
 
 private:
+    // The weights of a layer for the batched computation. The output neurons are split into
+    // panels of PANEL_WIDTH, and the weights of a panel are contiguous, so that a panel is
+    // streamed from the cache while it's multiplied with several samples.
+    struct PackedLayer {
+        static const int PANEL_WIDTH = 8;
+
+        void pack(const float w[], int num_in, int num_out);
+        // y = x * W + bias for |num_samples| samples.
+        void multiply(const float x[], int num_samples, float y[], Precision) const;
+
+        int num_in = 0;
+        int num_out = 0;
+        int num_panels = 0;
+        // [panel][row][PANEL_WIDTH]. The last row is the bias.
+        std::vector<float> weights;
+        std::vector<std::int8_t> quantized_weights;
+        // [panel * PANEL_WIDTH + column]
+        std::vector<float> scales;
+    };
+
+    // The intermediate values of a chunk of a mini-batch.
+    struct BatchGradient;
+
     int hidden_layer_weight_size() const;
     int output_layer_weight_size() const;
 
     void forward(const float x[], ForwardingIntermediateStorage* data) const;
 
+    // Computes the hidden layer input |i2| and the output layer |i3| for |num_samples| samples.
+    void forwardBatchInternal(const float x[], int num_samples, float i2[], float o2[], float i3[], Precision) const;
+    // Computes the gradients of |num_samples| samples, and adds them to |gradient|.
+    void accumulateGradient(const int correct_labels[], const float x[], int num_samples, BatchGradient* gradient) const;
+
+    // Returns the packed layers. They're packed again if the weights have been modified.
+    const PackedLayer& packedHiddenLayer() const;
+    const PackedLayer& packedOutputLayer() const;
+    void packIfDirty() const;
+    void invalidatePacked() { packedRebuild_.invalidate(); }
+
     const int num_input_;  // the number of input layer neuron.
     const int num_hidden_; // the number of hidden layer nueron.
     const int num_output_; // the number of output layer nueron.
 
     std::unique_ptr<float[]> w2_; // hidden layer weight
     std::unique_ptr<float[]> w3_; // output layer weight
+
+    mutable PackedLayer packed_w2_;
+    mutable PackedLayer packed_w3_;
+    mutable base::LazyRebuild packedRebuild_;
 };
 
 } // namespace learning
@@ -0,0 +1,203 @@
+#include "learning/multi_layer_perceptron.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "base/executor.h"
+
+using namespace std;
+using learning::MultiLayerPerceptron;
+
+namespace {
+
+const int NUM_INPUT = 37;
+const int NUM_HIDDEN = 13;
+// Not a multiple of the panel width (8).
+const int NUM_OUTPUT = 11;
+
+const float EPS = 1e-4;
+
+vector<float> makeRandomVector(int size, mt19937* rnd)
+{
+    uniform_real_distribution<float> distribution(-1.0, 1.0);
+    vector<float> v(size);
+    for (float& f : v)
+        f = distribution(*rnd);
+    return v;
+}
+
+// Makes a perceptron whose weights are generated from |seed|.
+void setRandomParameter(MultiLayerPerceptron* mlp, unsigned int seed)
+{
+    mt19937 rnd(seed);
+    vector<float> w2 = makeRandomVector((NUM_INPUT + 1) * NUM_HIDDEN, &rnd);
+    vector<float> w3 = makeRandomVector((NUM_HIDDEN + 1) * NUM_OUTPUT, &rnd);
+    mlp->setHiddenLayerParameter(w2.data());
+    mlp->setOutputLayerParameter(w3.data());
+}
+
+// Returns the output of forward() for each sample.
+vector<float> forwardOneByOne(const MultiLayerPerceptron& mlp, const vector<float>& x, int num_samples)
+{
+    MultiLayerPerceptron::ForwardingIntermediateStorage data = mlp.makeForwadingStorage();
+    vector<float> y(num_samples * NUM_OUTPUT);
+    for (int s = 0; s < num_samples; ++s) {
+        mlp.predict(x.data() + s * NUM_INPUT, &data);
+        copy(data.i3.get(), data.i3.get() + NUM_OUTPUT, y.begin() + s * NUM_OUTPUT);
+    }
+    return y;
+}
+
+} // anonymous namespace
+
+TEST(MultiLayerPerceptronTest, setParameter)
+{
+    MultiLayerPerceptron mlp(2, 2, 2);
+
+    // The last row of each layer is the bias.
+    const float w2[] = {
+        0.1, 0.2,
+        0.3, 0.4,
+        0.5, -0.6,
+    };
+    const float w3[] = {
+        0.7, -0.8,
+        0.9, 1.0,
+        -1.1, 1.2,
+    };
+    mlp.setHiddenLayerParameter(w2);
+    mlp.setOutputLayerParameter(w3);
+
+    const float x[] = { 1.0, -2.0 };
+    const float o2[] = {
+        tanh(1.0f * 0.1f - 2.0f * 0.3f + 0.5f),
+        tanh(1.0f * 0.2f - 2.0f * 0.4f - 0.6f),
+    };
+    const float expected[] = {
+        o2[0] * 0.7f + o2[1] * 0.9f - 1.1f,
+        o2[0] * -0.8f + o2[1] * 1.0f + 1.2f,
+    };
+
+    MultiLayerPerceptron::ForwardingIntermediateStorage data = mlp.makeForwadingStorage();
+    mlp.predict(x, &data);
+    EXPECT_NEAR(expected[0], data.i3[0], EPS);
+    EXPECT_NEAR(expected[1], data.i3[1], EPS);
+
+    float y[2];
+    mlp.forwardBatch(x, 1, y);
+    EXPECT_NEAR(expected[0], y[0], EPS);
+    EXPECT_NEAR(expected[1], y[1], EPS);
+}
+
+TEST(MultiLayerPerceptronTest, forwardBatch)
+{
+    MultiLayerPerceptron mlp(NUM_INPUT, NUM_HIDDEN, NUM_OUTPUT);
+    setRandomParameter(&mlp, 1);
+
+    mt19937 rnd(2);
+    // Includes the counts which are not multiples of the micro block (4) or the block (64).
+    for (int num_samples : { 1, 3, 6, 63, 65, 130 }) {
+        vector<float> x = makeRandomVector(num_samples * NUM_INPUT, &rnd);
+        vector<float> expected = forwardOneByOne(mlp, x, num_samples);
+
+        vector<float> y(num_samples * NUM_OUTPUT);
+        mlp.forwardBatch(x.data(), num_samples, y.data());
+        for (size_t i = 0; i < y.size(); ++i)
+            ASSERT_NEAR(expected[i], y[i], EPS) << "num_samples=" << num_samples << " i=" << i;
+
+        vector<int> labels(num_samples);
+        mlp.predictBatch(x.data(), num_samples, labels.data());
+        for (int s = 0; s < num_samples; ++s) {
+            const float* ys = y.data() + s * NUM_OUTPUT;
+            EXPECT_EQ(max_element(ys, ys + NUM_OUTPUT) - ys, labels[s]);
+        }
+    }
+}
+
+TEST(MultiLayerPerceptronTest, forwardBatchInt8)
+{
+    MultiLayerPerceptron mlp(NUM_INPUT, NUM_HIDDEN, NUM_OUTPUT);
+    setRandomParameter(&mlp, 3);
+
+    // With the weights and the inputs in [-1, 1], each quantized weight is off by at most
+    // 1/254, and the output is off by less than 0.1.
+    const float INT8_TOLERANCE = 0.1;
+
+    mt19937 rnd(4);
+    const int num_samples = 130;
+    vector<float> x = makeRandomVector(num_samples * NUM_INPUT, &rnd);
+    vector<float> expected = forwardOneByOne(mlp, x, num_samples);
+
+    vector<float> y(num_samples * NUM_OUTPUT);
+    mlp.forwardBatch(x.data(), num_samples, y.data(), MultiLayerPerceptron::Precision::INT8);
+    for (size_t i = 0; i < y.size(); ++i)
+        ASSERT_NEAR(expected[i], y[i], INT8_TOLERANCE) << "i=" << i;
+}
+
+TEST(MultiLayerPerceptronTest, trainMiniBatchWithOneSample)
+{
+    MultiLayerPerceptron expected(NUM_INPUT, NUM_HIDDEN, NUM_OUTPUT);
+    MultiLayerPerceptron actual(NUM_INPUT, NUM_HIDDEN, NUM_OUTPUT);
+    setRandomParameter(&expected, 5);
+    setRandomParameter(&actual, 5);
+
+    MultiLayerPerceptron::ForwardingIntermediateStorage data = expected.makeForwadingStorage();
+    MultiLayerPerceptron::BackPropagationIntermediateStorage error_data = expected.makeBackpropagationStorage();
+
+    mt19937 rnd(6);
+    for (int i = 0; i < 10; ++i) {
+        vector<float> x = makeRandomVector(NUM_INPUT, &rnd);
+        // Sparse inputs are handled specially in trainMiniBatch.
+        x[i] = 0;
+        const int label = i % NUM_OUTPUT;
+
+        bool correct = expected.train(label, x.data(), &data, &error_data, 0.1, 0.001);
+        int num_correct = actual.trainMiniBatch(&label, x.data(), 1, 0.1, 0.001);
+        EXPECT_EQ(correct ? 1 : 0, num_correct);
+    }
+
+    const int num_samples = 20;
+    vector<float> x = makeRandomVector(num_samples * NUM_INPUT, &rnd);
+    vector<float> expectedY = forwardOneByOne(expected, x, num_samples);
+    vector<float> actualY = forwardOneByOne(actual, x, num_samples);
+    for (size_t i = 0; i < expectedY.size(); ++i)
+        ASSERT_NEAR(expectedY[i], actualY[i], EPS) << "i=" << i;
+}
+
+TEST(MultiLayerPerceptronTest, trainMiniBatchWithExecutor)
+{
+    MultiLayerPerceptron expected(NUM_INPUT, NUM_HIDDEN, NUM_OUTPUT);
+    MultiLayerPerceptron actual(NUM_INPUT, NUM_HIDDEN, NUM_OUTPUT);
+    setRandomParameter(&expected, 7);
+    setRandomParameter(&actual, 7);
+
+    Executor executor(4);
+    executor.start();
+
+    mt19937 rnd(8);
+    // Split into several chunks, and the last chunk is smaller.
+    const int num_samples = 150;
+    for (int i = 0; i < 3; ++i) {
+        vector<float> x = makeRandomVector(num_samples * NUM_INPUT, &rnd);
+        vector<int> labels(num_samples);
+        for (int s = 0; s < num_samples; ++s)
+            labels[s] = s % NUM_OUTPUT;
+
+        int expectedCorrect = expected.trainMiniBatch(labels.data(), x.data(), num_samples, 0.1, 0.001);
+        int actualCorrect = actual.trainMiniBatch(labels.data(), x.data(), num_samples, 0.1, 0.001, &executor);
+        EXPECT_EQ(expectedCorrect, actualCorrect);
+    }
+    executor.stop();
+
+    // The gradients are summed up in the same order, so the results are exactly the same.
+    vector<float> x = makeRandomVector(num_samples * NUM_INPUT, &rnd);
+    vector<float> expectedY(num_samples * NUM_OUTPUT);
+    vector<float> actualY(num_samples * NUM_OUTPUT);
+    expected.forwardBatch(x.data(), num_samples, expectedY.data());
+    actual.forwardBatch(x.data(), num_samples, actualY.data());
+    EXPECT_EQ(expectedY, actualY);
+}
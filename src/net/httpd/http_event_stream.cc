@@ -0,0 +1,81 @@
+#include "net/httpd/http_event_stream.h"
+
+#include <sstream>
+
+#include <glog/logging.h>
+
+using namespace std;
+
+HttpEventStream::HttpEventStream(size_t capacity) :
+    capacity_(capacity)
+{
+    CHECK_GT(capacity, 0U);
+}
+
+void HttpEventStream::publish(const string& snapshot, const string& delta)
+{
+    // Serialize outside the lock. Subscribers only copy the pointers.
+    Message snapshotMessage = make_shared<const string>(formatMessage("snapshot", snapshot));
+    Message deltaMessage = make_shared<const string>(formatMessage("delta", delta));
+
+    {
+        lock_guard<mutex> lock(mu_);
+        snapshot_ = move(snapshotMessage);
+        deltas_.push_back(Entry { head_, move(deltaMessage) });
+        if (deltas_.size() > capacity_)
+            deltas_.pop_front();
+        ++head_;
+    }
+    condVar_.notify_all();
+}
+
+void HttpEventStream::close()
+{
+    {
+        lock_guard<mutex> lock(mu_);
+        closed_ = true;
+    }
+    condVar_.notify_all();
+}
+
+bool HttpEventStream::next(Subscription* subscription, chrono::milliseconds timeout, Message* message)
+{
+    unique_lock<mutex> lock(mu_);
+    bool ready = condVar_.wait_for(lock, timeout, [this, subscription]() {
+        return closed_ || (snapshot_ && (subscription->needsSnapshot_ || subscription->cursor_ < head_));
+    });
+
+    if (closed_)
+        return false;
+
+    if (!ready) {
+        *message = nullptr;
+        return true;
+    }
+
+    // The subscriber is new, or it has missed some deltas. Start over from the snapshot.
+    if (subscription->needsSnapshot_ || subscription->cursor_ < deltas_.front().seq) {
+        subscription->needsSnapshot_ = false;
+        subscription->cursor_ = head_;
+        *message = snapshot_;
+        return true;
+    }
+
+    *message = deltas_[subscription->cursor_ - deltas_.front().seq].delta;
+    ++subscription->cursor_;
+    return true;
+}
+
+// static
+string HttpEventStream::formatMessage(const string& eventName, const string& data)
+{
+    stringstream ss;
+    ss << "event: " << eventName << '\n';
+
+    istringstream is(data);
+    string line;
+    while (getline(is, line))
+        ss << "data: " << line << '\n';
+    ss << '\n';
+    return ss.str();
+}
@@ -0,0 +1,69 @@
+#ifndef NET_HTTPD_HTTP_EVENT_STREAM_H_
+#define NET_HTTPD_HTTP_EVENT_STREAM_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "base/base.h"
+
+// HttpEventStream fans out Server-Sent Events to many subscribers.
+//
+// Each published event is serialized once into an immutable buffer, and all the
+// subscribers share it. A publisher gives two forms of the state: a snapshot, which
+// is the whole state, and a delta from the previous event. A new subscriber starts
+// from the latest snapshot, then receives deltas. A subscriber that falls behind
+// more than |capacity| events is resynchronized with the latest snapshot.
+class HttpEventStream {
+public:
+    typedef std::shared_ptr<const std::string> Message;
+
+    class Subscription {
+    public:
+        Subscription() {}
+
+    private:
+        friend class HttpEventStream;
+        uint64_t cursor_ = 0;
+        bool needsSnapshot_ = true;
+    };
+
+    explicit HttpEventStream(size_t capacity = 256);
+
+    // Publishes a new event. |snapshot| and |delta| are the data of SSE messages.
+    void publish(const std::string& snapshot, const std::string& delta);
+
+    // Ends all the subscriptions. After close(), next() returns false.
+    void close();
+
+    // Waits for the next message for |subscription| up to |timeout|.
+    // Returns false when the stream is closed. When timed out, |*message| is set to nullptr.
+    bool next(Subscription*, std::chrono::milliseconds timeout, Message* message);
+
+    // Formats an SSE message. |data| can contain newlines.
+    static std::string formatMessage(const std::string& eventName, const std::string& data);
+
+private:
+    struct Entry {
+        uint64_t seq;
+        Message delta;
+    };
+
+    mutable std::mutex mu_;
+    std::condition_variable condVar_;
+
+    const size_t capacity_;
+    // The sequence number of the next event.
+    uint64_t head_ = 0;
+    Message snapshot_;
+    std::deque<Entry> deltas_;
+    bool closed_ = false;
+
+    DISALLOW_COPY_AND_ASSIGN(HttpEventStream);
+};
+
+#endif // NET_HTTPD_HTTP_EVENT_STREAM_H_
@@ -0,0 +1,151 @@
+#include "net/httpd/http_event_stream.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+
+const chrono::milliseconds NO_WAIT(0);
+
+string nextMessage(HttpEventStream* stream, HttpEventStream::Subscription* subscription)
+{
+    HttpEventStream::Message message;
+    if (!stream->next(subscription, NO_WAIT, &message))
+        return "closed";
+    if (!message)
+        return "timeout";
+    return *message;
+}
+
+string snapshot(const string& data)
+{
+    return HttpEventStream::formatMessage("snapshot", data);
+}
+
+string delta(const string& data)
+{
+    return HttpEventStream::formatMessage("delta", data);
+}
+
+} // anonymous namespace
+
+TEST(HttpEventStreamTest, formatMessage)
+{
+    EXPECT_EQ("event: delta\ndata: a\ndata: b\n\n", HttpEventStream::formatMessage("delta", "a\nb"));
+}
+
+TEST(HttpEventStreamTest, nothingPublished)
+{
+    HttpEventStream stream;
+    HttpEventStream::Subscription subscription;
+
+    EXPECT_EQ("timeout", nextMessage(&stream, &subscription));
+}
+
+TEST(HttpEventStreamTest, snapshotThenDeltas)
+{
+    HttpEventStream stream;
+    HttpEventStream::Subscription subscription;
+
+    stream.publish("s1", "d1");
+    stream.publish("s2", "d2");
+
+    // A new subscriber starts from the latest snapshot, which contains d1 and d2.
+    EXPECT_EQ(snapshot("s2"), nextMessage(&stream, &subscription));
+    EXPECT_EQ("timeout", nextMessage(&stream, &subscription));
+
+    stream.publish("s3", "d3");
+    stream.publish("s4", "d4");
+    EXPECT_EQ(delta("d3"), nextMessage(&stream, &subscription));
+    EXPECT_EQ(delta("d4"), nextMessage(&stream, &subscription));
+    EXPECT_EQ("timeout", nextMessage(&stream, &subscription));
+}
+
+TEST(HttpEventStreamTest, lateSubscriberAfterOverflow)
+{
+    HttpEventStream stream(2);
+    HttpEventStream::Subscription subscription;
+
+    for (int i = 1; i <= 5; ++i)
+        stream.publish("s" + to_string(i), "d" + to_string(i));
+
+    EXPECT_EQ(snapshot("s5"), nextMessage(&stream, &subscription));
+    EXPECT_EQ("timeout", nextMessage(&stream, &subscription));
+}
+
+TEST(HttpEventStreamTest, laggingSubscriberIsResynchronized)
+{
+    HttpEventStream stream(2);
+    HttpEventStream::Subscription subscription;
+
+    stream.publish("s1", "d1");
+    EXPECT_EQ(snapshot("s1"), nextMessage(&stream, &subscription));
+
+    // d2 and d3 are still in the buffer.
+    stream.publish("s2", "d2");
+    stream.publish("s3", "d3");
+    EXPECT_EQ(delta("d2"), nextMessage(&stream, &subscription));
+
+    // d3 is dropped from the buffer before the subscriber reads it.
+    stream.publish("s4", "d4");
+    stream.publish("s5", "d5");
+    EXPECT_EQ(snapshot("s5"), nextMessage(&stream, &subscription));
+    EXPECT_EQ("timeout", nextMessage(&stream, &subscription));
+
+    // Then deltas again.
+    stream.publish("s6", "d6");
+    EXPECT_EQ(delta("d6"), nextMessage(&stream, &subscription));
+}
+
+TEST(HttpEventStreamTest, subscribersAreIndependent)
+{
+    HttpEventStream stream(2);
+    HttpEventStream::Subscription fast;
+    HttpEventStream::Subscription slow;
+
+    stream.publish("s1", "d1");
+    EXPECT_EQ(snapshot("s1"), nextMessage(&stream, &fast));
+    EXPECT_EQ(snapshot("s1"), nextMessage(&stream, &slow));
+
+    for (int i = 2; i <= 4; ++i) {
+        stream.publish("s" + to_string(i), "d" + to_string(i));
+        EXPECT_EQ(delta("d" + to_string(i)), nextMessage(&stream, &fast));
+    }
+
+    EXPECT_EQ(snapshot("s4"), nextMessage(&stream, &slow));
+    EXPECT_EQ("timeout", nextMessage(&stream, &fast));
+}
+
+TEST(HttpEventStreamTest, nextWaitsForPublish)
+{
+    HttpEventStream stream;
+    HttpEventStream::Subscription subscription;
+
+    thread publisher([&]() {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        stream.publish("s1", "d1");
+    });
+
+    HttpEventStream::Message message;
+    EXPECT_TRUE(stream.next(&subscription, chrono::seconds(10), &message));
+    ASSERT_TRUE(message != nullptr);
+    EXPECT_EQ(snapshot("s1"), *message);
+
+    publisher.join();
+}
+
+TEST(HttpEventStreamTest, close)
+{
+    HttpEventStream stream;
+    HttpEventStream::Subscription subscription;
+
+    stream.publish("s1", "d1");
+    stream.close();
+
+    EXPECT_EQ("closed", nextMessage(&stream, &subscription));
+}
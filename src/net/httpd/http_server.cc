@@ -2,6 +2,8 @@
 
 #include <cstdlib>
 
+#include <algorithm>
+#include <chrono>
 #include <string>
 #include <fstream>
 
@@ -12,10 +14,14 @@
 #include "base/file/file.h"
 #include "base/file/path.h"
 #include "base/strings.h"
+#include "net/httpd/http_event_stream.h"
 
 using namespace std;
 
 const int POST_BUFFER_SIZE = 4096;
+const int EVENT_STREAM_BLOCK_SIZE = 4096;
+// A comment line is sent when nothing happens for a while, so that proxies don't close the stream.
+const std::chrono::seconds EVENT_STREAM_KEEPALIVE_INTERVAL(15);
 
 class HttpExchange {
 public:
@@ -83,6 +89,62 @@ static int handleHandler(MHD_Connection* connection, const HttpHandler& handler,
     return ret;
 }
 
+// EventStreamReader is the state of an event stream response for one connection.
+class EventStreamReader {
+public:
+    explicit EventStreamReader(HttpEventStream* stream) : stream_(stream) {}
+
+    // This runs on the connection's thread, so it can block until the next message comes.
+    static ssize_t read(void* cls, uint64_t /*pos*/, char* buf, size_t max)
+    {
+        EventStreamReader* reader = reinterpret_cast<EventStreamReader*>(cls);
+
+        if (!reader->message_ || reader->offset_ >= reader->message_->size()) {
+            HttpEventStream::Message message;
+            if (!reader->stream_->next(&reader->subscription_, EVENT_STREAM_KEEPALIVE_INTERVAL, &message))
+                return MHD_CONTENT_READER_END_OF_STREAM;
+            if (!message)
+                message = keepAliveMessage();
+            reader->message_ = move(message);
+            reader->offset_ = 0;
+        }
+
+        size_t size = min(max, reader->message_->size() - reader->offset_);
+        memcpy(buf, reader->message_->data() + reader->offset_, size);
+        reader->offset_ += size;
+        return size;
+    }
+
+    static void destroy(void* cls)
+    {
+        delete reinterpret_cast<EventStreamReader*>(cls);
+    }
+
+private:
+    static const HttpEventStream::Message& keepAliveMessage()
+    {
+        static const HttpEventStream::Message message = make_shared<const string>(":\n\n");
+        return message;
+    }
+
+    HttpEventStream* stream_;
+    HttpEventStream::Subscription subscription_;
+    HttpEventStream::Message message_;
+    size_t offset_ = 0;
+};
+
+static int eventStreamHandler(MHD_Connection* connection, HttpEventStream* stream)
+{
+    struct MHD_Response* response = MHD_create_response_from_callback(
+        MHD_SIZE_UNKNOWN, EVENT_STREAM_BLOCK_SIZE,
+        &EventStreamReader::read, new EventStreamReader(stream), &EventStreamReader::destroy);
+    MHD_add_response_header(response, "Content-Type", "text/event-stream");
+    MHD_add_response_header(response, "Cache-Control", "no-cache");
+    int ret = MHD_queue_response(connection, MHD_HTTP_OK, response);
+    MHD_destroy_response(response);
+    return ret;
+}
+
 static int iterate_post(void* con_cls, enum MHD_ValueKind /*kind*/, const char* key,
                         const char* /*filename*/, const char* /*content_type*/, const char* /*transfer_encoding*/,
                         const char* data, uint64_t /*off*/, size_t size)
@@ -122,6 +184,12 @@ int HttpServer::accessHandler(void* cls, struct MHD_Connection* connection,
     HttpExchange* exchange = reinterpret_cast<HttpExchange*>(*con_cls);
 
     if (strcmp(method, MHD_HTTP_METHOD_GET) == 0) {
+        // Check event streams.
+        auto streamIt = server->eventStreams_.find(url);
+        if (streamIt != server->eventStreams_.end()) {
+            return eventStreamHandler(connection, streamIt->second);
+        }
+
         // Check normal handlers.
         auto it = server->handlers_.find(url);
         if (it != server->handlers_.end()) {
@@ -186,7 +254,8 @@ bool HttpServer::start()
 {
     DCHECK(!httpd_);
 
-    httpd_ = MHD_start_daemon(MHD_USE_SELECT_INTERNALLY, port_, nullptr, nullptr,
+    // Each connection has its own thread, since an event stream blocks until the next event comes.
+    httpd_ = MHD_start_daemon(MHD_USE_THREAD_PER_CONNECTION, port_, nullptr, nullptr,
                               &HttpServer::accessHandler, reinterpret_cast<void*>(this),
                               MHD_OPTION_NOTIFY_COMPLETED, &HttpServer::requestCompleted, nullptr,
                               MHD_OPTION_END);
@@ -196,6 +265,10 @@ bool HttpServer::start()
 
 void HttpServer::stop()
 {
+    // Close the streams first. Otherwise the connection threads never finish.
+    for (auto& entry : eventStreams_)
+        entry.second->close();
+
     MHD_stop_daemon(httpd_);
 }
 
@@ -238,3 +311,11 @@ void HttpServer::installStaticFileHandler(const std::string& path,
         return;
     };
 }
+
+void HttpServer::installEventStreamHandler(const string& path, HttpEventStream* stream)
+{
+    DCHECK(stream);
+    DCHECK(!eventStreams_[path]);
+
+    eventStreams_[path] = stream;
+}
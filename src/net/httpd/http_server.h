@@ -9,6 +9,8 @@
 
 #include "net/httpd/http_handler.h"
 
+class HttpEventStream;
+
 class HttpServer {
 public:
     explicit HttpServer(int port);
@@ -21,6 +23,9 @@ public:
     void installStaticFileHandler(const std::string& path,
                                   const std::string& filepath,
                                   const std::string& mime);
+    // Serves |stream| as text/event-stream. Doesn't take ownership.
+    // |stream| should be alive until stop() is called.
+    void installEventStreamHandler(const std::string& path, HttpEventStream* stream);
 
     // When no handler is matched, we get the content of this path.
     void setAssetDirectory(const std::string& path);
@@ -35,6 +40,7 @@ private:
     int port_;
     struct MHD_Daemon* httpd_;
     std::unordered_map<std::string, HttpHandler> handlers_;
+    std::unordered_map<std::string, HttpEventStream*> eventStreams_;
     std::string assetDirPath_;
 };
 
@@ -32,6 +32,7 @@ EndlessResult Endless::run(const KumipuyoSeq& originalSeq)
     ai_->enemy_.seq = req.playerFrameRequest[1].kumipuyoSeq;
 
     vector<Decision> decisions;
+    vector<double> thinkTimes;
 
     int maxRensaScore = 0;
     int maxRensa = 0;
@@ -61,6 +62,7 @@ EndlessResult Endless::run(const KumipuyoSeq& originalSeq)
                                                false);
 
         double endTime = currentTime();
+        thinkTimes.push_back(endTime - beginTime);
 
         CoreField f(req.myPlayerFrameRequest().field);
         if (!f.dropKumipuyo(dropDecision.decision(), req.myPlayerFrameRequest().kumipuyoSeq.front())) {
@@ -85,6 +87,7 @@ EndlessResult Endless::run(const KumipuyoSeq& originalSeq)
                 false,                     // .zenkeshi
                 decisions,                 // .decisions
                 EndlessResult::Type::DEAD, // .type
+                thinkTimes,                // .thinkTimes
             };
         }
         if (rensaResult.score > 10000) {
@@ -96,6 +99,7 @@ EndlessResult Endless::run(const KumipuyoSeq& originalSeq)
                 f.isZenkeshi(),                  // .zenkeshi
                 decisions,                       // .decisions
                 EndlessResult::Type::MAIN_CHAIN, // .type
+                thinkTimes,                      // .thinkTimes
             };
         }
         if (f.isZenkeshi()) {
@@ -106,7 +110,7 @@ EndlessResult Endless::run(const KumipuyoSeq& originalSeq)
                 true,                          // .zenkeshi
                 decisions,                     // .decisions
                 EndlessResult::Type::ZENKESHI, // .type
-
+                thinkTimes,                    // .thinkTimes
             };
         }
 
@@ -125,6 +129,7 @@ EndlessResult Endless::run(const KumipuyoSeq& originalSeq)
         false,                               // .zenkeshi
         decisions,                           // .decisions
         EndlessResult::Type::PUYOSEQ_RUNOUT, // .type
+        thinkTimes,                          // .thinkTimes
     };
 }
 
@@ -23,6 +23,8 @@ struct EndlessResult {
     bool zenkeshi;
     std::vector<Decision> decisions;
     Type type;
+    // The time [s] spent for think() in each hand.
+    std::vector<double> thinkTimes;
 };
 
 // Endless implements endless mode. This can be used to check your AI's strength.
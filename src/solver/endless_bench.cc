@@ -0,0 +1,275 @@
+#include "solver/endless_bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <glog/logging.h>
+#include <json/json.h>
+
+#include "base/time.h"
+#include "core/client/ai/ai.h"
+#include "core/kumipuyo_seq.h"
+#include "core/kumipuyo_seq_generator.h"
+
+using namespace std;
+
+namespace {
+
+int scoreOf(const EndlessResult& result)
+{
+    return std::max(result.score, 0);
+}
+
+const char* typeToString(EndlessResult::Type type)
+{
+    switch (type) {
+    case EndlessResult::Type::DEAD: return "DEAD";
+    case EndlessResult::Type::MAIN_CHAIN: return "MAIN_CHAIN";
+    case EndlessResult::Type::ZENKESHI: return "ZENKESHI";
+    case EndlessResult::Type::PUYOSEQ_RUNOUT: return "PUYOSEQ_RUNOUT";
+    }
+
+    CHECK(false) << "Unknown type: " << static_cast<int>(type);
+    return "";
+}
+
+} // anonymous namespace
+
+// static
+const vector<double>& EndlessBenchReport::thinkTimeBucketBounds()
+{
+    static const vector<double> bounds { 1, 2, 5, 10, 20, 50, 100, 200, 300, 500, 1000 };
+    return bounds;
+}
+
+int EndlessBenchReport::countType(EndlessResult::Type type) const
+{
+    int count = 0;
+    for (const auto& c : cases) {
+        if (c.result.type == type)
+            ++count;
+    }
+    return count;
+}
+
+double EndlessBenchReport::mainChainRate() const
+{
+    if (cases.empty())
+        return 0;
+    return static_cast<double>(countType(EndlessResult::Type::MAIN_CHAIN)) / cases.size();
+}
+
+double EndlessBenchReport::meanScore() const
+{
+    if (cases.empty())
+        return 0;
+
+    double sum = 0;
+    for (const auto& c : cases)
+        sum += scoreOf(c.result);
+    return sum / cases.size();
+}
+
+double EndlessBenchReport::scoreDeviation() const
+{
+    if (cases.size() < 2)
+        return 0;
+
+    double mean = meanScore();
+    double variance = 0;
+    for (const auto& c : cases)
+        variance += (scoreOf(c.result) - mean) * (scoreOf(c.result) - mean);
+    return std::sqrt(variance / (cases.size() - 1));
+}
+
+int EndlessBenchReport::percentileScore(double percentile) const
+{
+    DCHECK(0 <= percentile && percentile <= 100) << percentile;
+    if (cases.empty())
+        return 0;
+
+    vector<int> scores;
+    scores.reserve(cases.size());
+    for (const auto& c : cases)
+        scores.push_back(scoreOf(c.result));
+    sort(scores.begin(), scores.end());
+
+    // nearest-rank method.
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * scores.size()));
+    return scores[rank == 0 ? 0 : rank - 1];
+}
+
+vector<int> EndlessBenchReport::thinkTimeHistogram() const
+{
+    const vector<double>& bounds = thinkTimeBucketBounds();
+    vector<int> histogram(bounds.size() + 1);
+    for (const auto& c : cases) {
+        for (double t : c.result.thinkTimes) {
+            size_t i = upper_bound(bounds.begin(), bounds.end(), t * 1000) - bounds.begin();
+            histogram[i]++;
+        }
+    }
+
+    return histogram;
+}
+
+double EndlessBenchReport::maxThinkTime() const
+{
+    double result = 0;
+    for (const auto& c : cases) {
+        for (double t : c.result.thinkTimes)
+            result = std::max(result, t);
+    }
+    return result;
+}
+
+string EndlessBenchReport::toString() const
+{
+    stringstream ss;
+    ss << "cases        = " << cases.size() << endl;
+    ss << "main chain % = " << (100.0 * mainChainRate()) << endl;
+    ss << "zenkeshi     = " << countType(EndlessResult::Type::ZENKESHI) << endl;
+    ss << "dead         = " << countType(EndlessResult::Type::DEAD) << endl;
+    ss << "ave score    = " << meanScore() << endl;
+    ss << "deviation    = " << scoreDeviation() << endl;
+    ss << "p10 / p50 / p90 score = "
+       << percentileScore(10) << " / " << percentileScore(50) << " / " << percentileScore(90) << endl;
+    ss << "max think    = " << (maxThinkTime() * 1000) << " [ms]" << endl;
+    ss << "games/sec    = " << gamesPerSecond() << " (" << numWorkers << " workers)" << endl;
+
+    const vector<double>& bounds = thinkTimeBucketBounds();
+    vector<int> histogram = thinkTimeHistogram();
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        if (i < bounds.size())
+            ss << "  think < " << setw(4) << bounds[i] << " [ms]: " << histogram[i] << endl;
+        else
+            ss << "  think >= " << setw(3) << bounds.back() << " [ms]: " << histogram[i] << endl;
+    }
+
+    return ss.str();
+}
+
+string EndlessBenchReport::toJson() const
+{
+    Json::Value root;
+    root["num_cases"] = numCases();
+    root["num_workers"] = numWorkers;
+    root["elapsed_time"] = elapsedTime;
+    root["games_per_second"] = gamesPerSecond();
+    root["main_chain_rate"] = mainChainRate();
+    root["num_zenkeshi"] = countType(EndlessResult::Type::ZENKESHI);
+    root["num_dead"] = countType(EndlessResult::Type::DEAD);
+    root["mean_score"] = meanScore();
+    root["score_deviation"] = scoreDeviation();
+    for (int p : { 10, 25, 50, 75, 90, 99 })
+        root["score_percentiles"]["p" + std::to_string(p)] = percentileScore(p);
+    root["max_think_time"] = maxThinkTime();
+
+    Json::Value& histogram = root["think_time_histogram"];
+    histogram["bounds_ms"] = Json::Value(Json::arrayValue);
+    for (double bound : thinkTimeBucketBounds())
+        histogram["bounds_ms"].append(bound);
+    histogram["counts"] = Json::Value(Json::arrayValue);
+    for (int count : thinkTimeHistogram())
+        histogram["counts"].append(count);
+
+    Json::Value& cs = root["cases"];
+    cs = Json::Value(Json::arrayValue);
+    for (const auto& c : cases) {
+        Json::Value v;
+        v["seed"] = c.seed;
+        v["type"] = typeToString(c.result.type);
+        v["hand"] = c.result.hand;
+        v["score"] = c.result.score;
+        v["max_rensa"] = c.result.maxRensa;
+        v["zenkeshi"] = c.result.zenkeshi;
+        v["decisions"] = ::toString(c.result.decisions);
+        cs.append(v);
+    }
+
+    Json::StyledWriter writer;
+    return writer.write(root);
+}
+
+string EndlessBenchReport::toCSV() const
+{
+    stringstream ss;
+    ss << "seed,type,hand,score,max_rensa,zenkeshi,total_think_time,max_think_time" << endl;
+    for (const auto& c : cases) {
+        double totalTime = 0;
+        double maxTime = 0;
+        for (double t : c.result.thinkTimes) {
+            totalTime += t;
+            maxTime = std::max(maxTime, t);
+        }
+
+        ss << c.seed << ','
+           << typeToString(c.result.type) << ','
+           << c.result.hand << ','
+           << c.result.score << ','
+           << c.result.maxRensa << ','
+           << (c.result.zenkeshi ? 1 : 0) << ','
+           << totalTime << ','
+           << maxTime << endl;
+    }
+
+    return ss.str();
+}
+
+EndlessBench::EndlessBench(AIFactory factory, int numWorkers) :
+    factory_(std::move(factory)),
+    numWorkers_(numWorkers)
+{
+    CHECK_GE(numWorkers_, 1);
+}
+
+EndlessBenchReport EndlessBench::run(int numCases, int seedOffset)
+{
+    EndlessBenchReport report;
+    report.cases.resize(numCases);
+    report.numWorkers = numWorkers_;
+
+    atomic<int> nextIndex(0);
+    mutex mu;
+
+    auto worker = [&]() {
+        Endless endless(factory_());
+        while (true) {
+            int i = nextIndex++;
+            if (i >= numCases)
+                return;
+
+            int seed = seedOffset + i;
+            KumipuyoSeq seq = KumipuyoSeqGenerator::generateACPuyo2SequenceWithSeed(seed);
+            EndlessResult result = endless.run(seq);
+
+            if (verbose_) {
+                lock_guard<mutex> lock(mu);
+                cout << "case " << setw(4) << seed << ": "
+                     << "score=" << setw(6) << result.score << " rensa=" << setw(2) << result.maxRensa;
+                if (result.zenkeshi)
+                    cout << " / ZENKESHI";
+                cout << endl;
+            }
+
+            report.cases[i] = EndlessBenchReport::Case { seed, std::move(result) };
+        }
+    };
+
+    double beginTime = currentTime();
+
+    vector<thread> threads;
+    for (int i = 0; i < numWorkers_; ++i)
+        threads.emplace_back(worker);
+    for (auto& th : threads)
+        th.join();
+
+    report.elapsedTime = currentTime() - beginTime;
+    return report;
+}
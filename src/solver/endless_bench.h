@@ -0,0 +1,73 @@
+#ifndef SOLVER_ENDLESS_BENCH_H_
+#define SOLVER_ENDLESS_BENCH_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/base.h"
+#include "solver/endless.h"
+
+class AI;
+
+// EndlessBenchReport is a summary of EndlessBench::run().
+struct EndlessBenchReport {
+    struct Case {
+        int seed;
+        EndlessResult result;
+    };
+
+    // Upper bounds [ms] of the think time histogram buckets. The last bucket has no upper bound.
+    static const std::vector<double>& thinkTimeBucketBounds();
+
+    int numCases() const { return static_cast<int>(cases.size()); }
+    int countType(EndlessResult::Type) const;
+    // Rate of the cases where the main chain is fired.
+    double mainChainRate() const;
+    // Score statistics. The score of a dead case is considered as 0.
+    double meanScore() const;
+    double scoreDeviation() const;
+    // Returns the score at |percentile| (0 <= percentile <= 100).
+    int percentileScore(double percentile) const;
+    // Returns the number of hands in each think time bucket.
+    std::vector<int> thinkTimeHistogram() const;
+    double maxThinkTime() const;
+    double gamesPerSecond() const { return elapsedTime > 0 ? cases.size() / elapsedTime : 0; }
+
+    std::string toString() const;
+    // Machine readable formats.
+    std::string toJson() const;
+    // One line for each case.
+    std::string toCSV() const;
+
+    // Sorted by seed.
+    std::vector<Case> cases;
+    int numWorkers = 0;
+    // Wall clock time [s] to run all the cases.
+    double elapsedTime = 0;
+};
+
+// EndlessBench runs Endless over seeded KumipuyoSeqs in parallel.
+// Each worker thread makes its own AI with AIFactory and reuses it for all the cases
+// the worker runs. The sequence of case i is generated with seed |seedOffset + i|,
+// so the result is reproducible as long as the AI itself is deterministic.
+class EndlessBench {
+public:
+    typedef std::function<std::unique_ptr<AI> ()> AIFactory;
+
+    EndlessBench(AIFactory factory, int numWorkers);
+
+    EndlessBenchReport run(int numCases, int seedOffset = 0);
+
+    void setVerbose(bool flag) { verbose_ = flag; }
+
+private:
+    AIFactory factory_;
+    int numWorkers_;
+    bool verbose_ = false;
+
+    DISALLOW_COPY_AND_ASSIGN(EndlessBench);
+};
+
+#endif // SOLVER_ENDLESS_BENCH_H_
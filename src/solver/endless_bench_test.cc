@@ -0,0 +1,122 @@
+#include "solver/endless_bench.h"
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+using namespace std;
+
+namespace {
+
+EndlessBenchReport::Case makeCase(int seed, EndlessResult::Type type, int score, vector<double> thinkTimes)
+{
+    EndlessResult result;
+    result.hand = 10;
+    result.score = score;
+    result.maxRensa = 0;
+    result.zenkeshi = type == EndlessResult::Type::ZENKESHI;
+    result.type = type;
+    result.thinkTimes = std::move(thinkTimes);
+    return EndlessBenchReport::Case { seed, result };
+}
+
+// Scores after clamping are 40000, 0, 60000, 2100, 8000.
+EndlessBenchReport makeReport()
+{
+    EndlessBenchReport report;
+    report.cases.push_back(makeCase(10, EndlessResult::Type::MAIN_CHAIN, 40000, { 0.0005, 0.003 }));
+    report.cases.push_back(makeCase(11, EndlessResult::Type::DEAD, -1, { 0.15 }));
+    report.cases.push_back(makeCase(12, EndlessResult::Type::MAIN_CHAIN, 60000, { 0.0015 }));
+    report.cases.push_back(makeCase(13, EndlessResult::Type::ZENKESHI, 2100, { 2.0 }));
+    report.cases.push_back(makeCase(14, EndlessResult::Type::PUYOSEQ_RUNOUT, 8000, {}));
+    report.numWorkers = 2;
+    report.elapsedTime = 2.5;
+    return report;
+}
+
+} // anonymous namespace
+
+TEST(EndlessBenchReportTest, empty)
+{
+    EndlessBenchReport report;
+
+    EXPECT_EQ(0, report.numCases());
+    EXPECT_EQ(0, report.mainChainRate());
+    EXPECT_EQ(0, report.meanScore());
+    EXPECT_EQ(0, report.scoreDeviation());
+    EXPECT_EQ(0, report.percentileScore(50));
+    EXPECT_EQ(0, report.maxThinkTime());
+    EXPECT_EQ(0, report.gamesPerSecond());
+}
+
+TEST(EndlessBenchReportTest, countType)
+{
+    EndlessBenchReport report = makeReport();
+
+    EXPECT_EQ(5, report.numCases());
+    EXPECT_EQ(2, report.countType(EndlessResult::Type::MAIN_CHAIN));
+    EXPECT_EQ(1, report.countType(EndlessResult::Type::DEAD));
+    EXPECT_EQ(1, report.countType(EndlessResult::Type::ZENKESHI));
+    EXPECT_EQ(1, report.countType(EndlessResult::Type::PUYOSEQ_RUNOUT));
+    EXPECT_DOUBLE_EQ(0.4, report.mainChainRate());
+    EXPECT_DOUBLE_EQ(2.0, report.gamesPerSecond());
+}
+
+TEST(EndlessBenchReportTest, scoreStatistics)
+{
+    EndlessBenchReport report = makeReport();
+
+    // The score of the dead case is counted as 0.
+    EXPECT_DOUBLE_EQ(22020, report.meanScore());
+    // Sample standard deviation.
+    EXPECT_NEAR(26664.6207548, report.scoreDeviation(), 1e-6);
+}
+
+TEST(EndlessBenchReportTest, percentileScore)
+{
+    EndlessBenchReport report = makeReport();
+
+    // Nearest-rank over the sorted scores 0, 2100, 8000, 40000, 60000.
+    EXPECT_EQ(0, report.percentileScore(0));
+    EXPECT_EQ(0, report.percentileScore(10));
+    EXPECT_EQ(0, report.percentileScore(20));
+    EXPECT_EQ(2100, report.percentileScore(21));
+    EXPECT_EQ(2100, report.percentileScore(40));
+    EXPECT_EQ(8000, report.percentileScore(50));
+    EXPECT_EQ(60000, report.percentileScore(90));
+    EXPECT_EQ(60000, report.percentileScore(100));
+}
+
+TEST(EndlessBenchReportTest, thinkTimeHistogram)
+{
+    EndlessBenchReport report = makeReport();
+
+    // Bounds are 1, 2, 5, 10, 20, 50, 100, 200, 300, 500, 1000 [ms].
+    vector<int> expected { 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 0, 1 };
+    EXPECT_EQ(expected, report.thinkTimeHistogram());
+    EXPECT_DOUBLE_EQ(2.0, report.maxThinkTime());
+}
+
+TEST(EndlessBenchReportTest, toJson)
+{
+    EndlessBenchReport report = makeReport();
+
+    Json::Value root;
+    Json::Reader reader;
+    ASSERT_TRUE(reader.parse(report.toJson(), root));
+
+    EXPECT_EQ(5, root["num_cases"].asInt());
+    EXPECT_EQ(2, root["num_workers"].asInt());
+    EXPECT_DOUBLE_EQ(22020, root["mean_score"].asDouble());
+    EXPECT_EQ(8000, root["score_percentiles"]["p50"].asInt());
+    EXPECT_EQ(1, root["num_dead"].asInt());
+
+    int numHands = 0;
+    for (const auto& count : root["think_time_histogram"]["counts"])
+        numHands += count.asInt();
+    EXPECT_EQ(5, numHands);
+
+    ASSERT_EQ(5U, root["cases"].size());
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(10 + i, root["cases"][i]["seed"].asInt());
+    EXPECT_EQ("DEAD", root["cases"][1]["type"].asString());
+}